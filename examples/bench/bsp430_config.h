@@ -0,0 +1,26 @@
+/* The benchmarks run in an instruction-set simulator that does not
+ * model the clock system.  Leave clocks at their power-up
+ * configuration so nothing waits on oscillator flags. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_CLOCKS 0
+
+/* Console output is buffered and never waits for the UART */
+#define configBSP430_CONSOLE 1
+#define BSP430_CONSOLE_TX_BUFFER_SIZE 128
+
+/* Provide the uptime timer used for timestamps and alarms, with the
+ * delay support required by the BMP180 module */
+#define configBSP430_UPTIME 1
+#define configBSP430_UPTIME_DELAY 1
+
+/* The BMP180 module uses I2C although the benchmark does not */
+#define configBSP430_SERIAL_ENABLE_I2C 1
+
+/* Include TLV infrastructure for its checksum routine */
+#define configBSP430_TLV 1
+
+/* Room for the largest multiplexed alarm benchmark when
+ * configBSP430_TIMER_MUXALARM_HEAP is enabled */
+#define BSP430_TIMER_MUXALARM_HEAP_SIZE 129
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,366 @@
+/** This file is in the public domain.
+ *
+ * Cycle-count benchmarks for library routines that sit on common
+ * application hot paths.
+ *
+ * Each benchmark is run once between calls to bench_start() and
+ * bench_stop().  These functions do nothing; they exist so an
+ * instruction-set simulator can stop at them.  Before bench_start()
+ * is invoked the name of the benchmark is stored in #bench_name.
+ * When all benchmarks have run the application invokes the pair
+ * repeatedly with an empty name.
+ *
+ * <tt>make bench</tt> runs the image in the mspdebug simulator,
+ * clears the cycle counter of a tracer device at each bench_start(),
+ * reads it at each bench_stop(), and emits one line per benchmark:
+ * @verbatim
+ * <name> <cycles>
+ * @endverbatim
+ * The cycles of the @c overhead benchmark, which does nothing, have
+ * been subtracted from every other result, so the values reflect
+ * only the routine being measured.
+ *
+ * The simulator has no peripherals beyond those it is told about, so
+ * the application avoids operations that wait on hardware: clocks
+ * are not configured, and console output goes into a transmit
+ * buffer large enough to hold it all.
+ *
+ * The host platform has no cycle counter, and its emulation of each
+ * peripheral access costs far more than the routines measured here.
+ * A host build runs each benchmark once, writes its name to the
+ * console with @c unmeasured in place of the cycle count, and exits;
+ * this checks that the benchmarks work, but produces no timing.
+ * bench-cycles.py rejects host images.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/cli.h>
+#include <bsp430/utility/event.h>
+#include <bsp430/utility/tlv.h>
+#include <bsp430/sensors/bmp180.h>
+#include <string.h>
+#if (BSP430_PLATFORM_HOST - 0)
+#include <stdlib.h>
+#endif /* BSP430_PLATFORM_HOST */
+
+/* Name of the benchmark being run, or an empty string when all have
+ * completed.  Read by the simulator script at bench_stop(), which
+ * dumps only these 16 octets, so names are limited to 15 characters. */
+char bench_name[16];
+
+void __attribute__((__noinline__))
+bench_start (void)
+{
+  __asm__ __volatile__("");
+}
+
+void __attribute__((__noinline__))
+bench_stop (void)
+{
+  __asm__ __volatile__("");
+}
+
+static void
+bench_overhead (void)
+{
+}
+
+static void
+bench_cprintf (void)
+{
+  cprintf("%s %d 0x%04x %lu\n", "value", -1234, 0xBEEFU, 1234567890UL);
+}
+
+static void
+bench_uptimeAsText (void)
+{
+  char buffer[BSP430_UPTIME_AS_TEXT_LENGTH];
+
+  (void)xBSP430uptimeAsText(BSP430_UPTIME_MS_TO_UTT(3723456UL), buffer);
+}
+
+static volatile unsigned long uptime_ms;
+
+static void
+bench_uptimeUTTToMS (void)
+{
+  uptime_ms = BSP430_UPTIME_UTT_TO_MS(122013917UL);
+}
+
+static int
+cmd_dummy (const char * argstr)
+{
+  return 0;
+}
+
+#define LAST_COMMAND NULL
+static const sBSP430cliCommand dcmd_uptime = {
+  .key = "uptime",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_dummy
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_uptime
+static const sBSP430cliCommand dcmd_show = {
+  .key = "show",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_dummy
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_show
+static const sBSP430cliCommand dcmd_set = {
+  .key = "set",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_dummy
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_set
+static const sBSP430cliCommand dcmd_help = {
+  .key = "help",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_dummy
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_help
+static const sBSP430cliCommand dcmd_expand = {
+  .key = "expand",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_dummy
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_expand
+
+static void
+bench_cliMatchCommand (void)
+{
+  static const char command[] = "uptime now";
+  const sBSP430cliCommand * match;
+
+  (void)iBSP430cliMatchCommand(LAST_COMMAND, command, sizeof(command) - 1, &match, NULL, NULL, NULL);
+}
+
+/* Multiplexed alarm operations run with interrupts disabled, so
+ * their cycle counts are the interrupt-off time each imposes.  They
+ * are measured with 8, 32, and 128 active alarms, at the extremes of
+ * the schedule.  To measure the heap instead of the sorted list use:
+ *
+ *   make bench EXT_CPPFLAGS=-DconfigBSP430_TIMER_MUXALARM_HEAP=1 */
+#define MUX_ALARM_MAX 128
+static sBSP430timerMuxSharedAlarm mux_shared;
+static sBSP430timerMuxAlarm mux_alarms[MUX_ALARM_MAX];
+static sBSP430timerMuxAlarm mux_early;
+static sBSP430timerMuxAlarm mux_late;
+static unsigned int mux_count;
+static unsigned long mux_base_tck;
+
+static int
+mux_cb_ni (hBSP430timerMuxSharedAlarm shared,
+           hBSP430timerMuxAlarm alarm)
+{
+  return 0;
+}
+
+/* Leave count alarms active, due at 1000-tick intervals, with
+ * mux_early due before all of them and mux_late after. */
+static void
+mux_prepare (unsigned int count)
+{
+  unsigned int i;
+
+  (void)iBSP430timerMuxAlarmRemove_ni(&mux_shared, &mux_early);
+  (void)iBSP430timerMuxAlarmRemove_ni(&mux_shared, &mux_late);
+  for (i = 0; i < MUX_ALARM_MAX; ++i) {
+    (void)iBSP430timerMuxAlarmRemove_ni(&mux_shared, mux_alarms + i);
+  }
+  mux_count = count;
+  for (i = 0; i < count; ++i) {
+    mux_alarms[i].setting_tck = mux_base_tck + 1000UL * (i + 1);
+    (void)iBSP430timerMuxAlarmAdd_ni(&mux_shared, mux_alarms + i);
+  }
+  mux_early.setting_tck = mux_base_tck + 500;
+  mux_late.setting_tck = mux_base_tck + 1000UL * (count + 1);
+}
+
+/* As mux_prepare() but with the first alarm due now */
+static void
+mux_prepare_fire (unsigned int count)
+{
+  mux_prepare(count);
+  (void)iBSP430timerMuxAlarmRemove_ni(&mux_shared, mux_alarms);
+  mux_alarms[0].setting_tck = mux_base_tck;
+  (void)iBSP430timerMuxAlarmAdd_ni(&mux_shared, mux_alarms);
+}
+
+#define MUX_PREPARE(n_)                         \
+  static void mux_prepare##n_ (void)            \
+  {                                             \
+    mux_prepare(n_);                            \
+  }                                             \
+  static void mux_prepare_fire##n_ (void)       \
+  {                                             \
+    mux_prepare_fire(n_);                       \
+  }
+MUX_PREPARE(8)
+MUX_PREPARE(32)
+MUX_PREPARE(128)
+#undef MUX_PREPARE
+
+static void
+bench_muxAddEarly (void)
+{
+  (void)iBSP430timerMuxAlarmAdd_ni(&mux_shared, &mux_early);
+}
+
+static void
+bench_muxAddLate (void)
+{
+  (void)iBSP430timerMuxAlarmAdd_ni(&mux_shared, &mux_late);
+}
+
+static void
+bench_muxRmEarly (void)
+{
+  (void)iBSP430timerMuxAlarmRemove_ni(&mux_shared, mux_alarms);
+}
+
+static void
+bench_muxRmLate (void)
+{
+  (void)iBSP430timerMuxAlarmRemove_ni(&mux_shared, mux_alarms + mux_count - 1);
+}
+
+/* Expire the first alarm as the dedicated alarm interrupt would */
+static void
+bench_muxFire (void)
+{
+  (void)mux_shared.dedicated.callback_ni(&mux_shared.dedicated);
+}
+
+static unsigned char event_tag;
+
+static void
+bench_eventRecordEvent (void)
+{
+  uBSP430eventAnyType u;
+
+  u.u32 = 0x12345678UL;
+  (void)xBSP430eventRecordEvent_ni(event_tag, 1, &u);
+}
+
+static void
+bench_BMP180convertSample (void)
+{
+  /* Values from the data sheet */
+  static const sBSP430sensorsBMP180calibration calib = {
+    .ac1 = 408, .ac2 = -72, .ac3 = -14383, .ac4 = 32741,
+    .ac5 = 32757, .ac6 = 23153, .b1 = 6190, .b2 = 4,
+    .mb = -32768, .mc = -8711, .md = 2868
+  };
+  sBSP430sensorsBMP180sample sample;
+
+  memset(&sample, 0, sizeof(sample));
+  sample.temperature_uncomp = 27898;
+  sample.pressure_uncomp = 23843;
+  vBSP430sensorsBMP180convertSample(&calib, &sample);
+}
+
+static unsigned char tlv_data[64];
+
+static void
+bench_tlvChecksum (void)
+{
+  (void)uiBSP430tlvChecksum(tlv_data, sizeof(tlv_data));
+}
+
+typedef struct sBenchmark {
+  const char * name;
+  void (* fn) (void);
+  /* Optional; invoked before bench_start() */
+  void (* prepare) (void);
+} sBenchmark;
+
+#define MUX_BENCHMARKS(n_)                                      \
+  { "muxAddEarly" #n_, bench_muxAddEarly, mux_prepare##n_ },    \
+  { "muxAddLate" #n_, bench_muxAddLate, mux_prepare##n_ },      \
+  { "muxRmEarly" #n_, bench_muxRmEarly, mux_prepare##n_ },      \
+  { "muxRmLate" #n_, bench_muxRmLate, mux_prepare##n_ },        \
+  { "muxFire" #n_, bench_muxFire, mux_prepare_fire##n_ }
+
+/* The overhead benchmark must be first */
+static const sBenchmark benchmarks[] = {
+  { "overhead", bench_overhead },
+  { "cprintf", bench_cprintf },
+  { "uptimeAsText", bench_uptimeAsText },
+  { "uptimeUTTToMS", bench_uptimeUTTToMS },
+  { "cliMatchCommand", bench_cliMatchCommand },
+  MUX_BENCHMARKS(8),
+  MUX_BENCHMARKS(32),
+  MUX_BENCHMARKS(128),
+  { "eventRecord", bench_eventRecordEvent },
+  { "BMP180convert", bench_BMP180convertSample },
+  { "tlvChecksum", bench_tlvChecksum },
+};
+
+static void
+setup (void)
+{
+  int i;
+
+  (void)hBSP430timerMuxAlarmStartup(&mux_shared, BSP430_UPTIME_TIMER_PERIPH_HANDLE, 3);
+  mux_base_tck = ulBSP430uptime_ni();
+  for (i = 0; i < MUX_ALARM_MAX; ++i) {
+    mux_alarms[i].callback_ni = mux_cb_ni;
+  }
+  mux_early.callback_ni = mux_cb_ni;
+  mux_late.callback_ni = mux_cb_ni;
+
+  event_tag = ucBSP430eventTagAllocate("bench");
+
+  for (i = 0; i < sizeof(tlv_data); ++i) {
+    tlv_data[i] = 0x5A ^ i;
+  }
+}
+
+void main ()
+{
+  const sBenchmark * bp = benchmarks;
+  const sBenchmark * const bpe = benchmarks + sizeof(benchmarks) / sizeof(*benchmarks);
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+  setup();
+
+  while (bp < bpe) {
+    if (bp->prepare) {
+      bp->prepare();
+    }
+    strncpy(bench_name, bp->name, sizeof(bench_name) - 1);
+    bench_start();
+    bp->fn();
+    bench_stop();
+#if (BSP430_PLATFORM_HOST - 0)
+    cprintf("%s unmeasured\n", bench_name);
+#endif /* BSP430_PLATFORM_HOST */
+    ++bp;
+  }
+#if (BSP430_PLATFORM_HOST - 0)
+  (void)iBSP430consoleFlush();
+  exit(EXIT_SUCCESS);
+#endif /* BSP430_PLATFORM_HOST */
+  bench_name[0] = 0;
+  while (1) {
+    bench_start();
+    bench_stop();
+  }
+}
@@ -60,13 +60,13 @@ void main ()
   tms.tm_mon = 11;
 #endif
 
-  /* Set start address for slave transmitter mode */
+#if 0
+  /* Write the time starting at register 0 */
   {
     uint8_t data[8];
 
     memset(data, -1, sizeof(data));
     data[0] = 0;
-#if 0
     cprintf("Write time: %s", asctime(&tms));
     xDS3231tmToRegisters(&tms, &regs);
     vBSP430consoleDisplayMemory((uint8_t*)&regs, sizeof(regs), 0);
@@ -76,14 +76,16 @@ void main ()
     vBSP430consoleDisplayMemory(data, sizeof(data), 0);
     rc = iBSP430i2cTxData_rh(i2c, data, sizeof(data));
     cprintf("Time write got %d\n", rc);
-#endif
-    rc = iBSP430i2cTxData_rh(i2c, data, 1);
-    cprintf("Address set got %d\n", rc);
   }
+#endif
   while (1) {
+    const uint8_t start_addr = 0;
+
     cprintf("Regs %u long\n", (unsigned int)sizeof(regs));
     memset(&regs, 0, sizeof(regs));
-    rc = iBSP430i2cRxData_rh(i2c, (uint8_t*)&regs, sizeof(regs));
+    /* Set start address for slave transmitter mode and read back
+     * following a repeated start */
+    rc = iBSP430i2cTxRxData_rh(i2c, &start_addr, sizeof(start_addr), (uint8_t*)&regs, sizeof(regs));
     if (0 > rc) {
       cprintf("I2C RX ERROR: %d\n", rc);
       break;
@@ -35,11 +35,35 @@ static unsigned int total_fired;
 static volatile unsigned long late_min_v;
 static volatile unsigned long late_max_v;
 
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0) && (NMUXALARMS > BSP430_TIMER_MUXALARM_HEAP_SIZE)
+#error Alarm heap cannot hold NMUXALARMS alarms
+#endif /* HEAP */
+
 unsigned int
 cacheQueue_ni (hBSP430timerMuxSharedAlarm sap)
 {
-  hBSP430timerMuxAlarm map = sap->alarms;
   sAlarmQueue * qp = queue;
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0)
+  unsigned int hi;
+
+  /* In heap mode sap->alarms is only the earliest alarm, and the
+   * link fields are not maintained.  Insert each heap entry into the
+   * cache so it is displayed in the order the alarms will fire. */
+  memset(queue, -1, sizeof(queue));
+  for (hi = 0; hi < sap->heap_len; ++hi) {
+    hBSP430timerMuxAlarm map = sap->heap[hi];
+    sAlarmQueue * ip = qp;
+
+    while ((ip > queue) && (0 < (long)(ip[-1].setting_tck - map->setting_tck))) {
+      ip[0] = ip[-1];
+      --ip;
+    }
+    ip->id = (map - alarms);
+    ip->setting_tck = map->setting_tck;
+    ++qp;
+  }
+#else /* configBSP430_TIMER_MUXALARM_HEAP */
+  hBSP430timerMuxAlarm map = sap->alarms;
   memset(queue, -1, sizeof(queue));
   while (map) {
     qp->id = (map - alarms);
@@ -47,6 +71,7 @@ cacheQueue_ni (hBSP430timerMuxSharedAlarm sap)
     map = map->next;
     ++qp;
   }
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
   return (unsigned int)(qp - queue);
 }
 
@@ -14,6 +14,7 @@
 #define configBSP430_UPTIME 1
 #define configBSP430_UPTIME_DELAY 1
 #define configBSP430_UPTIME_EPOCH 1
+#define configBSP430_UPTIME_EPOCH_DISCIPLINE 1
 
 /* Support for CC30000 BoosterPack.  This conflicts with RFEM use. */
 #ifndef configBSP430_RF_CC3000BOOST
@@ -65,10 +65,20 @@
 #ifndef NTP_ADJUST_EACH_ITER
 /** Set to a true value to cause the epoch to be updated on each NTP
  * response.  When false, the epoch is set only when it is invalid,
- * which allows you to monitor the drift of the MCU uptime clock. */
+ * which allows you to monitor the drift of the MCU uptime clock.
+ *
+ * When #configBSP430_UPTIME_EPOCH_DISCIPLINE is enabled the update
+ * uses iBSP430uptimeDisciplineEpochFromNTP(), which also estimates the
+ * frequency error of the uptime clock.  Once that has settled
+ * #NTP_INTERVAL_S can be increased to an hour or more. */
 #define NTP_ADJUST_EACH_ITER 0
 #endif /* NTP_ADJUST_EACH_ITER */
 
+#ifndef NTP_INTERVAL_S
+/** The number of seconds between NTP queries. */
+#define NTP_INTERVAL_S 60
+#endif /* NTP_INTERVAL_S */
+
 static const char *
 net_ipv4AsText (const in_addr * ipaddr)
 {
@@ -372,11 +382,23 @@ void main (void)
           }
 #if (NTP_ADJUST_EACH_ITER - 0)
         } else {
+#if (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+          sBSP430uptimeDiscipline disc;
+
+          rc = iBSP430uptimeDisciplineEpochFromNTP(adjustment_ntp);
+          cputchar((0 < rc) ? 'E' : 'D');
+          if (0 > rc) {
+            cprintf("\nERR: DisciplineEpoch failed: %d\n", rc);
+          } else if (0 == (rc = iBSP430uptimeGetDiscipline(&disc))) {
+            cprintf("[freq %ld ppb jitter %lu us]", disc.freq_ppb, disc.jitter_us);
+          }
+#else /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
           rc = iBSP430uptimeAdjustEpochFromNTP(adjustment_ntp);
           cputchar('A');
           if (0 != rc) {
             cprintf("\nERR: AdjustEpoch failed: %d\n", rc);
           }
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
 #endif
         }
         cprintf("[%s:%u adj %lld ntp = %ld ms, rtt %lu us]",
@@ -413,7 +435,7 @@ void main (void)
     wlan_stop();
     vBSP430ledSet(BSP430_LED_GREEN, 0);
     vBSP430ledSet(BSP430_LED_RED, 0);
-    wake_utt += 60 * ulBSP430uptimeConversionFrequency_Hz();
+    wake_utt += NTP_INTERVAL_S * ulBSP430uptimeConversionFrequency_Hz();
     while (0 < lBSP430uptimeSleepUntil(wake_utt, LPM2_bits)) {
     }
   }
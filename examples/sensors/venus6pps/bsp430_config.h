@@ -19,6 +19,10 @@
 #define configBSP430_UPTIME 1
 #define configBSP430_UPTIME_DELAY 1
 
+/* Discipline the uptime epoch to the 1PPS signal */
+#define configBSP430_UPTIME_EPOCH 1
+#define configBSP430_UPTIME_EPOCH_DISCIPLINE 1
+
 /* Need a CC register, preferably on the uptime timer, to use for 1PPS
  * capture.  Remember that CC0 is for RTOS switching, CC1 is the
  * default for configBSP430_UPTIME_DELAY, and CC2 is the default for
@@ -14,6 +14,7 @@
 #include <ctype.h>
 #include <time.h>
 #include <bsp430/utility/gps.h>
+#include <bsp430/utility/pps.h>
 #include <bsp430/sensors/skytraq.h>
 
 /** Infrastructure has updated the 1PPS timestamp */
@@ -175,6 +176,7 @@ gps_pps_cb (unsigned long pps_tck)
 {
   gps_state_.flags |= GPS_STATE_1PPS;
   gps_state_.pps_tt = pps_tck;
+  (void)iBSP430ppsCapture_ni(pps_tck);
   /* Don't wake up on 1PPS; we'll wake on the subsequent message that
    * says what time the 1PPS occurred. */
   return 0;
@@ -342,6 +344,26 @@ void main ()
           /* Reset if we've lost the GPS fix */
           if (0 == np->fix_mode) {
             sync_utc = 0;
+            vBSP430ppsReset();
+          }
+
+          /* With a 3D fix use the time of the 1PPS to discipline the
+           * uptime epoch, and once a minute show the result. */
+          if (2 <= np->fix_mode) {
+            rc = iBSP430ppsAssociateTime(when_utc, msec, state.rx_utt);
+            if ((0 < rc) || ((0 == rc) && (0 == when_tm.tm_sec))) {
+              sBSP430ppsState pps;
+              sBSP430uptimeDiscipline disc;
+              struct timeval tv;
+
+              (void)iBSP430ppsGetState(&pps);
+              (void)iBSP430uptimeGetDiscipline(&disc);
+              (void)iBSP430uptimeAsTimeval(now_utt, &tv);
+              cprintf("\t1PPS %s: offset %ld us, freq %ld ppb, jitter %lu us; now %lu.%06lu\n",
+                      (0 < rc) ? "stepped" : "slewed", pps.offset_us,
+                      disc.freq_ppb, disc.jitter_us,
+                      (unsigned long)tv.tv_sec, (unsigned long)tv.tv_usec);
+            }
           }
 
           if (state.flags & GPS_STATE_1PPS) {
@@ -0,0 +1,118 @@
+/** This file is in the public domain.
+ *
+ * Emit binary console log records, decode them with
+ * maintainer/blog-decode.py using this image, and compare the result
+ * with the text the C library produces for the same calls.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/platform/host/sim.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if ! (configBSP430_CONSOLE_BINARY_LOG - 0)
+#error configBSP430_CONSOLE_BINARY_LOG must be enabled for this test
+#endif /* configBSP430_CONSOLE_BINARY_LOG */
+
+static unsigned char capture[1024];
+static char expect[1024];
+static char decoded[1024];
+static size_t expect_len;
+
+/* Emit a record and append the expected text */
+#define LOG(...) do {                                                   \
+    (void)cprintf(__VA_ARGS__);                                         \
+    expect_len += snprintf(expect + expect_len, sizeof(expect) - expect_len, __VA_ARGS__); \
+  } while (0)
+
+/* Emit text that is not a record */
+#define TEXT(s_) do {                                                   \
+    (void)cputtext(s_);                                                 \
+    expect_len += snprintf(expect + expect_len, sizeof(expect) - expect_len, "%s", s_); \
+  } while (0)
+
+static long
+emit_records (void)
+{
+  const char * str = "string";
+  int i = -42;
+
+  iBSP430consoleFlush();
+  (void)lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, capture, sizeof(capture));
+
+  LOG("no arguments\n");
+  TEXT("plain text ");
+  LOG("int %d unsigned %u hex %x %X octal %o\n", i, 40000U, 0xbeef, 0xBEEF, 8);
+  LOG("long %ld %lu %lx\n", -1234567890L, 4000000000UL, 0xfeedfaceUL);
+  LOG("long long %lld %llu\n", -1234567890123LL, 18446744073709551615ULL);
+  LOG("char '%c' string '%s' literal '%s'\n", 'z', str, "lit");
+  LOG("width [%8d] [%-8d] [%08d] [%+d] [% d]\n", 17, 17, -17, 17, 17);
+  LOG("star [%*d] [%-*s] [%.*s]\n", 6, i, 7, str, 3, str);
+  LOG("modifiers %hd %hhu %zu %td\n", (short)-3, (unsigned char)200, sizeof(capture), (ptrdiff_t)-9);
+  LOG("percent %% pointer %p\n", (void *)capture);
+  TEXT("trailing text\n");
+
+  iBSP430consoleFlush();
+  return lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, NULL, 0);
+}
+
+/* Run the decoder on the captured stream, returning the length of the
+ * decoded text or -1 on failure. */
+static long
+decode (long len)
+{
+  char path[] = "/tmp/blogXXXXXX";
+  char command[256];
+  FILE * fp;
+  long n = -1;
+  int fd = mkstemp(path);
+
+  if (0 > fd) {
+    return -1;
+  }
+  if (len == write(fd, capture, len)) {
+    snprintf(command, sizeof(command), BLOG_DECODE " /proc/%d/exe %s", (int)getpid(), path);
+    fp = popen(command, "r");
+    if (NULL != fp) {
+      n = fread(decoded, 1, sizeof(decoded) - 1, fp);
+      decoded[n] = 0;
+      if (0 != pclose(fp)) {
+        n = -1;
+      }
+    }
+  }
+  close(fd);
+  unlink(path);
+  return n;
+}
+
+void main ()
+{
+  long len;
+  long n;
+
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  len = emit_records();
+  BSP430_UNITTEST_ASSERT_TRUE(0 < len);
+  BSP430_UNITTEST_ASSERT_TRUE(len < (long)sizeof(capture));
+  /* Records begin with the marker */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(BSP430_CONSOLE_BINARY_LOG_MARKER, capture[0]);
+  BSP430_UNITTEST_ASSERT_TRUE(NULL == memmem(capture, len, "no arguments", 12));
+  n = decode(len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld((long)expect_len, n);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == strcmp(expect, decoded));
+  if (0 != strcmp(expect, decoded)) {
+    (cprintf)("# expected:\n%s# decoded:\n%s", expect, decoded);
+  }
+
+  vBSP430unittestFinalize();
+}
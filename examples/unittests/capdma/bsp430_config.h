@@ -0,0 +1,26 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Support the unit-test framework */
+#define configBSP430_UNITTEST 1
+
+/* Captures are made on the uptime timer, which counts overflows */
+#define configBSP430_UPTIME 1
+#define configBSP430_TIMER_CAPTURE_DMA 1
+
+/* The DMA channel and the triggers for the capture registers */
+#if (BSP430_PLATFORM_HOST - 0)
+#define APP_DMA_CHANNEL 0
+#define APP_CCR0_DMATSEL 1      /* TA0CCR0 */
+#define APP_CCR2_DMATSEL 2      /* TA0CCR2 */
+#endif /* PLATFORM */
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,200 @@
+/** This file is in the public domain.
+ *
+ * Exercise the DMA capture stream.  The uptime timer is halted and
+ * set explicitly, and edges are produced by toggling the capture
+ * input between GND and VCC.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/periph/dma.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+
+hBSP430halTIMER uthal;
+
+static sBSP430timerCaptureDMA capdma;
+static uint16_t captures[8];
+static unsigned int ncompleted;
+static unsigned int completed[4];
+
+static int
+capdma_cb_ni (sBSP430timerCaptureDMA * cdp,
+              unsigned int half)
+{
+  (void)cdp;
+  if (ncompleted < (sizeof(completed) / sizeof(*completed))) {
+    completed[ncompleted] = half;
+  }
+  ++ncompleted;
+  return 0;
+}
+
+/* Set the timer to tt, then toggle the input of capture register
+ * ccidx to produce a rising edge at that time. */
+static void
+edge (int ccidx,
+      unsigned long tt)
+{
+  volatile unsigned int * cctlp = uthal->hpl->cctl + ccidx;
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    uthal->overflow_count = tt >> 16;
+    uthal->hpl->r = (uint16_t)tt;
+    *cctlp = (*cctlp & ~CCIS_3) | CCIS_3;
+    *cctlp = (*cctlp & ~CCIS_3) | CCIS_2;
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  __nop();
+}
+
+void
+testConfigure (void)
+{
+  static uint16_t odd[3];
+  int rc;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430timerCaptureDMAConfigure_ni(&capdma, BSP430_UPTIME_TIMER_PERIPH_HANDLE, 2, CM_1, CCIS_2,
+                                          APP_DMA_CHANNEL, APP_CCR2_DMATSEL, odd, sizeof(odd) / sizeof(*odd));
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_TRUE(0 > rc);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430timerCaptureDMAConfigure_ni(&capdma, BSP430_UPTIME_TIMER_PERIPH_HANDLE, 2, 0, CCIS_2,
+                                          APP_DMA_CHANNEL, APP_CCR2_DMATSEL, captures, sizeof(captures) / sizeof(*captures));
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_TRUE(0 > rc);
+}
+
+void
+testDoubleBuffer (void)
+{
+  static const unsigned long tts[] = {
+    0x1FFF0UL, 0x20010UL, 0x28010UL, 0x3000FUL,
+    0x30100UL, 0x3FFFFUL, 0x40000UL, 0x4FF00UL,
+    0x50000UL, 0x50001UL,
+  };
+  unsigned long ext[4];
+  unsigned int i;
+  int rc;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430timerCaptureDMAConfigure_ni(&capdma, BSP430_UPTIME_TIMER_PERIPH_HANDLE, 2, CM_1, CCIS_2,
+                                          APP_DMA_CHANNEL, APP_CCR2_DMATSEL, captures, sizeof(captures) / sizeof(*captures));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  capdma.callback_ni = capdma_cb_ni;
+  rc = iBSP430timerCaptureDMAStart_ni(&capdma);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  /* Each capture is copied without interrupting until a half is
+   * full. */
+  for (i = 0; i < 3; ++i) {
+    edge(2, tts[i]);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTx((uint16_t)tts[i], captures[i]);
+    BSP430_UNITTEST_ASSERT_FALSE(CCIFG & uthal->hpl->cctl[2]);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, ncompleted);
+  edge(2, tts[i++]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, ncompleted);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, completed[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(tts[3], capdma.end_tt_ni[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(tts[0], ulBSP430timerExtendCaptures(capdma.end_tt_ni[0], captures, ext, 4));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(tts[1], ext[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(tts[2], ext[2]);
+
+  /* The second half fills next */
+  for (; i < 8; ++i) {
+    edge(2, tts[i]);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTx((uint16_t)tts[i], captures[i]);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(2, ncompleted);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, completed[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(tts[7], capdma.end_tt_ni[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(tts[4], ulBSP430timerExtendCaptures(capdma.end_tt_ni[1], captures + 4, ext, 4));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(tts[5], ext[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(tts[6], ext[2]);
+
+  /* Then the first half again, without a lost capture */
+  for (; i < (sizeof(tts) / sizeof(*tts)); ++i) {
+    edge(2, tts[i]);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTx((uint16_t)tts[i], captures[i - 8]);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(2, ncompleted);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(2, capdma.blocks_ni);
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_CAPDMA_OVERRUN & capdma.flags_ni);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430timerCaptureDMAStop_ni(&capdma);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(2, rc);
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_CAPDMA_ACTIVE & capdma.flags_ni);
+
+  /* Once stopped captures are left in the register */
+  edge(2, 0x60000UL);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx((uint16_t)tts[2], captures[2]);
+  BSP430_UNITTEST_ASSERT_TRUE(CCIFG & uthal->hpl->cctl[2]);
+  uthal->hpl->cctl[2] &= ~CCIFG;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)iBSP430timerCaptureDMARelease_ni(&capdma);
+  BSP430_CORE_ENABLE_INTERRUPT();
+}
+
+void
+testCCR0 (void)
+{
+  int rc;
+
+  ncompleted = 0;
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430timerCaptureDMAConfigure_ni(&capdma, BSP430_UPTIME_TIMER_PERIPH_HANDLE, 0, CM_1, CCIS_2,
+                                          APP_DMA_CHANNEL, APP_CCR0_DMATSEL, captures, 2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  capdma.callback_ni = capdma_cb_ni;
+  rc = iBSP430timerCaptureDMAStart_ni(&capdma);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  edge(0, 0x71234UL);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, ncompleted);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0x1234, captures[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x71234UL, capdma.end_tt_ni[0]);
+  edge(0, 0x74321UL);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(2, ncompleted);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0x4321, captures[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x74321UL, capdma.end_tt_ni[1]);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)iBSP430timerCaptureDMARelease_ni(&capdma);
+  BSP430_CORE_ENABLE_INTERRUPT();
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430uptimeStart_ni();
+  vBSP430unittestInitialize();
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  /* Halt the timer without telling the infrastructure, since the
+   * test sets it explicitly.  Interrupts remain enabled so DMA
+   * completion is handled normally. */
+  uthal = hBSP430uptimeTimer();
+  uthal->hpl->ctl &= ~(MC0 | MC1);
+  uthal->hpl->r = 0;
+  uthal->overflow_count = 0;
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  testConfigure();
+  testDoubleBuffer();
+  testCCR0();
+
+  vBSP430unittestFinalize();
+}
@@ -0,0 +1,21 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Support the unit-test framework */
+#define configBSP430_UNITTEST 1
+
+/* The command set is a table generated by maintainer/cli-gentable.py */
+#define configBSP430_CLI_COMMAND_TABLE 1
+
+/* Support the binary RPC mode */
+#define configBSP430_CLI_RPC 1
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,310 @@
+/** This file is in the public domain.
+ *
+ * Exercise command lookup in a sorted command table generated by
+ * maintainer/cli-gentable.py from commands.desc, execution of
+ * command scripts, and the binary RPC mode used by
+ * maintainer/lib/python/bsp430/clirpc.py.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <string.h>
+#include <bsp430/utility/cli.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+
+static int ival;
+static long lval;
+
+/* Each simple command returns a distinct value identifying it */
+#define CMD_RETURNS(name_, value_)              \
+  static int                                    \
+  cmd_##name_ (const char * argstr)             \
+  {                                             \
+    (void)argstr;                               \
+    return value_;                              \
+  }
+
+CMD_RETURNS(alpha, 1)
+CMD_RETURNS(beta, 2)
+CMD_RETURNS(epsilon, 4)
+CMD_RETURNS(eta, 5)
+CMD_RETURNS(gamma, 6)
+CMD_RETURNS(iota, 7)
+CMD_RETURNS(kappa, 8)
+
+#include "commands.inc"
+
+#define NUM_COMMANDS (sizeof(commands) / sizeof(*commands))
+
+typedef struct sCollectMatches {
+  sBSP430cliMatchCallback cb;
+  const sBSP430cliCommand * matches[NUM_COMMANDS];
+  unsigned int nmatches;
+} sCollectMatches;
+
+static void
+collect_cb (sBSP430cliMatchCallback * self,
+            const sBSP430cliCommand * cmd)
+{
+  sCollectMatches * cp = (sCollectMatches *)self;
+
+  if (cp->nmatches < NUM_COMMANDS) {
+    cp->matches[cp->nmatches] = cmd;
+  }
+  ++cp->nmatches;
+}
+
+static int
+match (const char * command,
+       const sBSP430cliCommand ** matchp,
+       sCollectMatches * cp)
+{
+  if (cp) {
+    memset(cp, 0, sizeof(*cp));
+    cp->cb.callback = collect_cb;
+  }
+  return iBSP430cliMatchCommand(commands, command, strlen(command), matchp, cp ? &cp->cb : NULL, NULL, NULL);
+}
+
+void
+testTableShape (void)
+{
+  unsigned int i;
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(NUM_COMMANDS, commands[0].table_len);
+  for (i = 1; i < NUM_COMMANDS; ++i) {
+    BSP430_UNITTEST_ASSERT_TRUE(0 > strcmp(commands[i-1].key, commands[i].key));
+  }
+}
+
+void
+testMatch (void)
+{
+  const sBSP430cliCommand * mp;
+  sCollectMatches cm;
+  unsigned int i;
+
+  /* Every key is found by its full text and its unique prefixes,
+   * including the first and last entries of the table. */
+  for (i = 0; i < NUM_COMMANDS; ++i) {
+    mp = NULL;
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, match(commands[i].key, &mp, NULL));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTp(commands + i, mp);
+  }
+  mp = NULL;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, match("a", &mp, NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(commands + 0, mp);
+  mp = NULL;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, match("k", &mp, NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(commands + NUM_COMMANDS - 1, mp);
+  mp = NULL;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, match("ep arg", &mp, NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(commands + 3, mp);
+
+  /* An ambiguous prefix reports each candidate in table order */
+  mp = commands;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(2, match("e", &mp, &cm));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, mp);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(2, cm.nmatches);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(commands + 3, cm.matches[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(commands + 4, cm.matches[1]);
+
+  /* Tokens that sort before, between, and after the keys */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, match("aa", NULL, NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, match("f", NULL, NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, match("kappas", NULL, NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, match("z", NULL, NULL));
+
+  /* An empty token lists every command */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(- (int)NUM_COMMANDS, match("", NULL, &cm));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(NUM_COMMANDS, cm.nmatches);
+}
+
+void
+testExecute (void)
+{
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, iBSP430cliExecuteCommand(commands, NULL, "alpha"));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(6, iBSP430cliExecuteCommand(commands, NULL, "g"));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(8, iBSP430cliExecuteCommand(commands, NULL, "  kap x"));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_MultiMatch, iBSP430cliExecuteCommand(commands, NULL, "e"));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Unrecognized, iBSP430cliExecuteCommand(commands, NULL, "zeta"));
+
+  /* Sub-commands come from the nested table */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430cliExecuteCommand(commands, NULL, "delta ival 42"));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(42, ival);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430cliExecuteCommand(commands, NULL, "d l -70000"));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(-70000L, lval);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Missing, iBSP430cliExecuteCommand(commands, NULL, "delta"));
+}
+
+/* A memory script delivered a few octets at a time, so lines span
+ * several reads. */
+static int
+read_chunked (const sBSP430cliScriptSource * self,
+              unsigned long offset,
+              char * dst,
+              size_t len)
+{
+  if (3 < len) {
+    len = 3;
+  }
+  return iBSP430cliScriptReadMemory(self, offset, dst, len);
+}
+
+static int
+run_script (const char * script,
+            size_t line_size,
+            int chunked)
+{
+  sBSP430cliScriptMemory sm;
+  char line[16];
+
+  sm.source.read = chunked ? read_chunked : iBSP430cliScriptReadMemory;
+  sm.script = script;
+  sm.script_len = strlen(script);
+  memset(line, '*', sizeof(line));
+  BSP430_UNITTEST_ASSERT_TRUE(line_size < sizeof(line));
+  return iBSP430cliExecuteScript(commands, NULL, &sm.source, line, line_size);
+}
+
+void
+testScript (void)
+{
+  int chunked;
+
+  for (chunked = 0; chunked < 2; ++chunked) {
+    /* Lines of line_size-1 characters fit, with or without a final
+     * newline */
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(3, run_script("alpha x\n# note\n\nbeta yy\ngamma z", 8, chunked));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(2, run_script("alpha x\nbeta yy\n", 8, chunked));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, run_script("kappa 1", 8, chunked));
+
+    /* One more character does not */
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, run_script("alpha xy\nbeta", 8, chunked));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, run_script("beta\nkappa 12", 8, chunked));
+
+    /* A command that fails stops the script */
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Unrecognized, run_script("alpha\nzeta\nbeta", 8, chunked));
+  }
+  ival = 0;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, run_script("delta ival 9\n", 13, 0));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(9, ival);
+}
+
+/* Invoke a command through RPC, returning the reply status and
+ * storing any results after it in reply. */
+static int
+rpc (const uint8_t * body,
+     size_t body_len,
+     uint8_t * reply,
+     size_t * reply_lenp)
+{
+  size_t len;
+
+  memset(reply, 0xA5, BSP430_CLI_RPC_REPLY_SIZE);
+  len = xBSP430cliRPCExecute(commands, NULL, body, body_len, reply, BSP430_CLI_RPC_REPLY_SIZE);
+  BSP430_UNITTEST_ASSERT_TRUE((0 < len) && (len <= BSP430_CLI_RPC_REPLY_SIZE));
+  if (reply_lenp) {
+    *reply_lenp = len;
+  }
+  return reply[0] ? ((int)reply[0] - 256) : 0;
+}
+
+/* Build the body of a request for delta/<index>, with the
+ * little-endian value as argument when size is non-zero. */
+static size_t
+delta_body (uint8_t * body,
+            unsigned int index,
+            unsigned long value,
+            size_t size)
+{
+  size_t i;
+
+  body[0] = 2;
+  body[1] = 2;
+  body[2] = index;
+  for (i = 0; i < size; ++i) {
+    body[3 + i] = value;
+    value >>= 8;
+  }
+  return 3 + size;
+}
+
+void
+testRPC (void)
+{
+  /* The request produced by clirpc.encodeRequest((2, 0), struct.pack('<i', 1234)) */
+  static const uint8_t frame[] = { 0x01, 0x07, 0x02, 0x02, 0x00, 0xD2, 0x04, 0x00, 0x00, 0x2E, 0x84 };
+  uint8_t body[3 + sizeof(long)];
+  uint8_t reply[BSP430_CLI_RPC_REPLY_SIZE];
+  size_t len;
+
+  /* The check value for CRC-16/CCITT-FALSE, and the CRC of a frame
+   * generated by the host client */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0x29B1, uiBSP430cliRPCCRC(0xFFFF, (const uint8_t *)"123456789", 9));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(frame[9] | (frame[10] << 8), uiBSP430cliRPCCRC(0xFFFF, frame + 1, 1 + frame[1]));
+
+  /* Write then read ival */
+  ival = 0;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rpc(body, delta_body(body, 0, 1234, sizeof(int)), reply, &len));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1 + sizeof(int), len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1234, ival);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0xD2, reply[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0x04, reply[2]);
+  ival = -2;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rpc(body, delta_body(body, 0, 0, 0), reply, &len));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1 + sizeof(int), len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0xFE, reply[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0xFF, reply[sizeof(int)]);
+
+  /* Write lval, including its most significant octet */
+  lval = 0;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rpc(body, delta_body(body, 1, 0x81020304UL, sizeof(long)), reply, &len));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1 + sizeof(long), len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x81020304UL, (unsigned long)lval);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0x04, reply[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0x81, reply[4]);
+
+  /* An argument of the wrong size is rejected without a write */
+  ival = 7;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, rpc(body, delta_body(body, 0, 1, 1), reply, &len));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(7, ival);
+
+  /* Paths that do not identify a command */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Unrecognized, rpc(body, delta_body(body, 2, 0, 0), reply, NULL));
+  body[0] = 1;
+  body[1] = NUM_COMMANDS;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Unrecognized, rpc(body, 2, reply, NULL));
+  body[0] = 2;
+  body[1] = 0;
+  body[2] = 0;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Unrecognized, rpc(body, 3, reply, NULL));
+
+  /* A command with no RPC handler, and malformed bodies */
+  body[0] = 1;
+  body[1] = 0;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Config, rpc(body, 2, reply, NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Missing, rpc(body, 0, reply, NULL));
+  body[0] = 0;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Missing, rpc(body, 1, reply, NULL));
+  body[0] = 2;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, rpc(body, 2, reply, NULL));
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testTableShape();
+  testMatch();
+  testExecute();
+  testScript();
+  testRPC();
+
+  vBSP430unittestFinalize();
+}
@@ -0,0 +1,137 @@
+/** This file is in the public domain.
+ *
+ * Exercise deferred console logging.  Drained records are captured
+ * from the simulated console UART and compared with the text the C
+ * library produces for the same format and arguments.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/platform/host/sim.h>
+#include <stdio.h>
+#include <string.h>
+
+static char out[256];
+static char expect[256];
+
+/* Drain the deferred records, capturing what the console transmits.
+ * Returns the drain result. */
+static int
+drain (void)
+{
+  long n;
+  int rv;
+
+  iBSP430consoleFlush();
+  (void)lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, out, sizeof(out) - 1);
+  rv = iBSP430consoleLogDrain();
+  iBSP430consoleFlush();
+  n = lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, NULL, 0);
+  out[(n < (long)sizeof(out)) ? n : (long)sizeof(out) - 1] = 0;
+  return rv;
+}
+
+#define CHECK_OUTPUT(expect_) do {                              \
+    BSP430_UNITTEST_ASSERT_TRUE(0 == strcmp((expect_), out));   \
+    if (0 != strcmp((expect_), out)) {                          \
+      cprintf("# expected '%s'\n# got      '%s'\n", (expect_), out);  \
+    }                                                           \
+  } while (0)
+
+/* Log a single record, drain it, and compare the result with what
+ * snprintf(3) produces from the same arguments. */
+#define CHECK_LOG(...) do {                                     \
+    BSP430_CORE_SAVED_INTERRUPT_STATE(istate);                  \
+    BSP430_CORE_DISABLE_INTERRUPT();                            \
+    vBSP430consoleLogDeferred_ni(__VA_ARGS__);                  \
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);                \
+    snprintf(expect, sizeof(expect), __VA_ARGS__);              \
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, drain());              \
+    CHECK_OUTPUT(expect);                                       \
+  } while (0)
+
+#define LOG(...) do {                                           \
+    BSP430_CORE_SAVED_INTERRUPT_STATE(istate);                  \
+    BSP430_CORE_DISABLE_INTERRUPT();                            \
+    vBSP430consoleLogDeferred_ni(__VA_ARGS__);                  \
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);                \
+  } while (0)
+
+void
+testEmpty (void)
+{
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, drain());
+  CHECK_OUTPUT("");
+}
+
+void
+testConversions (void)
+{
+  CHECK_LOG("plain text");
+  CHECK_LOG("w%*d|%%|%c", 6, 42, 'x');
+  CHECK_LOG("[%-*.*d]", 8, 3, 7);
+  CHECK_LOG("[%*.*s]", -6, 2, "abc");
+  CHECK_LOG("%ld %lx", -123456789L, 0xFEDCBA98UL);
+  CHECK_LOG("%lld", -1234567890123LL);
+  CHECK_LOG("%llu", 18446744073709551615ULL);
+  CHECK_LOG("%hhd %hd %zu", -3, -4, (size_t)5);
+  CHECK_LOG("%jd %td", (intmax_t)-6, (ptrdiff_t)7);
+  CHECK_LOG("%5.3x|%-4u|%+d", 0x1F, 9U, 5);
+  CHECK_LOG("% d|%#o", 6, 8);
+}
+
+void
+testOverflow (void)
+{
+  /* Arguments past the record capacity are shown as ?, as is
+   * everything after a floating point conversion. */
+  LOG("%ld %ld %d", 1L, 2L, 3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, drain());
+  CHECK_OUTPUT("1 2 ?");
+  LOG("%ld %d %ld %d", 1L, 2, 3L, 4);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, drain());
+  CHECK_OUTPUT("1 2 ? ?");
+  LOG("%d %f %d", 1, 2.5, 3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, drain());
+  CHECK_OUTPUT("1 ? ?");
+  LOG("%d %Lf", 1, (long double)2.5);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, drain());
+  CHECK_OUTPUT("1 ?");
+}
+
+void
+testDropped (void)
+{
+  int i;
+
+  /* The ring holds one record fewer than its size */
+  for (i = 0; i < BSP430_CONSOLE_LOG_DEFERRED_RECORDS + 1; ++i) {
+    LOG("r%d;", i);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(BSP430_CONSOLE_LOG_DEFERRED_RECORDS - 1, drain());
+  CHECK_OUTPUT("r0;r1;r2;[2 deferred log records dropped]\r\n");
+
+  /* The count is reported once */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, drain());
+  CHECK_OUTPUT("");
+  LOG("r%d;", i);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, drain());
+  CHECK_OUTPUT("r5;");
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testEmpty();
+  testConversions();
+  testOverflow();
+  testDropped();
+
+  vBSP430unittestFinalize();
+}
@@ -0,0 +1,23 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Interrupt-driven input and output through buffers larger than 255
+ * octets, which need 16-bit indexes.  The transmit buffer size may
+ * be overridden, e.g. with one that is not a power of two. */
+#ifndef BSP430_CONSOLE_TX_BUFFER_SIZE
+#define BSP430_CONSOLE_TX_BUFFER_SIZE 512
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+#define BSP430_CONSOLE_RX_BUFFER_SIZE 512
+
+/* Support the unit-test framework */
+#define configBSP430_UNITTEST 1
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
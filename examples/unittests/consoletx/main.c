@@ -0,0 +1,419 @@
+/** This file is in the public domain.
+ *
+ * Exercise the console transmit buffer.  Output is captured from the
+ * simulated console UART and compared octet for octet with what was
+ * written.
+ *
+ * Blocks are written in lengths that share no factor with the buffer
+ * size, so over as many blocks as the buffer holds octets every
+ * block starts at every buffer position, and those near the end are
+ * copied in two segments around the wrap.
+ *
+ * Build with TX_DMA=1 to check the DMA drain instead of the transmit
+ * interrupt, and with TX_BUFFER_SIZE=300 to check a buffer whose
+ * indexes wrap without a mask.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/platform/host/sim.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+#include <bsp430/periph/dma.h>
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
+/* Octets written per block.  This must share no factor with the
+ * buffer size. */
+#define BLOCK_LEN 37
+
+static char out[BLOCK_LEN * BSP430_CONSOLE_TX_BUFFER_SIZE + 1];
+static char expect[sizeof(out)];
+
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+static volatile sBSP430hplDMAchannel * const dma_ch = &BSP430_HPL_DMA->ch[BSP430_CONSOLE_TX_DMA_CHANNEL];
+static volatile unsigned int dma_completions;
+
+/* Count completions of the console transfers.  This is linked ahead
+ * of the console's own handler and does not break the chain. */
+static int
+dma_count_ni (const struct sBSP430halISRIndexedChainNode * cb,
+              void * context,
+              int idx)
+{
+  ++dma_completions;
+  return 0;
+}
+
+static sBSP430halISRIndexedChainNode dma_count_node = {
+  .callback_ni = dma_count_ni,
+};
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
+static void
+capture_begin (void)
+{
+  iBSP430consoleFlush();
+  (void)lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, out, sizeof(out));
+}
+
+/* Wait for the buffer to drain and return the number of octets
+ * transmitted since capture_begin(). */
+static long
+capture_end (void)
+{
+  iBSP430consoleFlush();
+  return lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, NULL, 0);
+}
+
+/* Assertions write to the console, so they are made only after the
+ * capture ends. */
+#define CHECK_CAPTURE(len_) do {                                        \
+    long n_ = capture_end();                                            \
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTld((long)(len_), n_);               \
+    BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(expect, out, (len_)));      \
+  } while (0)
+
+/* Store len printable characters at bp.  The character depends on
+ * its position in the output, so lost, repeated, or misplaced octets
+ * are detected. */
+static void
+fill (char * bp,
+      size_t len,
+      unsigned long pos)
+{
+  while (0 < len--) {
+    *bp++ = '!' + (((pos++ * 2654435761UL) >> 16) % 94);
+  }
+}
+
+/* Blocks written with cputchars() start at every buffer position. */
+void
+testWrapChars (void)
+{
+  size_t pos = 0;
+  size_t queued = 0;
+  unsigned int i;
+
+  capture_begin();
+  for (i = 0; i < BSP430_CONSOLE_TX_BUFFER_SIZE; ++i) {
+    fill(expect + pos, BLOCK_LEN, pos);
+    queued += cputchars(expect + pos, BLOCK_LEN);
+    pos += BLOCK_LEN;
+  }
+  CHECK_CAPTURE(pos);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(pos, queued);
+}
+
+/* Text with a newline is queued in pieces, the carriage return
+ * inserted before the newline being one of them; each piece may
+ * wrap. */
+void
+testWrapText (void)
+{
+  char text[BLOCK_LEN];
+  size_t pos = 0;
+  unsigned int i;
+
+  capture_begin();
+  for (i = 0; i < BSP430_CONSOLE_TX_BUFFER_SIZE; ++i) {
+    fill(text, BLOCK_LEN - 2, pos);
+    text[BLOCK_LEN - 2] = 0;
+    memcpy(expect + pos, text, BLOCK_LEN - 2);
+    pos += BLOCK_LEN - 2;
+    memcpy(expect + pos, "\r\n", 2);
+    pos += 2;
+    cputs(text);
+  }
+  CHECK_CAPTURE(pos);
+}
+
+/* A block larger than the buffer is queued in pieces as space is
+ * released. */
+void
+testLong (void)
+{
+  const size_t len = 3 * BSP430_CONSOLE_TX_BUFFER_SIZE + 5;
+  int rv;
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  unsigned int completions = dma_completions;
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
+  capture_begin();
+  fill(expect, len, 0);
+  rv = cputchars(expect, len);
+  CHECK_CAPTURE(len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(len, rv);
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  /* Each segment ends at the wrap or at the data queued when it
+   * started, and the next is started from the completion interrupt.
+   * There must be at least one for each wrap plus the last, and far
+   * fewer than one per octet. */
+  completions = dma_completions - completions;
+  BSP430_UNITTEST_ASSERT_TRUE(completions > (len / BSP430_CONSOLE_TX_BUFFER_SIZE));
+  BSP430_UNITTEST_ASSERT_TRUE(completions < (len / 4));
+#endif /* configBSP430_CONSOLE_TX_DMA */
+}
+
+/* More than 255 octets can be held in the transmit buffer.  While
+ * interrupts are disabled the transmit interrupt cannot remove any,
+ * so all are queued in a single pass. */
+void
+testLargeTransmit (void)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  const size_t len = BSP430_CONSOLE_TX_BUFFER_SIZE - 1;
+  int rv;
+
+  capture_begin();
+  fill(expect, len, 0);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rv = cputchars(expect, len);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  CHECK_CAPTURE(len);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(len, rv);
+}
+
+/* More than 255 octets can be held in the receive buffer. */
+void
+testLargeReceive (void)
+{
+  const size_t len = 400;
+  size_t n = 0;
+  int c;
+
+  fill(expect, len, 0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(len, iBSP430hostInjectRx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, expect, len));
+  /* Wait long enough for all of it to arrive at 9600 baud */
+  BSP430_CORE_DELAY_CYCLES(BSP430_CLOCK_NOMINAL_MCLK_HZ / 2);
+  while ((n < sizeof(out)) && (0 <= (c = cgetchar()))) {
+    out[n++] = c;
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(len, n);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(expect, out, len));
+}
+
+#define CHECK_TEXT(expect_) do {                                        \
+    long n_ = capture_end();                                            \
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTld((long)strlen(expect_), n_);      \
+    BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp((expect_), out, strlen(expect_))); \
+  } while (0)
+
+static const uint8_t dump_data[] = "0123456789ABCDEF!\x00\x7f\x80\xff~ "
+  "\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f"
+  "The quick brown fox";
+
+void
+testDisplayOctets (void)
+{
+  char * ep = expect;
+  size_t i;
+
+  capture_begin();
+  vBSP430consoleDisplayOctets(dump_data + 17, 4);
+  CHECK_TEXT("00 7f 80 ff");
+
+  capture_begin();
+  vBSP430consoleDisplayOctets(dump_data, 0);
+  CHECK_TEXT("");
+
+  /* Longer than the line built at once */
+  for (i = 0; i < sizeof(dump_data); ++i) {
+    ep += sprintf(ep, (0 == i) ? "%02x" : " %02x", dump_data[i]);
+  }
+  capture_begin();
+  vBSP430consoleDisplayOctets(dump_data, sizeof(dump_data));
+  CHECK_TEXT(expect);
+}
+
+/* Produce in expect what vBSP430consoleDisplayMemory() displays,
+ * with the console's carriage return before each newline. */
+static void
+format_memory (const uint8_t * dp,
+               size_t len,
+               unsigned long base)
+{
+  const uint8_t * const edp = dp + len;
+  const uint8_t * adp = dp;
+  char * ep = expect;
+
+  while (dp < edp) {
+    if (0 == (base & 0x0F)) {
+      if (adp < dp) {
+        ep += sprintf(ep, "  ");
+        while (adp < dp) {
+          *ep++ = isprint(*adp) ? *adp : '.';
+          ++adp;
+        }
+      }
+      adp = dp;
+      ep += sprintf(ep, "\r\n%08lx ", base);
+    } else if (0 == (base & 0x07)) {
+      *ep++ = ' ';
+    }
+    ep += sprintf(ep, " %02x", *dp++);
+    ++base;
+  }
+  if (adp < dp) {
+    while (base & 0x0F) {
+      if (0 == (base & 0x07)) {
+        *ep++ = ' ';
+      }
+      ep += sprintf(ep, "   ");
+      ++base;
+    }
+    ep += sprintf(ep, "  ");
+    while (adp < dp) {
+      *ep++ = isprint(*adp) ? *adp : '.';
+      ++adp;
+    }
+  }
+  strcpy(ep, "\r\n");
+}
+
+void
+testDisplayMemory (void)
+{
+  static const unsigned long bases[] = { 0, 0x1230, 0x13, 0x18, 0x1F, 0xFFFFFFF8UL };
+  unsigned int bi;
+  size_t len;
+  int failures = 0;
+
+  capture_begin();
+  vBSP430consoleDisplayMemory(dump_data, 17, 0x1230);
+  CHECK_TEXT("\r\n00001230  30 31 32 33 34 35 36 37  38 39 41 42 43 44 45 46  0123456789ABCDEF"
+             "\r\n00001240  21                                                !\r\n");
+
+  capture_begin();
+  vBSP430consoleDisplayMemory(dump_data + 15, 6, 0x2C);
+  CHECK_TEXT(" 46 21 00 7f  F!.."
+             "\r\n00000030  80 ff                                             ..\r\n");
+
+  capture_begin();
+  vBSP430consoleDisplayMemory(dump_data, 0, 0);
+  CHECK_TEXT("\r\n");
+
+  /* Every length from each starting column against the format
+   * produced an octet at a time */
+  for (bi = 0; bi < sizeof(bases) / sizeof(*bases); ++bi) {
+    for (len = 0; len <= sizeof(dump_data); ++len) {
+      long n;
+
+      format_memory(dump_data, len, bases[bi]);
+      capture_begin();
+      vBSP430consoleDisplayMemory(dump_data, len, bases[bi]);
+      n = capture_end();
+      if ((n != (long)strlen(expect)) || (0 != memcmp(expect, out, n))) {
+        ++failures;
+      }
+    }
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, failures);
+}
+
+/* Queued output is sent by the DMA channel or by the transmit
+ * interrupt, never both. */
+void
+testDrainMode (void)
+{
+  hBSP430halSERIAL uart = hBSP430serialLookup(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE);
+  const size_t len = BSP430_CONSOLE_TX_BUFFER_SIZE / 2;
+  unsigned char ie;
+  unsigned char idle_ie;
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  unsigned int ctl;
+  unsigned int idle_ctl;
+#endif /* configBSP430_CONSOLE_TX_DMA */
+  long n;
+
+  capture_begin();
+  fill(expect, len, 0);
+  (void)cputchars(expect, len);
+  ie = uart->hpl.usci5->ie;
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  ctl = dma_ch->ctl;
+#endif /* configBSP430_CONSOLE_TX_DMA */
+  n = capture_end();
+  idle_ie = uart->hpl.usci5->ie;
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  idle_ctl = dma_ch->ctl;
+#endif /* configBSP430_CONSOLE_TX_DMA */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld((long)len, n);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(expect, out, len));
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, ie & UCTXIE);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(DMAEN | DMAIE, ctl & (DMAEN | DMAIE));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, idle_ctl & DMAEN);
+#else /* configBSP430_CONSOLE_TX_DMA */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(UCTXIE, ie & UCTXIE);
+#endif /* configBSP430_CONSOLE_TX_DMA */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, idle_ie & UCTXIE);
+}
+
+/* Switching to polled output while a transfer is in progress keeps
+ * what has not been sent, and switching back sends it. */
+void
+testStopRestart (void)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  const size_t len = BSP430_CONSOLE_TX_BUFFER_SIZE - 1;
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  unsigned int ctl;
+  unsigned int sz;
+#endif /* configBSP430_CONSOLE_TX_DMA */
+  long n;
+
+  capture_begin();
+  fill(expect, len, 0);
+  (void)cputchars(expect, len);
+  /* Let about ten characters go at 9600 baud */
+  BSP430_CORE_DELAY_CYCLES(BSP430_CLOCK_NOMINAL_MCLK_HZ / 100);
+  BSP430_CORE_DISABLE_INTERRUPT();
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  ctl = dma_ch->ctl;
+  sz = dma_ch->sz;
+#endif /* configBSP430_CONSOLE_TX_DMA */
+  (void)iBSP430consoleTransmitUseInterrupts_ni(0);
+  n = lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, out, sizeof(out));
+  (void)iBSP430consoleTransmitUseInterrupts_ni(1);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  (void)lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, out + n, sizeof(out) - n);
+  n += capture_end();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld((long)len, n);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(expect, out, len));
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(DMAEN, ctl & DMAEN);
+  BSP430_UNITTEST_ASSERT_TRUE((0 < sz) && (sz < len));
+#endif /* configBSP430_CONSOLE_TX_DMA */
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[BSP430_CONSOLE_TX_DMA_CHANNEL], dma_count_node, next_ni);
+#endif /* configBSP430_CONSOLE_TX_DMA */
+  /* Received data is buffered by the receive interrupt */
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  testWrapChars();
+  testWrapText();
+  testLong();
+  testLargeTransmit();
+  testLargeReceive();
+  testDisplayOctets();
+  testDisplayMemory();
+  testDrainMode();
+  testStopRestart();
+
+  vBSP430unittestFinalize();
+}
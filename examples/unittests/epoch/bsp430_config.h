@@ -14,6 +14,7 @@
 /* We're testing the uptime epoch facility so we need it */
 #define configBSP430_UPTIME 1
 #define configBSP430_UPTIME_EPOCH 1
+#define configBSP430_UPTIME_EPOCH_DISCIPLINE 1
 
 /* Get platform defaults */
 #include <bsp430/platform/bsp430_config.h>
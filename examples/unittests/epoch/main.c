@@ -237,8 +237,8 @@ testNTPSequence (void)
   */
   const sBSP430uptimeNTPPacketHeader * ph;
   int64_t adjustment_ntp;
-  int32_t adjustment_ms;
-  uint32_t rtt_us;
+  long adjustment_ms;
+  unsigned long rtt_us;
 
   hBSP430uptimeTimer()->hpl->r = 0;
   hBSP430uptimeTimer()->overflow_count = 0;
@@ -261,6 +261,89 @@ testNTPSequence (void)
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(rtt1_us, rtt_us);
 }
 
+#define MS_TO_NTP(ms_) ((((int64_t)(ms_)) << 32) / 1000)
+#define S_TO_OVERFLOW(s_) ((s_) / 2) /* 32 kiHz, 2 s per overflow */
+
+void
+testDiscipline (void)
+{
+  sBSP430uptimeDiscipline disc;
+  struct timeval tv;
+  unsigned long utt;
+
+  hBSP430uptimeTimer()->hpl->r = 0;
+  hBSP430uptimeTimer()->overflow_count = 0;
+  BSP430_UNITTEST_ASSERT_TRUE(0 == iBSP430uptimeSetEpochFromTimeval(&basetv, 0UL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(0, disc.freq_ppb);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, disc.samples);
+
+  /* After 1000 s a clock running 50 ppm slow is 50 ms behind. */
+  hBSP430uptimeTimer()->overflow_count = S_TO_OVERFLOW(1000);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeDisciplineEpochFromNTP(MS_TO_NTP(50)));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(50000L - disc.freq_ppb));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, disc.samples);
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(50000L - disc.slew_us));
+  utt = ulBSP430uptime();
+  BSP430_UNITTEST_ASSERT_TRUE(0 == iBSP430uptimeAsTimeval(utt, &tv));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(basetv.tv_sec + 1000, tv.tv_sec);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(0, tv.tv_usec);
+
+  /* The offset is slewed in at 500 ppm, taking 100 s, while the
+   * frequency correction applies 50 ppm. */
+  hBSP430uptimeTimer()->overflow_count += S_TO_OVERFLOW(50);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(25000L - disc.slew_us));
+  BSP430_UNITTEST_ASSERT_TRUE(0 == iBSP430uptimeAsTimeval(ulBSP430uptime(), &tv));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(basetv.tv_sec + 1050, tv.tv_sec);
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(27500L - tv.tv_usec));
+
+  /* Times before the adjustment are not affected by the slew */
+  BSP430_UNITTEST_ASSERT_TRUE(0 == iBSP430uptimeAsTimeval(utt - 32768UL, &tv));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(basetv.tv_sec + 998, tv.tv_sec);
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(999950L - tv.tv_usec));
+
+  /* With the frequency corrected the clock remains in sync */
+  hBSP430uptimeTimer()->overflow_count = S_TO_OVERFLOW(2000);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == iBSP430uptimeAsTimeval(ulBSP430uptime(), &tv));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(basetv.tv_sec + 2000, tv.tv_sec);
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(100000L - tv.tv_usec));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeDisciplineEpochFromNTP(0));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(50000L - disc.freq_ppb));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(2, disc.samples);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(0, disc.slew_us);
+
+  /* A residual error is filtered */
+  hBSP430uptimeTimer()->overflow_count = S_TO_OVERFLOW(3000);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeDisciplineEpochFromNTP(MS_TO_NTP(4)));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(51000L - disc.freq_ppb));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, disc.samples);
+  BSP430_UNITTEST_ASSERT_TRUE(0 < disc.jitter_us);
+
+  /* Large offsets step the epoch but keep the frequency */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, iBSP430uptimeDisciplineEpochFromNTP(MS_TO_NTP(-2000)));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(51000L - disc.freq_ppb));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(0, disc.slew_us);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == iBSP430uptimeAsTimeval(ulBSP430uptime(), &tv));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(basetv.tv_sec + 2998, tv.tv_sec);
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(150000L - tv.tv_usec));
+
+  /* An interval of 2^31 ticks or more gives no frequency estimate,
+   * but the offset is still slewed in. */
+  hBSP430uptimeTimer()->overflow_count += S_TO_OVERFLOW(20UL * 3600);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeDisciplineEpochFromNTP(MS_TO_NTP(4)));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(51000L - disc.freq_ppb));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, disc.samples);
+  BSP430_UNITTEST_ASSERT_TRUE(1 >= (unsigned long)(4000L - disc.slew_us));
+
+  hBSP430uptimeTimer()->overflow_count = 0;
+}
+
 void main ()
 {
   vBSP430platformInitialize_ni();
@@ -283,6 +366,7 @@ void main ()
   testEpochValidate();
   testEpochAge();
   testNTPSequence();
+  testDiscipline();
 
   vBSP430unittestFinalize();
 }
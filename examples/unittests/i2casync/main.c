@@ -0,0 +1,336 @@
+/** This file is in the public domain.
+ *
+ * Exercise the queued I2C transaction engine and the synchronous
+ * write-then-read.  On hardware only the handling of an
+ * unacknowledged address is checked; on the host platform a simulated
+ * slave also answers reads and writes.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <string.h>
+#include <bsp430/serial.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+#if (BSP430_PLATFORM_HOST - 0)
+#include <bsp430/platform/host/sim.h>
+#endif /* BSP430_PLATFORM_HOST */
+
+/* Reserved for future use by the I2C specification, so nothing on
+ * the bus should acknowledge it. */
+#define ABSENT_ADDRESS 0x7C
+
+/* Address of the simulated slave */
+#define SLAVE_ADDRESS 0x48
+
+hBSP430halSERIAL i2c;
+
+static sBSP430i2cTransaction * completed[4];
+static unsigned int ncompleted;
+
+static int
+record_cb_ni (sBSP430i2cTransaction * tp)
+{
+  if (ncompleted < (sizeof(completed) / sizeof(*completed))) {
+    completed[ncompleted] = tp;
+  }
+  ++ncompleted;
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+/* Submit a transaction and sleep until it completes.  Returns the
+ * transaction result. */
+static int
+run_transaction (sBSP430i2cTransaction * tp)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  int rc;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430i2cSubmit_ni(i2c, tp);
+  if (0 == rc) {
+    while (0 == tp->result) {
+      BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
+      BSP430_CORE_DISABLE_INTERRUPT();
+    }
+    rc = tp->result;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rc;
+}
+
+void
+testRejectEmpty (void)
+{
+  sBSP430i2cTransaction txn = { .address = ABSENT_ADDRESS };
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  int rc;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430i2cSubmit_ni(i2c, &txn);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-1, rc);
+}
+
+void
+testNack (void)
+{
+  static const uint8_t cmd[] = { 0x01 };
+  uint8_t rx[2];
+  sBSP430i2cTransaction txn = { .address = ABSENT_ADDRESS };
+
+  txn.tx_data = cmd;
+  txn.tx_len = sizeof(cmd);
+  BSP430_UNITTEST_ASSERT_TRUE(0 > run_transaction(&txn));
+
+  txn.tx_len = 0;
+  txn.rx_data = rx;
+  txn.rx_len = sizeof(rx);
+  BSP430_UNITTEST_ASSERT_TRUE(0 > run_transaction(&txn));
+
+  /* The engine recovers for the next transaction */
+  txn.tx_len = sizeof(cmd);
+  txn.flags = BSP430_I2C_TXN_FLAG_REPEATED_START;
+  BSP430_UNITTEST_ASSERT_TRUE(0 > run_transaction(&txn));
+}
+
+#if (BSP430_PLATFORM_HOST - 0)
+
+void
+testWrite (void)
+{
+  static const uint8_t cmd[] = { 0x10, 0x20, 0x30 };
+  sBSP430i2cTransaction txn = { .address = SLAVE_ADDRESS };
+
+  txn.tx_data = cmd;
+  txn.tx_len = sizeof(cmd);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(cmd), run_transaction(&txn));
+}
+
+void
+testRead (void)
+{
+  static const uint8_t resp[] = { 0xA1, 0xB2, 0xC3 };
+  uint8_t rx[sizeof(resp)];
+  sBSP430i2cTransaction txn = { .address = SLAVE_ADDRESS };
+
+  /* Single-octet reads request the STOP along with the address */
+  memset(rx, 0, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, iBSP430hostInjectRx(APP_I2C_PERIPH_HANDLE, resp, 1));
+  txn.rx_data = rx;
+  txn.rx_len = 1;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, run_transaction(&txn));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(resp[0], rx[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, rx[1]);
+
+  memset(rx, 0, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(resp), iBSP430hostInjectRx(APP_I2C_PERIPH_HANDLE, resp, sizeof(resp)));
+  txn.rx_len = sizeof(rx);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(resp), run_transaction(&txn));
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(resp, rx, sizeof(rx)));
+}
+
+static void
+checkWriteRead (unsigned int flags)
+{
+  static const uint8_t reg[] = { 0x0E };
+  static const uint8_t resp[] = { 0x5A, 0xA5 };
+  uint8_t rx[sizeof(resp)];
+  sBSP430i2cTransaction txn = { .address = SLAVE_ADDRESS };
+
+  memset(rx, 0, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(resp), iBSP430hostInjectRx(APP_I2C_PERIPH_HANDLE, resp, sizeof(resp)));
+  txn.tx_data = reg;
+  txn.tx_len = sizeof(reg);
+  txn.rx_data = rx;
+  txn.rx_len = sizeof(rx);
+  txn.flags = flags;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(reg) + sizeof(resp), run_transaction(&txn));
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(resp, rx, sizeof(rx)));
+}
+
+void
+testWriteRead (void)
+{
+  checkWriteRead(0);
+  checkWriteRead(BSP430_I2C_TXN_FLAG_REPEATED_START);
+}
+
+void
+testQueue (void)
+{
+  static const uint8_t cmd[] = { 0x42 };
+  static const uint8_t resp[] = { 0x99 };
+  uint8_t rx[sizeof(resp)];
+  sBSP430i2cTransaction t1 = { .address = SLAVE_ADDRESS };
+  sBSP430i2cTransaction t2 = { .address = ABSENT_ADDRESS };
+  sBSP430i2cTransaction t3 = { .address = SLAVE_ADDRESS };
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  /* Three transactions submitted together complete in order; the
+   * failure of the middle one does not affect the others. */
+  ncompleted = 0;
+  t1.tx_data = cmd;
+  t1.tx_len = sizeof(cmd);
+  t1.callback_ni = record_cb_ni;
+  t2.tx_data = cmd;
+  t2.tx_len = sizeof(cmd);
+  t2.callback_ni = record_cb_ni;
+  t3.tx_data = cmd;
+  t3.tx_len = sizeof(cmd);
+  t3.rx_data = rx;
+  t3.rx_len = sizeof(rx);
+  t3.flags = BSP430_I2C_TXN_FLAG_REPEATED_START;
+  t3.callback_ni = record_cb_ni;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(resp), iBSP430hostInjectRx(APP_I2C_PERIPH_HANDLE, resp, sizeof(resp)));
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430i2cSubmit_ni(i2c, &t1));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430i2cSubmit_ni(i2c, &t2));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430i2cSubmit_ni(i2c, &t3));
+  while (0 == t3.result) {
+    BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
+    BSP430_CORE_DISABLE_INTERRUPT();
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, ncompleted);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&t1, completed[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&t2, completed[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&t3, completed[2]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(cmd), t1.result);
+  BSP430_UNITTEST_ASSERT_TRUE(0 > t2.result);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(cmd) + sizeof(resp), t3.result);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(resp[0], rx[0]);
+}
+
+/* Run the synchronous write-then-read, collecting the octets
+ * written to the slave in written[].  Returns the result of
+ * iBSP430i2cTxRxData_rh(), and stores the number of octets written
+ * in *nwrittenp. */
+static int
+txrx (const uint8_t * tx_data,
+      size_t tx_len,
+      uint8_t * rx_data,
+      size_t rx_len,
+      uint8_t * written,
+      size_t written_size,
+      long * nwrittenp)
+{
+  int rc;
+
+  (void)lBSP430hostCaptureTx(APP_I2C_PERIPH_HANDLE, written, written_size);
+  rc = iBSP430i2cTxRxData_rh(i2c, tx_data, tx_len, rx_data, rx_len);
+  *nwrittenp = lBSP430hostCaptureTx(APP_I2C_PERIPH_HANDLE, NULL, 0);
+  return rc;
+}
+
+void
+testTxRxData (void)
+{
+  static const uint8_t reg[] = { 0x0E, 0x0F };
+  static const uint8_t resp[] = { 0x5A, 0xA5, 0x3C };
+  uint8_t rx[sizeof(resp) + 1];
+  uint8_t written[4];
+  long nwritten;
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430i2cSetAddresses_rh(i2c, -1, SLAVE_ADDRESS));
+
+  /* Write then read a single octet */
+  memset(rx, 0, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, iBSP430hostInjectRx(APP_I2C_PERIPH_HANDLE, resp, 1));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, txrx(reg, 1, rx, 1, written, sizeof(written), &nwritten));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(1, nwritten);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(reg[0], written[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(resp[0], rx[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, rx[1]);
+
+  /* Write then read several octets */
+  memset(rx, 0, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(resp), iBSP430hostInjectRx(APP_I2C_PERIPH_HANDLE, resp, sizeof(resp)));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(resp), txrx(reg, sizeof(reg), rx, sizeof(resp), written, sizeof(written), &nwritten));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(sizeof(reg), nwritten);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(reg, written, sizeof(reg)));
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(resp, rx, sizeof(resp)));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, rx[sizeof(resp)]);
+
+  /* With nothing to write only the read is done */
+  memset(rx, 0, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(2, iBSP430hostInjectRx(APP_I2C_PERIPH_HANDLE, resp, 2));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(2, txrx(reg, 0, rx, 2, written, sizeof(written), &nwritten));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(0, nwritten);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(resp, rx, 2));
+
+  /* With nothing to read the write ends with a STOP and the result
+   * is the number of octets written */
+  memset(rx, 0, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(reg), txrx(reg, sizeof(reg), rx, 0, written, sizeof(written), &nwritten));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(sizeof(reg), nwritten);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(reg, written, sizeof(reg)));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, rx[0]);
+
+  /* The command buffer may receive the response, as the SHT21
+   * driver does */
+  {
+    uint8_t data[sizeof(resp)];
+
+    data[0] = reg[1];
+    data[1] = data[2] = 0;
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(resp), iBSP430hostInjectRx(APP_I2C_PERIPH_HANDLE, resp, sizeof(resp)));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(data), txrx(data, 1, data, sizeof(data), written, sizeof(written), &nwritten));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTld(1, nwritten);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTx(reg[1], written[0]);
+    BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(resp, data, sizeof(data)));
+  }
+}
+
+#endif /* BSP430_PLATFORM_HOST */
+
+void
+testTxRxDataNack (void)
+{
+  static const uint8_t reg[] = { 0x01 };
+  uint8_t rx[2];
+  int rc;
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430i2cSetAddresses_rh(i2c, -1, ABSENT_ADDRESS));
+  rc = iBSP430i2cTxRxData_rh(i2c, reg, sizeof(reg), rx, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_TRUE(0 > rc);
+  BSP430_UNITTEST_ASSERT_TRUE(-1 != rc);
+  BSP430_UNITTEST_ASSERT_TRUE(0 != (BSP430_I2C_ERRFLAG_PROTOCOL & -rc));
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  i2c = hBSP430serialOpenI2C(hBSP430serialLookup(APP_I2C_PERIPH_HANDLE),
+                             BSP430_SERIAL_ADJUST_CTL0_INITIALIZER(UCMST),
+                             0, 0);
+  BSP430_UNITTEST_ASSERT_TRUE(NULL != i2c);
+  if (NULL != i2c) {
+#if (BSP430_PLATFORM_HOST - 0)
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430hostSetI2CSlave(APP_I2C_PERIPH_HANDLE, SLAVE_ADDRESS));
+#endif /* BSP430_PLATFORM_HOST */
+    testRejectEmpty();
+    testNack();
+#if (BSP430_PLATFORM_HOST - 0)
+    testWrite();
+    testRead();
+    testWriteRead();
+    testQueue();
+    testTxRxData();
+#endif /* BSP430_PLATFORM_HOST */
+    testTxRxDataNack();
+#if (BSP430_PLATFORM_HOST - 0)
+    /* Transactions still work after the failure */
+    testTxRxData();
+    testWrite();
+#endif /* BSP430_PLATFORM_HOST */
+  }
+
+  vBSP430unittestFinalize();
+}
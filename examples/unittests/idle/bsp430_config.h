@@ -0,0 +1,23 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Support the unit-test framework */
+#define configBSP430_UNITTEST 1
+
+/* Sleep on the uptime timer */
+#define configBSP430_UPTIME 1
+#define configBSP430_UPTIME_DELAY 1
+
+/* A second timer whose clock source the test changes */
+#define configBSP430_TIMER_CCACLK 1
+#define configBSP430_TIMER_CCACLK_HAL 1
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,256 @@
+/** This file is in the public domain.
+ *
+ * Exercise the selection of the low power mode used when idle, and
+ * the sleeps that use it.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/event.h>
+#include <bsp430/utility/idle.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/periph/timer.h>
+#include <string.h>
+
+/* Capture/compare register of the uptime timer used for the
+ * multiplexed alarm.  The uptime delay uses
+ * BSP430_UPTIME_DELAY_CCIDX and valid counter reads use
+ * BSP430_TIMER_VALID_COUNTER_READ_CCIDX. */
+#define MUX_CCIDX 3
+
+static volatile unsigned int nfired_v;
+
+static int
+mux_cb_ni (hBSP430timerMuxSharedAlarm shared,
+           hBSP430timerMuxAlarm alarm)
+{
+  ++nfired_v;
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+/* xBSP430idleDeepestMode_ni() with interrupts disabled */
+static eBSP430idleMode
+deepest (hBSP430halTIMER timer)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  eBSP430idleMode rv;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rv = xBSP430idleDeepestMode_ni(timer);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+void
+testModeBits (void)
+{
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, uiBSP430idleModeLPMBits(eBSP430idleMode_ACTIVE));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(LPM0_bits, uiBSP430idleModeLPMBits(eBSP430idleMode_LPM0));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(LPM1_bits, uiBSP430idleModeLPMBits(eBSP430idleMode_LPM1));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(LPM2_bits, uiBSP430idleModeLPMBits(eBSP430idleMode_LPM2));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(LPM3_bits, uiBSP430idleModeLPMBits(eBSP430idleMode_LPM3));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(LPM4_bits, uiBSP430idleModeLPMBits(eBSP430idleMode_LPM4));
+}
+
+void
+testConstraints (void)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, xBSP430idleDeepestMode_ni(NULL));
+
+  /* Constraints nest, and the shallowest one applies */
+  vBSP430idleConstraintAdd_ni(eBSP430idleMode_LPM3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM3, xBSP430idleDeepestMode_ni(NULL));
+  vBSP430idleConstraintAdd_ni(eBSP430idleMode_LPM3);
+  vBSP430idleConstraintAdd_ni(eBSP430idleMode_LPM0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM0, xBSP430idleDeepestMode_ni(NULL));
+  vBSP430idleConstraintRemove_ni(eBSP430idleMode_LPM0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM3, xBSP430idleDeepestMode_ni(NULL));
+  vBSP430idleConstraintRemove_ni(eBSP430idleMode_LPM3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM3, xBSP430idleDeepestMode_ni(NULL));
+  vBSP430idleConstraintRemove_ni(eBSP430idleMode_LPM3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, xBSP430idleDeepestMode_ni(NULL));
+
+  /* An unbalanced removal does not underflow the count */
+  vBSP430idleConstraintRemove_ni(eBSP430idleMode_LPM2);
+  vBSP430idleConstraintAdd_ni(eBSP430idleMode_LPM2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM2, xBSP430idleDeepestMode_ni(NULL));
+  vBSP430idleConstraintRemove_ni(eBSP430idleMode_LPM2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, xBSP430idleDeepestMode_ni(NULL));
+
+  /* An LPM4 constraint imposes nothing */
+  vBSP430idleConstraintAdd_ni(eBSP430idleMode_LPM4);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, xBSP430idleDeepestMode_ni(NULL));
+  vBSP430idleConstraintRemove_ni(eBSP430idleMode_LPM4);
+
+  /* An ACTIVE constraint prevents sleep */
+  vBSP430idleConstraintAdd_ni(eBSP430idleMode_ACTIVE);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_ACTIVE, xBSP430idleDeepestMode_ni(NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, uiBSP430idleSleep_ni());
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, uiBSP430idleSleepUntil_ni(ulBSP430uptime_ni() + 1000));
+  vBSP430idleConstraintRemove_ni(eBSP430idleMode_ACTIVE);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, xBSP430idleDeepestMode_ni(NULL));
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
+void
+testTimerSource (void)
+{
+  hBSP430halTIMER timer = hBSP430timerLookup(BSP430_TIMER_CCACLK_PERIPH_HANDLE);
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  unsigned int ctl = timer->hpl->ctl;
+
+  /* The mode must keep the clock the timer counts */
+  timer->hpl->ctl = TASSEL_0;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, deepest(timer));
+  timer->hpl->ctl = TASSEL_1;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM3, deepest(timer));
+  timer->hpl->ctl = TASSEL_2;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM0, deepest(timer));
+  timer->hpl->ctl = TASSEL_3;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM3, deepest(timer));
+
+  /* The shallower of the timer limit and any constraint applies */
+  timer->hpl->ctl = TASSEL_1;
+  BSP430_CORE_DISABLE_INTERRUPT();
+  vBSP430idleConstraintAdd_ni(eBSP430idleMode_LPM0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM0, xBSP430idleDeepestMode_ni(timer));
+  vBSP430idleConstraintRemove_ni(eBSP430idleMode_LPM0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  timer->hpl->ctl = ctl;
+}
+
+void
+testMuxAlarm (void)
+{
+  sBSP430timerMuxSharedAlarm shared_data;
+  hBSP430timerMuxSharedAlarm shared;
+  sBSP430timerMuxAlarm alarm;
+  hBSP430halTIMER timer = hBSP430uptimeTimer();
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  unsigned int lpm_bits;
+  unsigned int ctl;
+
+  shared = hBSP430timerMuxAlarmStartup(&shared_data, BSP430_UPTIME_TIMER_PERIPH_HANDLE, MUX_CCIDX);
+  BSP430_UNITTEST_ASSERT_TRUE(NULL != shared);
+  if (NULL == shared) {
+    return;
+  }
+  memset(&alarm, 0, sizeof(alarm));
+  alarm.callback_ni = mux_cb_ni;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  vBSP430idleSetMuxAlarm_ni(shared);
+
+  /* Without an active alarm the timer does not matter */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, xBSP430idleDeepestMode_ni(NULL));
+
+  /* An active alarm limits the mode by its timer's clock */
+  alarm.setting_tck = ulBSP430uptime_ni() + BSP430_UPTIME_MS_TO_UTT(20);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmAdd_ni(shared, &alarm));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM3, xBSP430idleDeepestMode_ni(NULL));
+  ctl = timer->hpl->ctl;
+  timer->hpl->ctl = (ctl & ~TASSEL_3) | TASSEL_2;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM0, xBSP430idleDeepestMode_ni(NULL));
+  timer->hpl->ctl = ctl;
+
+  /* The sleep ends when the alarm fires */
+  nfired_v = 0;
+  lpm_bits = uiBSP430idleSleep_ni();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(LPM3_bits, lpm_bits);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, nfired_v);
+  BSP430_UNITTEST_ASSERT_TRUE(0 <= (long)(ulBSP430uptime_ni() - alarm.setting_tck));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, xBSP430idleDeepestMode_ni(NULL));
+
+  /* A removed alarm no longer limits the mode */
+  alarm.setting_tck = ulBSP430uptime_ni() + BSP430_UPTIME_MS_TO_UTT(20);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmAdd_ni(shared, &alarm));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM3, xBSP430idleDeepestMode_ni(NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmRemove_ni(shared, &alarm));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, xBSP430idleDeepestMode_ni(NULL));
+
+  vBSP430idleSetMuxAlarm_ni(NULL);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmShutdown(shared));
+}
+
+void
+testEventFlags (void)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  unsigned int lpm_bits;
+  unsigned long t0;
+  unsigned long t1;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  vBSP430eventFlagsSet_ni(uiBSP430eventFlagAllocate());
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_ACTIVE, xBSP430idleDeepestMode_ni(NULL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, uiBSP430idleSleep_ni());
+  t0 = ulBSP430uptime_ni();
+  lpm_bits = uiBSP430idleSleepUntil_ni(t0 + BSP430_UPTIME_MS_TO_UTT(100));
+  t1 = ulBSP430uptime_ni();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, lpm_bits);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FUTURE_LIMIT > (t1 - t0));
+  BSP430_UNITTEST_ASSERT_TRUE(0 != uiBSP430eventFlagsGet_ni());
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(eBSP430idleMode_LPM4, xBSP430idleDeepestMode_ni(NULL));
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
+void
+testSleepUntil (void)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  unsigned int lpm_bits;
+  unsigned long t0;
+  unsigned long t1;
+  unsigned long wake_utt;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+
+  /* The uptime timer runs from ACLK */
+  wake_utt = ulBSP430uptime_ni() + BSP430_UPTIME_MS_TO_UTT(10);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(LPM3_bits, uiBSP430idleSleepUntil_ni(wake_utt));
+  BSP430_UNITTEST_ASSERT_TRUE(0 <= (long)(ulBSP430uptime_ni() - wake_utt));
+
+  /* A constraint makes the sleep shallower */
+  vBSP430idleConstraintAdd_ni(eBSP430idleMode_LPM0);
+  wake_utt = ulBSP430uptime_ni() + BSP430_UPTIME_MS_TO_UTT(10);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(LPM0_bits, uiBSP430idleSleepUntil_ni(wake_utt));
+  BSP430_UNITTEST_ASSERT_TRUE(0 <= (long)(ulBSP430uptime_ni() - wake_utt));
+  vBSP430idleConstraintRemove_ni(eBSP430idleMode_LPM0);
+
+  /* Wakeup times within BSP430_TIMER_ALARM_FUTURE_LIMIT of now, or
+   * in the past, do not sleep */
+  t0 = ulBSP430uptime_ni();
+  lpm_bits = uiBSP430idleSleepUntil_ni(t0 + BSP430_TIMER_ALARM_FUTURE_LIMIT - 1);
+  t1 = ulBSP430uptime_ni();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, lpm_bits);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FUTURE_LIMIT > (t1 - t0));
+  t0 = ulBSP430uptime_ni();
+  lpm_bits = uiBSP430idleSleepUntil_ni(t0 - 10);
+  t1 = ulBSP430uptime_ni();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, lpm_bits);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FUTURE_LIMIT > (t1 - t0));
+
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testModeBits();
+  testConstraints();
+  testTimerSource();
+  testMuxAlarm();
+  testEventFlags();
+  testSleepUntil();
+
+  vBSP430unittestFinalize();
+}
@@ -11,6 +11,13 @@
 #include <bsp430/utility/unittest.h>
 #include <bsp430/periph/timer.h>
 
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0)
+/* Active alarms are not linked when held in a heap */
+#define ASSERT_NEXT(_a, _b) do { } while (0)
+#else /* configBSP430_TIMER_MUXALARM_HEAP */
+#define ASSERT_NEXT(_a, _b) BSP430_UNITTEST_ASSERT_EQUAL_FMTp(_a, _b)
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
+
 void
 testOnOff (void)
 {
@@ -45,6 +52,7 @@ testAddRemove (void)
   hs->dedicated.timer->hpl->ctl &= ~(MC0 | MC1);
   vBSP430timerResetCounter_ni(hs->dedicated.timer);
 
+  memset(alarms, 0, sizeof(alarms));
   for (i = 0; i < sizeof(alarms)/sizeof(*alarms); ++i) {
     hBSP430timerMuxAlarm mp = alarms + i;
     mp->setting_tck = 100 * (i+1);
@@ -55,79 +63,79 @@ testAddRemove (void)
   i = iBSP430timerMuxAlarmAdd_ni(hs, alarms+1);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, i);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+1, hs->alarms);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, alarms[1].next);
+  ASSERT_NEXT(NULL, alarms[1].next);
   BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(hs->alarms->setting_tck, hs->dedicated.setting_tck);
 
   i = iBSP430timerMuxAlarmAdd_ni(hs, alarms+3);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, i);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+1, hs->alarms);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+3, alarms[1].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, alarms[3].next);
+  ASSERT_NEXT(alarms+3, alarms[1].next);
+  ASSERT_NEXT(NULL, alarms[3].next);
   BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(hs->alarms->setting_tck, hs->dedicated.setting_tck);
 
   i = iBSP430timerMuxAlarmAdd_ni(hs, alarms+2);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, i);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+1, hs->alarms);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+2, alarms[1].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+3, alarms[2].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, alarms[3].next);
+  ASSERT_NEXT(alarms+2, alarms[1].next);
+  ASSERT_NEXT(alarms+3, alarms[2].next);
+  ASSERT_NEXT(NULL, alarms[3].next);
   BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(hs->alarms->setting_tck, hs->dedicated.setting_tck);
 
   i = iBSP430timerMuxAlarmAdd_ni(hs, alarms+0);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, i);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+0, hs->alarms);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+1, alarms[0].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+2, alarms[1].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+3, alarms[2].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, alarms[3].next);
+  ASSERT_NEXT(alarms+1, alarms[0].next);
+  ASSERT_NEXT(alarms+2, alarms[1].next);
+  ASSERT_NEXT(alarms+3, alarms[2].next);
+  ASSERT_NEXT(NULL, alarms[3].next);
   BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(hs->alarms->setting_tck, hs->dedicated.setting_tck);
 
   i = iBSP430timerMuxAlarmAdd_ni(hs, alarms+4);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, i);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+0, hs->alarms);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+1, alarms[0].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+2, alarms[1].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+3, alarms[2].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+4, alarms[3].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, alarms[4].next);
+  ASSERT_NEXT(alarms+1, alarms[0].next);
+  ASSERT_NEXT(alarms+2, alarms[1].next);
+  ASSERT_NEXT(alarms+3, alarms[2].next);
+  ASSERT_NEXT(alarms+4, alarms[3].next);
+  ASSERT_NEXT(NULL, alarms[4].next);
   BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(hs->alarms->setting_tck, hs->dedicated.setting_tck);
 
   i = iBSP430timerMuxAlarmRemove_ni(hs, alarms+0);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, i);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+1, hs->alarms);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+2, alarms[1].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+3, alarms[2].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+4, alarms[3].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, alarms[4].next);
+  ASSERT_NEXT(alarms+2, alarms[1].next);
+  ASSERT_NEXT(alarms+3, alarms[2].next);
+  ASSERT_NEXT(alarms+4, alarms[3].next);
+  ASSERT_NEXT(NULL, alarms[4].next);
   BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(hs->alarms->setting_tck, hs->dedicated.setting_tck);
 
   i = iBSP430timerMuxAlarmRemove_ni(hs, alarms+2);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, i);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+1, hs->alarms);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+3, alarms[1].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+4, alarms[3].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, alarms[4].next);
+  ASSERT_NEXT(alarms+3, alarms[1].next);
+  ASSERT_NEXT(alarms+4, alarms[3].next);
+  ASSERT_NEXT(NULL, alarms[4].next);
   BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(hs->alarms->setting_tck, hs->dedicated.setting_tck);
 
   i = iBSP430timerMuxAlarmRemove_ni(hs, alarms+4);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, i);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+1, hs->alarms);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+3, alarms[1].next);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, alarms[3].next);
+  ASSERT_NEXT(alarms+3, alarms[1].next);
+  ASSERT_NEXT(NULL, alarms[3].next);
   BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(hs->alarms->setting_tck, hs->dedicated.setting_tck);
 
   i = iBSP430timerMuxAlarmRemove_ni(hs, alarms+3);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, i);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms+1, hs->alarms);
-  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, alarms[1].next);
+  ASSERT_NEXT(NULL, alarms[1].next);
   BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTld(hs->alarms->setting_tck, hs->dedicated.setting_tck);
 
@@ -137,6 +145,168 @@ testAddRemove (void)
   BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
 }
 
+static hBSP430timerMuxAlarm fired[16];
+static int nfired;
+
+static int
+record_cb_ni (hBSP430timerMuxSharedAlarm shared,
+              hBSP430timerMuxAlarm alarm)
+{
+  fired[nfired++] = alarm;
+  return 0;
+}
+
+void
+testFireOrder (void)
+{
+  /* Settings are a permutation of -1 to -16, so with the counter at
+   * zero every alarm is due. */
+  static const unsigned char order[16] = { 7, 12, 3, 15, 0, 9, 14, 5, 10, 1, 13, 6, 2, 11, 8, 4 };
+  sBSP430timerMuxSharedAlarm sd;
+  hBSP430timerMuxSharedAlarm hs;
+  sBSP430timerMuxAlarm alarms[16];
+  int i;
+
+  memset(&sd, 0x96, sizeof(sd));
+  hs = hBSP430timerMuxAlarmStartup(&sd, BSP430_TIMER_CCACLK_PERIPH_HANDLE, 1);
+  hs->dedicated.timer->hpl->ctl &= ~(MC0 | MC1);
+  vBSP430timerResetCounter_ni(hs->dedicated.timer);
+
+  memset(alarms, 0, sizeof(alarms));
+  for (i = 0; i < sizeof(alarms)/sizeof(*alarms); ++i) {
+    alarms[i].setting_tck = -(1 + (long)order[i]);
+    alarms[i].callback_ni = record_cb_ni;
+    BSP430_UNITTEST_ASSERT_TRUE(0 <= iBSP430timerMuxAlarmAdd_ni(hs, alarms + i));
+  }
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0) && (16 == BSP430_TIMER_MUXALARM_HEAP_SIZE)
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-1, iBSP430timerMuxAlarmAdd_ni(hs, alarms + 0));
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms + 3, hs->alarms);
+  BSP430_UNITTEST_ASSERT_TRUE(0 <= iBSP430timerMuxAlarmRemove_ni(hs, alarms + 3));
+  BSP430_UNITTEST_ASSERT_TRUE(0 <= iBSP430timerMuxAlarmRemove_ni(hs, alarms + 5));
+  BSP430_UNITTEST_ASSERT_TRUE(0 <= iBSP430timerMuxAlarmRemove_ni(hs, alarms + 4));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms + 6, hs->alarms);
+
+  nfired = 0;
+  (void)hs->dedicated.callback_ni(&hs->dedicated);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(13, nfired);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, hs->alarms);
+  for (i = 1; i < nfired; ++i) {
+    BSP430_UNITTEST_ASSERT_TRUE(0 > (long)(fired[i-1]->setting_tck - fired[i]->setting_tck));
+  }
+  (void)iBSP430timerMuxAlarmShutdown(hs);
+}
+
+#if (configBSP430_TIMER_MUXALARM_SLACK - 0)
+void
+testSlack (void)
+{
+  /* Notification windows [1000,6000], [3000,3000], [4000,4500], and
+   * [8000,18000] */
+  static const unsigned int settings[] = { 1000, 3000, 4000, 8000 };
+  static const unsigned int slacks[] = { 5000, 0, 500, 10000 };
+  sBSP430timerMuxSharedAlarm sd;
+  hBSP430timerMuxSharedAlarm hs;
+  sBSP430timerMuxAlarm alarms[4];
+  int i;
+
+  memset(&sd, 0x96, sizeof(sd));
+  hs = hBSP430timerMuxAlarmStartup(&sd, BSP430_TIMER_CCACLK_PERIPH_HANDLE, 1);
+  hs->dedicated.timer->hpl->ctl &= ~(MC0 | MC1);
+  vBSP430timerResetCounter_ni(hs->dedicated.timer);
+
+  memset(alarms, 0, sizeof(alarms));
+  for (i = 0; i < sizeof(alarms)/sizeof(*alarms); ++i) {
+    alarms[i].setting_tck = settings[i];
+    alarms[i].slack_tck = slacks[i];
+    alarms[i].callback_ni = record_cb_ni;
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmAdd_ni(hs, alarms + i));
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms + 0, hs->alarms);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(3000L, hs->dedicated.setting_tck);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmRemove_ni(hs, alarms + 1));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(4500L, hs->dedicated.setting_tck);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmRemove_ni(hs, alarms + 2));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(6000L, hs->dedicated.setting_tck);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmAdd_ni(hs, alarms + 2));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmAdd_ni(hs, alarms + 1));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(3000L, hs->dedicated.setting_tck);
+
+  /* Waking at 3000 notifies the two alarms whose windows are open.
+   * Cancel the dedicated alarm as its interrupt would. */
+  hs->dedicated.timer->hpl->r = 3000;
+  BSP430_UNITTEST_ASSERT_TRUE(0 <= iBSP430timerAlarmCancel_ni(&hs->dedicated));
+  nfired = 0;
+  (void)hs->dedicated.callback_ni(&hs->dedicated);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(2, nfired);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms + 0, fired[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms + 1, fired[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(alarms + 2, hs->alarms);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(4500L, hs->dedicated.setting_tck);
+  (void)iBSP430timerMuxAlarmShutdown(hs);
+}
+
+/* The wakeup time for active alarms with slack is the earliest end
+ * of a notification window */
+static unsigned long
+slackWake (const sBSP430timerMuxAlarm * alarms,
+           const unsigned char * active,
+           unsigned int n)
+{
+  unsigned long wake_tck = 0;
+  int have = 0;
+  unsigned int i;
+
+  for (i = 0; i < n; ++i) {
+    unsigned long latest_tck = alarms[i].setting_tck + alarms[i].slack_tck;
+    if (active[i] && ((! have) || (0 > (long)(latest_tck - wake_tck)))) {
+      wake_tck = latest_tck;
+      have = 1;
+    }
+  }
+  return wake_tck;
+}
+
+void
+testSlackMany (void)
+{
+  sBSP430timerMuxSharedAlarm sd;
+  hBSP430timerMuxSharedAlarm hs;
+  sBSP430timerMuxAlarm alarms[12];
+  unsigned char active[sizeof(alarms)/sizeof(*alarms)];
+  const unsigned int nalarms = sizeof(alarms)/sizeof(*alarms);
+  unsigned int i;
+
+  memset(&sd, 0x96, sizeof(sd));
+  hs = hBSP430timerMuxAlarmStartup(&sd, BSP430_TIMER_CCACLK_PERIPH_HANDLE, 1);
+  hs->dedicated.timer->hpl->ctl &= ~(MC0 | MC1);
+  vBSP430timerResetCounter_ni(hs->dedicated.timer);
+
+  /* Later alarms have shorter windows, so the wakeup time depends
+   * on alarms several levels below the first */
+  memset(alarms, 0, sizeof(alarms));
+  memset(active, 0, sizeof(active));
+  for (i = 0; i < nalarms; ++i) {
+    alarms[i].setting_tck = 1000 + 500 * i;
+    alarms[i].slack_tck = 20000 - 1700 * i;
+    alarms[i].callback_ni = record_cb_ni;
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmAdd_ni(hs, alarms + i));
+    active[i] = 1;
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(slackWake(alarms, active, nalarms), hs->dedicated.setting_tck);
+  }
+  for (i = 0; i < nalarms; ++i) {
+    unsigned int j = (5 * i) % nalarms;
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430timerMuxAlarmRemove_ni(hs, alarms + j));
+    active[j] = 0;
+    if (NULL != hs->alarms) {
+      BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(slackWake(alarms, active, nalarms), hs->dedicated.setting_tck);
+    }
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, hs->alarms);
+  (void)iBSP430timerMuxAlarmShutdown(hs);
+}
+#endif /* configBSP430_TIMER_MUXALARM_SLACK */
+
 void main ()
 {
   vBSP430platformInitialize_ni();
@@ -144,6 +314,11 @@ void main ()
 
   testOnOff();
   testAddRemove();
+  testFireOrder();
+#if (configBSP430_TIMER_MUXALARM_SLACK - 0)
+  testSlack();
+  testSlackMany();
+#endif /* configBSP430_TIMER_MUXALARM_SLACK */
 
   vBSP430unittestFinalize();
 }
@@ -27,7 +27,7 @@
 #define PORT_BIT BIT3
 #define PORT_SEL0 P1SEL
 #define PORT_SEL1 P1SEL2
-#elif (BSP430_PLATFORM_TRXEB - 0) || (BSP430_PLATFORM_EXP430F5438 - 0)
+#elif (BSP430_PLATFORM_TRXEB - 0) || (BSP430_PLATFORM_EXP430F5438 - 0) || (BSP430_PLATFORM_HOST - 0)
 /* Use A0 on P6.0 */
 #define configBSP430_HAL_PORT6 1
 #define PORT_HAL BSP430_HAL_PORT6
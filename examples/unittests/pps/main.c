@@ -0,0 +1,196 @@
+/** This file is in the public domain.
+ *
+ * Exercise the 1PPS epoch discipline with synthetic pulse captures
+ * and message times.  The uptime timer is halted and set explicitly,
+ * so the pulses may come from a clock running at any rate.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/pps.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#define POSIX_20140101T000000Z 1388534400UL
+
+/* Ticks per second of the uptime clock, nominally 32 kiHz */
+#define UTT_PER_S 32768UL
+
+/* Delay from a pulse to the start of the message describing it */
+#define RX_DELAY_UTT (UTT_PER_S / 4)
+
+/* Uptime at the first pulse */
+#define BASE_UTT 0x10000UL
+
+static void
+set_uptime (unsigned long utt)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  hBSP430uptimeTimer()->overflow_count = utt >> 16;
+  hBSP430uptimeTimer()->hpl->r = (uint16_t)utt;
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
+/* The uptime of the pulse k seconds after the first, for a clock that
+ * runs ppm parts per million fast */
+static unsigned long
+pulse_utt (unsigned int k,
+           unsigned int ppm)
+{
+  return BASE_UTT + (((uint64_t)k * UTT_PER_S * (1000000UL + ppm)) + 500000UL) / 1000000UL;
+}
+
+/* Capture the pulse at pps_utt, then deliver at the expected delay
+ * the message describing it.  Returns the result of the
+ * association. */
+static int
+pulse (unsigned long pps_utt,
+       time_t utc,
+       unsigned int msec)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  set_uptime(pps_utt);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)iBSP430ppsCapture_ni(pps_utt);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  set_uptime(pps_utt + RX_DELAY_UTT);
+  return iBSP430ppsAssociateTime(utc, msec, pps_utt + RX_DELAY_UTT);
+}
+
+void
+testRejects (void)
+{
+  sBSP430ppsState st;
+
+  /* Nothing captured yet */
+  BSP430_UNITTEST_ASSERT_TRUE(0 > iBSP430ppsGetState(&st));
+  BSP430_UNITTEST_ASSERT_TRUE(0 > iBSP430ppsAssociateTime(POSIX_20140101T000000Z, 0, BASE_UTT));
+
+  /* A message that is not near a whole second */
+  BSP430_UNITTEST_ASSERT_TRUE(0 > pulse(BASE_UTT, POSIX_20140101T000000Z, 500));
+
+  /* A message more than a second after the pulse */
+  BSP430_UNITTEST_ASSERT_TRUE(0 > iBSP430ppsAssociateTime(POSIX_20140101T000000Z, 0, BASE_UTT + UTT_PER_S));
+  BSP430_UNITTEST_ASSERT_TRUE(0 > iBSP430ppsGetState(&st));
+  BSP430_UNITTEST_ASSERT_TRUE(0 > iBSP430uptimeCheckEpochValidity());
+}
+
+void
+testDiscipline (void)
+{
+  const time_t utc0 = POSIX_20140101T000000Z;
+  const unsigned int ppm = 100;
+  sBSP430ppsState st;
+  sBSP430uptimeDiscipline disc;
+  unsigned int k;
+
+  /* The first association sets the epoch at the pulse */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, pulse(pulse_utt(0, ppm), utc0, 0));
+  BSP430_UNITTEST_ASSERT_TRUE(0 == iBSP430uptimeCheckEpochValidity());
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430ppsGetState(&st));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(1, st.pulses);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(pulse_utt(0, ppm), st.pps_utt);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(utc0, (long)st.pps_utc);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(0, st.offset_us);
+
+  /* A second message describing the same pulse is ignored */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430ppsAssociateTime(utc0, 0, pulse_utt(0, ppm) + RX_DELAY_UTT + 100));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430ppsGetState(&st));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(1, st.pulses);
+
+  /* The local clock runs fast, so each second the pulse comes 100 us
+   * earlier than the epoch expects.  A message time just short of the second describes the
+   * pulse at that second. */
+  for (k = 1; k < BSP430_PPS_UPDATE_INTERVAL_S; ++k) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, pulse(pulse_utt(k, ppm), utc0 + k - (1 == k), (1 == k) ? 990 : 0));
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430ppsGetState(&st));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(BSP430_PPS_UPDATE_INTERVAL_S, st.pulses);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(utc0 + BSP430_PPS_UPDATE_INTERVAL_S - 1, (long)st.pps_utc);
+  BSP430_UNITTEST_ASSERT_TRUE(40 > labs(st.offset_us + 100L * (BSP430_PPS_UPDATE_INTERVAL_S - 1)));
+
+  /* Only pulses at the update interval are fed to the epoch
+   * discipline, which takes its first frequency estimate from this
+   * one */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, disc.samples);
+  k = BSP430_PPS_UPDATE_INTERVAL_S;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, pulse(pulse_utt(k, ppm), utc0 + k, 0));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, disc.samples);
+  BSP430_UNITTEST_ASSERT_TRUE(5000 > labs(disc.freq_ppb + 1000L * ppm));
+
+  /* Once the offset has been slewed out the pulses stay close to the
+   * epoch */
+  for (++k; k <= 4 * BSP430_PPS_UPDATE_INTERVAL_S; ++k) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, pulse(pulse_utt(k, ppm), utc0 + k, 0));
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430ppsGetState(&st));
+  BSP430_UNITTEST_ASSERT_TRUE(100 > labs(st.offset_us));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(4, disc.samples);
+  BSP430_UNITTEST_ASSERT_TRUE(5000 > labs(disc.freq_ppb + 1000L * ppm));
+}
+
+void
+testStep (void)
+{
+  const time_t utc0 = POSIX_20140101T000000Z;
+  const unsigned int ppm = 100;
+  const long jump_s = 3000;
+  sBSP430ppsState st;
+  sBSP430uptimeDiscipline disc;
+  unsigned int k = 5 * BSP430_PPS_UPDATE_INTERVAL_S;
+
+  /* After a reset the next association is fed to the discipline.
+   * An offset beyond the slew limit steps the epoch, and the state
+   * records the offset that remains. */
+  vBSP430ppsReset();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, pulse(pulse_utt(k, ppm), utc0 + k + jump_s, 0));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430ppsGetState(&st));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(utc0 + k + jump_s, (long)st.pps_utc);
+  BSP430_UNITTEST_ASSERT_TRUE(100 > labs(st.offset_us));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430uptimeGetDiscipline(&disc));
+  BSP430_UNITTEST_ASSERT_TRUE(5000 > labs(disc.freq_ppb + 1000L * ppm));
+
+  /* A pulse associated between updates records its offset, which
+   * saturates if long cannot represent it */
+  ++k;
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, pulse(pulse_utt(k, ppm), utc0 + k, 0));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430ppsGetState(&st));
+  if (LONG_MAX / 1000000L > jump_s) {
+    BSP430_UNITTEST_ASSERT_TRUE(100 > labs(st.offset_us + 1000000L * jump_s));
+  } else {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTld(LONG_MIN, st.offset_us);
+  }
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430uptimeStart_ni();
+  vBSP430unittestInitialize();
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  /* Halt the timer without telling the infrastructure, since the
+   * test sets it explicitly. */
+  hBSP430uptimeTimer()->hpl->ctl &= ~(MC0 | MC1);
+  hBSP430uptimeTimer()->hpl->r = 0;
+  hBSP430uptimeTimer()->overflow_count = 0;
+  ulBSP430uptimeSetConversionFrequency_ni(UTT_PER_S);
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  testRejects();
+  testDiscipline();
+  testStep();
+
+  vBSP430unittestFinalize();
+}
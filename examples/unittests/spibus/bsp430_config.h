@@ -0,0 +1,33 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Support the unit-test framework */
+#define configBSP430_UNITTEST 1
+
+/* Exercise the shared SPI bus manager */
+#define configBSP430_SERIAL_ENABLE_SPI 1
+#define configBSP430_SERIAL_SPI_ASYNC 1
+#define configBSP430_SERIAL_SPI_BUS 1
+#define configBSP430_HAL_DMA 1
+
+/* The bus, its DMA channels, and the chip selects of two devices */
+#if (BSP430_PLATFORM_HOST - 0)
+#define APP_SPI_PERIPH_HANDLE BSP430_PERIPH_USCI5_B0
+#define configBSP430_HAL_USCI5_B0 1
+#define APP_SPI_RX_DMATSEL 18   /* UCB0RXIFG */
+#define APP_SPI_TX_DMATSEL 19   /* UCB0TXIFG */
+#define configBSP430_HPL_PORT3 1
+#define APP_CSN_HPL BSP430_HPL_PORT3
+#define APP_CSN_A_BIT BIT0
+#define APP_CSN_B_BIT BIT1
+#endif /* PLATFORM */
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,255 @@
+/** This file is in the public domain.
+ *
+ * Exercise the shared SPI bus manager with two devices that use
+ * different chip selects and serial configurations, and an M25P
+ * flash driver attached to the bus.  The simulated host supplies the
+ * responses.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <string.h>
+#include <bsp430/serial.h>
+#include <bsp430/utility/m25p.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/platform/host/sim.h>
+
+#define CTL0_A BSP430_SERIAL_ADJUST_CTL0_INITIALIZER(UCCKPL | UCMSB | UCMST)
+#define CTL0_B BSP430_SERIAL_ADJUST_CTL0_INITIALIZER(UCCKPH | UCMSB | UCMST)
+#define PRESCALER_A 4
+#define PRESCALER_B 8
+
+sBSP430spiBus bus;
+hBSP430halSERIAL spi;
+
+static sBSP430spiTransaction * completed[4];
+static unsigned int ncompleted;
+
+static int
+record_cb_ni (sBSP430spiTransaction * tp)
+{
+  if (ncompleted < (sizeof(completed) / sizeof(*completed))) {
+    completed[ncompleted] = tp;
+  }
+  ++ncompleted;
+  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+}
+
+static void
+init_txn (sBSP430spiTransaction * tp,
+          unsigned char csn_bit)
+{
+  memset(tp, 0, sizeof(*tp));
+  tp->csn_port = APP_CSN_HPL;
+  tp->csn_bit = csn_bit;
+  if (APP_CSN_A_BIT == csn_bit) {
+    tp->ctl0_byte = CTL0_A;
+    tp->prescaler = PRESCALER_A;
+  } else {
+    tp->ctl0_byte = CTL0_B;
+    tp->prescaler = PRESCALER_B;
+  }
+  tp->ctl1_byte = UCSSEL_2;
+  tp->callback_ni = record_cb_ni;
+}
+
+/* Sleep until the transaction completes */
+static int
+wait_ni (sBSP430spiTransaction * tp)
+{
+  while (0 == tp->result) {
+    BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
+    BSP430_CORE_DISABLE_INTERRUPT();
+  }
+  return tp->result;
+}
+
+void
+testSingle (void)
+{
+  static const uint8_t cmd[] = { 0x9F };
+  static const uint8_t resp[] = { 0xFF, 0x20, 0x71 };
+  uint8_t rx[sizeof(resp)];
+  sBSP430spiTransaction txn;
+  unsigned long num_rx = spi->num_rx;
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  init_txn(&txn, APP_CSN_A_BIT);
+  txn.tx_data = cmd;
+  txn.tx_len = sizeof(cmd);
+  txn.rx_len = sizeof(resp) - sizeof(cmd);
+  txn.rx_data = rx;
+  memset(rx, 0, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(resp), iBSP430hostInjectRx(APP_SPI_PERIPH_HANDLE, resp, sizeof(resp)));
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430spiBusSubmit_ni(&bus, &txn));
+  /* The chip select is asserted only while the transaction runs */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, APP_CSN_HPL->out & APP_CSN_A_BIT);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(resp), wait_ni(&txn));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(APP_CSN_A_BIT, APP_CSN_HPL->out & APP_CSN_A_BIT);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(resp, rx, sizeof(rx)));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(num_rx + sizeof(resp), spi->num_rx);
+}
+
+void
+testQueue (void)
+{
+  static const uint8_t cmd[] = { 0x05 };
+  sBSP430spiTransaction t1;
+  sBSP430spiTransaction t2;
+  sBSP430spiTransaction t3;
+  unsigned long num_rx = spi->num_rx;
+  unsigned long num_tx = spi->num_tx;
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  /* Alternating devices reconfigure the peripheral for each
+   * transaction without losing its statistics. */
+  init_txn(&t1, APP_CSN_A_BIT);
+  t1.tx_data = cmd;
+  t1.tx_len = sizeof(cmd);
+  init_txn(&t2, APP_CSN_B_BIT);
+  t2.rx_len = 2;
+  init_txn(&t3, APP_CSN_A_BIT);
+  t3.tx_data = cmd;
+  t3.tx_len = sizeof(cmd);
+  t3.rx_len = 3;
+  ncompleted = 0;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430spiBusSubmit_ni(&bus, &t1));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430spiBusSubmit_ni(&bus, &t2));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430spiBusSubmit_ni(&bus, &t3));
+  (void)wait_ni(&t3);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, ncompleted);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&t1, completed[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&t2, completed[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&t3, completed[2]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, t1.result);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(2, t2.result);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(4, t3.result);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(num_rx + 7, spi->num_rx);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(num_tx + 7, spi->num_tx);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(APP_CSN_A_BIT | APP_CSN_B_BIT, APP_CSN_HPL->out & (APP_CSN_A_BIT | APP_CSN_B_BIT));
+}
+
+void
+testHold (void)
+{
+  static const uint8_t cmd[] = { 0x03, 0x00, 0x01, 0x00 };
+  sBSP430spiTransaction a1;
+  sBSP430spiTransaction a2;
+  sBSP430spiTransaction b;
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  init_txn(&a1, APP_CSN_A_BIT);
+  a1.tx_data = cmd;
+  a1.tx_len = sizeof(cmd);
+  a1.flags = BSP430_SPI_TXN_FLAG_HOLD_CS;
+  init_txn(&b, APP_CSN_B_BIT);
+  b.rx_len = 1;
+  init_txn(&a2, APP_CSN_A_BIT);
+  a2.rx_len = 2;
+  ncompleted = 0;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430spiBusSubmit_ni(&bus, &a1));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430spiBusSubmit_ni(&bus, &b));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(cmd), wait_ni(&a1));
+
+  /* The device keeps its chip select and the other device waits */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, APP_CSN_HPL->out & APP_CSN_A_BIT);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, b.result);
+
+  /* The continuation goes ahead of the waiting transaction */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430spiBusSubmit_ni(&bus, &a2));
+  (void)wait_ni(&b);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, ncompleted);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&a1, completed[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&a2, completed[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&b, completed[2]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(2, a2.result);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(1, b.result);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(APP_CSN_A_BIT | APP_CSN_B_BIT, APP_CSN_HPL->out & (APP_CSN_A_BIT | APP_CSN_B_BIT));
+}
+
+void
+testM25P (void)
+{
+  static const uint8_t status[] = { 0xFF, BSP430_M25P_SR_WEL };
+  static const uint8_t cmd_echo[] = { 0xFF, 0xFF, 0xFF, 0xFF };
+  static const uint8_t data[] = { 0x12, 0x34, 0x56 };
+  sBSP430m25p m25p_data;
+  hBSP430m25p m25p;
+  uint8_t rx[sizeof(data)];
+  unsigned long num_rx;
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  memset(&m25p_data, 0, sizeof(m25p_data));
+  m25p_data.csn_port = APP_CSN_HPL;
+  m25p_data.csn_bit = APP_CSN_B_BIT;
+  m25p_data.bus = &bus;
+  m25p = hBSP430m25pInitialize(&m25p_data, BSP430_PLATFORM_M25P_SPI_CTL0_BYTE, UCSSEL_2, PRESCALER_B);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&m25p_data, m25p);
+  num_rx = spi->num_rx;
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(status), iBSP430hostInjectRx(APP_SPI_PERIPH_HANDLE, status, sizeof(status)));
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(BSP430_M25P_SR_WEL, iBSP430m25pStatus_rh(m25p));
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(num_rx + sizeof(status), spi->num_rx);
+
+  /* Called with interrupts enabled the command sleeps until done and
+   * returns with them still enabled */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(status), iBSP430hostInjectRx(APP_SPI_PERIPH_HANDLE, status, sizeof(status)));
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(BSP430_M25P_SR_WEL, iBSP430m25pStatus_rh(m25p));
+  BSP430_UNITTEST_ASSERT_TRUE(GIE & __get_interrupt_state());
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(num_rx + 2 * sizeof(status), spi->num_rx);
+
+  /* A read spans two transactions that hold the chip select */
+  memset(rx, 0, sizeof(rx));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(cmd_echo), iBSP430hostInjectRx(APP_SPI_PERIPH_HANDLE, cmd_echo, sizeof(cmd_echo)));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(data), iBSP430hostInjectRx(APP_SPI_PERIPH_HANDLE, data, sizeof(data)));
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430m25pInitiateAddressCommand_rh(m25p, BSP430_M25P_CMD_READ, 0x10000));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0, APP_CSN_HPL->out & APP_CSN_B_BIT);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sizeof(data), iBSP430m25pCompleteTxRx_rh(m25p, NULL, 0, sizeof(rx), rx));
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(APP_CSN_B_BIT, APP_CSN_HPL->out & APP_CSN_B_BIT);
+  BSP430_UNITTEST_ASSERT_TRUE(0 == memcmp(data, rx, sizeof(rx)));
+}
+
+void main ()
+{
+  int rc;
+
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  /* Both chip selects are outputs driven high */
+  APP_CSN_HPL->out |= APP_CSN_A_BIT | APP_CSN_B_BIT;
+  APP_CSN_HPL->dir |= APP_CSN_A_BIT | APP_CSN_B_BIT;
+
+  spi = hBSP430serialLookup(APP_SPI_PERIPH_HANDLE);
+  rc = iBSP430spiBusConfigure_ni(&bus, spi, 0, APP_SPI_RX_DMATSEL, 1, APP_SPI_TX_DMATSEL);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  if (0 == rc) {
+    testSingle();
+    testQueue();
+    testHold();
+    testM25P();
+  }
+
+  vBSP430unittestFinalize();
+}
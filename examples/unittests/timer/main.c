@@ -60,11 +60,40 @@ testOverflowTimer (void)
   BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(0, ulBSP430uptime());
 }
 
+void
+testPendingOverflow (void)
+{
+  unsigned int overflow;
+
+  resetTimer();
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    /* With the overflow unhandled the lock-free read must account for
+     * the pending flag just as the _ni read does. */
+    uthal->hpl->r = 0x1234;
+    uthal->hpl->ctl |= TAIFG;
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x11234UL, ulBSP430timerCounter_ni(uthal, &overflow));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x11234UL, ulBSP430uptime());
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTllx(0x11234ULL, ullBSP430uptime());
+    BSP430_UNITTEST_ASSERT_TRUE(TAIFG & uthal->hpl->ctl);
+
+    /* Past the midpoint the overflow is assumed to follow the read. */
+    uthal->hpl->r = 0x9234;
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x9234UL, ulBSP430uptime());
+    uthal->hpl->r = 0x1234;
+  } while (0);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  __nop();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(1, uthal->overflow_count);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x11234UL, ulBSP430uptime());
+  resetTimer();
+}
+
 static void
 testCorrection (const unsigned int cap_ctr,
                 const unsigned int cur_ctr)
 {
-  const unsigned int delta_ctr = cur_ctr - cap_ctr;
+  const uint16_t delta_ctr = cur_ctr - cap_ctr;
   unsigned long long full_base = 0;
   unsigned long long cur_ull = cur_ctr;
   unsigned long cur_ul = cur_ull;
@@ -72,7 +101,7 @@ testCorrection (const unsigned int cap_ctr,
 #define RESET_CTR() do {                         \
     uthal->hpl->r = cur_ctr;                     \
     cur_ull = full_base + cur_ctr;               \
-    cur_ul = cur_ull;                            \
+    cur_ul = (uint32_t)cur_ull;                  \
   } while (0)
 
   cprintf("# Testing correction cap 0x%04x cur 0x%04x\n", cap_ctr, cur_ctr);
@@ -93,7 +122,7 @@ testCorrection (const unsigned int cap_ctr,
   BSP430_UNITTEST_ASSERT_EQUAL_FMTllx(cur_ull, ullBSP430uptime());
   BSP430_UNITTEST_ASSERT_EQUAL_FMTllx(cur_ull - delta_ctr, ullBSP430uptimeCorrected(cap_ctr));
   uthal->hpl->r = 0;
-  uthal->overflow_count = ~(unsigned int)0;
+  uthal->overflow_count = 0xFFFFU;
   full_base = 0xFFFF0000UL;
   BSP430_UNITTEST_ASSERT_EQUAL_FMTllx(full_base, ullBSP430uptime());
 
@@ -113,7 +142,7 @@ testCorrection (const unsigned int cap_ctr,
   BSP430_UNITTEST_ASSERT_FALSE(cur_ul == cur_ull);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTllx(cur_ull - delta_ctr, ullBSP430uptimeCorrected(cap_ctr));
 
-  uthal->overflow_count =  ~(unsigned long)0;
+  uthal->overflow_count = 0xFFFFFFFFUL;
   full_base = uthal->overflow_count;
   BSP430_UNITTEST_ASSERT_EQUAL_FMTllx(full_base, 0xFFFFFFFFUL);
   full_base <<= 16;
@@ -136,6 +165,168 @@ testWrapCorrection (void)
 {
 }
 
+void
+testExtendCaptures (void)
+{
+  const uint16_t captures[] = { 0xFFF0, 0x0010, 0x8010, 0x000F, 0x0005 };
+  unsigned long tts[sizeof(captures) / sizeof(*captures)];
+  unsigned long end_tt = 0x40005UL;
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(end_tt, ulBSP430timerExtendCaptures(end_tt, captures, tts, 0));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(end_tt, ulBSP430timerExtendCaptures(end_tt, captures + 4, tts + 4, 1));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(end_tt, tts[4]);
+
+  /* Each interval is below 65536 ticks but the sequence spans several
+   * overflows. */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x1FFF0UL, ulBSP430timerExtendCaptures(end_tt, captures, tts, 5));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x1FFF0UL, tts[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x20010UL, tts[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x28010UL, tts[2]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x3000FUL, tts[3]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x40005UL, tts[4]);
+}
+
+#define PERIODCAP_CCIDX 1
+
+static sBSP430timerPeriodCapture periodcap_;
+static unsigned int periodcap_callbacks;
+static unsigned int periodcap_restarts;
+static unsigned long periodcap_totals[4];
+
+static int
+periodcap_cb_ni (hBSP430timerPeriodCapture periodcap)
+{
+  if (periodcap_callbacks < (sizeof(periodcap_totals) / sizeof(*periodcap_totals))) {
+    periodcap_totals[periodcap_callbacks] = periodcap->total_tt_ni;
+  }
+  ++periodcap_callbacks;
+  if (0 < periodcap_restarts) {
+    --periodcap_restarts;
+    (void)iBSP430timerPeriodCaptureStart_ni(periodcap, periodcap->count);
+  }
+  return 0;
+}
+
+/* Set the timer to tt, then toggle the capture input between GND and
+ * VCC to produce a rising edge at that time. */
+static void
+periodEdge (unsigned long tt)
+{
+  volatile unsigned int * cctlp = uthal->hpl->cctl + PERIODCAP_CCIDX;
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    uthal->overflow_count = tt >> 16;
+    uthal->hpl->r = (uint16_t)tt;
+    *cctlp = (*cctlp & ~CCIS_3) | CCIS_3;
+    *cctlp = (*cctlp & ~CCIS_3) | CCIS_2;
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  __nop();
+}
+
+void
+testPeriodCapture (void)
+{
+  hBSP430timerPeriodCapture pcap;
+  unsigned long tt = 0x1234;
+  int rc;
+
+  resetTimer();
+  pcap = hBSP430timerPeriodCaptureInitialize(&periodcap_,
+                                             BSP430_UPTIME_TIMER_PERIPH_HANDLE,
+                                             PERIODCAP_CCIDX,
+                                             CM_1, CCIS_2,
+                                             periodcap_cb_ni);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&periodcap_, pcap);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430timerPeriodCaptureSetEnabled_ni(pcap, 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  rc = iBSP430timerPeriodCaptureStart_ni(pcap, 0);
+  BSP430_UNITTEST_ASSERT_TRUE(0 > rc);
+  rc = iBSP430timerPeriodCaptureStart_ni(pcap, 4);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+
+  /* The first edge only marks the start of the first interval.  The
+   * third interval spans two overflows. */
+  periodEdge(tt);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_PERIODCAP_SYNCED & pcap->flags_ni);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, pcap->intervals_ni);
+  periodEdge(tt += 1000);
+  periodEdge(tt += 1500);
+  periodEdge(tt += 0x18000UL);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, pcap->intervals_ni);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, periodcap_callbacks);
+  periodEdge(tt += 800);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, periodcap_callbacks);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_PERIODCAP_COMPLETE & pcap->flags_ni);
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_PERIODCAP_ACTIVE & pcap->flags_ni);
+  BSP430_UNITTEST_ASSERT_FALSE(CCIE & uthal->hpl->cctl[PERIODCAP_CCIDX]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(4, pcap->intervals_ni);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x18000UL + 3300, pcap->total_tt_ni);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(800, pcap->min_tt_ni);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x18000UL, pcap->max_tt_ni);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu((0x18000UL + 3300 + 2) / 4, ulBSP430timerPeriodCaptureMean_ni(pcap));
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  /* With the measurement complete further edges are ignored */
+  periodEdge(tt += 100);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, periodcap_callbacks);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(4, pcap->intervals_ni);
+
+  /* A measurement restarted from the callback begins at the edge that
+   * completed the previous one, so no interval is lost. */
+  periodcap_callbacks = 0;
+  periodcap_restarts = 2;
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430timerPeriodCaptureStart_ni(pcap, 2);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  periodEdge(tt += 5000);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, pcap->intervals_ni);
+  periodEdge(tt += 100);
+  periodEdge(tt += 200);
+  periodEdge(tt += 300);
+  periodEdge(tt += 400);
+  periodEdge(tt += 500);
+  periodEdge(tt += 600);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, periodcap_callbacks);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(300, periodcap_totals[0]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(700, periodcap_totals[1]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(1100, periodcap_totals[2]);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(500, pcap->min_tt_ni);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(600, pcap->max_tt_ni);
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_PERIODCAP_ACTIVE & pcap->flags_ni);
+
+  /* An edge lost while the previous capture was pending abandons the
+   * measurement. */
+  periodcap_callbacks = 0;
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430timerPeriodCaptureStart_ni(pcap, 4);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_PERIODCAP_SYNCED & pcap->flags_ni);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  periodEdge(tt += 1000);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  periodEdge(tt += 1000);
+  periodEdge(tt += 1000);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  __nop();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1, periodcap_callbacks);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_PERIODCAP_OVERFLOW & pcap->flags_ni);
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_PERIODCAP_ACTIVE & pcap->flags_ni);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, pcap->intervals_ni);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rc = iBSP430timerPeriodCaptureSetEnabled_ni(pcap, 0);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  resetTimer();
+}
+
 void main ()
 {
   vBSP430platformInitialize_ni();
@@ -154,12 +345,15 @@ void main ()
 
   testInitialConditions();
   testOverflowTimer();
+  testPendingOverflow();
   testCorrection(0x4000, 0xC000);
   testCorrection(0xC000, 0x4000);
   testCorrection(0x0000, 0xFFFF);
   testCorrection(0xFFFF, 0x0000);
   testCorrection(0x0000, 0x0001);
   testCorrection(0X0001, 0x0000);
+  testExtendCaptures();
+  testPeriodCapture();
 
   vBSP430unittestFinalize();
 }
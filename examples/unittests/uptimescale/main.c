@@ -9,6 +9,93 @@
 #include <bsp430/clock.h>
 #include <bsp430/utility/uptime.h>
 #include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+
+/* Count the values for which the division-free conversions disagree
+ * with the equivalent divisions, over a pseudo-random sample of
+ * durations within the range where neither overflows. */
+static unsigned int
+conversionErrors (unsigned long frequency_Hz)
+{
+  uint32_t v = 1;
+  unsigned int errors = 0;
+  int i;
+
+  ulBSP430uptimeSetConversionFrequency_ni(frequency_Hz);
+  for (i = 0; i < 200; ++i) {
+    unsigned long long utt = v % (4UL * frequency_Hz);
+    unsigned long long ms = v % 100000UL;
+
+    errors += (ulBSP430uptimeUTTToMS(utt) != (1000ULL * utt) / frequency_Hz);
+    errors += (ulBSP430uptimeUTTToUS(utt) != (unsigned long)((1000000ULL * utt) / frequency_Hz));
+    errors += (ulBSP430uptimeMSToUTT(ms) != (ms * frequency_Hz) / 1000U);
+    errors += (ulBSP430uptimeUSToUTT(v) != ((unsigned long long)v * frequency_Hz) / 1000000UL);
+    v = (uint32_t)(1664525UL * v + 1013904223UL);
+  }
+  return errors;
+}
+
+/* Cycle benchmark: the cost of each conversion, measured with the
+ * suspended uptime timer temporarily counting SMCLK.  Results are
+ * informational and not checked.  The host simulator advances its
+ * timers only on peripheral access, so there each conversion is run
+ * once but not measured. */
+#define BENCH_REPS 16
+
+static unsigned long bench_utt = 123456789UL;
+static unsigned long bench_hz;
+static volatile unsigned long bench_sink;
+
+static void
+bench_divide (void)
+{
+  bench_sink = (1000ULL * bench_utt) / bench_hz;
+}
+
+static void
+bench_multiply (void)
+{
+  bench_sink = ulBSP430uptimeUTTToMS(bench_utt);
+}
+
+static void
+bench_asText (void)
+{
+  char buffer[BSP430_UPTIME_AS_TEXT_LENGTH];
+  bench_sink = (unsigned long)xBSP430uptimeAsText(bench_utt, buffer);
+}
+
+static void
+bench_scale (void)
+{
+  const char * units;
+  bench_sink = uiBSP430uptimeScaleForDisplay(bench_utt, &units);
+}
+
+static void
+bench (const char * name,
+       void (* fn) (void))
+{
+#if (BSP430_PLATFORM_HOST - 0)
+  fn();
+  cprintf("# %s: not measured on host\n", name);
+#else /* BSP430_PLATFORM_HOST */
+  volatile sBSP430hplTIMER * const hpl = hBSP430uptimeTimer()->hpl;
+  unsigned int ctl = hpl->ctl;
+  unsigned int t0;
+  unsigned int t1;
+  int i;
+
+  hpl->ctl = TASSEL_2 | MC_2 | TACLR;
+  t0 = hpl->r;
+  for (i = 0; i < BENCH_REPS; ++i) {
+    fn();
+  }
+  t1 = hpl->r;
+  hpl->ctl = ctl;
+  cprintf("# %s: %u SMCLK ticks\n", name, (t1 - t0) / BENCH_REPS);
+#endif /* BSP430_PLATFORM_HOST */
+}
 
 void main ()
 {
@@ -58,5 +145,40 @@ void main ()
   BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3000, sv);
   BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ("ms", units);
 
+  {
+    char buffer[BSP430_UPTIME_AS_TEXT_LENGTH];
+
+    BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(" 0:00.000", xBSP430uptimeAsText(32, buffer));
+    BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ(" 0:01.999", xBSP430uptimeAsText(2*32768UL - 1, buffer));
+    BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ("59:59.999", xBSP430uptimeAsText(3600*32768UL - 1, buffer));
+    BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ("36:24:31.000", xBSP430uptimeAsText(131071UL * 32768UL, buffer));
+    BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ("36:24:31.999", xBSP430uptimeAsText(0xFFFFFFFFUL, buffer));
+  }
+
+  sv = uiBSP430uptimeScaleForDisplay(3*60*32768ULL - 1, &units);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(179, sv);
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ("s", units);
+
+  sv = uiBSP430uptimeScaleForDisplay(3*3600*32768ULL - 1, &units);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(179, sv);
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ("min", units);
+
+  sv = uiBSP430uptimeScaleForDisplay(1000*3600*32768ULL, &units);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1000, sv);
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ("h", units);
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, conversionErrors(32768));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, conversionErrors(10000));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, conversionErrors(11981));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, conversionErrors(1000000));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, conversionErrors(20000000));
+
+  ulBSP430uptimeSetConversionFrequency_ni(one_s);
+  bench_hz = one_s;
+  bench("UTT_TO_MS divide", bench_divide);
+  bench("UTT_TO_MS multiply", bench_multiply);
+  bench("uptimeAsText", bench_asText);
+  bench("uptimeScaleForDisplay", bench_scale);
+
   vBSP430unittestFinalize();
 }
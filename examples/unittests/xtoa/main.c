@@ -0,0 +1,163 @@
+/** This file is in the public domain.
+ *
+ * Verify the console integer conversions, which do not use division
+ * for radix 8, 10, or 16, against the C library.  Build with
+ * XTOA_RECIPROCAL=1 and XTOA_RECIPROCAL=0 to cover both ways of
+ * producing decimal digits.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ *
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/unittest.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/platform/host/sim.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+static char out[256];
+static char expect[256];
+
+static void
+capture_begin (void)
+{
+  iBSP430consoleFlush();
+  (void)lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, out, sizeof(out) - 1);
+}
+
+static void
+capture_end (void)
+{
+  long n;
+
+  iBSP430consoleFlush();
+  n = lBSP430hostCaptureTx(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE, NULL, 0);
+  out[(n < (long)sizeof(out)) ? n : (long)sizeof(out) - 1] = 0;
+}
+
+#define CHECK_OUTPUT(expect_) do {                              \
+    BSP430_UNITTEST_ASSERT_TRUE(0 == strcmp((expect_), out));   \
+    if (0 != strcmp((expect_), out)) {                          \
+      cprintf("# expected '%s'\n# got      '%s'\n", (expect_), out);  \
+    }                                                           \
+  } while (0)
+
+/* Compare the output and result of cprintf(3) with snprintf(3) */
+#define CHECK_PRINTF(...) do {                                  \
+    int rv_;                                                    \
+    capture_begin();                                            \
+    rv_ = cprintf(__VA_ARGS__);                                 \
+    capture_end();                                              \
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(snprintf(expect, sizeof(expect), __VA_ARGS__), rv_); \
+    CHECK_OUTPUT(expect);                                       \
+  } while (0)
+
+/* Compare a cput function with snprintf(3) */
+#define CHECK_CPUT(fn_, v_, radix_, fmt_) do {                  \
+    capture_begin();                                            \
+    (void)fn_(v_, radix_);                                      \
+    capture_end();                                              \
+    snprintf(expect, sizeof(expect), fmt_, v_);                 \
+    CHECK_OUTPUT(expect);                                       \
+  } while (0)
+
+static const unsigned long uvalues[] = {
+  0, 1, 9, 10, 99, 100, 12345, 0xFFFF, 0x10000, 99999, 100000,
+  999999999, 1000000000, 0x7FFFFFFFUL, 0x80000000UL, 0xFFFFFFFFUL,
+#if 0xFFFFFFFFUL < ULONG_MAX
+  0x100000000UL, 9999999999UL, 10000000000UL,
+  9999999999999999999UL, 10000000000000000000UL,
+#endif /* ULONG_MAX */
+  LONG_MAX, (unsigned long)LONG_MIN, ULONG_MAX - 1, ULONG_MAX
+};
+
+void
+testCputUnsigned (void)
+{
+  const unsigned long * vp = uvalues;
+  const unsigned long * const vpe = vp + sizeof(uvalues) / sizeof(*uvalues);
+
+  while (vp < vpe) {
+    unsigned long v = *vp++;
+    CHECK_CPUT(cputul, v, 8, "%lo");
+    CHECK_CPUT(cputul, v, 10, "%lu");
+    CHECK_CPUT(cputul, v, 16, "%lX");
+    CHECK_CPUT(cputu, (unsigned int)v, 10, "%u");
+    CHECK_CPUT(cputu, (unsigned int)v, 16, "%X");
+  }
+}
+
+void
+testCputSigned (void)
+{
+  const unsigned long * vp = uvalues;
+  const unsigned long * const vpe = vp + sizeof(uvalues) / sizeof(*uvalues);
+
+  while (vp < vpe) {
+    long v = (long)*vp++;
+    CHECK_CPUT(cputl, v, 10, "%ld");
+    CHECK_CPUT(cputl, v, 16, "%lX");
+    CHECK_CPUT(cputl, -v, 10, "%ld");
+    CHECK_CPUT(cputi, (int)v, 10, "%d");
+    CHECK_CPUT(cputi, (int)v, 8, "%o");
+  }
+  CHECK_CPUT(cputl, LONG_MIN, 10, "%ld");
+  CHECK_CPUT(cputl, LONG_MIN, 8, "%lo");
+  CHECK_CPUT(cputi, INT_MIN, 10, "%d");
+}
+
+void
+testPrintfLong (void)
+{
+  const unsigned long * vp = uvalues;
+  const unsigned long * const vpe = vp + sizeof(uvalues) / sizeof(*uvalues);
+
+  while (vp < vpe) {
+    unsigned long v = *vp++;
+    CHECK_PRINTF("%lu %lo %lx %lX", v, v, v, v);
+    CHECK_PRINTF("%ld %li", (long)v, -(long)v);
+  }
+  CHECK_PRINTF("%ld", LONG_MIN);
+  CHECK_PRINTF("%lu", ULONG_MAX);
+}
+
+void
+testPrintfFlags (void)
+{
+  CHECK_PRINTF("[%12lu][%-12lu][%012lu]", 1234UL, 1234UL, 1234UL);
+  CHECK_PRINTF("[%12ld][%-12ld][%012ld]", -1234L, -1234L, -1234L);
+  CHECK_PRINTF("[%+ld][%+ld][% ld][% ld][%+08ld]", 5L, -5L, 5L, -5L, 5L);
+  CHECK_PRINTF("[%*lx][%-*lo][%0*lu]", 10, 0xbeefUL, -7, 8UL, 6, 42UL);
+  CHECK_PRINTF("[%2lu][%-2ld][%02lx]", 123456UL, -123456L, 0xabcdefUL);
+}
+
+void
+testPrintfMixed (void)
+{
+  /* Conversions other than long integers, and long conversions with
+   * a precision or the alternate form, are left to the library. */
+  CHECK_PRINTF("a%db%luc%sd%ce%%f", -3, 4000000000UL, "str", 'x');
+  CHECK_PRINTF("%.7lu|%#lx|%#lo|%8.3ld", 42UL, 0x2aUL, 8UL, -9L);
+  CHECK_PRINTF("%lld %lu %llx", -1234567890123LL, 99UL, 0xfedcba9876ULL);
+  CHECK_PRINTF("%hd %lu %hhu %zu", -2, 3UL, 260, (size_t)17);
+  CHECK_PRINTF("%5.2f %lu %Lg %lu", 2.5, 1UL, (long double)0.125, 2UL);
+  CHECK_PRINTF("%*.*s|%lu|%p", 6, 2, "abcdef", 0UL, (void *)out);
+  CHECK_PRINTF("no conversions");
+  CHECK_PRINTF("%d %s", 17, "no long");
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testCputUnsigned();
+  testCputSigned();
+  testPrintfLong();
+  testPrintfFlags();
+  testPrintfMixed();
+
+  vBSP430unittestFinalize();
+}
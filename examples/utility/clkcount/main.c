@@ -39,31 +39,26 @@
 unsigned long sums[HISTORY_EXP];
 unsigned long samples[MAX_SAMPLES];
 
-struct sCaptures {
-  sBSP430halISRIndexedChainNode cb;
-  unsigned long last_count;
-  volatile unsigned long count;
-  unsigned int nsamples;
-};
+/* Periods are measured one at a time, with each measurement
+ * restarted from the callback so no pulse is missed. */
+static sBSP430timerPeriodCapture periodcap;
+static volatile unsigned long period_tt;
+static volatile unsigned int nperiods;
 
 static int
-capture_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
-                void * context,
-                int idx)
+period_cb_ni (hBSP430timerPeriodCapture pcap)
 {
-  struct sCaptures * cp = (struct sCaptures *)cb;
-  hBSP430halTIMER timer = (hBSP430halTIMER)context;
-  unsigned long now_tt = ulBSP430timerCounter_ni(timer, NULL);
+  int rv = 0;
 
-  cp->count = now_tt + ((int)timer->hpl->ccr[idx] - (unsigned int)now_tt);
-  cp->nsamples += 1;
-  return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  if (BSP430_TIMER_PERIODCAP_COMPLETE & pcap->flags_ni) {
+    period_tt = pcap->total_tt_ni;
+    nperiods += 1;
+    rv = BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  }
+  (void)iBSP430timerPeriodCaptureStart_ni(pcap, 1);
+  return rv;
 }
 
-static struct sCaptures captures = {
-  .cb = { .callback_ni = capture_isr_ni },
-};
-
 /* Simulate floating-point output */
 #define EMIT_SCALED(_s,_n) do {                         \
     static const int MULTIPLIER = 100;                  \
@@ -79,6 +74,7 @@ void main ()
   hBSP430halPORT h_cc0;
   unsigned long nominal_Hz;
   unsigned int tassel;
+  unsigned int nsamples = 0;
 
   vBSP430platformInitialize_ni();
   (void)iBSP430consoleInitialize();
@@ -124,12 +120,15 @@ void main ()
 #endif /* BSP430_PORT_SUPPORTS_REN */
   BSP430_PORT_HAL_HPL_SEL(h_cc0) |= BSP430_TIMER_CCACLK_CC0_PORT_BIT;
 
-  /* Chain in interrupt handler */
-  captures.cb.next_ni = timer->cc_cbchain_ni[0];
-  timer->cc_cbchain_ni[0] = &captures.cb;
-
-  /* Capture synchronously on rising edge and interrupt */
-  timer->hpl->cctl[0] = BSP430_TIMER_CCACLK_CC0_CCIS | CM_1 | SCS | CAP | CCIE;
+  /* Capture synchronously on rising edge */
+  if (NULL == hBSP430timerPeriodCaptureInitialize(&periodcap,
+                                                  BSP430_TIMER_CCACLK_PERIPH_HANDLE,
+                                                  0, CM_1,
+                                                  BSP430_TIMER_CCACLK_CC0_CCIS,
+                                                  period_cb_ni)) {
+    cprintf("ERROR: period capture initialization failed\n");
+    return;
+  }
 
   /* Configure timer to run continuously off selected clock */
   timer->hpl->ctl = 0;
@@ -137,27 +136,25 @@ void main ()
   timer->hpl->ctl = tassel | MC_2 | TACLR | TAIE;
   vBSP430timerInferHints_ni(timer);
 
-  /* Align to capture then clear the state */
-  BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
-  BSP430_CORE_DISABLE_INTERRUPT();
   memset(sums, 0, sizeof(sums));
   memset(samples, 0, sizeof(samples));
-  captures.last_count = captures.count;
-  captures.nsamples = 0;
+  (void)iBSP430timerPeriodCaptureSetEnabled_ni(&periodcap, 1);
+  (void)iBSP430timerPeriodCaptureStart_ni(&periodcap, 1);
   BSP430_CORE_ENABLE_INTERRUPT();
   while (1) {
-    unsigned int nsamples;
     unsigned long delta;
     long err;
     unsigned long ppm;
     int i;
     int si;
 
-    BSP430_CORE_LPM_ENTER(LPM0_bits);
     BSP430_CORE_DISABLE_INTERRUPT();
-    delta = captures.count - captures.last_count;
-    captures.last_count = captures.count;
-    nsamples = captures.nsamples;
+    while (nsamples == nperiods) {
+      BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
+      BSP430_CORE_DISABLE_INTERRUPT();
+    }
+    delta = period_tt;
+    nsamples = nperiods;
     BSP430_CORE_ENABLE_INTERRUPT();
     err = delta - nominal_Hz;
     if (0 > err) {
@@ -24,6 +24,7 @@
 #include <bsp430/utility/uptime.h>
 #include <bsp430/utility/led.h>
 #include <bsp430/utility/event.h>
+#include <bsp430/utility/idle.h>
 #include <bsp430/utility/console.h>
 #include <string.h>
 
@@ -218,6 +219,9 @@ void main ()
     cprintf("ERR initializing mux shared alarm\n");
     goto err_out;
   }
+  BSP430_CORE_DISABLE_INTERRUPT();
+  vBSP430idleSetMuxAlarm_ni(map);
+  BSP430_CORE_ENABLE_INTERRUPT();
 
   /* Processing done entirely in mux callback.  No wakeup. */
   mux_alarms[0].alarm.callback_ni = mux_alarm_callback;
@@ -280,14 +284,14 @@ void main ()
     /* Put back any unprocessed events */
     vBSP430eventFlagsSet_ni(events);
     if (iBSP430eventFlagsEmpty_ni()) {
-      /* Nothing pending: go to sleep, then jump back to the loop head
-       * when we get woken. */
+      /* Nothing pending: go to sleep in the deepest mode the active
+       * alarms permit, then go back to the loop head when we get
+       * woken. */
       statistics_v.sleep_utt += last_wake_utt - last_sleep_utt;
       last_sleep_utt = ulBSP430uptime_ni();
       statistics_v.awake_utt += last_sleep_utt - last_wake_utt;
       statistics_v.sleep_ct += 1;
-      BSP430_CORE_LPM_ENTER_NI(LPM4_bits | GIE);
-      continue;
+      (void)uiBSP430idleSleep_ni();
     }
     BSP430_CORE_ENABLE_INTERRUPT();
   }
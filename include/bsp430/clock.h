@@ -774,5 +774,9 @@ uiBSP430clockACLK_Hz (void)
 #include <bsp430/periph/cs.h>
 #endif /* BSP430_PERIPH_CS_IS_CS4 */
 #endif /* __MSP430_HAS_CS__ */
+#if defined(__MSP430_HOST__)
+/* The host platform simulator supplies the clock interface */
+#include <bsp430/platform/host/sim.h>
+#endif /* __MSP430_HOST__ */
 
 #endif /* BSP430_CLOCK_H */
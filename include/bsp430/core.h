@@ -366,8 +366,15 @@
 /** Defined to a true value if mspgcc is being used */
 #define BSP430_CORE_TOOLCHAIN_GCC_MSPGCC (1 < __MSPGCC__)
 
+/** Defined to a true value if a native host compiler is being used
+ * to build for #BSP430_PLATFORM_HOST.
+ *
+ * The simulated <msp430.h> used by that platform defines @c
+ * __MSP430_HOST__. */
+#define BSP430_CORE_TOOLCHAIN_HOST (1 == __MSP430_HOST__)
+
 /** Defined to a true value if msp430-elf GCC is being used */
-#define BSP430_CORE_TOOLCHAIN_GCC_MSP430_ELF (BSP430_CORE_TOOLCHAIN_GCC && ! BSP430_CORE_TOOLCHAIN_GCC_MSPGCC)
+#define BSP430_CORE_TOOLCHAIN_GCC_MSP430_ELF (BSP430_CORE_TOOLCHAIN_GCC && ! BSP430_CORE_TOOLCHAIN_GCC_MSPGCC && ! BSP430_CORE_TOOLCHAIN_HOST)
 
 #if (BSP430_CORE_TOOLCHAIN_GCC_MSP430_ELF - 0)
 #define __read_status_register() _get_SR_register()
@@ -480,6 +487,10 @@
 /* Helper function required to make the _Pragma argument a single
  * string literal */
 #define _BSP430_CORE_TOOLCHAIN_TI_PRAGMA(x_) _Pragma(#x_)
+#elif (BSP430_CORE_TOOLCHAIN_HOST - 0)
+/* Handlers are ordinary functions located by name and invoked by the
+ * host simulator */
+#define BSP430_CORE_DECLARE_INTERRUPT(iv_) void
 #else  /* TOOLCHAIN */
 #define BSP430_CORE_DECLARE_INTERRUPT(iv_) void __attribute__((__interrupt__(iv_)))
 #endif /* TOOLCHAIN */
@@ -927,6 +927,13 @@ int iBSP430eusciI2CtxData_rh (hBSP430halSERIAL hal,
                               const uint8_t * tx_data,
                               size_t tx_len);
 
+/** eUSCI-specific implementation of iBSP430i2cTxRxData_rh() */
+int iBSP430eusciI2CtxRxData_rh (hBSP430halSERIAL hal,
+                                const uint8_t * tx_data,
+                                size_t tx_len,
+                                uint8_t * rx_data,
+                                size_t rx_len);
+
 /** Get the HPL handle for a specific EUSCIA instance.
  *
  * @param periph The handle identifier, such as #BSP430_PERIPH_EUSCI_A0.
@@ -273,6 +273,24 @@
  *
  * @section grp_timer_alarm_muxed Multiplexed Alarm Infrastructure
  *
+ * A single dedicated alarm may be shared among any number of
+ * multiplexed alarms (#sBSP430timerMuxAlarm) through
+ * #sBSP430timerMuxSharedAlarm.  By default the active alarms are kept
+ * in a list sorted by due time, so adding or removing an alarm walks
+ * a number of active alarms proportional to their count, all with
+ * interrupts disabled.  Applications with many concurrent alarms can
+ * enable #configBSP430_TIMER_MUXALARM_HEAP to keep them in a binary
+ * heap instead, which examines a number of alarms proportional to
+ * the logarithm of the count.  Each step in the heap does more work
+ * than one in the list, so for few alarms the list may well be
+ * faster; use the @c mux* benchmarks in @c examples/bench to compare
+ * the two on the target before choosing.
+ *
+ * Periodic tasks whose timing is not critical may give their alarms
+ * a window of tolerance through #configBSP430_TIMER_MUXALARM_SLACK.
+ * Alarms whose windows overlap are then notified together, reducing
+ * the number of times the processor leaves low power mode.
+ *
  * @homepage http://github.com/pabigot/bsp430
  * @copyright Copyright 2012-2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
  */
@@ -981,7 +999,10 @@
  *
  * @return -1 (cast to unsigned int) if @p capture_mode is not valid
  * or the timer is unrecognized or stopped.  Otherwise the delta in
- * the counter of the timer over @p count captures. */
+ * the counter of the timer over @p count captures.
+ *
+ * @see hBSP430timerPeriodCaptureInitialize() for a measurement that
+ * does not busy-wait. */
 unsigned int uiBSP430timerCaptureDelta_ni (tBSP430periphHandle periph,
                                            int ccidx,
                                            unsigned int capture_mode,
@@ -1145,8 +1166,9 @@ typedef struct sBSP430halTIMER {
    *
    * @note This field is not marked volatile because doing so costs
    * several extra instructions due to it being a multi-word value.
-   * It should be read and written only when interrupts are
-   * disabled. */
+   * It should be written only when interrupts are disabled, and read
+   * either with interrupts disabled or through
+   * ulBSP430timerCounter(). */
   unsigned long overflow_count;
 
   /** The callback chain to invoke when an overflow interrupt is
@@ -1268,25 +1290,22 @@ unsigned long ulBSP430timerCounter_ni (hBSP430halTIMER timer,
 
 /** Read timer counter regardless of interrupt enable state.
  *
- * This wraps #ulBSP430timerCounter_ni with code that saves the
- * interrupt state, reads the timer, then restores the entry interrupt
- * state prior to returning the timer counts.
- *
- * @warning See warnings at ulBSP430timerCounter_ni().
+ * This produces the same result as ulBSP430timerCounter_ni() but
+ * never disables interrupts, so it adds nothing to the latency of
+ * other interrupts and may be used to time-stamp events from within
+ * interrupt handlers.  Instead of a critical section it reads the
+ * overflow counter, the timer counter, and the pending overflow flag,
+ * then repeats the sequence if the overflow counter changed in the
+ * meantime.  A retry is needed only when the overflow interrupt is
+ * handled during the read, so it occurs at most once per 2^16 timer
+ * ticks.
+ *
+ * @warning See warnings at ulBSP430timerCounter_ni().  The counter
+ * read techniques used underneath tolerate being interrupted by
+ * another read of the same timer.
  */
-static BSP430_CORE_INLINE
-unsigned long
-ulBSP430timerCounter (hBSP430halTIMER timer,
-                      unsigned int * overflowp)
-{
-  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
-  unsigned long rv;
-
-  BSP430_CORE_DISABLE_INTERRUPT();
-  rv = ulBSP430timerCounter_ni(timer, overflowp);
-  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
-  return rv;
-}
+unsigned long ulBSP430timerCounter (hBSP430halTIMER timer,
+                                    unsigned int * overflowp);
 
 /** Return the full-precision counter at the point the timer produced @p ctr
  *
@@ -1308,23 +1327,18 @@ unsigned long long
 ullBSP430timerCorrected (hBSP430halTIMER timer,
                          unsigned int ctr)
 {
-  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
   unsigned int overflow;
-  unsigned int ui;
+  uint16_t ui;
   unsigned long ul;
   unsigned long long ull;
 
-  BSP430_CORE_DISABLE_INTERRUPT();
-  do {
-    ul = ulBSP430timerCounter_ni(timer, &overflow);
-  } while (0);
-  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  ul = ulBSP430timerCounter(timer, &overflow);
   ull = overflow;
-  ull <<= 8 * sizeof(ul);
-  ull += ul;
+  ull <<= 32;
+  ull += (uint32_t)ul;
   ui = ul;
   ui -= ctr;
-  ull -= (long)ui;
+  ull -= ui;
   return ull;
 }
 
@@ -1735,6 +1749,63 @@ int iBSP430timerAlarmCancel (hBSP430timerAlarm alarm)
   return rv;
 }
 
+/** Define to a true value to keep multiplexed alarms in a binary
+ * heap rather than a sorted list.
+ *
+ * With the heap iBSP430timerMuxAlarmAdd_ni(),
+ * iBSP430timerMuxAlarmRemove_ni(), and the processing of each expired
+ * alarm examine a number of alarms proportional to the logarithm of
+ * the number of active alarms, rather than to the number itself.
+ * Whether that shortens the time spent with interrupts disabled
+ * depends on the number of alarms; see @ref grp_timer_alarm_muxed.
+ * The cost is
+ * #BSP430_TIMER_MUXALARM_HEAP_SIZE pointers in each
+ * #sBSP430timerMuxSharedAlarm, which bounds the number of active
+ * alarms, and an index in each #sBSP430timerMuxAlarm.
+ *
+ * Alarms due at the same time are not necessarily notified in the
+ * order they were added.
+ *
+ * @cppflag
+ * @defaulted
+ * @ingroup grp_timer_alarm */
+#ifndef configBSP430_TIMER_MUXALARM_HEAP
+#define configBSP430_TIMER_MUXALARM_HEAP 0
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
+
+/** The maximum number of alarms that may be active in a shared alarm
+ * when #configBSP430_TIMER_MUXALARM_HEAP is enabled.
+ *
+ * @defaulted
+ * @dependency #configBSP430_TIMER_MUXALARM_HEAP
+ * @ingroup grp_timer_alarm */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_TIMER_MUXALARM_HEAP_SIZE)
+#define BSP430_TIMER_MUXALARM_HEAP_SIZE 16
+#endif /* BSP430_TIMER_MUXALARM_HEAP_SIZE */
+
+/** Define to a true value to allow multiplexed alarms to be delayed
+ * so that several of them are notified in a single wakeup.
+ *
+ * This adds sBSP430timerMuxAlarm::slack_tck.  The dedicated alarm is
+ * then set for the earliest time by which some active alarm must be
+ * notified (its setting plus its slack) rather than the earliest
+ * setting, and when it fires every alarm whose setting has been
+ * reached is notified.  An application with several periodic tasks
+ * that tolerate some jitter can thus wake once for all of them
+ * instead of once for each.
+ *
+ * Computing the wakeup time examines each active alarm due before it,
+ * so with large slack values iBSP430timerMuxAlarmAdd_ni() and the
+ * alarm interrupt take time proportional to the number of active
+ * alarms even when #configBSP430_TIMER_MUXALARM_HEAP is enabled.
+ *
+ * @cppflag
+ * @defaulted
+ * @ingroup grp_timer_alarm */
+#ifndef configBSP430_TIMER_MUXALARM_SLACK
+#define configBSP430_TIMER_MUXALARM_SLACK 0
+#endif /* configBSP430_TIMER_MUXALARM_SLACK */
+
 /* Forward declaration */
 struct sBSP430timerMuxAlarm;
 
@@ -1752,6 +1823,12 @@ struct sBSP430timerMuxSharedAlarm;
  * callback to re-associate @p alarm with @p shared.  Prior to doing
  * this the @p alarm->setting_tck value should be updated.
  *
+ * With #configBSP430_TIMER_MUXALARM_SLACK the callback may be invoked
+ * as much as @link sBSP430timerMuxAlarm::slack_tck
+ * alarm->slack_tck@endlink after the setting.  A periodic alarm
+ * should advance its setting from the previous setting rather than
+ * the current time so these delays do not accumulate.
+ *
  * @ingroup grp_timer_alarm
  */
 typedef int (* iBSP430timerMuxAlarmCallback_ni) (struct sBSP430timerMuxSharedAlarm * shared,
@@ -1770,8 +1847,26 @@ typedef struct sBSP430timerMuxSharedAlarm {
   sBSP430timerAlarm dedicated;
 
   /** The active multiplexed alarms, sorted by time with earliest
-   * wakeup first. */
+   * wakeup first.
+   *
+   * When #configBSP430_TIMER_MUXALARM_HEAP is enabled this is only
+   * the earliest alarm, or a null pointer if none are active; the
+   * remaining alarms are in @a heap. */
   struct sBSP430timerMuxAlarm * alarms;
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_TIMER_MUXALARM_HEAP - 0)
+  /** The number of active alarms in @a heap.
+   *
+   * @dependency #configBSP430_TIMER_MUXALARM_HEAP */
+  unsigned int heap_len;
+
+  /** The active multiplexed alarms, as a binary heap in which no
+   * alarm is due before its parent.  The children of the alarm at
+   * index @em i are at <em>2i+1</em> and <em>2i+2</em>.
+   *
+   * @dependency #configBSP430_TIMER_MUXALARM_HEAP */
+  struct sBSP430timerMuxAlarm * heap[BSP430_TIMER_MUXALARM_HEAP_SIZE];
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
 } sBSP430timerMuxSharedAlarm;
 
 /** Handle for the underlying shared alarm for multiplixed alarms.
@@ -1796,11 +1891,31 @@ typedef struct sBSP430timerMuxAlarm {
   /** The callback to be invoked when the alarm goes off. */
   iBSP430timerMuxAlarmCallback_ni callback_ni;
 
+#if defined(BSP430_DOXYGEN) || (configBSP430_TIMER_MUXALARM_SLACK - 0)
+  /** The number of ticks past #setting_tck by which notification of
+   * the alarm may be delayed so that it can share a wakeup with other
+   * alarms.  Zero requests notification at #setting_tck.
+   *
+   * As with #setting_tck the value must not be modified while the
+   * alarm is active.
+   *
+   * @dependency #configBSP430_TIMER_MUXALARM_SLACK */
+  unsigned long slack_tck;
+#endif /* configBSP430_TIMER_MUXALARM_SLACK */
+
   /** A link to the next alarm in a chain.
    *
    * User code is only permitted to use this field when the structure
    * is not owned by a shared multiplex alarm. */
   struct sBSP430timerMuxAlarm * next;
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_TIMER_MUXALARM_HEAP - 0)
+  /** The position of the alarm in sBSP430timerMuxSharedAlarm::heap
+   * while it is active.
+   *
+   * @dependency #configBSP430_TIMER_MUXALARM_HEAP */
+  unsigned int heap_idx;
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
 } sBSP430timerMuxAlarm;
 
 /** Handle for an individual multiplixed alarm.
@@ -1881,8 +1996,11 @@ unsigned long ulBSP430timerMuxSharedAlarmCounter (sBSP430timerMuxSharedAlarm * s
  *
  * @return Normally the return value from
  * iBSP430timerAlarmSetForced_ni() when setting for the first
- * multiplexed alarm.  If a negative value appears, the multiplexed
- * alarm structure is in an undefined state.
+ * multiplexed alarm.  -1 is returned without changing @p shared if
+ * #configBSP430_TIMER_MUXALARM_HEAP is enabled and
+ * #BSP430_TIMER_MUXALARM_HEAP_SIZE alarms are already active.  If
+ * any other negative value appears, the multiplexed alarm structure
+ * is in an undefined state.
  *
  * @ingroup grp_timer_alarm */
 int iBSP430timerMuxAlarmAdd_ni (hBSP430timerMuxSharedAlarm shared,
@@ -2256,6 +2374,454 @@ void vBSP430timerPulseCaptureInvertSense_ni (hBSP430timerPulseCapture pulsecap)
   pulsecap->flags_ni = flags;
 }
 
+/** Bit set in sBSP430timerPeriodCapture::flags_ni once an edge has
+ * been captured to mark the start of the first interval. */
+#define BSP430_TIMER_PERIODCAP_SYNCED 0x01
+
+/** Bit set in sBSP430timerPeriodCapture::flags_ni when the requested
+ * number of intervals has been accumulated. */
+#define BSP430_TIMER_PERIODCAP_COMPLETE 0x02
+
+/** Bit set in sBSP430timerPeriodCapture::flags_ni if a capture was
+ * lost because a second edge arrived before the first was processed.
+ * The measurement is stopped, and the accumulated values describe
+ * only the intervals completed before the loss. */
+#define BSP430_TIMER_PERIODCAP_OVERFLOW 0x04
+
+/** Bit set in sBSP430timerPeriodCapture::flags_ni if the callback is
+ * being invoked.  This is used for diagnostics and error checking. */
+#define BSP430_TIMER_PERIODCAP_CALLBACK_ACTIVE 0x0400
+
+/** Bit set in sBSP430timerPeriodCapture::flags_ni if the period
+ * capture infrastructure is enabled (i.e., linked into the interrupt
+ * callback chains). */
+#define BSP430_TIMER_PERIODCAP_ENABLED 0x1000
+
+/** Bit set in sBSP430timerPeriodCapture::flags_ni while a measurement
+ * is in progress (i.e., the interrupt is enabled). */
+#define BSP430_TIMER_PERIODCAP_ACTIVE 0x2000
+
+/* Forward declaration */
+struct sBSP430timerPeriodCapture;
+
+/** Callback invoked when a period measurement completes or is
+ * abandoned due to #BSP430_TIMER_PERIODCAP_OVERFLOW.
+ *
+ * The callback may invoke iBSP430timerPeriodCaptureStart_ni() to
+ * begin another measurement.  A measurement started this way after a
+ * successful one begins at the edge that completed the previous one,
+ * so consecutive measurements cover the input without gaps.
+ *
+ * @param state the state of the period capture.
+ *
+ * @return a value conformant with @ref callback_retval that is used
+ * as the return value from the interrupt callback handling capture
+ * events. */
+typedef int (* iBSP430timerPeriodCaptureCallback_ni) (struct sBSP430timerPeriodCapture * state);
+
+/** Structure containing data related to measuring the period of a
+ * signal on a timer capture input.
+ *
+ * This is an interrupt-driven alternative to
+ * uiBSP430timerCaptureDelta_ni(): the processor may sleep while the
+ * intervals are accumulated, and is notified through the callback
+ * when the measurement is complete.
+ *
+ * Periods are measured in ticks of the timer.  If the timer overflow
+ * interrupt (#TAIE) is enabled the captures are extended to 32 bits
+ * using ulBSP430timerOverflowAdjusted_ni(), so intervals may span
+ * multiple overflows.  Otherwise each interval must be less than
+ * 65536 ticks. */
+typedef struct sBSP430timerPeriodCapture {
+  /** Structure to hook callback into timer interrupt chain.  This
+   * must be the first field in the structure. */
+  sBSP430halISRIndexedChainNode cb;
+
+  /** Handle for the timer HAL used for captures */
+  hBSP430halTIMER hal;
+
+  /** Capture/compare index on @a hal used for captures. */
+  int ccidx;
+
+  /** Callback invoked when the measurement completes or is
+   * abandoned.  This may be a null pointer if the application polls
+   * @a flags_ni instead. */
+  iBSP430timerPeriodCaptureCallback_ni callback_ni;
+
+  /** Flags indicating progress and configuration information.
+   * @warning This field must be treated as @link enh_interrupts_ni
+   * not interrupt-able@endlink while the period capture is enabled. */
+  volatile unsigned int flags_ni;
+
+  /** The number of intervals requested by
+   * iBSP430timerPeriodCaptureStart_ni() */
+  unsigned int count;
+
+  /** The number of intervals accumulated so far */
+  volatile unsigned int intervals_ni;
+
+  /** The timer counter at the most recent capture.  Valid only if
+   * #BSP430_TIMER_PERIODCAP_SYNCED is set. */
+  volatile unsigned long last_tt_ni;
+
+  /** The sum of the accumulated intervals, in timer ticks */
+  volatile unsigned long total_tt_ni;
+
+  /** The shortest accumulated interval, in timer ticks */
+  volatile unsigned long min_tt_ni;
+
+  /** The longest accumulated interval, in timer ticks */
+  volatile unsigned long max_tt_ni;
+} sBSP430timerPeriodCapture;
+
+/** Handle for a structure used to measure the period of a signal */
+typedef struct sBSP430timerPeriodCapture * hBSP430timerPeriodCapture;
+
+/** Configure the @p periodcap structure to measure the period of a
+ * signal.
+ *
+ * Capture/compare register @p ccidx in @p periph is configured to
+ * capture synchronously on @p capture_mode edges of input @p ccis.
+ * The capture interrupt is not enabled by this function.
+ *
+ * As with hBSP430timerPulseCaptureInitialize() the user must
+ * separately configure @p periph to count continuously.
+ *
+ * @param periodcap the structure holding the information about the
+ * period capture.
+ *
+ * @param periph the timer that is to be used for the capture
+ *
+ * @param ccidx the capture/compare index within the timer.
+ *
+ * @param capture_mode the edge detection capture specification, such
+ * as #CM_1.  If this does not identify a capture the initialization
+ * fails.
+ *
+ * @param ccis the capture/compare input source on which the signal
+ * will arrive
+ *
+ * @param callback the callback to be invoked when a measurement
+ * completes.  This may be a NULL pointer.
+ *
+ * @return The period capture handle if successful, or a null handle
+ * if initialization failed. */
+hBSP430timerPeriodCapture
+hBSP430timerPeriodCaptureInitialize (hBSP430timerPeriodCapture periodcap,
+                                     tBSP430periphHandle periph,
+                                     int ccidx,
+                                     unsigned int capture_mode,
+                                     unsigned int ccis,
+                                     iBSP430timerPeriodCaptureCallback_ni callback);
+
+/** Enable or disable an initialized period capture structure.
+ *
+ * @warning This function must @b not be invoked from within an
+ * iBSP430timerPeriodCaptureCallback_ni() as it manipulates the
+ * interrupt callback chains.
+ *
+ * @note If @p enablep is false any measurement in progress is
+ * stopped.  If @p enablep is true no measurement is started.
+ *
+ * @param periodcap a period capture structure initialized using
+ * hBSP430timerPeriodCaptureInitialize().
+ *
+ * @param enablep If true, @p periodcap is linked into the callback
+ * chain for the configured capture/compare register.  If false, it is
+ * removed from that chain.
+ *
+ * @return 0 on success, or a negative error code. */
+int iBSP430timerPeriodCaptureSetEnabled_ni (hBSP430timerPeriodCapture periodcap,
+                                            int enablep);
+
+/** Begin measuring @p count consecutive intervals.
+ *
+ * The accumulated values are cleared and the capture interrupt is
+ * enabled.  The first capture only marks the start of the first
+ * interval, unless this is invoked from the callback of a measurement
+ * that completed successfully, in which case the capture that
+ * completed it is used.
+ *
+ * @param periodcap a period capture structure enabled by
+ * iBSP430timerPeriodCaptureSetEnabled_ni().
+ *
+ * @param count the number of intervals to accumulate.  This must be
+ * positive.
+ *
+ * @return 0 on success, or a negative error code. */
+int iBSP430timerPeriodCaptureStart_ni (hBSP430timerPeriodCapture periodcap,
+                                       unsigned int count);
+
+/** Abandon any measurement in progress.
+ *
+ * The capture interrupt is disabled.  The accumulated values are
+ * retained, and the callback is not invoked.
+ *
+ * @param periodcap a period capture structure enabled by
+ * iBSP430timerPeriodCaptureSetEnabled_ni().
+ *
+ * @return 0 on success, or a negative error code. */
+int iBSP430timerPeriodCaptureStop_ni (hBSP430timerPeriodCapture periodcap);
+
+/** Short-hand to start a period capture using
+ * iBSP430timerPeriodCaptureStart_ni() even if interrupts are enabled.
+ *
+ * @param periodcap a period capture structure enabled by
+ * iBSP430timerPeriodCaptureSetEnabled_ni().
+ *
+ * @param count the number of intervals to accumulate.
+ *
+ * @return 0 if successful, or a negative error code */
+static BSP430_CORE_INLINE
+int
+iBSP430timerPeriodCaptureStart (hBSP430timerPeriodCapture periodcap,
+                                unsigned int count)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  int rv;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rv = iBSP430timerPeriodCaptureStart_ni(periodcap, count);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+/** Calculate the mean of the accumulated intervals.
+ *
+ * This is not maintained by the interrupt handler, so that the
+ * division is performed only when the value is needed.
+ *
+ * @param periodcap the period capture structure.  The pointer must
+ * not be null.
+ *
+ * @return the mean interval in timer ticks, rounded to nearest, or
+ * zero if no intervals have been accumulated. */
+static BSP430_CORE_INLINE
+unsigned long
+ulBSP430timerPeriodCaptureMean_ni (hBSP430timerPeriodCapture periodcap)
+{
+  unsigned int intervals = periodcap->intervals_ni;
+
+  if (0 == intervals) {
+    return 0;
+  }
+  return (periodcap->total_tt_ni + (intervals / 2)) / intervals;
+}
+
+/** Convert a sequence of 16-bit captures into 32-bit timestamps.
+ *
+ * Raw captures, such as those written by DMA, do not record how many
+ * times the timer overflowed between them.  This function
+ * reconstructs the full counter values from the 32-bit time of the
+ * last capture, working backwards under the assumption that
+ * consecutive captures are less than 65536 ticks apart.
+ *
+ * @param end_tt the 32-bit counter value of @p captures[@p count-1],
+ * for example sBSP430timerCaptureDMA::end_tt_ni
+ *
+ * @param captures the raw captured counter values, oldest first
+ *
+ * @param tts where the 32-bit timestamps corresponding to @p captures
+ * are stored
+ *
+ * @param count the number of captures to convert
+ *
+ * @return the timestamp of the first capture, or @p end_tt if @p
+ * count is zero. */
+unsigned long ulBSP430timerExtendCaptures (unsigned long end_tt,
+                                           const uint16_t * captures,
+                                           unsigned long * tts,
+                                           unsigned int count);
+
+/** Define to a true value to enable sBSP430timerCaptureDMA, which
+ * streams capture/compare register values into memory using DMA.
+ *
+ * Capturing each edge through an interrupt, as
+ * #sBSP430timerPulseCapture does, limits edge rates to a few tens of
+ * kHz.  With DMA the CPU is interrupted once per block of captures.
+ *
+ * This requires a 5xx-family DMA controller.  Requesting it enables
+ * #configBSP430_HAL_DMA; the application must add @c periph/dma to
+ * its @c MODULES.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_TIMER_CAPTURE_DMA
+#define configBSP430_TIMER_CAPTURE_DMA 0
+#endif /* configBSP430_TIMER_CAPTURE_DMA */
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_TIMER_CAPTURE_DMA - 0)
+
+/** Bit set in sBSP430timerCaptureDMA::flags_ni if captures were lost,
+ * either because an edge occurred before the DMA controller read the
+ * previous capture (hardware #COV) or because a block completed
+ * before the notification for the previous block was processed.
+ *
+ * @dependency #configBSP430_TIMER_CAPTURE_DMA */
+#define BSP430_TIMER_CAPDMA_OVERRUN 0x01
+
+/** Bit set in sBSP430timerCaptureDMA::flags_ni while captures are
+ * being transferred.
+ *
+ * @dependency #configBSP430_TIMER_CAPTURE_DMA */
+#define BSP430_TIMER_CAPDMA_ACTIVE 0x2000
+
+struct sBSP430timerCaptureDMA;
+
+/** Callback invoked when half of the capture buffer has been filled.
+ *
+ * The callback is invoked from the DMA interrupt.  The DMA controller
+ * is already writing the other half of the buffer, so the captures in
+ * @p half must be consumed or copied before that half is filled.
+ *
+ * @param cdp the capture streaming structure
+ *
+ * @param half 0 if the first half of sBSP430timerCaptureDMA::buffer
+ * is complete, 1 if the second half is complete
+ *
+ * @return as with @link callbacks ISR callbacks@endlink, e.g.
+ * #BSP430_HAL_ISR_CALLBACK_EXIT_LPM to wake the application.
+ *
+ * @dependency #configBSP430_TIMER_CAPTURE_DMA */
+typedef int (* iBSP430timerCaptureDMACallback_ni) (struct sBSP430timerCaptureDMA * cdp,
+                                                   unsigned int half);
+
+/** State for streaming timer captures into a double-buffered ring.
+ *
+ * Each edge on the capture input causes the DMA controller to copy
+ * the capture register into the next slot of @a buffer.  The channel
+ * is configured to fill one half of the buffer at a time; when a half
+ * completes the controller immediately starts on the other half and
+ * the callback is notified of the completed one.
+ *
+ * Only capture/compare registers that can trigger a DMA transfer may
+ * be used.  On most MCUs these are CCR0 and CCR2 of each timer.  The
+ * timer must count overflows (#TAIE with its @HAL interrupt enabled)
+ * so that sBSP430timerCaptureDMA::end_tt_ni can be calculated.
+ *
+ * @dependency #configBSP430_TIMER_CAPTURE_DMA */
+typedef struct sBSP430timerCaptureDMA {
+  /** Function invoked when a half of @a buffer is complete.  If null,
+   * completion returns #BSP430_HAL_ISR_CALLBACK_EXIT_LPM.  This field
+   * is set by the application. */
+  iBSP430timerCaptureDMACallback_ni callback_ni;
+
+  /** The buffer into which captures are written, as provided to
+   * iBSP430timerCaptureDMAConfigure_ni() */
+  uint16_t * buffer;
+
+  /** The number of captures in each half of @a buffer */
+  unsigned int half_len;
+
+  /** Flags indicating progress and errors */
+  volatile unsigned int flags_ni;
+
+  /** The number of halves completed since
+   * iBSP430timerCaptureDMAStart_ni() */
+  volatile unsigned long blocks_ni;
+
+  /** The 32-bit timer counter value of the last capture in each half
+   * of @a buffer, valid once that half has been completed.  Pass this
+   * to ulBSP430timerExtendCaptures() to convert the half to
+   * timestamps. */
+  volatile unsigned long end_tt_ni[2];
+
+  /** @cond DOXYGEN_EXCLUDE */
+  sBSP430halISRIndexedChainNode cb;
+  hBSP430halTIMER timer;
+  unsigned char ccidx;
+  unsigned char channel;
+  unsigned char next_half;
+  /** @endcond */
+} sBSP430timerCaptureDMA;
+
+/** Bind a timer capture/compare register and a DMA channel to a
+ * capture buffer.
+ *
+ * Capture/compare register @p ccidx in @p periph is configured to
+ * capture synchronously on @p capture_mode edges of input @p ccis,
+ * with its interrupt disabled.  The DMA channel is set to be
+ * triggered by that register and linked into its interrupt callback
+ * chain.  No captures are transferred until
+ * iBSP430timerCaptureDMAStart_ni() is invoked.
+ *
+ * @param cdp the structure to be initialized.  The caller must set
+ * sBSP430timerCaptureDMA::callback_ni after this returns.
+ *
+ * @param periph the timer used for captures.  The timer must be
+ * configured separately to count continuously.
+ *
+ * @param ccidx the capture/compare index within the timer
+ *
+ * @param capture_mode the edge detection capture specification, such
+ * as #CM_1
+ *
+ * @param ccis the capture/compare input source
+ *
+ * @param channel the DMA channel used for the transfers
+ *
+ * @param trigger the DMA trigger for the @c CCIFG of @p ccidx on @p
+ * periph.  This is MCU-specific: consult the DMA trigger assignments
+ * table in the device datasheet.
+ *
+ * @param buffer where captures are stored
+ *
+ * @param len the number of captures @p buffer can hold.  This must
+ * be even and at least 2.
+ *
+ * @return 0 if the structure was configured, or -1 if the timer,
+ * capture mode, or buffer length is not supported.
+ *
+ * @dependency #configBSP430_TIMER_CAPTURE_DMA */
+int iBSP430timerCaptureDMAConfigure_ni (sBSP430timerCaptureDMA * cdp,
+                                        tBSP430periphHandle periph,
+                                        int ccidx,
+                                        unsigned int capture_mode,
+                                        unsigned int ccis,
+                                        int channel,
+                                        int trigger,
+                                        uint16_t * buffer,
+                                        unsigned int len);
+
+/** Begin streaming captures into the first half of the buffer.
+ *
+ * Any stream in progress is restarted.  sBSP430timerCaptureDMA::flags_ni
+ * and sBSP430timerCaptureDMA::blocks_ni are cleared.
+ *
+ * @param cdp a structure configured by
+ * iBSP430timerCaptureDMAConfigure_ni()
+ *
+ * @return 0 on success, or a negative error code.
+ *
+ * @dependency #configBSP430_TIMER_CAPTURE_DMA */
+int iBSP430timerCaptureDMAStart_ni (sBSP430timerCaptureDMA * cdp);
+
+/** Stop streaming captures.
+ *
+ * The callback is not invoked for the partially filled half.
+ *
+ * @param cdp a structure configured by
+ * iBSP430timerCaptureDMAConfigure_ni()
+ *
+ * @return the number of captures that were written to the partially
+ * filled half, which is the half following the last one reported to
+ * the callback, or a negative error code.
+ *
+ * @dependency #configBSP430_TIMER_CAPTURE_DMA */
+int iBSP430timerCaptureDMAStop_ni (sBSP430timerCaptureDMA * cdp);
+
+/** Stop streaming and release the DMA channel bound by
+ * iBSP430timerCaptureDMAConfigure_ni().
+ *
+ * @param cdp a configured structure
+ *
+ * @return 0
+ *
+ * @dependency #configBSP430_TIMER_CAPTURE_DMA */
+int iBSP430timerCaptureDMARelease_ni (sBSP430timerCaptureDMA * cdp);
+
+#endif /* configBSP430_TIMER_CAPTURE_DMA */
+
 /* !BSP430! insert=hal_decl */
 /* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [hal_decl] */
 /** Control inclusion of the @HAL interface to #BSP430_PERIPH_TA0
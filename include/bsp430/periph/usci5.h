@@ -1090,6 +1090,13 @@ int iBSP430usci5I2CtxData_rh (hBSP430halSERIAL hal,
                               const uint8_t * tx_data,
                               size_t tx_len);
 
+/** USCI5-specific implementation of iBSP430i2cTxRxData_rh() */
+int iBSP430usci5I2CtxRxData_rh (hBSP430halSERIAL hal,
+                                const uint8_t * tx_data,
+                                size_t tx_len,
+                                uint8_t * rx_data,
+                                size_t rx_len);
+
 /** Get the HPL handle for a specific USCI5 instance.
  *
  * @param periph The handle identifier, such as #BSP430_PERIPH_USCI5_A0.
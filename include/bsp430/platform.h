@@ -52,6 +52,7 @@
  * <li>#BSP430_PLATFORM_SURF</a>
  * <li>#BSP430_PLATFORM_TRXEB</a>
  * <li>#BSP430_PLATFORM_WOLVERINE</a>
+ * <li>#BSP430_PLATFORM_HOST</a>
  * <li>#BSP430_PLATFORM_CUSTOM</a>
  * </ul>
  *
@@ -607,6 +608,28 @@ const char * xBSP430platformPeripheralHelp (tBSP430periphHandle periph, int peri
 /* END AUTOMATICALLY GENERATED CODE [platform_decl_url] */
 /* !BSP430! end=platform_decl_url */
 
+/** Define to a true value if application is being built to run as a
+ * native executable on the development host.
+ *
+ * A true value causes <bsp430/platform.h> to include the corresponding
+ * platform-specific header <bsp430/platform/host/platform.h>.
+ * If you include that header directly, #BSP430_PLATFORM_HOST will be
+ * defined for you.
+ *
+ * A true value also causes <bsp430/platform/bsp430_config.h> to
+ * include <bsp430/platform/host/bsp430_config.h> for you.
+ * You should not include that header directly, as it coordinates with
+ * the generic platform version.
+ *
+ * @defaulted */
+#ifndef BSP430_PLATFORM_HOST
+#define BSP430_PLATFORM_HOST 0
+#endif /* BSP430_PLATFORM_HOST */
+
+#if (BSP430_PLATFORM_HOST - 0)
+#include <bsp430/platform/host/platform.h>
+#endif /* BSP430_PLATFORM_HOST */
+
 /** Define to a true value if application is being built for a custom
  * (out-of-tree) platform.
  *
@@ -54,6 +54,7 @@
  * <li>#BSP430_PLATFORM_SURF</a>
  * <li>#BSP430_PLATFORM_TRXEB</a>
  * <li>#BSP430_PLATFORM_WOLVERINE</a>
+ * <li>#BSP430_PLATFORM_HOST</a>
  * <li>#BSP430_PLATFORM_CUSTOM</a>
  * </ul>
  *
@@ -141,8 +142,9 @@
  *
  * @li #configBSP430_CONSOLE provides a serial console via
  * #BSP430_CONSOLE_SERIAL_PERIPH_HANDLE with the corresponding @HPL,
- * @HAL, and interrupt capabilities enabled.  There are no optional
- * functional resources associated with the console.
+ * @HAL, and interrupt capabilities enabled.  When
+ * #configBSP430_CONSOLE_TX_DMA is requested the DMA @HAL is enabled
+ * as well.
  */
 
 #ifndef BSP430_PLATFORM_BSP430_CONFIG_H
@@ -226,6 +228,10 @@
 /* END AUTOMATICALLY GENERATED CODE [platform_bsp430_config] */
 /* !BSP430! end=platform_bsp430_config */
 
+#if (BSP430_PLATFORM_HOST - 0)
+#include <bsp430/platform/host/bsp430_config.h>
+#endif /* BSP430_PLATFORM_HOST */
+
 #if (BSP430_PLATFORM_CUSTOM - 0)
 #include <bsp430/platform/custom/bsp430_config.h>
 #endif /* BSP430_PLATFORM_CUSTOM */
@@ -329,8 +335,29 @@
 #undef BSP430_WANT_CONFIG_HAL
 #undef BSP430_WANT_CONFIG_HPL
 #undef BSP430_WANT_PERIPH_CPPID
+
+/* DMA-driven transmission uses the DMA HAL and its interrupt */
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+#ifndef configBSP430_HAL_DMA
+#define configBSP430_HAL_DMA 1
+#endif /* configBSP430_HAL_DMA */
+#endif /* configBSP430_CONSOLE_TX_DMA */
 #endif /* configBSP430_CONSOLE */
 
+/* Asynchronous SPI transfers use the DMA HAL and its interrupt */
+#if (configBSP430_SERIAL_SPI_ASYNC - 0)
+#ifndef configBSP430_HAL_DMA
+#define configBSP430_HAL_DMA 1
+#endif /* configBSP430_HAL_DMA */
+#endif /* configBSP430_SERIAL_SPI_ASYNC */
+
+/* DMA capture streaming uses the DMA HAL and its interrupt */
+#if (configBSP430_TIMER_CAPTURE_DMA - 0)
+#ifndef configBSP430_HAL_DMA
+#define configBSP430_HAL_DMA 1
+#endif /* configBSP430_HAL_DMA */
+#endif /* configBSP430_TIMER_CAPTURE_DMA */
+
 #if (configBSP430_TIMER_CCACLK - 0)
 
 #ifndef BSP430_TIMER_CCACLK_PERIPH_CPPID
@@ -0,0 +1,615 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Simulated MCU description for the @c host platform.
+ *
+ * This file stands in for the toolchain-provided <msp430.h> when
+ * BSP430 is built with a native compiler using @c PLATFORM=host.  It
+ * describes a 5xx-family MCU with USCI_A0/A1/B0/B1, Timer_A
+ * instances T0A5/T1A3/T2A3, a T0B7, ports 1 through 8 and J, and a
+ * three-channel DMAX controller.
+ *
+ * Peripheral registers live in a single page of simulated memory
+ * that is established by the host platform before @c main runs.  The
+ * register maps are the standard BSP430 @HPL structures: because @c
+ * unsigned @c int is wider on the host than on the MCU the offsets
+ * within each peripheral differ from the hardware, so the base
+ * addresses are spaced to accommodate the larger structures and the
+ * raw register macros below are defined to match.
+ *
+ * The intrinsics normally provided by the MSP430 toolchain are
+ * declared here and implemented by the host simulator.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_PLATFORM_HOST_MCU_MSP430_H
+#define BSP430_PLATFORM_HOST_MCU_MSP430_H
+
+/* Identify the simulated MCU */
+#define __MSP430_HOST__ 1
+#define __MSP430F5529__ 1
+
+/** Address at which the simulated peripheral page is mapped.  It
+ * must be representable as a positive @c int since peripheral
+ * handles are integers. */
+#define __MSP430_HOST_PERIPH_BASE__ 0x10000000UL
+
+/** Size of the simulated peripheral page. */
+#define __MSP430_HOST_PERIPH_SIZE__ 0x1000
+
+#define __MSP430_HAS_MSP430XV2_CPU__
+#define __MSP430_HAS_SFR__
+#define __MSP430_HAS_WDT_A__
+#define __MSP430_HAS_PORT1_R__
+#define __MSP430_HAS_PORT2_R__
+#define __MSP430_HAS_PORTA_R__
+#define __MSP430_HAS_PORT3_R__
+#define __MSP430_HAS_PORT4_R__
+#define __MSP430_HAS_PORTB_R__
+#define __MSP430_HAS_PORT5_R__
+#define __MSP430_HAS_PORT6_R__
+#define __MSP430_HAS_PORTC_R__
+#define __MSP430_HAS_PORT7_R__
+#define __MSP430_HAS_PORT8_R__
+#define __MSP430_HAS_PORTD_R__
+#define __MSP430_HAS_PORTJ_R__
+#define __MSP430_HAS_T0A5__
+#define __MSP430_HAS_T1A3__
+#define __MSP430_HAS_T2A3__
+#define __MSP430_HAS_T0B7__
+#define __MSP430_HAS_USCI_A0__
+#define __MSP430_HAS_USCI_B0__
+#define __MSP430_HAS_USCI_A1__
+#define __MSP430_HAS_USCI_B1__
+#define __MSP430_HAS_DMAX_3__
+
+#define __MSP430_BASEADDRESS_SFR__ (__MSP430_HOST_PERIPH_BASE__ + 0x0000)
+#define __MSP430_BASEADDRESS_WDT_A__ (__MSP430_HOST_PERIPH_BASE__ + 0x00C0)
+#define __MSP430_BASEADDRESS_PORTA_R__ (__MSP430_HOST_PERIPH_BASE__ + 0x0200)
+#define __MSP430_BASEADDRESS_PORT1_R__ __MSP430_BASEADDRESS_PORTA_R__
+#define __MSP430_BASEADDRESS_PORT2_R__ __MSP430_BASEADDRESS_PORTA_R__
+#define __MSP430_BASEADDRESS_PORTB_R__ (__MSP430_HOST_PERIPH_BASE__ + 0x0220)
+#define __MSP430_BASEADDRESS_PORT3_R__ __MSP430_BASEADDRESS_PORTB_R__
+#define __MSP430_BASEADDRESS_PORT4_R__ __MSP430_BASEADDRESS_PORTB_R__
+#define __MSP430_BASEADDRESS_PORTC_R__ (__MSP430_HOST_PERIPH_BASE__ + 0x0240)
+#define __MSP430_BASEADDRESS_PORT5_R__ __MSP430_BASEADDRESS_PORTC_R__
+#define __MSP430_BASEADDRESS_PORT6_R__ __MSP430_BASEADDRESS_PORTC_R__
+#define __MSP430_BASEADDRESS_PORTD_R__ (__MSP430_HOST_PERIPH_BASE__ + 0x0260)
+#define __MSP430_BASEADDRESS_PORT7_R__ __MSP430_BASEADDRESS_PORTD_R__
+#define __MSP430_BASEADDRESS_PORT8_R__ __MSP430_BASEADDRESS_PORTD_R__
+#define __MSP430_BASEADDRESS_PORTJ_R__ (__MSP430_HOST_PERIPH_BASE__ + 0x0320)
+#define __MSP430_BASEADDRESS_T0A5__ (__MSP430_HOST_PERIPH_BASE__ + 0x0400)
+#define __MSP430_BASEADDRESS_T1A3__ (__MSP430_HOST_PERIPH_BASE__ + 0x0480)
+#define __MSP430_BASEADDRESS_T2A3__ (__MSP430_HOST_PERIPH_BASE__ + 0x0500)
+#define __MSP430_BASEADDRESS_T0B7__ (__MSP430_HOST_PERIPH_BASE__ + 0x0580)
+#define __MSP430_BASEADDRESS_DMAX_3__ (__MSP430_HOST_PERIPH_BASE__ + 0x0600)
+#define __MSP430_BASEADDRESS_USCI_A0__ (__MSP430_HOST_PERIPH_BASE__ + 0x0800)
+#define __MSP430_BASEADDRESS_USCI_B0__ (__MSP430_HOST_PERIPH_BASE__ + 0x0880)
+#define __MSP430_BASEADDRESS_USCI_A1__ (__MSP430_HOST_PERIPH_BASE__ + 0x0900)
+#define __MSP430_BASEADDRESS_USCI_B1__ (__MSP430_HOST_PERIPH_BASE__ + 0x0980)
+
+/* Raw register access.  Offsets reflect the host layout of the
+ * corresponding BSP430 HPL structures; the host simulator verifies
+ * them at compile time.  Word registers are accessed as 16-bit
+ * values, as on the MCU, so a word register that shares its slot
+ * with a neighbor (e.g. P2IV) does not read the neighbor too. */
+#define __MSP430_HOST_SFR8(a_) (*(volatile unsigned char *)(a_))
+#define __MSP430_HOST_SFR16(a_) (*(volatile unsigned short *)(a_))
+
+/* Special function registers */
+#define SFRIE1 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_SFR__ + 0x00)
+#define SFRIFG1 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_SFR__ + 0x04)
+#define SFRRPCR __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_SFR__ + 0x08)
+#define WDTIFG 0x0001
+#define OFIFG 0x0002
+#define VMAIFG 0x0008
+#define NMIIFG 0x0010
+#define ACCVIFG 0x0020
+#define JMBINIFG 0x0040
+#define JMBOUTIFG 0x0080
+
+/* Watchdog */
+#define WDTCTL __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_WDT_A__)
+#define WDTPW 0x5A00
+#define WDTHOLD 0x0080
+#define WDTSSEL0 0x0020
+#define WDTSSEL1 0x0040
+#define WDTTMSEL 0x0010
+#define WDTCNTCL 0x0008
+#define WDTIS0 0x0001
+#define WDTIS1 0x0002
+#define WDTIS2 0x0004
+
+/* Status register */
+#define C 0x0001
+#define Z 0x0002
+#define N 0x0004
+#define V 0x0100
+#define GIE 0x0008
+#define CPUOFF 0x0010
+#define OSCOFF 0x0020
+#define SCG0 0x0040
+#define SCG1 0x0080
+#define LPM0_bits (CPUOFF)
+#define LPM1_bits (SCG0 | CPUOFF)
+#define LPM2_bits (SCG1 | CPUOFF)
+#define LPM3_bits (SCG1 | SCG0 | CPUOFF)
+#define LPM4_bits (SCG1 | SCG0 | OSCOFF | CPUOFF)
+
+#define BIT0 0x0001
+#define BIT1 0x0002
+#define BIT2 0x0004
+#define BIT3 0x0008
+#define BIT4 0x0010
+#define BIT5 0x0020
+#define BIT6 0x0040
+#define BIT7 0x0080
+#define BIT8 0x0100
+#define BIT9 0x0200
+#define BITA 0x0400
+#define BITB 0x0800
+#define BITC 0x1000
+#define BITD 0x2000
+#define BITE 0x4000
+#define BITF 0x8000
+
+/* Digital I/O.  The byte-oriented 5xx layout is identical on the
+ * host. */
+#define P1IN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x00)
+#define P1OUT __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x02)
+#define P1DIR __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x04)
+#define P1REN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x06)
+#define P1DS __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x08)
+#define P1SEL __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x0A)
+#define P1IV __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_PORTA_R__ + 0x0E)
+#define P1IES __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x18)
+#define P1IE __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x1A)
+#define P1IFG __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x1C)
+#define P2IN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x01)
+#define P2OUT __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x03)
+#define P2DIR __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x05)
+#define P2REN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x07)
+#define P2DS __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x09)
+#define P2SEL __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x0B)
+#define P2IV __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_PORTA_R__ + 0x1E)
+#define P2IES __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x19)
+#define P2IE __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x1B)
+#define P2IFG __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTA_R__ + 0x1D)
+#define P3IN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x00)
+#define P3OUT __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x02)
+#define P3DIR __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x04)
+#define P3REN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x06)
+#define P3DS __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x08)
+#define P3SEL __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x0A)
+#define P4IN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x01)
+#define P4OUT __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x03)
+#define P4DIR __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x05)
+#define P4REN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x07)
+#define P4DS __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x09)
+#define P4SEL __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTB_R__ + 0x0B)
+#define P5IN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x00)
+#define P5OUT __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x02)
+#define P5DIR __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x04)
+#define P5REN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x06)
+#define P5DS __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x08)
+#define P5SEL __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x0A)
+#define P6IN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x01)
+#define P6OUT __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x03)
+#define P6DIR __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x05)
+#define P6REN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x07)
+#define P6DS __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x09)
+#define P6SEL __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTC_R__ + 0x0B)
+#define P7IN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x00)
+#define P7OUT __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x02)
+#define P7DIR __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x04)
+#define P7REN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x06)
+#define P7DS __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x08)
+#define P7SEL __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x0A)
+#define P8IN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x01)
+#define P8OUT __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x03)
+#define P8DIR __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x05)
+#define P8REN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x07)
+#define P8DS __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x09)
+#define P8SEL __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTD_R__ + 0x0B)
+#define PJIN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTJ_R__ + 0x00)
+#define PJOUT __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTJ_R__ + 0x02)
+#define PJDIR __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTJ_R__ + 0x04)
+#define PJREN __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTJ_R__ + 0x06)
+#define PJDS __MSP430_HOST_SFR8(__MSP430_BASEADDRESS_PORTJ_R__ + 0x08)
+
+/* Timer_A/Timer_B.  Host layout: CTL 0x00, CCTLn 0x04+4n, R 0x20,
+ * CCRn 0x24+4n, EX0 0x40, IV 0x5C. */
+#define __MSP430_HOST_TIMER_CTL_OFS 0x00
+#define __MSP430_HOST_TIMER_CCTL_OFS(n_) (0x04 + 4 * (n_))
+#define __MSP430_HOST_TIMER_R_OFS 0x20
+#define __MSP430_HOST_TIMER_CCR_OFS(n_) (0x24 + 4 * (n_))
+#define __MSP430_HOST_TIMER_EX0_OFS 0x40
+#define __MSP430_HOST_TIMER_IV_OFS 0x5C
+
+#define TA0CTL __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_CTL_OFS)
+#define TA0CCTL0 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_CCTL_OFS(0))
+#define TA0CCTL1 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_CCTL_OFS(1))
+#define TA0CCTL2 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_CCTL_OFS(2))
+#define TA0R __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_R_OFS)
+#define TA0CCR0 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_CCR_OFS(0))
+#define TA0CCR1 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_CCR_OFS(1))
+#define TA0CCR2 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_CCR_OFS(2))
+#define TA0EX0 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_EX0_OFS)
+#define TA0IV __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0A5__ + __MSP430_HOST_TIMER_IV_OFS)
+#define TA1CTL __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T1A3__ + __MSP430_HOST_TIMER_CTL_OFS)
+#define TA1R __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T1A3__ + __MSP430_HOST_TIMER_R_OFS)
+#define TA1EX0 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T1A3__ + __MSP430_HOST_TIMER_EX0_OFS)
+#define TA1IV __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T1A3__ + __MSP430_HOST_TIMER_IV_OFS)
+#define TA2CTL __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T2A3__ + __MSP430_HOST_TIMER_CTL_OFS)
+#define TA2R __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T2A3__ + __MSP430_HOST_TIMER_R_OFS)
+#define TA2EX0 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T2A3__ + __MSP430_HOST_TIMER_EX0_OFS)
+#define TA2IV __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T2A3__ + __MSP430_HOST_TIMER_IV_OFS)
+#define TB0CTL __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0B7__ + __MSP430_HOST_TIMER_CTL_OFS)
+#define TB0R __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0B7__ + __MSP430_HOST_TIMER_R_OFS)
+#define TB0EX0 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0B7__ + __MSP430_HOST_TIMER_EX0_OFS)
+#define TB0IV __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_T0B7__ + __MSP430_HOST_TIMER_IV_OFS)
+
+#define TASSEL1 0x0200
+#define TASSEL0 0x0100
+#define ID1 0x0080
+#define ID0 0x0040
+#define MC1 0x0020
+#define MC0 0x0010
+#define TACLR 0x0004
+#define TAIE 0x0002
+#define TAIFG 0x0001
+#define TASSEL_0 (0 * 0x100u)
+#define TASSEL_1 (1 * 0x100u)
+#define TASSEL_2 (2 * 0x100u)
+#define TASSEL_3 (3 * 0x100u)
+#define TASSEL__TACLK TASSEL_0
+#define TASSEL__ACLK TASSEL_1
+#define TASSEL__SMCLK TASSEL_2
+#define TASSEL__INCLK TASSEL_3
+#define ID_0 (0 * 0x40u)
+#define ID_1 (1 * 0x40u)
+#define ID_2 (2 * 0x40u)
+#define ID_3 (3 * 0x40u)
+#define MC_0 (0 * 0x10u)
+#define MC_1 (1 * 0x10u)
+#define MC_2 (2 * 0x10u)
+#define MC_3 (3 * 0x10u)
+#define MC__STOP MC_0
+#define MC__UP MC_1
+#define MC__CONTINUOUS MC_2
+#define MC__CONTINOUS MC_2
+#define MC__UPDOWN MC_3
+#define TAIDEX_0 (0 * 0x0001u)
+#define TAIDEX_1 (1 * 0x0001u)
+#define TAIDEX_2 (2 * 0x0001u)
+#define TAIDEX_3 (3 * 0x0001u)
+#define TAIDEX_4 (4 * 0x0001u)
+#define TAIDEX_5 (5 * 0x0001u)
+#define TAIDEX_6 (6 * 0x0001u)
+#define TAIDEX_7 (7 * 0x0001u)
+
+#define TBCLGRP1 0x4000
+#define TBCLGRP0 0x2000
+#define CNTL1 0x1000
+#define CNTL0 0x0800
+#define TBSSEL1 0x0200
+#define TBSSEL0 0x0100
+#define TBCLR 0x0004
+#define TBIE 0x0002
+#define TBIFG 0x0001
+
+#define CM1 0x8000
+#define CM0 0x4000
+#define CCIS1 0x2000
+#define CCIS0 0x1000
+#define SCS 0x0800
+#define SCCI 0x0400
+#define CLLD1 0x0400
+#define CLLD0 0x0200
+#define CAP 0x0100
+#define OUTMOD2 0x0080
+#define OUTMOD1 0x0040
+#define OUTMOD0 0x0020
+#define CCIE 0x0010
+#define CCI 0x0008
+#define OUT 0x0004
+#define COV 0x0002
+#define CCIFG 0x0001
+#define CM_0 (0 * 0x4000u)
+#define CM_1 (1 * 0x4000u)
+#define CM_2 (2 * 0x4000u)
+#define CM_3 (3 * 0x4000u)
+#define CCIS_0 (0 * 0x1000u)
+#define CCIS_1 (1 * 0x1000u)
+#define CCIS_2 (2 * 0x1000u)
+#define CCIS_3 (3 * 0x1000u)
+#define OUTMOD_0 (0 * 0x20u)
+#define OUTMOD_1 (1 * 0x20u)
+#define OUTMOD_2 (2 * 0x20u)
+#define OUTMOD_3 (3 * 0x20u)
+#define OUTMOD_4 (4 * 0x20u)
+#define OUTMOD_5 (5 * 0x20u)
+#define OUTMOD_6 (6 * 0x20u)
+#define OUTMOD_7 (7 * 0x20u)
+
+#define TA0IV_NONE 0x0000
+#define TA0IV_TA0CCR1 0x0002
+#define TA0IV_TA0CCR2 0x0004
+#define TA0IV_TA0CCR3 0x0006
+#define TA0IV_TA0CCR4 0x0008
+#define TA0IV_TA0IFG 0x000E
+
+/* DMA.  Host layout: CTL0..CTL4 0x00-0x10, IV 0x1C, channels from
+ * 0x20 at 0x28 intervals. */
+#define DMACTL0 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_DMAX_3__ + 0x00)
+#define DMACTL1 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_DMAX_3__ + 0x04)
+#define DMACTL2 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_DMAX_3__ + 0x08)
+#define DMACTL3 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_DMAX_3__ + 0x0C)
+#define DMACTL4 __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_DMAX_3__ + 0x10)
+#define DMAIV __MSP430_HOST_SFR16(__MSP430_BASEADDRESS_DMAX_3__ + 0x1C)
+
+#define DMAEN 0x0010
+#define DMAIFG 0x0008
+#define DMAIE 0x0004
+#define DMAABORT 0x0002
+#define DMAREQ 0x0001
+#define DMADSTBYTE 0x0080
+#define DMASRCBYTE 0x0040
+#define DMALEVEL 0x0020
+#define DMADT_0 (0 * 0x1000u)
+#define DMADT_1 (1 * 0x1000u)
+#define DMADT_2 (2 * 0x1000u)
+#define DMADT_3 (3 * 0x1000u)
+#define DMADT_4 (4 * 0x1000u)
+#define DMADT_5 (5 * 0x1000u)
+#define DMADT_6 (6 * 0x1000u)
+#define DMADT_7 (7 * 0x1000u)
+#define DMADSTINCR_0 (0 * 0x0400u)
+#define DMADSTINCR_1 (1 * 0x0400u)
+#define DMADSTINCR_2 (2 * 0x0400u)
+#define DMADSTINCR_3 (3 * 0x0400u)
+#define DMASRCINCR_0 (0 * 0x0100u)
+#define DMASRCINCR_1 (1 * 0x0100u)
+#define DMASRCINCR_2 (2 * 0x0100u)
+#define DMASRCINCR_3 (3 * 0x0100u)
+#define DMARMWDIS 0x0004
+#define ROUNDROBIN 0x0002
+#define ENNMI 0x0001
+#define DMAIV_NONE 0x0000
+#define DMAIV_DMA0IFG 0x0002
+#define DMAIV_DMA1IFG 0x0004
+#define DMAIV_DMA2IFG 0x0006
+
+/* DMA trigger assignments, following the MSP430F5529 */
+#define DMA0TSEL_0 (0 * 0x0001u)
+#define DMA0TSEL__DMAREQ (0 * 0x0001u)
+#define DMA0TSEL__TA0CCR0 (1 * 0x0001u)
+#define DMA0TSEL__TA0CCR2 (2 * 0x0001u)
+#define DMA0TSEL__TA1CCR0 (3 * 0x0001u)
+#define DMA0TSEL__TA1CCR2 (4 * 0x0001u)
+#define DMA0TSEL__TA2CCR0 (5 * 0x0001u)
+#define DMA0TSEL__TA2CCR2 (6 * 0x0001u)
+#define DMA0TSEL__TB0CCR0 (7 * 0x0001u)
+#define DMA0TSEL__TB0CCR2 (8 * 0x0001u)
+#define DMA0TSEL__UCA0RXIFG (16 * 0x0001u)
+#define DMA0TSEL__UCA0TXIFG (17 * 0x0001u)
+#define DMA0TSEL__UCB0RXIFG (18 * 0x0001u)
+#define DMA0TSEL__UCB0TXIFG (19 * 0x0001u)
+#define DMA0TSEL__UCA1RXIFG (20 * 0x0001u)
+#define DMA0TSEL__UCA1TXIFG (21 * 0x0001u)
+#define DMA0TSEL__UCB1RXIFG (22 * 0x0001u)
+#define DMA0TSEL__UCB1TXIFG (23 * 0x0001u)
+#define DMA0TSEL__DMA2IFG (30 * 0x0001u)
+#define DMA0TSEL__DMAE0 (31 * 0x0001u)
+#define DMA1TSEL__DMAREQ (0 * 0x0100u)
+#define DMA1TSEL__UCA0RXIFG (16 * 0x0100u)
+#define DMA1TSEL__UCA0TXIFG (17 * 0x0100u)
+#define DMA1TSEL__UCB0RXIFG (18 * 0x0100u)
+#define DMA1TSEL__UCB0TXIFG (19 * 0x0100u)
+#define DMA1TSEL__UCA1RXIFG (20 * 0x0100u)
+#define DMA1TSEL__UCA1TXIFG (21 * 0x0100u)
+#define DMA1TSEL__UCB1RXIFG (22 * 0x0100u)
+#define DMA1TSEL__UCB1TXIFG (23 * 0x0100u)
+#define DMA2TSEL__DMAREQ (0 * 0x0001u)
+#define DMA2TSEL__UCA0RXIFG (16 * 0x0001u)
+#define DMA2TSEL__UCA0TXIFG (17 * 0x0001u)
+#define DMA2TSEL__UCB0RXIFG (18 * 0x0001u)
+#define DMA2TSEL__UCB0TXIFG (19 * 0x0001u)
+#define DMA2TSEL__UCA1RXIFG (20 * 0x0001u)
+#define DMA2TSEL__UCA1TXIFG (21 * 0x0001u)
+#define DMA2TSEL__UCB1RXIFG (22 * 0x0001u)
+#define DMA2TSEL__UCB1TXIFG (23 * 0x0001u)
+
+/* USCI */
+#define UCPEN 0x80
+#define UCPAR 0x40
+#define UCMSB 0x20
+#define UC7BIT 0x10
+#define UCSPB 0x08
+#define UCMODE1 0x04
+#define UCMODE0 0x02
+#define UCSYNC 0x01
+#define UCCKPH 0x80
+#define UCCKPL 0x40
+#define UCMST 0x08
+#define UCMODE_0 (0 * 0x02u)
+#define UCMODE_1 (1 * 0x02u)
+#define UCMODE_2 (2 * 0x02u)
+#define UCMODE_3 (3 * 0x02u)
+#define UCA10 0x80
+#define UCSLA10 0x40
+#define UCMM 0x20
+
+#define UCSSEL1 0x80
+#define UCSSEL0 0x40
+#define UCRXEIE 0x20
+#define UCBRKIE 0x10
+#define UCDORM 0x08
+#define UCTXADDR 0x04
+#define UCTXBRK 0x02
+#define UCSWRST 0x01
+#define UCSSEL_0 (0 * 0x40u)
+#define UCSSEL_1 (1 * 0x40u)
+#define UCSSEL_2 (2 * 0x40u)
+#define UCSSEL_3 (3 * 0x40u)
+#define UCSSEL__UCLK UCSSEL_0
+#define UCSSEL__ACLK UCSSEL_1
+#define UCSSEL__SMCLK UCSSEL_2
+#define UCTR 0x10
+#define UCTXNACK 0x08
+#define UCTXSTP 0x04
+#define UCTXSTT 0x02
+
+#define UCBRF3 0x80
+#define UCBRF2 0x40
+#define UCBRF1 0x20
+#define UCBRF0 0x10
+#define UCBRS2 0x08
+#define UCBRS1 0x04
+#define UCBRS0 0x02
+#define UCOS16 0x01
+#define UCBRF_0 (0 * 0x10u)
+#define UCBRF_1 (1 * 0x10u)
+#define UCBRF_2 (2 * 0x10u)
+#define UCBRF_3 (3 * 0x10u)
+#define UCBRF_4 (4 * 0x10u)
+#define UCBRF_5 (5 * 0x10u)
+#define UCBRF_6 (6 * 0x10u)
+#define UCBRF_7 (7 * 0x10u)
+#define UCBRF_8 (8 * 0x10u)
+#define UCBRF_9 (9 * 0x10u)
+#define UCBRF_10 (10 * 0x10u)
+#define UCBRF_11 (11 * 0x10u)
+#define UCBRF_12 (12 * 0x10u)
+#define UCBRF_13 (13 * 0x10u)
+#define UCBRF_14 (14 * 0x10u)
+#define UCBRF_15 (15 * 0x10u)
+#define UCBRS_0 (0 * 0x02u)
+#define UCBRS_1 (1 * 0x02u)
+#define UCBRS_2 (2 * 0x02u)
+#define UCBRS_3 (3 * 0x02u)
+#define UCBRS_4 (4 * 0x02u)
+#define UCBRS_5 (5 * 0x02u)
+#define UCBRS_6 (6 * 0x02u)
+#define UCBRS_7 (7 * 0x02u)
+
+#define UCLISTEN 0x80
+#define UCFE 0x40
+#define UCOE 0x20
+#define UCPE 0x10
+#define UCBRK 0x08
+#define UCRXERR 0x04
+#define UCADDR 0x02
+#define UCIDLE 0x02
+#define UCBUSY 0x01
+#define UCSCLLOW 0x40
+#define UCGC 0x20
+#define UCBBUSY 0x10
+
+#define UCNACKIE 0x20
+#define UCALIE 0x10
+#define UCSTPIE 0x08
+#define UCSTTIE 0x04
+#define UCTXIE 0x02
+#define UCRXIE 0x01
+#define UCNACKIFG 0x20
+#define UCALIFG 0x10
+#define UCSTPIFG 0x08
+#define UCSTTIFG 0x04
+#define UCTXIFG 0x02
+#define UCRXIFG 0x01
+
+#define USCI_NONE 0x0000
+#define USCI_UCRXIFG 0x0002
+#define USCI_UCTXIFG 0x0004
+#define USCI_I2C_UCALIFG 0x0002
+#define USCI_I2C_UCNACKIFG 0x0004
+#define USCI_I2C_UCSTTIFG 0x0006
+#define USCI_I2C_UCSTPIFG 0x0008
+#define USCI_I2C_UCRXIFG 0x000A
+#define USCI_I2C_UCTXIFG 0x000C
+
+/* Interrupt vectors, numbered as on the MSP430F5529.  A higher
+ * number indicates a higher priority. */
+#define RTC_VECTOR (41 * 1u)
+#define PORT2_VECTOR (42 * 1u)
+#define TIMER2_A1_VECTOR (43 * 1u)
+#define TIMER2_A0_VECTOR (44 * 1u)
+#define USCI_B1_VECTOR (45 * 1u)
+#define USCI_A1_VECTOR (46 * 1u)
+#define PORT1_VECTOR (47 * 1u)
+#define TIMER1_A1_VECTOR (48 * 1u)
+#define TIMER1_A0_VECTOR (49 * 1u)
+#define DMA_VECTOR (50 * 1u)
+#define USB_UBM_VECTOR (51 * 1u)
+#define TIMER0_A1_VECTOR (52 * 1u)
+#define TIMER0_A0_VECTOR (53 * 1u)
+#define ADC12_VECTOR (54 * 1u)
+#define USCI_B0_VECTOR (55 * 1u)
+#define USCI_A0_VECTOR (56 * 1u)
+#define WDT_VECTOR (57 * 1u)
+#define TIMER0_B1_VECTOR (58 * 1u)
+#define TIMER0_B0_VECTOR (59 * 1u)
+#define COMP_B_VECTOR (60 * 1u)
+#define UNMI_VECTOR (61 * 1u)
+#define SYSNMI_VECTOR (62 * 1u)
+#define RESET_VECTOR (63 * 1u)
+
+#ifndef __ASSEMBLER__
+
+/* Intrinsics.  On the MCU these are compiler built-ins; on the host
+ * they are provided by the simulator, which uses them as the points
+ * at which the simulated status register changes and pending
+ * interrupts are dispatched. */
+unsigned int __get_interrupt_state (void);
+void __set_interrupt_state (unsigned int istate);
+void __enable_interrupt (void);
+void __disable_interrupt (void);
+void __nop (void);
+void __delay_cycles (unsigned long cycles);
+unsigned int __read_status_register (void);
+void __bis_status_register (unsigned int bits);
+void __bic_status_register (unsigned int bits);
+void __bis_status_register_on_exit (unsigned int bits);
+void __bic_status_register_on_exit (unsigned int bits);
+
+#define __no_operation() __nop()
+#define _NOP() __nop()
+#define _EINT() __enable_interrupt()
+#define _DINT() __disable_interrupt()
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* BSP430_PLATFORM_HOST_MCU_MSP430_H */
@@ -0,0 +1,108 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BSP430_PLATFORM_HOST_PLATFORM_H
+#define BSP430_PLATFORM_HOST_PLATFORM_H
+
+/** @file
+ *
+ * @brief Platform-specific BSP430 configuration directives for native execution on the development host
+ *
+ * This platform builds BSP430 applications as ordinary executables
+ * for the machine doing the build, so that library code and unit
+ * tests can be run without a target board.  Select it with @c
+ * PLATFORM=host; the executable is run with <tt>make run</tt>.
+ *
+ * The simulated MCU resembles an MSP430F5529 wired like the <a
+ * href="http://www.ti.com/tool/msp-exp430f5529lp">MSP-EXP430F5529
+ * USB LaunchPad</a>.  See <bsp430/platform/host/sim.h> for what is
+ * and is not simulated.
+ *
+ * The following platform-specific features are supported: <ul>
+ *
+ * <li> #vBSP430platformSpinForJumper_ni The jumper is simulated as
+ * P2.0, which reads high through its pull-up, so the function returns
+ * immediately.
+ *
+ * <li> The console is on USCI_A1.  Transmitted characters are written
+ * to standard output.
+ *
+ * </ul>
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+/** Unconditionally define this, so as to produce errors if there is a
+ * conflict in definition. */
+#define BSP430_PLATFORM_HOST 1
+
+/** @cond DOXYGEN_EXCLUDE */
+
+/* Available button definitions */
+#define BSP430_PLATFORM_BUTTON0_PORT_PERIPH_HANDLE BSP430_PERIPH_PORT2
+#define BSP430_PLATFORM_BUTTON0_PORT_BIT BIT1
+#define BSP430_PLATFORM_BUTTON1_PORT_PERIPH_HANDLE BSP430_PERIPH_PORT1
+#define BSP430_PLATFORM_BUTTON1_PORT_BIT BIT1
+
+/* Standard LED colors */
+#define BSP430_LED_RED 0
+#define BSP430_LED_GREEN 1
+
+/* How to use ACLK as a capture/compare input source */
+/* Settings for TA2: T2A2 ccis=1 ; clk P2.2 ; cc0 P2.3 ; cc1 P2.4 */
+#ifndef BSP430_TIMER_CCACLK_ACLK_CCIDX
+/* NB: Check against BSP430_TIMER_CCACLK_PERIPH_CPPID in bsp430_config.h */
+#define BSP430_TIMER_CCACLK_ACLK_CCIDX 2
+#endif /* BSP430_TIMER_CCACLK_ACLK_CCIDX */
+#ifndef BSP430_TIMER_CCACLK_ACLK_CCIS
+/* NB: Check against BSP430_TIMER_CCACLK_PERIPH_CPPID in bsp430_config.h */
+#define BSP430_TIMER_CCACLK_ACLK_CCIS CCIS_1
+#endif /* BSP430_TIMER_CCACLK_ACLK_CCIS */
+#ifndef BSP430_TIMER_CCACLK_CLK_PORT_BIT
+/* NB: Check against BSP430_TIMER_CCACLK_CLK_PORT_PERIPH_CPPID in bsp430_config.h */
+#define BSP430_TIMER_CCACLK_CLK_PORT_BIT BIT2
+#endif /* BSP430_TIMER_CCACLK_CLK_PORT_BIT */
+#ifndef BSP430_TIMER_CCACLK_CC0_PORT_BIT
+/* NB: Check against BSP430_TIMER_CCACLK_CC0_PORT_PERIPH_CPPID in bsp430_config.h */
+#define BSP430_TIMER_CCACLK_CC0_PORT_BIT BIT3
+#endif /* BSP430_TIMER_CCACLK_CC0_PORT_BIT */
+#ifndef BSP430_TIMER_CCACLK_CC1_PORT_BIT
+/* NB: Check against BSP430_TIMER_CCACLK_CC1_PORT_PERIPH_CPPID in bsp430_config.h */
+#define BSP430_TIMER_CCACLK_CC1_PORT_BIT BIT4
+#endif /* BSP430_TIMER_CCACLK_CC1_PORT_BIT */
+
+/** @endcond */
+
+/* Include generic file, in case this is being included directly */
+#include <bsp430/platform.h>
+
+#endif /* BSP430_PLATFORM_HOST_PLATFORM_H */
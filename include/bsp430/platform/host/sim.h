@@ -0,0 +1,161 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Peripheral simulation underlying the @c host platform
+ *
+ * On #BSP430_PLATFORM_HOST the peripheral register maps are placed in
+ * a page of memory that is inaccessible to the application.  Each
+ * access to it traps into a simulator which advances a virtual MCLK
+ * cycle counter, brings the simulated peripherals up to date, lets
+ * the access complete, and then applies any side effects such as
+ * starting a UART transmission or clearing a flag because an
+ * interrupt vector register was read.
+ *
+ * Interrupts are dispatched only at the points where a real MCU
+ * would change its status register: the interrupt and status
+ * register intrinsics, #BSP430_CORE_DELAY_CYCLES(), and entry to a
+ * low power mode.  Entering a low power mode advances virtual time to
+ * the next peripheral event; if there is none the application could
+ * never wake and the simulator aborts.
+ *
+ * The simulated peripherals are those used by the BSP430 HAL on
+ * 5xx-family MCUs: Timer_A and Timer_B in compare and software
+ * capture modes, USCI_A and USCI_B in UART and SPI mode, the digital
+ * I/O ports with P1 and P2 interrupts, and the DMAX controller with
+ * software, timer, and USCI triggers.  Bytes transmitted by a UART
+ * are written to standard output.  The unified clock system is not
+ * simulated; this module provides the @ref clock interface directly.
+ *
+ * The simulator supports x86_64 Linux.  Because @c int is 32 bits and
+ * @c long is 64 bits on that host, code that relies on 16-bit
+ * wraparound of @c unsigned @c int arithmetic may behave differently
+ * than on the MCU.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_PLATFORM_HOST_SIM_H
+#define BSP430_PLATFORM_HOST_SIM_H
+
+#include <bsp430/periph.h>
+
+/** @cond DOXYGEN_EXCLUDE */
+#define BSP430_CLOCK_PUC_MCLK_HZ 1048576UL
+#define BSP430_CLOCK_NOMINAL_VLOCLK_HZ 10000U
+#define BSP430_CLOCK_LFXT1_IS_FAULTED_NI() (0)
+#define BSP430_CLOCK_CLEAR_FAULTS_NI() BSP430_CLOCK_OSC_CLEAR_FAULT_NI()
+/** @endcond */
+
+/** Return the number of MCLK cycles simulated since the program
+ * started.
+ *
+ * Time advances when the application accesses a peripheral register,
+ * invokes an intrinsic, delays, or sleeps; it does not reflect time
+ * spent executing host instructions. */
+unsigned long long ullBSP430hostCycles (void);
+
+/** Queue data to be received by a UART-mode USCI.
+ *
+ * The bytes are delivered to the peripheral receive buffer one per
+ * character time, at the configured baud rate, starting after any
+ * previously queued data.
+ *
+ * @param periph the handle of the USCI peripheral, e.g. #BSP430_PERIPH_USCI5_A1
+ *
+ * @param data the bytes to be received
+ *
+ * @param len the number of bytes at @p data
+ *
+ * @return the number of bytes queued, or -1 if @p periph is not a
+ * simulated USCI or the queue is full. */
+int iBSP430hostInjectRx (tBSP430periphHandle periph,
+                         const void * data,
+                         size_t len);
+
+/** Collect the octets transmitted by a UART-mode USCI, or written to
+ * the simulated slave by a USCI operating as an I2C master.
+ *
+ * While a buffer is set, each octet the USCI finishes transmitting is
+ * stored in it rather than written to standard output.  Octets
+ * beyond @p size are counted but discarded.  This lets a test
+ * compare console output with what it expects.
+ *
+ * @param periph the handle of the USCI peripheral, e.g. #BSP430_PERIPH_USCI5_A1
+ *
+ * @param buf where subsequent octets are stored, or a null pointer to
+ * resume writing them to standard output
+ *
+ * @param size the number of octets @p buf can hold
+ *
+ * @return the number of octets transmitted while the previous buffer
+ * was set, or -1 if @p periph is not a simulated USCI */
+long lBSP430hostCaptureTx (tBSP430periphHandle periph,
+                           void * buf,
+                           size_t size);
+
+/** Attach a simulated slave to a USCI operating as an I2C master.
+ *
+ * A START addressed to @p address is acknowledged.  Octets written
+ * by the master are discarded unless collected with
+ * lBSP430hostCaptureTx(); octets read by the master come from
+ * data queued with iBSP430hostInjectRx(), or are 0xFF when none is
+ * queued.  Any other address is not acknowledged.
+ *
+ * @param periph the handle of the USCI peripheral, e.g. #BSP430_PERIPH_USCI5_B0
+ *
+ * @param address the 7-bit slave address, or a negative value to
+ * remove the slave
+ *
+ * @return 0 on success, -1 if @p periph is not a simulated USCI */
+int iBSP430hostSetI2CSlave (tBSP430periphHandle periph,
+                            int address);
+
+/** Drive the external input for pins of a digital I/O port.
+ *
+ * The value is visible in PxIN for pins configured as inputs without
+ * a pull resistor.  Edges that match PxIES on interrupt-capable
+ * ports set the corresponding PxIFG bit.
+ *
+ * @param periph the handle of the port, e.g. #BSP430_PERIPH_PORT1
+ *
+ * @param mask the pins to be changed
+ *
+ * @param value the new levels for the pins in @p mask
+ *
+ * @return 0 on success, -1 if @p periph is not a simulated port */
+int iBSP430hostSetPortInput (tBSP430periphHandle periph,
+                             unsigned char mask,
+                             unsigned char value);
+
+#endif /* BSP430_PLATFORM_HOST_SIM_H */
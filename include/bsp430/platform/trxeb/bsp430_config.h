@@ -70,6 +70,12 @@
 #ifndef BSP430_CONSOLE_SERIAL_PERIPH_CPPID
 #define BSP430_CONSOLE_SERIAL_PERIPH_CPPID BSP430_PERIPH_CPPID_USCI5_A1
 #endif /* BSP430_CONSOLE_SERIAL_PERIPH_CPPID */
+#if ((configBSP430_CONSOLE_TX_DMA - 0)                                   \
+     && (BSP430_CONSOLE_SERIAL_PERIPH_CPPID == BSP430_PERIPH_CPPID_USCI5_A1))
+#ifndef BSP430_CONSOLE_TX_DMA_TRIGGER
+#define BSP430_CONSOLE_TX_DMA_TRIGGER 21 /* UCA1TXIFG */
+#endif /* BSP430_CONSOLE_TX_DMA_TRIGGER */
+#endif /* configBSP430_CONSOLE_TX_DMA */
 #endif /* configBSP430_CONSOLE */
 
 /* How to use ACLK as a capture/compare input source */
@@ -119,6 +119,37 @@
 #define configBSP430_SERIAL_ENABLE_SPI 0
 #endif /* configBSP430_SERIAL_ENABLE_SPI */
 
+/** Define to a true value to enable iBSP430spiTxRxAsync_ni() and
+ * its supporting functions.
+ *
+ * Asynchronous transfers move data between memory and a SPI-configured
+ * USCI_A/USCI_B (5xx) or eUSCI peripheral using a pair of DMA
+ * channels, so the CPU may sleep for the duration of the transaction.
+ * This requires a 5xx-family DMA controller.  Requesting it enables
+ * #configBSP430_HAL_DMA; the application must add @c periph/dma to
+ * its @c MODULES.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_SERIAL_SPI_ASYNC
+#define configBSP430_SERIAL_SPI_ASYNC 0
+#endif /* configBSP430_SERIAL_SPI_ASYNC */
+
+/** Define to a true value to enable iBSP430spiBusSubmit_ni() and its
+ * supporting functions.
+ *
+ * A SPI bus manager queues transactions for several devices that
+ * share one SPI-configured peripheral, asserting each device's chip
+ * select and applying its clock configuration as its transaction
+ * starts.  Transactions run back-to-back from the DMA interrupt.
+ * This requires #configBSP430_SERIAL_SPI_ASYNC.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_SERIAL_SPI_BUS
+#define configBSP430_SERIAL_SPI_BUS 0
+#endif /* configBSP430_SERIAL_SPI_BUS */
+
 /** Default speed for SPI bus transactions when application does not
  * specify divisor.
  *
@@ -150,6 +181,19 @@
 #define configBSP430_SERIAL_ENABLE_I2C 0
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
 
+/** Define to a true value to enable iBSP430i2cSubmit_ni().
+ *
+ * The interrupt-driven I2C engine runs queued
+ * #sBSP430i2cTransaction requests from the serial interrupt handler
+ * of a 5xx USCI_B or eUSCI_B peripheral in master mode.  The
+ * peripheral's HAL interrupt handler must be enabled.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_SERIAL_I2C_ASYNC
+#define configBSP430_SERIAL_I2C_ASYNC 0
+#endif /* configBSP430_SERIAL_I2C_ASYNC */
+
 /** Default speed for I2C bus transactions when application does not
  * specify divisor.
  *
@@ -453,6 +497,320 @@ int iBSP430spiTxRx_rh (hBSP430halSERIAL hal,
   return hal->dispatch->spiTxRx_rh(hal, tx_data, tx_len, rx_len, rx_data);
 }
 
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_SPI_ASYNC - 0)
+
+struct sBSP430spiAsync;
+
+/** Callback invoked when an asynchronous SPI transaction completes.
+ *
+ * The callback is invoked from the DMA interrupt after
+ * sBSP430spiAsync::result has been stored.  It may start another
+ * transaction on the same structure.
+ *
+ * @param ap the structure describing the completed transaction
+ *
+ * @return as with @link callbacks ISR callbacks@endlink, e.g.
+ * #BSP430_HAL_ISR_CALLBACK_EXIT_LPM to wake the application.
+ *
+ * @dependency #configBSP430_SERIAL_SPI_ASYNC */
+typedef int (* iBSP430spiAsyncCallback_ni) (struct sBSP430spiAsync * ap);
+
+/** State for DMA-driven SPI transactions on one serial device.
+ *
+ * Initialize the structure with iBSP430spiAsyncConfigure_ni(), which
+ * records the DMA channels and links the structure into their
+ * interrupt callback chains.  The structure must remain valid until
+ * iBSP430spiAsyncRelease_ni() is invoked.
+ *
+ * @dependency #configBSP430_SERIAL_SPI_ASYNC */
+typedef struct sBSP430spiAsync {
+  /** Function invoked when a transaction completes.  If null,
+   * completion returns #BSP430_HAL_ISR_CALLBACK_EXIT_LPM.  This field
+   * is set by the application. */
+  iBSP430spiAsyncCallback_ni callback_ni;
+
+  /** Zero while a transaction is in progress.  On completion this is
+   * the number of bytes exchanged.  A negative value indicates that
+   * no transaction has been started. */
+  volatile int result;
+
+  /** @cond DOXYGEN_EXCLUDE */
+  sBSP430halISRIndexedChainNode rx_cb;
+  sBSP430halISRIndexedChainNode tx_cb;
+  hBSP430halSERIAL hal;
+  volatile uint8_t * rxbuf;
+  volatile uint8_t * txbuf;
+  volatile uint8_t * ifg;
+  unsigned char rx_channel;
+  unsigned char tx_channel;
+  size_t pending_rx_len;
+  size_t length;
+  uint8_t rx_dummy;
+  uint8_t tx_dummy;
+  /** @endcond */
+} sBSP430spiAsync;
+
+/** Bind DMA channels to a SPI-configured serial device.
+ *
+ * Each transaction uses one DMA channel to move received data out of
+ * the peripheral and one to feed transmitted data into it.  The
+ * trigger values that select the peripheral's receive and transmit
+ * flags are MCU-specific: consult the DMA trigger assignments table
+ * in the device datasheet.  The receive channel should have the
+ * higher priority, i.e. the lower channel number.
+ *
+ * @param ap the structure to be initialized
+ *
+ * @param hal a SPI-configured serial device
+ *
+ * @param rx_channel the DMA channel used for reception
+ *
+ * @param rx_trigger the DMA trigger for the device's @c UCRXIFG
+ *
+ * @param tx_channel the DMA channel used for transmission
+ *
+ * @param tx_trigger the DMA trigger for the device's @c UCTXIFG
+ *
+ * @return 0 if the structure was configured, or -1 if the device or
+ * channels are not supported.
+ *
+ * @dependency #configBSP430_SERIAL_SPI_ASYNC */
+int iBSP430spiAsyncConfigure_ni (sBSP430spiAsync * ap,
+                                 hBSP430halSERIAL hal,
+                                 int rx_channel,
+                                 int rx_trigger,
+                                 int tx_channel,
+                                 int tx_trigger);
+
+/** Release the DMA channels bound by iBSP430spiAsyncConfigure_ni().
+ *
+ * Any transaction in progress is abandoned.
+ *
+ * @param ap a configured structure
+ *
+ * @return 0
+ *
+ * @dependency #configBSP430_SERIAL_SPI_ASYNC */
+int iBSP430spiAsyncRelease_ni (sBSP430spiAsync * ap);
+
+/** Start a SPI transaction that completes in the background.
+ *
+ * This is the asynchronous equivalent of iBSP430spiTxRx_rh(): @p
+ * tx_len octets from @p tx_data are transmitted, followed by @p rx_len
+ * dummy octets, and the responses are stored in @p rx_data.  The
+ * function returns once the DMA channels are armed.  The caller may
+ * sleep in LPM0 until sBSP430spiAsync::result becomes nonzero; the
+ * completion callback (if any) is invoked first.
+ *
+ * Every dummy octet has the value
+ * #BSP430_SERIAL_SPI_READ_TX_BYTE(0).  As with the synchronous call
+ * the device must not have transmit or receive callbacks installed.
+ * The buffers must not be touched until the transaction completes.
+ *
+ * @param ap a structure configured for the device
+ *
+ * @param tx_data as with iBSP430spiTxRx_rh()
+ *
+ * @param tx_len as with iBSP430spiTxRx_rh()
+ *
+ * @param rx_len as with iBSP430spiTxRx_rh()
+ *
+ * @param rx_data as with iBSP430spiTxRx_rh()
+ *
+ * @return 0 if the transaction was started, or -1 if a transaction
+ * is already in progress, the device has callbacks installed, or
+ * there is nothing to transfer.
+ *
+ * @dependency #configBSP430_SERIAL_SPI_ASYNC */
+int iBSP430spiTxRxAsync_ni (sBSP430spiAsync * ap,
+                            const uint8_t * tx_data,
+                            size_t tx_len,
+                            size_t rx_len,
+                            uint8_t * rx_data);
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_SPI_BUS - 0)
+
+#include <bsp430/periph/port.h>
+
+/** Bit in sBSP430spiTransaction::flags requesting that the chip
+ * select remain asserted when the transaction completes successfully.
+ *
+ * The bus then belongs to the device: transactions queued for other
+ * devices are held back until the device submits a transaction
+ * without this flag, which is started ahead of them and releases the
+ * chip select when it completes.  This allows a command and its data
+ * to be exchanged in separate transactions, as with
+ * iBSP430m25pInitiateCommand_rh() followed by
+ * iBSP430m25pCompleteTxRx_rh().
+ *
+ * @dependency #configBSP430_SERIAL_SPI_BUS */
+#define BSP430_SPI_TXN_FLAG_HOLD_CS 0x01
+
+struct sBSP430spiTransaction;
+
+/** Callback invoked when a queued SPI transaction completes.
+ *
+ * The callback is invoked from the DMA interrupt after the device's
+ * chip select has been released, sBSP430spiTransaction::result has
+ * been stored, and the next queued transaction (if any) has been
+ * started.  It may submit further transactions.
+ *
+ * @param tp the completed transaction
+ *
+ * @return as with @link callbacks ISR callbacks@endlink, e.g.
+ * #BSP430_HAL_ISR_CALLBACK_EXIT_LPM to wake the application.
+ *
+ * @dependency #configBSP430_SERIAL_SPI_BUS */
+typedef int (* iBSP430spiTransactionCallback_ni) (struct sBSP430spiTransaction * tp);
+
+/** Description of one SPI transaction for iBSP430spiBusSubmit_ni().
+ *
+ * The transaction asserts (drives low) the device chip select,
+ * transmits #tx_len octets followed by #rx_len dummy octets as with
+ * iBSP430spiTxRxAsync_ni(), and releases the chip select.  The
+ * application fills in the public fields; the structure and its
+ * buffers must remain untouched until #result becomes nonzero.
+ *
+ * @dependency #configBSP430_SERIAL_SPI_BUS */
+typedef struct sBSP430spiTransaction {
+  /** The port controlling the device CS# (chip select inverted)
+   * signal.  The pin must already be configured as an output driven
+   * high.  If null, the chip select is managed by the application. */
+  volatile sBSP430hplPORT * csn_port;
+
+  /** The bit for the device CS# signal on #csn_port */
+  unsigned char csn_bit;
+
+  /** The @p ctl0_byte to be passed to hBSP430serialOpenSPI() */
+  unsigned char ctl0_byte;
+
+  /** The @p ctl1_byte to be passed to hBSP430serialOpenSPI() */
+  unsigned char ctl1_byte;
+
+  /** The @p prescaler to be passed to hBSP430serialOpenSPI() */
+  unsigned int prescaler;
+
+  /** The octets to transmit */
+  const uint8_t * tx_data;
+
+  /** The number of octets to transmit */
+  size_t tx_len;
+
+  /** The number of dummy octets to transmit after #tx_data */
+  size_t rx_len;
+
+  /** Where to store the octets received, or null to discard them.
+   * The space available must be at least #tx_len + #rx_len octets. */
+  uint8_t * rx_data;
+
+  /** Options such as #BSP430_SPI_TXN_FLAG_HOLD_CS */
+  unsigned int flags;
+
+  /** Function invoked on completion.  If null, completion returns
+   * #BSP430_HAL_ISR_CALLBACK_EXIT_LPM. */
+  iBSP430spiTransactionCallback_ni callback_ni;
+
+  /** Zero while the transaction is queued or in progress.  On
+   * success the number of octets exchanged; -1 if the transaction
+   * could not be started. */
+  volatile int result;
+
+  /** @cond DOXYGEN_EXCLUDE */
+  struct sBSP430spiTransaction * next_ni;
+  /** @endcond */
+} sBSP430spiTransaction;
+
+/** State for a SPI bus shared by several devices.
+ *
+ * Initialize the structure with iBSP430spiBusConfigure_ni().
+ *
+ * @dependency #configBSP430_SERIAL_SPI_BUS */
+typedef struct sBSP430spiBus {
+  /** @cond DOXYGEN_EXCLUDE */
+  sBSP430spiAsync async;
+  sBSP430spiTransaction * volatile queue_ni;
+  volatile sBSP430hplPORT * hold_port;
+  unsigned int prescaler;
+  unsigned char ctl0_byte;
+  unsigned char ctl1_byte;
+  unsigned char configured;
+  unsigned char hold_bit;
+  unsigned char held;
+  /** @endcond */
+} sBSP430spiBus;
+
+/** Bind a SPI bus manager to a serial device and its DMA channels.
+ *
+ * The parameters are as with iBSP430spiAsyncConfigure_ni().  The
+ * device need not have been opened: each transaction opens it with
+ * its own configuration when that differs from the one in effect.
+ *
+ * @param bp the structure to be initialized
+ *
+ * @param hal the serial device connected to the bus
+ *
+ * @param rx_channel as with iBSP430spiAsyncConfigure_ni()
+ *
+ * @param rx_trigger as with iBSP430spiAsyncConfigure_ni()
+ *
+ * @param tx_channel as with iBSP430spiAsyncConfigure_ni()
+ *
+ * @param tx_trigger as with iBSP430spiAsyncConfigure_ni()
+ *
+ * @return 0 if the structure was configured, or -1 if the device or
+ * channels are not supported.
+ *
+ * @dependency #configBSP430_SERIAL_SPI_BUS */
+int iBSP430spiBusConfigure_ni (sBSP430spiBus * bp,
+                               hBSP430halSERIAL hal,
+                               int rx_channel,
+                               int rx_trigger,
+                               int tx_channel,
+                               int tx_trigger);
+
+/** Release the DMA channels bound by iBSP430spiBusConfigure_ni().
+ *
+ * Any queued transactions are abandoned with a result of -1, without
+ * invoking their callbacks, and a chip select held by
+ * #BSP430_SPI_TXN_FLAG_HOLD_CS is released.
+ *
+ * @param bp a configured structure
+ *
+ * @return 0
+ *
+ * @dependency #configBSP430_SERIAL_SPI_BUS */
+int iBSP430spiBusRelease_ni (sBSP430spiBus * bp);
+
+/** Queue a SPI transaction on a shared bus.
+ *
+ * The transaction is appended to the bus queue and started
+ * immediately if the bus is idle.  If the bus is held by the device
+ * (see #BSP430_SPI_TXN_FLAG_HOLD_CS) the transaction instead goes to
+ * the head of the queue and starts at once.  Queued transactions are started
+ * from the DMA interrupt as their predecessors complete, so devices
+ * sharing the bus need not coordinate with each other, and the
+ * caller may sleep in LPM0 until sBSP430spiTransaction::result
+ * becomes nonzero.
+ *
+ * Do not use iBSP430spiTxRx_rh() on the device while transactions are
+ * queued.
+ *
+ * @param bp the bus on which the transaction is to be performed
+ *
+ * @param tp the transaction to queue
+ *
+ * @return 0 if the transaction was queued, or -1 if @p tp is empty.
+ * A transaction that fails to start is completed immediately with a
+ * negative sBSP430spiTransaction::result.
+ *
+ * @dependency #configBSP430_SERIAL_SPI_BUS */
+int iBSP430spiBusSubmit_ni (sBSP430spiBus * bp,
+                            sBSP430spiTransaction * tp);
+
+#endif /* configBSP430_SERIAL_SPI_BUS */
+
+#endif /* configBSP430_SERIAL_SPI_ASYNC */
+
 #endif /* configBSP430_SERIAL_ENABLE_SPI */
 
 /** Control the duration of I2C loops waiting for bus conditions.
@@ -648,6 +1006,172 @@ int iBSP430i2cRxData_rh (hBSP430halSERIAL hal,
 {
   return hal->dispatch->i2cRxData_rh(hal, rx_data, rx_len);
 }
+
+/** Write then read using a master I2C-configured device
+ *
+ * This routine transmits @p tx_len octets from @p tx_data, then
+ * issues a repeated START and receives @p rx_len octets into @p
+ * rx_data, followed by a STOP.  This is the register read sequence
+ * expected by most I2C sensors, and avoids the STOP, bus idle wait,
+ * and second address phase incurred by calling iBSP430i2cTxData_rh()
+ * followed by iBSP430i2cRxData_rh().
+ *
+ * If @p tx_len is zero this is equivalent to iBSP430i2cRxData_rh().
+ * If @p rx_len is zero the transmission is terminated by a STOP.
+ *
+ * This routine should only be invoked when @link
+ * sBSP430halSERIAL.tx_cbchain_ni @a hal->tx_cbchain_ni @endlink is
+ * null.
+ *
+ * @warning This routine supports the common case of the MSP430 as
+ * single I2C master.  It will not work for slave operations, and may
+ * not work with multimaster configurations.
+ *
+ * @param hal the serial device over which the data is transmitted and
+ * received
+ *
+ * @param tx_data the data to be transmitted, commonly a register
+ * address
+ *
+ * @param tx_len the number of bytes to transmit
+ *
+ * @param rx_data where to store the data.  The space available must
+ * be at least @p rx_len octets.  This may be the same as @p tx_data.
+ *
+ * @param rx_len the number of bytes expected in response
+ *
+ * @return the total number of bytes stored in @p rx_data (or, if
+ * @p rx_len is zero, the number transmitted), or a negative error
+ * code (see #BSP430_I2C_ERRFLAG_PROTOCOL and
+ * #BSP430_I2C_ERRFLAG_SPINLIMIT).  On failure a STOP is requested and
+ * the error flags are cleared, so the next transaction can proceed.
+ * This function will not return -1, reserving that as a generic error
+ * code for higher-level functions.
+ */
+static BSP430_CORE_INLINE
+int iBSP430i2cTxRxData_rh (hBSP430halSERIAL hal,
+                           const uint8_t * tx_data,
+                           size_t tx_len,
+                           uint8_t * rx_data,
+                           size_t rx_len)
+{
+  return hal->dispatch->i2cTxRxData_rh(hal, tx_data, tx_len, rx_data, rx_len);
+}
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_I2C_ASYNC - 0)
+
+/** Bit in sBSP430i2cTransaction::flags requesting that the read phase
+ * of a transaction follow the write phase with a repeated START
+ * rather than a STOP and a new START.
+ *
+ * This is what most register-addressed sensors expect when reading
+ * from a register.
+ *
+ * @dependency #configBSP430_SERIAL_I2C_ASYNC */
+#define BSP430_I2C_TXN_FLAG_REPEATED_START 0x01
+
+struct sBSP430i2cTransaction;
+
+/** Callback invoked when a queued I2C transaction completes.
+ *
+ * The callback is invoked from the serial interrupt handler after
+ * sBSP430i2cTransaction::result has been stored and the next queued
+ * transaction (if any) has been started.  It may submit further
+ * transactions.
+ *
+ * @param tp the completed transaction
+ *
+ * @return as with @link callbacks ISR callbacks@endlink, e.g.
+ * #BSP430_HAL_ISR_CALLBACK_EXIT_LPM to wake the application.
+ *
+ * @dependency #configBSP430_SERIAL_I2C_ASYNC */
+typedef int (* iBSP430i2cTransactionCallback_ni) (struct sBSP430i2cTransaction * tp);
+
+/** Description of one I2C transaction for iBSP430i2cSubmit_ni().
+ *
+ * A transaction writes #tx_len octets to the slave and then reads
+ * #rx_len octets from it.  Either phase may be empty, but not both.
+ * The application fills in the public fields; the structure and its
+ * buffers must remain untouched until #result becomes nonzero.
+ *
+ * @dependency #configBSP430_SERIAL_I2C_ASYNC */
+typedef struct sBSP430i2cTransaction {
+  /** The slave address.  A negative value uses the slave address
+   * already configured in the peripheral. */
+  int address;
+
+  /** The octets to write */
+  const uint8_t * tx_data;
+
+  /** The number of octets to write */
+  size_t tx_len;
+
+  /** Where to store the octets read */
+  uint8_t * rx_data;
+
+  /** The number of octets to read */
+  size_t rx_len;
+
+  /** Options such as #BSP430_I2C_TXN_FLAG_REPEATED_START */
+  unsigned int flags;
+
+  /** Function invoked on completion.  If null, completion returns
+   * #BSP430_HAL_ISR_CALLBACK_EXIT_LPM. */
+  iBSP430i2cTransactionCallback_ni callback_ni;
+
+  /** Zero while the transaction is queued or in progress.  On
+   * success the total number of octets transferred; on failure a
+   * negative error code as with iBSP430i2cTxData_rh(). */
+  volatile int result;
+
+  /** @cond DOXYGEN_EXCLUDE */
+  struct sBSP430i2cTransaction * next_ni;
+  const uint8_t * txp;
+  size_t tx_rem;
+  uint8_t * rxp;
+  size_t rx_rem;
+  /** @endcond */
+} sBSP430i2cTransaction;
+
+/** Queue an I2C transaction for interrupt-driven execution.
+ *
+ * The transaction is appended to the device's queue and started
+ * immediately if the device is idle.  Each octet is moved by the
+ * serial interrupt handler, so the caller may sleep in LPM0 until
+ * sBSP430i2cTransaction::result becomes nonzero.
+ *
+ * The device must have been opened with hBSP430serialOpenI2C() in
+ * master mode.  Do not mix queued transactions with the polled
+ * iBSP430i2cTxData_rh() and iBSP430i2cRxData_rh() on the same device.
+ *
+ * @note The USCI_B peripheral signals neither the end of a STOP nor
+ * the acknowledgement of an address in master receive mode.  The
+ * engine therefore spins, bounded by #BSP430_I2C_SPIN_LIMIT, for a
+ * STOP to complete before starting a transaction and for the address
+ * to be acknowledged before a single-octet read.
+ *
+ * @param hal the I2C-configured serial device
+ *
+ * @param tp the transaction to queue
+ *
+ * @return 0 if the transaction was queued, or -1 if the device does
+ * not support queued transactions or @p tp is empty.  A transaction
+ * that fails to start is completed immediately with a negative
+ * sBSP430i2cTransaction::result.
+ *
+ * @dependency #configBSP430_SERIAL_I2C_ASYNC */
+int iBSP430i2cSubmit_ni (hBSP430halSERIAL hal,
+                         sBSP430i2cTransaction * tp);
+
+/** @cond DOXYGEN_EXCLUDE */
+/* Used by peripheral interrupt handlers to retire the active
+ * transaction with the given result and start the next one. */
+int iBSP430i2cTransactionComplete_ni_ (hBSP430halSERIAL hal,
+                                       int result);
+/** @endcond */
+
+#endif /* configBSP430_SERIAL_I2C_ASYNC */
+
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
 
 /** Control serial device reset mode.
@@ -187,6 +187,7 @@ struct sBSP430hplUSCI5;
 struct sBSP430hplEUSCIA;
 struct sBSP430hplEUSCIB;
 struct sBSP430serialDispatch;
+struct sBSP430i2cTransaction;
 
 /** Structure holding hardware abstraction layer state for serial
  * devices. */
@@ -288,6 +289,14 @@ typedef struct sBSP430halSERIAL {
    * even if interrupts are enabled. */
   const struct sBSP430halISRVoidChainNode * volatile tx_cbchain_ni;
 
+#if defined(BSP430_DOXYGEN) || ((configBSP430_SERIAL_ENABLE_I2C - 0) && (configBSP430_SERIAL_I2C_ASYNC - 0))
+  /** The queue of I2C transactions submitted through
+   * iBSP430i2cSubmit_ni().  The head is the active transaction.
+   *
+   * @dependency #configBSP430_SERIAL_I2C_ASYNC */
+  struct sBSP430i2cTransaction * volatile i2c_queue_ni;
+#endif /* configBSP430_SERIAL_I2C_ASYNC */
+
   /** Total number of received octets */
   unsigned long num_rx;
 
@@ -334,6 +343,10 @@ struct sBSP430serialDispatch {
   int (* i2cSetAddresses_rh) (hBSP430halSERIAL hal, int own_address, int slave_address);
   int (* i2cRxData_rh) (hBSP430halSERIAL hal, uint8_t * rx_data, size_t rx_len);
   int (* i2cTxData_rh) (hBSP430halSERIAL hal, const uint8_t * tx_data, size_t tx_len);
+  int (* i2cTxRxData_rh) (hBSP430halSERIAL hal, const uint8_t * tx_data, size_t tx_len, uint8_t * rx_data, size_t rx_len);
+#if (configBSP430_SERIAL_I2C_ASYNC - 0)
+  int (* i2cStart_ni) (hBSP430halSERIAL hal);
+#endif /* configBSP430_SERIAL_I2C_ASYNC */
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
   int (* setReset_rh) (hBSP430halSERIAL hal, int resetp);
   int (* setHold_rh) (hBSP430halSERIAL hal, int holdp);
@@ -56,6 +56,8 @@
  *
  * @li @ref grp_utility_cli_completion
  *
+ * @li @ref grp_utility_cli_rpc
+ *
  * See @ref ex_utility_cli for a detailed example demonstrating most
  * capabilities of this module.
  *
@@ -125,6 +127,23 @@
  *
  * @homepage http://github.com/pabigot/bsp430
  * @copyright Copyright 2012-2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ *
+ * @defgroup grp_utility_cli_rpc Binary Remote Procedure Calls
+ *
+ * @brief bsp430/utility/cli.h support for invoking commands from a host program.
+ *
+ * Automated test equipment that issues many commands pays for
+ * formatting arguments as text, parsing them on the MCU, and parsing
+ * the text of the response.  With #configBSP430_CLI_RPC enabled the
+ * same command tree may also be invoked through framed binary
+ * requests that identify the command by its position in the tree and
+ * carry packed arguments.  Request frames are recognized by
+ * iBSP430cliConsoleBufferProcessInput() in the same input stream
+ * used for interactive commands, and are executed by
+ * iBSP430cliConsoleBufferProcessRPC().
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2012-2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
  */
 
 #ifndef BSP430_UTILITY_CLI_H
@@ -171,6 +190,70 @@
 #define configBSP430_CLI_COMMAND_COMPLETION_HELPER 0
 #endif /* configBSP430_CLI_COMMAND_COMPLETION_HELPER */
 
+/** Define to a true value to support command tables.
+ *
+ * A command table is an array of sibling commands sorted by key, as
+ * produced by <c>maintainer/cli-gentable.py</c> from a description
+ * of the command tree.  Setting this to a true value causes the
+ * sBSP430cliCommand::table_len field to be declared.  When a set of
+ * commands begins with a table, iBSP430cliMatchCommand() locates the
+ * commands that match a token with a binary search instead of
+ * comparing the token against every key.  Command sets built by
+ * chaining sBSP430cliCommand::next remain supported, and the two
+ * forms may be mixed at different levels of the tree.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef configBSP430_CLI_COMMAND_TABLE
+#define configBSP430_CLI_COMMAND_TABLE 0
+#endif /* configBSP430_CLI_COMMAND_TABLE */
+
+/** Define to a true value to support binary remote procedure calls.
+ *
+ * In RPC mode a host program invokes commands by their position in
+ * the command tree and exchanges packed binary arguments and results,
+ * avoiding the cost of formatting and parsing text.  Setting this to
+ * a true value causes the sBSP430cliCommand::rpc_handler field to be
+ * declared, and allows iBSP430cliConsoleBufferProcessInput() to
+ * recognize request frames; see iBSP430cliRPCExecute() and
+ * iBSP430cliConsoleBufferProcessRPC().
+ *
+ * A client for host programs is in
+ * <c>maintainer/lib/python/bsp430/clirpc.py</c>.
+ *
+ * @cppflag
+ * @defaulted
+ * @ingroup grp_utility_cli_rpc
+ */
+#ifndef configBSP430_CLI_RPC
+#define configBSP430_CLI_RPC 0
+#endif /* configBSP430_CLI_RPC */
+
+/** The octet that begins an RPC request or reply frame.
+ *
+ * This is the ASCII SOH character, which has no function in the
+ * interactive line editor.  It begins a frame only when received
+ * while the console buffer is empty.
+ *
+ * @dependency #configBSP430_CLI_RPC
+ * @ingroup grp_utility_cli_rpc */
+#define BSP430_CLI_RPC_SOF 0x01
+
+/** The maximum length of the body of an RPC reply frame, including
+ * the status octet.
+ *
+ * The reply is assembled on the stack of
+ * iBSP430cliConsoleBufferProcessRPC(); this bounds the results an
+ * RPC handler may return.
+ *
+ * @defaulted
+ * @dependency #configBSP430_CLI_RPC
+ * @ingroup grp_utility_cli_rpc */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_CLI_RPC_REPLY_SIZE)
+#define BSP430_CLI_RPC_REPLY_SIZE 32
+#endif /* BSP430_CLI_RPC_REPLY_SIZE */
+
 /** Get the next token in the command string.
  *
  * @param commandp pointer to a pointer into an immutable buffer
@@ -417,6 +500,36 @@ typedef int (* iBSP430cliHandlerFunction) (struct sBSP430cliCommandLink * chain,
  */
 typedef int (* iBSP430cliSimpleHandler) (const char * argstr);
 
+/** Type for a function that implements a command invoked through
+ * RPC.
+ *
+ * @param chain as with iBSP430cliHandlerFunction.  The links are
+ * those of the command path in the request.
+ *
+ * @param param as with iBSP430cliHandlerFunction
+ *
+ * @param args the packed arguments from the request.  Multi-octet
+ * values are little-endian.
+ *
+ * @param args_len the number of octets at @p args
+ *
+ * @param result where packed results are to be stored
+ *
+ * @param result_size the space available at @p result
+ *
+ * @return the number of octets stored at @p result, or a negative
+ * value encoding an error.  The negated error is returned to the
+ * client as the reply status.
+ *
+ * @dependency #configBSP430_CLI_RPC
+ * @ingroup grp_utility_cli_rpc */
+typedef int (* iBSP430cliRPCHandlerFunction) (struct sBSP430cliCommandLink * chain,
+                                              void * param,
+                                              const uint8_t * args,
+                                              size_t args_len,
+                                              uint8_t * result,
+                                              size_t result_size);
+
 /** The definition of a command, including the token that identifies
  * it, optional help, subordinate and sibling command structures, and
  * the handler that implements the operation given user input. */
@@ -486,6 +599,32 @@ typedef struct sBSP430cliCommand {
     iBSP430cliSimpleHandler const simple_handler;
   } param;
 
+#if defined(BSP430_DOXYGEN) || (configBSP430_CLI_COMMAND_TABLE - 0)
+  /** The number of commands in the table that begins with this
+   * command.
+   *
+   * If greater than one, this command and the following <tt>table_len
+   * - 1</tt> commands are stored contiguously in memory in increasing
+   * order of key (as compared by strcmp(3)), and
+   * sBSP430cliCommand::next links each to its successor.  The last
+   * command in the table may link to further commands, which are
+   * searched linearly.  Zero indicates a command that does not begin
+   * a table.
+   *
+   * @dependency #configBSP430_CLI_COMMAND_TABLE */
+  unsigned char table_len;
+#endif /* configBSP430_CLI_COMMAND_TABLE */
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_CLI_RPC - 0)
+  /** The handler that implements this command when it is invoked
+   * through RPC.  A null pointer means the command cannot be invoked
+   * that way; sBSP430cliCommand::handler is not used for RPC
+   * requests.
+   *
+   * @dependency #configBSP430_CLI_RPC */
+  iBSP430cliRPCHandlerFunction const rpc_handler;
+#endif /* configBSP430_CLI_RPC */
+
 } sBSP430cliCommand;
 
 /** Callback support for iBSP430cliMatchCommand().  In addition to
@@ -608,6 +747,223 @@ iBSP430cliParseCommand (const sBSP430cliCommand * cmds,
                         iBSP430cliHandlerFunction chain_handler,
                         iBSP430cliHandlerFunction handler);
 
+/** Provider of script text for iBSP430cliExecuteScript().
+ *
+ * The structure may be followed in memory by application-specific
+ * data describing where the script is stored, using the techniques
+ * in @ref callback_appinfo.  sBSP430cliScriptMemory is a provider for
+ * scripts in addressable memory such as flash or FRAM.  A provider
+ * for a script stored in an M25P device might be:
+ *
+ * @code
+ * typedef struct sM25PScript {
+ *   sBSP430cliScriptSource source;
+ *   hBSP430m25p m25p;
+ *   unsigned long base;
+ * } sM25PScript;
+ *
+ * static int
+ * m25p_script_read (const sBSP430cliScriptSource * self,
+ *                   unsigned long offset,
+ *                   char * dst,
+ *                   size_t len)
+ * {
+ *   const sM25PScript * sp = (const sM25PScript *)self;
+ *
+ *   if (0 != iBSP430m25pInitiateAddressCommand_rh(sp->m25p, BSP430_M25P_CMD_FAST_READ, sp->base + offset)) {
+ *     return -1;
+ *   }
+ *   return iBSP430m25pCompleteTxRx_rh(sp->m25p, NULL, 0, len, (uint8_t *)dst);
+ * }
+ * @endcode */
+typedef struct sBSP430cliScriptSource {
+  /** Copy part of the script into a buffer.
+   *
+   * @param self a pointer to the provider structure
+   *
+   * @param offset the offset within the script of the first octet to
+   * be copied
+   *
+   * @param dst where the octets should be stored
+   *
+   * @param len the maximum number of octets to copy
+   *
+   * @return the number of octets stored in @p dst, which is zero only
+   * if @p offset is at or beyond the end of the script, or a negative
+   * value if the script could not be read. */
+  int (* read) (const struct sBSP430cliScriptSource * self,
+                unsigned long offset,
+                char * dst,
+                size_t len);
+} sBSP430cliScriptSource;
+
+/** A script provider for text in addressable memory.  Set
+ * sBSP430cliScriptSource::read to iBSP430cliScriptReadMemory(). */
+typedef struct sBSP430cliScriptMemory {
+  /** The generic provider structure */
+  sBSP430cliScriptSource source;
+
+  /** The first character of the script */
+  const char * script;
+
+  /** The maximum length of the script.  The script may end earlier;
+   * see iBSP430cliExecuteScript(). */
+  size_t script_len;
+} sBSP430cliScriptMemory;
+
+/** The sBSP430cliScriptSource::read function for
+ * sBSP430cliScriptMemory providers. */
+int iBSP430cliScriptReadMemory (const sBSP430cliScriptSource * self,
+                                unsigned long offset,
+                                char * dst,
+                                size_t len);
+
+/** Execute a sequence of commands stored as text.
+ *
+ * The script consists of commands separated by newlines.  It ends at
+ * the end of the text supplied by @p src, or at the first NUL or 0xFF
+ * octet, so a script may be stored in erased flash without recording
+ * its length.  Lines that are blank or that begin with @c # are
+ * ignored.  Each remaining line is copied to @p line and executed as
+ * with iBSP430cliExecuteCommand(), without passing through the
+ * console input buffer.
+ *
+ * @param cmds as with iBSP430cliExecuteCommand()
+ *
+ * @param param as with iBSP430cliExecuteCommand()
+ *
+ * @param src the provider of the script text
+ *
+ * @param line a buffer used to hold each command
+ *
+ * @param line_size the size of @p line.  It must be large enough for
+ * the longest line in the script and a terminating NUL, i.e. lines
+ * may hold at most @p line_size - 1 characters excluding the newline.
+ *
+ * @return the number of commands executed if every command returned
+ * a non-negative value.  Otherwise execution stops at the first
+ * command that returns a negative value, and that value is returned.
+ * A line that does not fit in @p line is diagnosed as
+ * #eBSP430_CLI_ERR_Invalid, and a negative value from
+ * sBSP430cliScriptSource::read is returned directly. */
+int iBSP430cliExecuteScript (const sBSP430cliCommand * cmds,
+                             void * param,
+                             const sBSP430cliScriptSource * src,
+                             char * line,
+                             size_t line_size);
+
+/** Execute the body of an RPC request.
+ *
+ * A request frame is:
+ *
+ * Octets    | Content
+ * :-------- | :---------------
+ * 1         | #BSP430_CLI_RPC_SOF
+ * 1         | @em len, the length of the body
+ * @em len   | the body
+ * 2         | CRC-16/CCITT of @em len and the body, little-endian
+ *
+ * The body begins with @em depth, the number of commands in the path
+ * to the invoked command, followed by @em depth octets each giving
+ * the position of a command within its set of siblings, starting
+ * from zero and following sBSP430cliCommand::next.  (For tables
+ * produced by <c>maintainer/cli-gentable.py</c> this is the index of
+ * the command in increasing order of key.)  The first position is
+ * within @p cmds, and each subsequent position within the
+ * sBSP430cliCommand::child of the previous command.  The remainder of
+ * the body holds the packed arguments.
+ *
+ * The reply frame has the same structure.  Its body is a status octet
+ * followed by the packed results.  The status is zero on success,
+ * and otherwise the error returned by the handler as a
+ * two's-complement octet; e.g. -#eBSP430_CLI_ERR_Unrecognized if a
+ * position does not identify a command.
+ *
+ * The diagnostic function is not invoked for errors detected in RPC
+ * requests.
+ *
+ * @param cmds the top level command set
+ *
+ * @param param passed to the sBSP430cliCommand::rpc_handler
+ *
+ * @param body the request body
+ *
+ * @param body_len the length of @p body
+ *
+ * @param reply where the reply body is stored
+ *
+ * @param reply_size the space available at @p reply, which must be
+ * at least one octet
+ *
+ * @return the length of the reply body stored in @p reply
+ *
+ * @dependency #configBSP430_CLI_RPC
+ * @ingroup grp_utility_cli_rpc */
+#if defined(BSP430_DOXYGEN) || (configBSP430_CLI_RPC - 0)
+size_t xBSP430cliRPCExecute (const sBSP430cliCommand * cmds,
+                             void * param,
+                             const uint8_t * body,
+                             size_t body_len,
+                             uint8_t * reply,
+                             size_t reply_size);
+
+/** Update a CRC-16/CCITT checksum.
+ *
+ * The checksum used in RPC frames uses polynomial 0x1021 without bit
+ * reflection, and begins with 0xFFFF.
+ *
+ * @param crc the checksum of preceding data, or 0xFFFF
+ *
+ * @param data the data to be added to the checksum
+ *
+ * @param len the number of octets at @p data
+ *
+ * @return the updated checksum
+ *
+ * @dependency #configBSP430_CLI_RPC
+ * @ingroup grp_utility_cli_rpc */
+uint16_t uiBSP430cliRPCCRC (uint16_t crc,
+                            const uint8_t * data,
+                            size_t len);
+
+/** RPC handler to read and optionally write an <c>int</c> or
+ * <c>unsigned int</c> variable.
+ *
+ * If @p args is not empty it must hold exactly <c>sizeof(int)</c>
+ * octets, which are stored in the variable.  The reply holds the
+ * value of the variable after any store.  This is the binary
+ * counterpart of iBSP430cliHandlerStoreI() and
+ * iBSP430cliHandlerStoreUI().
+ *
+ * @param chain Pointer to the end of the command chain.  @link
+ * sBSP430cliCommand::uParam::ptr @a chain->cmd->param.ptr @endlink is
+ * expected to be an <c>int *</c> value.
+ *
+ * @dependency #configBSP430_CLI_RPC
+ * @ingroup grp_utility_cli_rpc */
+int iBSP430cliRPCHandlerAccessI (struct sBSP430cliCommandLink * chain,
+                                 void * param,
+                                 const uint8_t * args,
+                                 size_t args_len,
+                                 uint8_t * result,
+                                 size_t result_size);
+
+/** RPC handler to read and optionally write a <c>long</c> or
+ * <c>unsigned long</c> variable.
+ *
+ * As with iBSP430cliRPCHandlerAccessI() but for variables of size
+ * <c>sizeof(long)</c>.
+ *
+ * @dependency #configBSP430_CLI_RPC
+ * @ingroup grp_utility_cli_rpc */
+int iBSP430cliRPCHandlerAccessL (struct sBSP430cliCommandLink * chain,
+                                 void * param,
+                                 const uint8_t * args,
+                                 size_t args_len,
+                                 uint8_t * result,
+                                 size_t result_size);
+#endif /* configBSP430_CLI_RPC */
+
 /** Utility to extract and store a signed 16-bit integer expressed in
  * text.
  *
@@ -1043,6 +1399,12 @@ typedef enum eBSP430cliConsole {
    * processing is in effect. */
   eBSP430cliConsole_ANY_ESCAPE = eBSP430cliConsole_PROCESS_ESCAPE | eBSP430cliConsole_IN_ESCAPE,
 
+  /** Bit set in response if console buffer now holds a complete RPC
+   * request frame.  The application should execute it using
+   * iBSP430cliConsoleBufferProcessRPC(), which also resets the
+   * buffer.  Only produced when #configBSP430_CLI_RPC is enabled. */
+  eBSP430cliConsole_RPC_READY = 0x20,
+
   /** Bit set to signal that the repaint should be followed by a BEL
    * or other indicator.  This is normally used to warn the user that
    * the screen content includes changes not directly entered by the
@@ -1190,9 +1552,14 @@ int iBSP430cliConsoleBufferExtend (const char * text, size_t len);
  * C-w (ETB)      | Kill previous word (erases back to space)
  * Escape (ESC)   | Return #eBSP430cliConsole_PROCESS_ESCAPE
  * Tab (HT)       | Auto-complete based on legal commands (<b>if enabled</b>)
+ * C-a (SOH)      | Begin an RPC request frame if buffer is empty (<b>if enabled</b>)
  *
  * Note that auto-completion is enabled by
- * #configBSP430_CLI_COMMAND_COMPLETION.
+ * #configBSP430_CLI_COMMAND_COMPLETION, and RPC by
+ * #configBSP430_CLI_RPC.  The octets of an RPC request frame are
+ * stored without echo or interpretation, and
+ * #eBSP430cliConsole_RPC_READY is returned when the frame is
+ * complete.
  *
  * When carriage return is pressed, a complete command is recognized,
  * and the function returns even if there is additional data to be
@@ -1210,6 +1577,32 @@ int iBSP430cliConsoleBufferExtend (const char * text, size_t len);
 int iBSP430cliConsoleBufferProcessInput (void);
 #endif /* BSP430_CLI_CONSOLE_BUFFER_SIZE */
 
+/** Execute an RPC request frame held in the console buffer.
+ *
+ * Invoke this when iBSP430cliConsoleBufferProcessInput() returns
+ * #eBSP430cliConsole_RPC_READY.  A frame that fails its checksum, or
+ * that was too long for the console buffer, is discarded without a
+ * reply.  Otherwise the request is executed with
+ * xBSP430cliRPCExecute() and the reply frame is written to the
+ * console without newline translation.  In either case the console
+ * buffer is reset.
+ *
+ * @param cmds the top level command set
+ *
+ * @param param passed to the sBSP430cliCommand::rpc_handler
+ *
+ * @return the reply status (zero or a negative error), or
+ * -#eBSP430_CLI_ERR_Invalid if the frame was discarded
+ *
+ * @dependency #BSP430_CLI_CONSOLE_BUFFER_SIZE
+ * @dependency #configBSP430_CLI_RPC
+ * @ingroup grp_utility_cli_rpc
+ */
+#if defined(BSP430_DOXYGEN) || ((0 < BSP430_CLI_CONSOLE_BUFFER_SIZE) && (configBSP430_CLI_RPC - 0))
+int iBSP430cliConsoleBufferProcessRPC (const sBSP430cliCommand * cmds,
+                                       void * param);
+#endif /* BSP430_CLI_CONSOLE_BUFFER_SIZE && configBSP430_CLI_RPC */
+
 /** Consume any pending escape sequences recorded in @p flags.
  *
  * This utility function allows applications that perform console
@@ -155,8 +155,11 @@
 #endif /* BSP430_CONSOLE_BAUD_RATE */
 
 /** Define this to the size of a buffer to be used for interrupt-driven
- * console input.  The value must not exceed 254, and buffer
- * management is most efficient if the value is a power of 2.
+ * console input.  The value must not exceed 32768.  Buffer indexes
+ * are 8-bit for sizes up to 255 and 16-bit for larger sizes.  Index
+ * wrap uses a mask when the value is a power of 2, which is the most
+ * efficient choice, and a comparison otherwise; it never requires a
+ * division.
  *
  * If this has a value of zero, character input is not interrupt
  * driven.  cgetchar() will return the most recently received
@@ -168,8 +171,11 @@
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 
 /** Define this to the size of a buffer to be used for interrupt-driven
- * console output.  The value must not exceed 254, and buffer
- * management is most efficient if the value is a power of 2.
+ * console output.  The value must not exceed 32768.  Buffer indexes
+ * are 8-bit for sizes up to 255 and 16-bit for larger sizes.  Index
+ * wrap uses a mask when the value is a power of 2, which is the most
+ * efficient choice, and a comparison otherwise; it never requires a
+ * division.
  *
  * If this has a value of zero, character output is not interrupt
  * driven.  cputchar() will block until the UART is ready to accept
@@ -184,6 +190,46 @@
 #define BSP430_CONSOLE_TX_BUFFER_SIZE 0
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 
+/** Define to a true value to drain the console transmit buffer using
+ * DMA rather than the UART transmit interrupt.
+ *
+ * Each contiguous segment of the #BSP430_CONSOLE_TX_BUFFER_SIZE
+ * buffer is moved to the UART by a DMA channel triggered by the UART
+ * transmit flag.  The CPU is interrupted once per segment, when the
+ * channel completes, rather than once per byte.
+ *
+ * This requires a 5xx-family DMA controller, a non-zero
+ * #BSP430_CONSOLE_TX_BUFFER_SIZE, and a definition of
+ * #BSP430_CONSOLE_TX_DMA_TRIGGER.  Requesting it enables
+ * #configBSP430_HAL_DMA; the application must add @c periph/dma to
+ * its @c MODULES.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_CONSOLE_TX_DMA
+#define configBSP430_CONSOLE_TX_DMA 0
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
+/** The DMA channel used when #configBSP430_CONSOLE_TX_DMA is enabled.
+ *
+ * @defaulted */
+#ifndef BSP430_CONSOLE_TX_DMA_CHANNEL
+#define BSP430_CONSOLE_TX_DMA_CHANNEL 0
+#endif /* BSP430_CONSOLE_TX_DMA_CHANNEL */
+
+/** The DMA trigger select value corresponding to the transmit flag of
+ * the console UART, for example 21 for UCA1TXIFG on the MSP430F5529.
+ *
+ * This is an MCU-specific value that depends on
+ * #BSP430_CONSOLE_SERIAL_PERIPH_CPPID.  Platforms supply it in their
+ * <bsp430/platform/bsp430_config.h> for their default console.  It
+ * must be defined when #configBSP430_CONSOLE_TX_DMA is enabled.
+ *
+ * @platformvalue */
+#if defined(BSP430_DOXYGEN)
+#define BSP430_CONSOLE_TX_DMA_TRIGGER platform or application specific
+#endif /* BSP430_DOXYGEN */
+
 /** Define to indicate build infrastructure support for embtextf
  *
  * This flag should be defined to a true value by the build
@@ -303,6 +349,81 @@ void vBSP430consoleSetRxCallback_ni (iBSP430consoleRxCallback_ni cb);
 #define configBSP430_CONSOLE_USE_ONLCR 1
 #endif /* configBSP430_CONSOLE_USE_ONLCR */
 
+/** If defined to a true value, #cprintf is replaced by a macro that
+ * emits a compact binary record instead of formatted text.
+ *
+ * The format string of each call site is placed in a section named
+ * <c>.bsp430_blog</c> that is retained in the ELF image but is not
+ * loaded into the MCU, so it consumes no flash.  The record consists
+ * of #BSP430_CONSOLE_BINARY_LOG_MARKER, the low 16 bits of the
+ * address of the format string in little-endian order, and the raw
+ * bytes of each argument in the target's native representation.  The
+ * linker places a section that is not allocated at address zero, so
+ * the address is the offset of the string within the section; the
+ * section may hold at most 64 KiB of format strings.
+ * Arguments of type <c>char *</c> are transmitted as the
+ * NUL-terminated text they reference.  No formatting is done on the
+ * target.
+ *
+ * The host script <c>maintainer/blog-decode.py</c> reads the format
+ * strings from the ELF image and reconstructs the text from a
+ * captured console stream.  Text emitted through other console
+ * functions passes through the decoder unchanged.
+ *
+ * @warning Floating point arguments are not supported.  At most 15
+ * arguments may follow the format string.  Calls to vcprintf() and to
+ * #cprintf from within the console implementation still format on
+ * the target.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #BSP430_CONSOLE, __GNUC__ */
+#ifndef configBSP430_CONSOLE_BINARY_LOG
+#define configBSP430_CONSOLE_BINARY_LOG 0
+#endif /* configBSP430_CONSOLE_BINARY_LOG */
+
+/** The octet that introduces a binary log record when
+ * #configBSP430_CONSOLE_BINARY_LOG is enabled.  It must not appear in
+ * text written to the console. */
+#define BSP430_CONSOLE_BINARY_LOG_MARKER 0x00
+
+/** Define this to a true value to produce the decimal digits of
+ * #cputl, #cputul, and @c %%lu and @c %%ld conversions by multiplying
+ * with a reciprocal of ten, or to a false value to subtract powers of
+ * ten.  Multiplication is faster only on MCUs with a 32-bit hardware
+ * multiplier.  On a host where @c long has 64 bits a 128-bit integer
+ * type is required.
+ *
+ * @defaulted to true when @c __MSP430_HAS_MPY32__ is defined */
+#ifndef BSP430_CONSOLE_XTOA_RECIPROCAL
+#if defined(__MSP430_HAS_MPY32__)
+#define BSP430_CONSOLE_XTOA_RECIPROCAL 1
+#else /* __MSP430_HAS_MPY32__ */
+#define BSP430_CONSOLE_XTOA_RECIPROCAL 0
+#endif /* __MSP430_HAS_MPY32__ */
+#endif /* BSP430_CONSOLE_XTOA_RECIPROCAL */
+
+/** Define this to the number of records held by the deferred log
+ * ring used by vBSP430consoleLogDeferred_ni().  The value must not
+ * exceed 255.  As with the transmit buffer one slot is kept empty, so
+ * the ring holds one fewer message than this value.
+ *
+ * If this has a value of zero, deferred logging is not available.
+ *
+ * @defaulted */
+#ifndef BSP430_CONSOLE_LOG_DEFERRED_RECORDS
+#define BSP430_CONSOLE_LOG_DEFERRED_RECORDS 0
+#endif /* BSP430_CONSOLE_LOG_DEFERRED_RECORDS */
+
+/** The number of <c>unsigned int</c> words of argument data held by
+ * each deferred log record.  An @c int argument occupies one word on
+ * the MSP430; a @c long or a far pointer occupies two.
+ *
+ * @defaulted */
+#ifndef BSP430_CONSOLE_LOG_DEFERRED_WORDS
+#define BSP430_CONSOLE_LOG_DEFERRED_WORDS 4
+#endif /* BSP430_CONSOLE_LOG_DEFERRED_WORDS */
+
 /** Like puts(3) to the console UART
  *
  * As with #cprintf, interrupts are disabled for the duration of the
@@ -356,10 +477,27 @@ int cputtext (const char * s);
  * @consoleoutput */
 int cputchars (const char * cp, size_t len);
 
+/** Like cputchars() but without newline translation.
+ *
+ * Use this to emit binary data such as framed RPC replies, which must
+ * reach the peer unaltered even when #configBSP430_CONSOLE_USE_ONLCR
+ * is enabled.
+ *
+ * @param data the first of a series of octets to be emitted to the
+ * console
+ *
+ * @param len number of octets to emit
+ *
+ * @return the number of octets written
+ *
+ * @consoleoutput */
+int cputraw (const void * data, size_t len);
+
 #if (defined(BSP430_DOXYGEN)                            \
      || (BSP430_CONSOLE_USE_EMBTEXTF - 0)               \
      || (BSP430_CORE_TOOLCHAIN_LIBC_MSP430_LIBC - 0)    \
-     || (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0))
+     || (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0)         \
+     || (BSP430_CORE_TOOLCHAIN_HOST - 0))
 
 /** Like printf(3), but to the console UART.
  *
@@ -376,6 +514,13 @@ int cputchars (const char * cp, size_t len);
  * if it is disabled; a negative error code if an error is
  * encountered
  *
+ * @note Conversions are performed by embtextf or the C library, not
+ * by the division-free routine behind cputl() and cputul(), because
+ * replacing them would mean reimplementing printf(3) here.  Where
+ * the MCU lacks a hardware divider each @c %%lu costs a 32-bit
+ * division per digit, so time-critical output of counters should use
+ * cputul().
+ *
  * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF, libc
  *
  * @consoleoutput */
@@ -396,7 +541,142 @@ __attribute__((__format__(printf, 1, 2)))
  * @consoleoutput */
 int vcprintf (const char * format, va_list ap);
 
-/** Format an int using itoa and emit it to the console.
+#if (configBSP430_CONSOLE_BINARY_LOG - 0) && ! defined(BSP430_DOXYGEN)
+
+/* Emit a binary log record.  @p codes is a zero-terminated list with
+ * one entry per variable argument: 1 for a string, otherwise the size
+ * of the argument in octets.  @p format is used only for its
+ * address. */
+int iBSP430consoleBinaryLog (const char * format,
+                             const unsigned char * codes,
+                             ...);
+
+#if (BSP430_CORE_TOOLCHAIN_HOST - 0)
+#define BSP430_CONSOLE_BINARY_LOG_ASM_COMMENT_ "#"
+#else /* BSP430_CORE_TOOLCHAIN_HOST */
+#define BSP430_CONSOLE_BINARY_LOG_ASM_COMMENT_ ";"
+#endif /* BSP430_CORE_TOOLCHAIN_HOST */
+
+/* Section flags supplied by the compiler are commented out so the
+ * section is not allocated in the image. */
+#define BSP430_CONSOLE_BINARY_LOG_SECTION_ \
+  ".bsp430_blog,\"\",%progbits " BSP430_CONSOLE_BINARY_LOG_ASM_COMMENT_
+
+#define BSP430_CONSOLE_BINARY_LOG_CODE_(x_)                             \
+  ((__builtin_types_compatible_p(__typeof__((x_) + 0), char *)          \
+    || __builtin_types_compatible_p(__typeof__((x_) + 0), const char *)) \
+   ? 1 : sizeof((x_) + 0))
+
+#define BSP430_CONSOLE_BINARY_LOG_NARGS_(...) \
+  BSP430_CONSOLE_BINARY_LOG_NARGS_N_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BSP430_CONSOLE_BINARY_LOG_NARGS_N_(a0_, a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_, a10_, a11_, a12_, a13_, a14_, a15_, n_, ...) n_
+#define BSP430_CONSOLE_BINARY_LOG_CAT_(a_, b_) a_##b_
+#define BSP430_CONSOLE_BINARY_LOG_XCAT_(a_, b_) BSP430_CONSOLE_BINARY_LOG_CAT_(a_, b_)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_1(f_) ()
+#define BSP430_CONSOLE_BINARY_LOG_CODES_2(f_, a1_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_3(f_, a1_, a2_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_4(f_, a1_, a2_, a3_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_5(f_, a1_, a2_, a3_, a4_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_6(f_, a1_, a2_, a3_, a4_, a5_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_7(f_, a1_, a2_, a3_, a4_, a5_, a6_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_8(f_, a1_, a2_, a3_, a4_, a5_, a6_, a7_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_), BSP430_CONSOLE_BINARY_LOG_CODE_(a7_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_9(f_, a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_), BSP430_CONSOLE_BINARY_LOG_CODE_(a7_), BSP430_CONSOLE_BINARY_LOG_CODE_(a8_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_10(f_, a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_), BSP430_CONSOLE_BINARY_LOG_CODE_(a7_), BSP430_CONSOLE_BINARY_LOG_CODE_(a8_), BSP430_CONSOLE_BINARY_LOG_CODE_(a9_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_11(f_, a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_, a10_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_), BSP430_CONSOLE_BINARY_LOG_CODE_(a7_), BSP430_CONSOLE_BINARY_LOG_CODE_(a8_), BSP430_CONSOLE_BINARY_LOG_CODE_(a9_), BSP430_CONSOLE_BINARY_LOG_CODE_(a10_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_12(f_, a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_, a10_, a11_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_), BSP430_CONSOLE_BINARY_LOG_CODE_(a7_), BSP430_CONSOLE_BINARY_LOG_CODE_(a8_), BSP430_CONSOLE_BINARY_LOG_CODE_(a9_), BSP430_CONSOLE_BINARY_LOG_CODE_(a10_), BSP430_CONSOLE_BINARY_LOG_CODE_(a11_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_13(f_, a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_, a10_, a11_, a12_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_), BSP430_CONSOLE_BINARY_LOG_CODE_(a7_), BSP430_CONSOLE_BINARY_LOG_CODE_(a8_), BSP430_CONSOLE_BINARY_LOG_CODE_(a9_), BSP430_CONSOLE_BINARY_LOG_CODE_(a10_), BSP430_CONSOLE_BINARY_LOG_CODE_(a11_), BSP430_CONSOLE_BINARY_LOG_CODE_(a12_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_14(f_, a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_, a10_, a11_, a12_, a13_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_), BSP430_CONSOLE_BINARY_LOG_CODE_(a7_), BSP430_CONSOLE_BINARY_LOG_CODE_(a8_), BSP430_CONSOLE_BINARY_LOG_CODE_(a9_), BSP430_CONSOLE_BINARY_LOG_CODE_(a10_), BSP430_CONSOLE_BINARY_LOG_CODE_(a11_), BSP430_CONSOLE_BINARY_LOG_CODE_(a12_), BSP430_CONSOLE_BINARY_LOG_CODE_(a13_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_15(f_, a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_, a10_, a11_, a12_, a13_, a14_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_), BSP430_CONSOLE_BINARY_LOG_CODE_(a7_), BSP430_CONSOLE_BINARY_LOG_CODE_(a8_), BSP430_CONSOLE_BINARY_LOG_CODE_(a9_), BSP430_CONSOLE_BINARY_LOG_CODE_(a10_), BSP430_CONSOLE_BINARY_LOG_CODE_(a11_), BSP430_CONSOLE_BINARY_LOG_CODE_(a12_), BSP430_CONSOLE_BINARY_LOG_CODE_(a13_), BSP430_CONSOLE_BINARY_LOG_CODE_(a14_),)
+#define BSP430_CONSOLE_BINARY_LOG_CODES_16(f_, a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_, a10_, a11_, a12_, a13_, a14_, a15_) \
+  (BSP430_CONSOLE_BINARY_LOG_CODE_(a1_), BSP430_CONSOLE_BINARY_LOG_CODE_(a2_), BSP430_CONSOLE_BINARY_LOG_CODE_(a3_), BSP430_CONSOLE_BINARY_LOG_CODE_(a4_), BSP430_CONSOLE_BINARY_LOG_CODE_(a5_), BSP430_CONSOLE_BINARY_LOG_CODE_(a6_), BSP430_CONSOLE_BINARY_LOG_CODE_(a7_), BSP430_CONSOLE_BINARY_LOG_CODE_(a8_), BSP430_CONSOLE_BINARY_LOG_CODE_(a9_), BSP430_CONSOLE_BINARY_LOG_CODE_(a10_), BSP430_CONSOLE_BINARY_LOG_CODE_(a11_), BSP430_CONSOLE_BINARY_LOG_CODE_(a12_), BSP430_CONSOLE_BINARY_LOG_CODE_(a13_), BSP430_CONSOLE_BINARY_LOG_CODE_(a14_), BSP430_CONSOLE_BINARY_LOG_CODE_(a15_),)
+#define BSP430_CONSOLE_BINARY_LOG_UNPAREN_(...) __VA_ARGS__
+
+#define BSP430_CONSOLE_BINARY_LOG_(codes_, format_, ...) __extension__ ({ \
+      static const char bsp430_blog_format_[]                           \
+        __attribute__((__section__(BSP430_CONSOLE_BINARY_LOG_SECTION_))) = format_; \
+      static const unsigned char bsp430_blog_codes_[] =                 \
+        { BSP430_CONSOLE_BINARY_LOG_UNPAREN_ codes_ 0 };                \
+      if (0) {                                                          \
+        /* Retain printf argument checking */                           \
+        (cprintf)(format_, ##__VA_ARGS__);                              \
+      }                                                                 \
+      iBSP430consoleBinaryLog(bsp430_blog_format_, bsp430_blog_codes_, ##__VA_ARGS__); \
+    })
+
+#define cprintf(...)                                                    \
+  BSP430_CONSOLE_BINARY_LOG_(BSP430_CONSOLE_BINARY_LOG_XCAT_(BSP430_CONSOLE_BINARY_LOG_CODES_, \
+                                                             BSP430_CONSOLE_BINARY_LOG_NARGS_(__VA_ARGS__))(__VA_ARGS__), \
+                             __VA_ARGS__)
+
+#endif /* configBSP430_CONSOLE_BINARY_LOG */
+
+#if defined(BSP430_DOXYGEN) || (0 < BSP430_CONSOLE_LOG_DEFERRED_RECORDS)
+
+/** Record a console message to be formatted later.
+ *
+ * The format pointer and the values of its arguments are copied into
+ * a ring of #BSP430_CONSOLE_LOG_DEFERRED_RECORDS records; no
+ * formatting is done and the call never waits for the console.  This
+ * makes it suitable for interrupt handlers and callbacks where
+ * #cprintf would distort timing.  The message is emitted when the
+ * application next calls iBSP430consoleLogDrain().
+ *
+ * Because only pointers are copied, @p format and any @c %%s
+ * arguments must remain valid until the record is drained; in
+ * practice they should be string literals.  The @c hh, @c h, @c l,
+ * @c ll, @c z, @c j, and @c t length modifiers are supported.
+ * Floating point conversions are not; they and the conversions that
+ * follow them are displayed as @c ?, as are arguments that do not fit
+ * in #BSP430_CONSOLE_LOG_DEFERRED_WORDS.  If the
+ * ring is full the message is discarded and counted, and the number
+ * of discarded messages is reported by the next drain.
+ *
+ * @param format A printf(3) format string
+ *
+ * @dependency #BSP430_CONSOLE_LOG_DEFERRED_RECORDS */
+void vBSP430consoleLogDeferred_ni (const char * format, ...)
+#if (__GNUC__ - 0)
+__attribute__((__format__(printf, 1, 2)))
+#endif /* __GNUC__ */
+;
+
+/** Format and emit all messages recorded by
+ * vBSP430consoleLogDeferred_ni().
+ *
+ * This should be called from the application main loop, typically
+ * just before it enters low power mode.  Interrupts are disabled only
+ * while each record is removed from the ring, so handlers may
+ * continue to record messages while the drain is in progress.
+ *
+ * @return the number of records emitted
+ *
+ * @dependency #BSP430_CONSOLE_LOG_DEFERRED_RECORDS
+ *
+ * @consoleoutput */
+int iBSP430consoleLogDrain (void);
+
+#endif /* BSP430_CONSOLE_LOG_DEFERRED_RECORDS */
+
+/** Format an int and emit it to the console.
+ *
+ * Conversion in radix 10 or in a power of two radix does not divide.
+ * In radixes other than 10 a negative value is shown as its two's
+ * complement at the width of int, so <tt>cputi(-1, 16)</tt> emits
+ * @c FFFF on an MSP430.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
@@ -406,10 +686,10 @@ int vcprintf (const char * format, va_list ap);
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF */
+ * @dependency #BSP430_CONSOLE */
 int cputi (int n, int radix);
 
-/** Format an int using utoa and emit it to the console.
+/** Format an unsigned int and emit it to the console.
  *
  * @consoleoutput
  *
@@ -421,12 +701,12 @@ int cputi (int n, int radix);
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF
+ * @dependency #BSP430_CONSOLE
  *
  * @consoleoutput */
 int cputu (unsigned int n, int radix);
 
-/** Format an int using ltoa and emit it to the console.
+/** Format a long and emit it to the console.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
@@ -436,12 +716,14 @@ int cputu (unsigned int n, int radix);
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF
+ * @dependency #BSP430_CONSOLE
  *
  * @consoleoutput */
 int cputl (long n, int radix);
 
-/** Format an int using itoa and emit it to the console.
+/** Format an unsigned long and emit it to the console.
+ *
+ * Conversion in radix 10 or in a power of two radix does not divide.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
@@ -451,7 +733,7 @@ int cputl (long n, int radix);
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF
+ * @dependency #BSP430_CONSOLE
  *
  * @consoleoutput */
 int cputul (unsigned long n, int radix);
@@ -0,0 +1,182 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Select and enter the deepest permissible low power mode
+ *
+ * An event-driven application's main loop processes whatever work is
+ * pending, then sleeps until an interrupt produces more.  The deeper
+ * the low power mode used for that sleep the longer the battery
+ * lasts, but a mode that stops a clock some active peripheral
+ * depends on will lose data or hang the system.  This module makes
+ * that decision in one place:
+ *
+ * @li If any event flags are pending (see iBSP430eventFlagsEmpty_ni())
+ * the processor does not sleep at all.
+ *
+ * @li Each active peripheral that requires a clock registers a
+ * constraint naming the deepest mode in which it can operate, using
+ * vBSP430idleConstraintAdd_ni().  For example, a UART receiving from
+ * an SMCLK-driven baud rate generator would add
+ * #eBSP430idleMode_LPM0, and remove the constraint with
+ * vBSP430idleConstraintRemove_ni() when reception is complete.
+ *
+ * @li If a wakeup time is required, because the application asked
+ * for one or because the multiplexed alarm set registered with
+ * vBSP430idleSetMuxAlarm_ni() has an active alarm, the mode must
+ * preserve the clock of the timer that provides the wakeup: LPM0 for
+ * SMCLK, LPM3 for ACLK.
+ *
+ * The main loop then becomes:
+ *
+ * @code
+ *  while (1) {
+ *    unsigned int events = uiBSP430eventFlagsGet();
+ *    // process events
+ *    BSP430_CORE_DISABLE_INTERRUPT();
+ *    (void)uiBSP430idleSleep_ni();
+ *    BSP430_CORE_ENABLE_INTERRUPT();
+ *  }
+ * @endcode
+ *
+ * Applications using this module must also link the @c utility/event
+ * module and the modules in @c MODULES_UPTIME.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_IDLE_H
+#define BSP430_UTILITY_IDLE_H
+
+#include <bsp430/utility/uptime.h>
+
+/** Low power modes, from shallowest to deepest.
+ *
+ * The value of each enumerated mode is an index, not a set of status
+ * register bits; use uiBSP430idleModeLPMBits() to obtain the latter. */
+typedef enum eBSP430idleMode {
+  /** The processor must not sleep */
+  eBSP430idleMode_ACTIVE,
+  /** CPU and MCLK are off; SMCLK and ACLK remain active */
+  eBSP430idleMode_LPM0,
+  /** As LPM0, but the FLL is disabled */
+  eBSP430idleMode_LPM1,
+  /** SMCLK is off; ACLK remains active */
+  eBSP430idleMode_LPM2,
+  /** As LPM2, but the FLL is disabled */
+  eBSP430idleMode_LPM3,
+  /** All clocks are off; only external interrupts wake the processor */
+  eBSP430idleMode_LPM4,
+} eBSP430idleMode;
+
+/** Return the status register bits that enter a low power mode.
+ *
+ * @param mode the mode of interest
+ *
+ * @return the corresponding value such as #LPM3_bits, or zero for
+ * #eBSP430idleMode_ACTIVE.  #GIE is not included. */
+unsigned int uiBSP430idleModeLPMBits (eBSP430idleMode mode);
+
+/** Record that an active peripheral cannot operate in a mode deeper
+ * than @p mode.
+ *
+ * Constraints are counted, so each call must be balanced by a call to
+ * vBSP430idleConstraintRemove_ni() with the same mode.  This function
+ * may be invoked from interrupt handlers.
+ *
+ * @param mode the deepest mode in which the peripheral operates
+ * correctly */
+void vBSP430idleConstraintAdd_ni (eBSP430idleMode mode);
+
+/** Release a constraint added by vBSP430idleConstraintAdd_ni().
+ *
+ * @param mode the mode that was passed when the constraint was
+ * added */
+void vBSP430idleConstraintRemove_ni (eBSP430idleMode mode);
+
+/** Identify the multiplexed alarm set whose active alarms must be
+ * able to wake the processor.
+ *
+ * @param shared the shared alarm returned by
+ * hBSP430timerMuxAlarmStartup(), or a null pointer to stop
+ * considering multiplexed alarms. */
+void vBSP430idleSetMuxAlarm_ni (hBSP430timerMuxSharedAlarm shared);
+
+/** Return the deepest mode in which the processor may sleep now.
+ *
+ * This accounts for pending event flags, registered constraints, and
+ * the multiplexed alarm set, but not any application wakeup time.
+ *
+ * @param timer if not null, a timer that must continue to count
+ * while sleeping.  Its clock source further limits the mode.
+ *
+ * @return the deepest permissible mode, which is
+ * #eBSP430idleMode_ACTIVE if event flags are pending. */
+eBSP430idleMode xBSP430idleDeepestMode_ni (hBSP430halTIMER timer);
+
+/** Sleep in the deepest permissible mode until an interrupt wakes the
+ * processor.
+ *
+ * If an active multiplexed alarm exists the sleep lasts no longer
+ * than the time until it fires.  Otherwise the wakeup must come from
+ * some other interrupt.
+ *
+ * @note As with lBSP430uptimeSleepUntil(), interrupts are enabled
+ * during the sleep and disabled again on return.
+ *
+ * @return the status register bits used for the sleep (without
+ * #GIE), or zero if the processor did not sleep because event flags
+ * were pending or a constraint of #eBSP430idleMode_ACTIVE is
+ * registered. */
+unsigned int uiBSP430idleSleep_ni (void);
+
+/** As with uiBSP430idleSleep_ni(), but the sleep also ends when the
+ * uptime clock reaches @p wake_utt.
+ *
+ * The uptime timer is subject to the same clock source restriction
+ * as the multiplexed alarm timer.
+ *
+ * @param wake_utt the uptime at which the application wishes to be
+ * awakened if no interrupt occurs first
+ *
+ * @return as with uiBSP430idleSleep_ni(); also zero if the processor
+ * did not sleep because @p wake_utt is less than
+ * #BSP430_TIMER_ALARM_FUTURE_LIMIT ticks away or the wakeup alarm
+ * could not be set.
+ *
+ * @dependency #configBSP430_UPTIME_DELAY */
+#if defined(BSP430_DOXYGEN) || (configBSP430_UPTIME_DELAY - 0)
+unsigned int uiBSP430idleSleepUntil_ni (unsigned long wake_utt);
+#endif /* configBSP430_UPTIME_DELAY */
+
+#endif /* BSP430_UTILITY_IDLE_H */
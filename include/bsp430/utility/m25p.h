@@ -55,6 +55,13 @@
  * interrupt-driven SPI transactions, or DMA, based on the
  * application's needs.
  *
+ * When #configBSP430_SERIAL_SPI_BUS is enabled the device may instead
+ * be attached to an sBSP430spiBus shared with other devices by
+ * setting sBSP430m25p::bus.  The module functions then perform their
+ * exchanges as queued transactions, sleeping in LPM0 with interrupts
+ * enabled until each completes, and the chip select is managed by
+ * the bus.
+ *
  * @note The commands constants defined in this module (e.g.,
  * #BSP430_M25P_CMD_PW) cover all known M25P implementations.  Not all
  * commands are supported on all devices.
@@ -220,6 +227,20 @@ typedef struct sBSP430m25p {
   /** The bit identifying the rstn_port peripheral port pin that
    * controls the device RESET# signal. */
   uint8_t rstn_bit;
+#if defined(BSP430_DOXYGEN) || (configBSP430_SERIAL_SPI_BUS - 0)
+  /** A shared SPI bus through which the device is accessed.  If
+   * provided, #spi is ignored and hBSP430m25pInitialize() records
+   * the SPI configuration for use in the device's transactions
+   * instead of opening a peripheral.
+   *
+   * @dependency #configBSP430_SERIAL_SPI_BUS */
+  sBSP430spiBus * bus;
+  /** @cond DOXYGEN_EXCLUDE */
+  unsigned int prescaler;
+  unsigned char ctl0_byte;
+  unsigned char ctl1_byte;
+  /** @endcond */
+#endif /* configBSP430_SERIAL_SPI_BUS */
 } sBSP430m25p;
 
 /** Handle used to access an M25P-based serial SPI flash device. */
@@ -464,6 +485,10 @@ int iBSP430m25pInitiateAddressCommand_rh (hBSP430m25p dev,
  * initiated by iBSP430m25pInitiateCommand_rh() or
  * iBSP430m25pInitiateAddressCommand_rh().
  *
+ * For a device on a shared sBSP430m25p::bus the initiating call holds
+ * the bus (see #BSP430_SPI_TXN_FLAG_HOLD_CS), and this function must
+ * be used to complete the command and release it.
+ *
  * @param dev the M25P device handle
  *
  * @param tx_data as with iBSP430spiTxRx_rh()
@@ -0,0 +1,164 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Discipline the uptime epoch to a GPS one-pulse-per-second signal
+ *
+ * A GPS sensor produces a 1PPS pulse at the start of each second, and
+ * shortly afterwards a message giving the time of that pulse.  This
+ * module pairs the two to maintain the @ref grp_utility_uptime_epoch
+ * "uptime epoch":
+ *
+ * @li iBSP430ppsCapture_ni() records the uptime at which a pulse was
+ * captured.  It conforms to #iBSP430gpsPPSCallback_ni, so it may be
+ * passed as sBSP430gpsConfiguration::pps_cb, or invoked from the
+ * application's own callback.
+ *
+ * @li iBSP430ppsAssociateTime() is invoked by the application when it
+ * has decoded the time from an NMEA or binary message.  If the
+ * message started arriving within a second of the most recent pulse
+ * and its time is aligned to a whole second, the pulse is taken to
+ * mark that second.  The first association sets the epoch; later
+ * associations, every #BSP430_PPS_UPDATE_INTERVAL_S seconds, pass the
+ * offset between the epoch and the pulse to
+ * iBSP430uptimeDisciplineEpochFromNTP(), which estimates the
+ * frequency error of the uptime clock.
+ *
+ * Once disciplined, iBSP430uptimeAsTimeval() converts uptime
+ * timestamps to UTC with an error that is limited by the uptime clock
+ * resolution and the capture latency rather than by crystal drift.
+ *
+ * The 1PPS capture timer must be the uptime timer, as it is for @ref
+ * ex_sensors_venus6pps.
+ *
+ * @note This module requires #configBSP430_UPTIME_EPOCH_DISCIPLINE.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_PPS_H
+#define BSP430_UTILITY_PPS_H
+
+#include <bsp430/utility/uptime.h>
+#include <time.h>
+
+/** The minimum number of seconds between offsets passed to
+ * iBSP430uptimeDisciplineEpochFromNTP().  Pulses associated more
+ * often than this update only the state returned by
+ * iBSP430ppsGetState().
+ *
+ * @defaulted */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_PPS_UPDATE_INTERVAL_S)
+#define BSP430_PPS_UPDATE_INTERVAL_S BSP430_UPTIME_DISCIPLINE_MIN_INTERVAL_S
+#endif /* BSP430_PPS_UPDATE_INTERVAL_S */
+
+/** The maximum distance, in milliseconds, between the time in a
+ * message and a whole second for the message to be associated with a
+ * pulse.  Some sensors delay messages so they are evenly spaced, and
+ * a message that is far from a whole second may describe an earlier
+ * pulse.
+ *
+ * @defaulted */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_PPS_ALIGN_MS)
+#define BSP430_PPS_ALIGN_MS 50
+#endif /* BSP430_PPS_ALIGN_MS */
+
+/** The state of the 1PPS discipline, as returned by
+ * iBSP430ppsGetState(). */
+typedef struct sBSP430ppsState {
+  /** The uptime at which the most recently associated pulse was
+   * captured */
+  unsigned long pps_utt;
+
+  /** The UTC second that began at #pps_utt */
+  time_t pps_utc;
+
+  /** The offset of that pulse from the uptime epoch, in microseconds.
+   * A positive value means the epoch is behind UTC.  If the epoch was
+   * stepped to the pulse this is the offset that remains afterwards.
+   * Offsets too large to represent are saturated at the range of
+   * <c>long</c>. */
+  long offset_us;
+
+  /** The number of pulses associated with a time */
+  unsigned long pulses;
+} sBSP430ppsState;
+
+/** Record the capture of a 1PPS pulse.
+ *
+ * @param pps_utt the uptime at which the rising edge was captured
+ *
+ * @return 0, so the processor remains in any low power mode until the
+ * message describing the pulse arrives. */
+int iBSP430ppsCapture_ni (unsigned long pps_utt);
+
+/** Associate a time decoded from a GPS message with the most recent
+ * 1PPS pulse.
+ *
+ * @param utc the time in the message, in seconds since the POSIX
+ * epoch; see xBSP430gpsConvertGPStoUTC_ni()
+ *
+ * @param msec the fractional part of the time in the message, in
+ * milliseconds.  Values within #BSP430_PPS_ALIGN_MS below 1000 round
+ * up to the following second.
+ *
+ * @param rx_utt the uptime at which the message started arriving, as
+ * provided to #iBSP430gpsSerialCallback_ni
+ *
+ * @return 1 if the epoch was set or stepped, 0 if the pulse was
+ * associated, or a negative error code if no pulse was captured in
+ * the second preceding @p rx_utt or @p msec is not aligned to a whole
+ * second. */
+int iBSP430ppsAssociateTime (time_t utc,
+                             unsigned int msec,
+                             unsigned long rx_utt);
+
+/** Discard any captured pulse and the record of the last discipline
+ * update.
+ *
+ * The application should invoke this if the sensor loses its fix.
+ * The epoch and frequency estimate are retained. */
+void vBSP430ppsReset (void);
+
+/** Obtain the state of the 1PPS discipline.
+ *
+ * The frequency error estimate is available through
+ * iBSP430uptimeGetDiscipline().
+ *
+ * @param sp where to store the state
+ *
+ * @return 0 on success, or a negative error code if no pulse has been
+ * associated. */
+int iBSP430ppsGetState (sBSP430ppsState * sp);
+
+#endif /* BSP430_UTILITY_PPS_H */
@@ -104,6 +104,11 @@
  * @li The uptime epoch is invalidated when the uptime clock is @link
  * vBSP430uptimeSuspend_ni suspended@endlink .
  *
+ * @li When #configBSP430_UPTIME_EPOCH_DISCIPLINE is enabled the
+ * epoch may be maintained with iBSP430uptimeDisciplineEpochFromNTP(),
+ * which compensates for the frequency error of the uptime clock so
+ * updates can be less frequent.
+ *
  * @homepage http://github.com/pabigot/bsp430
  * @copyright Copyright 2012-2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
  */
@@ -152,6 +157,26 @@
 #define configBSP430_UPTIME_EPOCH 0
 #endif /* configBSP430_UPTIME_EPOCH */
 
+/** Define to a true value to discipline the uptime epoch.
+ *
+ * Without discipline, every conversion from the uptime clock to civil
+ * time drifts by the frequency error of the uptime clock source
+ * (typically tens of ppm for a 32 kiHz crystal) until the epoch is
+ * next adjusted.  This flag enables
+ * iBSP430uptimeDisciplineEpochFromNTP(), which estimates that
+ * frequency error from successive NTP offsets, applies it to
+ * conversions, and corrects small offsets by slewing rather than
+ * stepping the converted time.
+ *
+ * @see grp_utility_uptime_epoch
+ *
+ * @dependency #configBSP430_UPTIME_EPOCH
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_UPTIME_EPOCH_DISCIPLINE
+#define configBSP430_UPTIME_EPOCH_DISCIPLINE 0
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
+
 /** Define to a true value to support uptime-driven delays.
  *
  * This flag enables infrastructure support to use the @ref
@@ -325,23 +350,63 @@ unsigned long ulBSP430uptimeConversionFrequency_Hz (void);
  * value of zero is provided, the current nominal frequency will be
  * used in subsequent conversions.
  *
+ * The multipliers used by ulBSP430uptimeUTTToMS() and the related
+ * conversions are recomputed here, which requires several 64-bit
+ * divisions.  Avoid invoking this on a hot path.
+ *
  * @return the previous value of the conversion frequency, which may
  * be 0 if no conversions had occured. */
 unsigned long ulBSP430uptimeSetConversionFrequency_ni (unsigned long frequency_Hz);
 
+/** Convert a duration in ticks of the uptime timer to milliseconds.
+ *
+ * This and the related conversion functions do not divide.  Whenever
+ * the conversion frequency is set the reciprocal needed for each
+ * conversion is computed as a 64-bit fixed-point multiplier; a
+ * conversion is then two 32x32 multiplications and a shift, plus one
+ * multiplication that corrects the final unit of rounding.  The
+ * result is the exact quotient rounded down, truncated to unsigned
+ * long.
+ *
+ * The functions may be invoked with interrupts enabled.
+ *
+ * @param duration_utt a duration in uptime ticks
+ *
+ * @return the duration in milliseconds */
+unsigned long ulBSP430uptimeUTTToMS (unsigned long duration_utt);
+
+/** Convert a duration in ticks of the uptime timer to microseconds.
+ *
+ * @see ulBSP430uptimeUTTToMS() */
+unsigned long ulBSP430uptimeUTTToUS (unsigned long duration_utt);
+
+/** Convert a duration in milliseconds to ticks of the uptime timer.
+ *
+ * @see ulBSP430uptimeUTTToMS() */
+unsigned long ulBSP430uptimeMSToUTT (unsigned long duration_ms);
+
+/** Convert a duration in microseconds to ticks of the uptime timer.
+ *
+ * @see ulBSP430uptimeUTTToMS() */
+unsigned long ulBSP430uptimeUSToUTT (unsigned long duration_us);
+
 #if defined(BSP430_DOXYGEN) || (BSP430_UPTIME - 0)
 /** Convert from milliseconds to ticks of the uptime timer.
- * @note Evaluation is valid only when the uptime timer is running.  The result is rounded down. */
-#define BSP430_UPTIME_MS_TO_UTT(ms_) BSP430_CORE_MS_TO_TICKS((ms_), ulBSP430uptimeConversionFrequency_Hz())
+ * @note Evaluation is valid only when the uptime timer is running.  The result is rounded down.
+ * @see ulBSP430uptimeMSToUTT() */
+#define BSP430_UPTIME_MS_TO_UTT(ms_) ulBSP430uptimeMSToUTT(ms_)
 /** Convert from ticks of the uptime timer to milliseconds.
- * @note Evaluation is valid only when the uptime timer is running.  The result is rounded down. */
-#define BSP430_UPTIME_UTT_TO_MS(utt_) BSP430_CORE_TICKS_TO_MS((utt_), ulBSP430uptimeConversionFrequency_Hz())
+ * @note Evaluation is valid only when the uptime timer is running.  The result is rounded down.
+ * @see ulBSP430uptimeUTTToMS() */
+#define BSP430_UPTIME_UTT_TO_MS(utt_) ulBSP430uptimeUTTToMS(utt_)
 /** Convert from microseconds to ticks of the uptime timer.
- * @note Evaluation is valid only when the uptime timer is running.  The result is rounded down. */
-#define BSP430_UPTIME_US_TO_UTT(us_) BSP430_CORE_US_TO_TICKS((us_), ulBSP430uptimeConversionFrequency_Hz())
+ * @note Evaluation is valid only when the uptime timer is running.  The result is rounded down.
+ * @see ulBSP430uptimeUSToUTT() */
+#define BSP430_UPTIME_US_TO_UTT(us_) ulBSP430uptimeUSToUTT(us_)
 /** Convert from ticks of the uptime timer to microseconds.
- * @note Evaluation is valid only when the uptime timer is running.  The result is rounded down. */
-#define BSP430_UPTIME_UTT_TO_US(utt_) BSP430_CORE_TICKS_TO_US((utt_), ulBSP430uptimeConversionFrequency_Hz())
+ * @note Evaluation is valid only when the uptime timer is running.  The result is rounded down.
+ * @see ulBSP430uptimeUTTToUS() */
+#define BSP430_UPTIME_UTT_TO_US(utt_) ulBSP430uptimeUTTToUS(utt_)
 #endif /* BSP430_UPTIME */
 
 #if defined(BSP430_DOXYGEN) || (BSP430_UPTIME - 0)
@@ -363,7 +428,9 @@ ulBSP430uptime_ni (void)
   return ulBSP430timerCounter_ni(hBSP430uptimeTimer(), 0);
 }
 
-/** Return the system uptime in clock ticks. */
+/** Return the system uptime in clock ticks.
+ *
+ * This does not disable interrupts; see ulBSP430timerCounter(). */
 static BSP430_CORE_INLINE
 unsigned long
 ulBSP430uptime (void)
@@ -375,21 +442,17 @@ ulBSP430uptime (void)
  *
  * This incorporates the overflow and the current counter.  On the
  * MSP430 the result is expected to be a 64-bit value of which the low
- * 48-bits are valid. */
+ * 48-bits are valid.  Like ulBSP430uptime() this does not disable
+ * interrupts. */
 static BSP430_CORE_INLINE
 unsigned long long
 ullBSP430uptime (void)
 {
-  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
   unsigned int overflow;
   unsigned long ul;
 
-  BSP430_CORE_DISABLE_INTERRUPT();
-  do {
-    ul = ulBSP430timerCounter_ni(hBSP430uptimeTimer(), &overflow);
-  } while (0);
-  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
-  return (((unsigned long long)overflow) << (8 * sizeof(ul))) | ul;
+  ul = ulBSP430timerCounter(hBSP430uptimeTimer(), &overflow);
+  return (((unsigned long long)overflow) << 32) | (uint32_t)ul;
 }
 
 /** Adjust a captured 16-bit counter to a full resolution timestamp.
@@ -1127,6 +1190,129 @@ int iBSP430uptimeProcessNTPResponse (const sBSP430uptimeNTPPacketHeader * req,
                                      long * adjustment_ms,
                                      unsigned long * rtt_us);
 
+#if defined(BSP430_DOXYGEN) || (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+
+/** Offsets passed to iBSP430uptimeDisciplineEpochFromNTP() with a
+ * magnitude of at least this many NTP ticks step the epoch instead
+ * of being slewed.  The default is 2^29 ticks, about 125 ms.
+ *
+ * @dependency #configBSP430_UPTIME_EPOCH_DISCIPLINE
+ * @defaulted
+ * @ingroup grp_utility_uptime_epoch */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_UPTIME_DISCIPLINE_STEP_NTP)
+#define BSP430_UPTIME_DISCIPLINE_STEP_NTP 0x20000000L
+#endif /* BSP430_UPTIME_DISCIPLINE_STEP_NTP */
+
+/** The maximum magnitude of the estimated frequency error, and the
+ * maximum rate at which offsets are slewed, in parts per million.
+ *
+ * @dependency #configBSP430_UPTIME_EPOCH_DISCIPLINE
+ * @defaulted
+ * @ingroup grp_utility_uptime_epoch */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_UPTIME_DISCIPLINE_MAX_PPM)
+#define BSP430_UPTIME_DISCIPLINE_MAX_PPM 500
+#endif /* BSP430_UPTIME_DISCIPLINE_MAX_PPM */
+
+/** The minimum interval, in seconds, between offset measurements that
+ * will be used to update the frequency estimate.  Over shorter
+ * intervals network delay variation dominates the frequency error.
+ *
+ * @dependency #configBSP430_UPTIME_EPOCH_DISCIPLINE
+ * @defaulted
+ * @ingroup grp_utility_uptime_epoch */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_UPTIME_DISCIPLINE_MIN_INTERVAL_S)
+#define BSP430_UPTIME_DISCIPLINE_MIN_INTERVAL_S 16
+#endif /* BSP430_UPTIME_DISCIPLINE_MIN_INTERVAL_S */
+
+/** Each frequency update after the first moves the estimate by
+ * 2^-N of the measured residual, and the jitter average uses the
+ * same weight.  Larger values reject more noise but track a changing
+ * frequency (e.g. due to temperature) more slowly.
+ *
+ * @dependency #configBSP430_UPTIME_EPOCH_DISCIPLINE
+ * @defaulted
+ * @ingroup grp_utility_uptime_epoch */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_UPTIME_DISCIPLINE_GAIN_SHIFT)
+#define BSP430_UPTIME_DISCIPLINE_GAIN_SHIFT 2
+#endif /* BSP430_UPTIME_DISCIPLINE_GAIN_SHIFT */
+
+/** The state of the uptime epoch discipline, as returned by
+ * iBSP430uptimeGetDiscipline().
+ *
+ * @dependency #configBSP430_UPTIME_EPOCH_DISCIPLINE
+ * @ingroup grp_utility_uptime_epoch */
+typedef struct sBSP430uptimeDiscipline {
+  /** The estimated frequency error of the uptime clock, in parts per
+   * billion.  A positive value means the uptime clock runs slow. */
+  long freq_ppb;
+
+  /** The average magnitude, in microseconds, of the measured offsets
+   * that were not accounted for by the frequency estimate and the
+   * offset remaining to be slewed. */
+  unsigned long jitter_us;
+
+  /** The part of the most recent offset, in microseconds, that has
+   * not yet been slewed into converted times. */
+  long slew_us;
+
+  /** The number of times the frequency estimate has been updated */
+  unsigned int samples;
+} sBSP430uptimeDiscipline;
+
+/** Correct the uptime epoch using an offset measured by NTP.
+ *
+ * Unlike iBSP430uptimeAdjustEpochFromNTP(), which steps the epoch,
+ * this treats the epoch as a clock to be disciplined:
+ *
+ * @li The offset is compared with the part of the previous offset
+ * that had not yet been applied.  The difference, divided by the time
+ * since the previous measurement, is a residual frequency error that
+ * updates the frequency estimate.  Conversions through
+ * iBSP430uptimeAsNTP() and iBSP430uptimeAsTimeval() scale the elapsed
+ * time since the epoch was updated by that estimate.
+ *
+ * @li The offset is slewed in at #BSP430_UPTIME_DISCIPLINE_MAX_PPM,
+ * so converted times remain monotonic.
+ *
+ * @li An offset with a magnitude of at least
+ * #BSP430_UPTIME_DISCIPLINE_STEP_NTP steps the epoch instead.  The
+ * frequency estimate is retained.
+ *
+ * The epoch must be valid.  iBSP430uptimeSetEpochFromNTP() (or
+ * iBSP430uptimeSetEpochFromTimeval()) provides the reference against
+ * which the first offset is measured.  Once the frequency estimate
+ * has settled the interval between calls may approach
+ * #BSP430_UPTIME_EPOCH_UPDATE_INTERVAL_UTT.  An offset measured over
+ * 2^31 or more uptime ticks (about 18 h at 32 KiHz) is slewed in but
+ * does not update the frequency estimate.
+ *
+ * The estimate is computed with interrupts enabled.  If the epoch is
+ * changed by another context meanwhile the offset is re-evaluated
+ * against the new epoch.
+ *
+ * @param adjustment_ntp the offset produced by
+ * iBSP430uptimeProcessNTPResponse() for a request made with a valid
+ * epoch.
+ *
+ * @return 0 if the offset was slewed, 1 if the epoch was stepped, or
+ * a negative error code if the epoch is not valid.
+ *
+ * @dependency #configBSP430_UPTIME_EPOCH_DISCIPLINE
+ * @ingroup grp_utility_uptime_epoch */
+int iBSP430uptimeDisciplineEpochFromNTP (int64_t adjustment_ntp);
+
+/** Obtain the state of the uptime epoch discipline.
+ *
+ * @param dp where to store the state
+ *
+ * @return 0 on success, or a negative error code if @p dp is null.
+ *
+ * @dependency #configBSP430_UPTIME_EPOCH_DISCIPLINE
+ * @ingroup grp_utility_uptime_epoch */
+int iBSP430uptimeGetDiscipline (sBSP430uptimeDiscipline * dp);
+
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
+
 #endif /* configBSP430_UPTIME_EPOCH */
 
 #endif /* BSP430_UTILITY_UPTIME_H */
@@ -0,0 +1,85 @@
+# Run the examples/bench application in the mspdebug simulator and
+# report the cycles consumed by each benchmark.
+#
+# The application stores the benchmark name in bench_name, then calls
+# bench_start(), the benchmark, and bench_stop().  A tracer device
+# counts the cycles executed; it is cleared at each bench_start() and
+# read at each bench_stop().  After the last benchmark the application
+# repeats the start/stop pair with an empty name.
+#
+# Output is one line per benchmark, "<name> <cycles>", with the cycles
+# of the "overhead" benchmark subtracted from every other result so
+# that results from different commits can be compared with diff.
+
+import sys
+import re
+import argparse
+import subprocess
+
+parser = argparse.ArgumentParser(description='Report cycle counts from the BSP430 benchmark application')
+parser.add_argument('image', help='ELF image of the benchmark application')
+parser.add_argument('--mspdebug', default='mspdebug', help='path to mspdebug')
+parser.add_argument('--max-benchmarks', type=int, default=32,
+                    help='upper bound on the number of benchmarks in the image')
+parser.add_argument('--raw', action='store_true',
+                    help='do not subtract the measurement overhead')
+args = parser.parse_args()
+
+# Only an MSP430 image can run in the simulator.  A host build of the
+# benchmark application executes directly and counts no cycles.
+EM_MSP430 = 105
+with open(args.image, 'rb') as f:
+    ehdr = bytearray(f.read(20))
+if (ehdr[:4] != bytearray(b'\x7fELF')) or (EM_MSP430 != (ehdr[18] | (ehdr[19] << 8))):
+    sys.stderr.write('%s is not an MSP430 image; cycle counts are available only from the simulator\n' % (args.image,))
+    sys.exit(1)
+
+commands = [ 'prog %s' % (args.image,),
+             'simio add tracer bench',
+             'setbreak bench_start',
+             'setbreak bench_stop' ]
+for i in range(args.max_benchmarks):
+    commands.extend([ 'run',                    # stop at bench_start
+                      'simio config bench clear',
+                      'run',                    # stop at bench_stop
+                      'simio info bench',
+                      'md bench_name 16' ])
+
+output = subprocess.check_output([args.mspdebug, '-q', 'sim'] + commands, universal_newlines=True)
+
+# Tracer info includes a line reporting the cycle count; the memory
+# dump of bench_name follows it.
+cycles_re = re.compile('cycles?\D*(\d+)', re.IGNORECASE)
+md_re = re.compile('^\s*(?:0x)?[0-9a-f]+:\s+((?:[0-9a-f]{2}\s+)+)', re.IGNORECASE)
+
+results = []
+cycles = None
+for line in output.splitlines():
+    mc = cycles_re.search(line)
+    if mc is not None:
+        cycles = int(mc.group(1))
+        continue
+    mm = md_re.match(line)
+    if (mm is not None) and (cycles is not None):
+        name = ''
+        for b in mm.group(1).split():
+            c = int(b, 16)
+            if 0 == c:
+                break
+            name += chr(c)
+        if not name:
+            break
+        results.append((name, cycles))
+        cycles = None
+
+if not results:
+    sys.stderr.write('No benchmark results found in simulator output\n')
+    sys.exit(1)
+
+overhead = 0
+if (not args.raw) and ('overhead' == results[0][0]):
+    overhead = results[0][1]
+for (name, cycles) in results:
+    if (not args.raw) and ('overhead' != name):
+        cycles -= overhead
+    print('%s %d' % (name, cycles))
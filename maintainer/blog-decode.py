@@ -0,0 +1,194 @@
+# Reconstruct console text from a stream that contains binary log
+# records produced with configBSP430_CONSOLE_BINARY_LOG.
+#
+# Each record is a NUL octet, the low 16 bits of the address of the
+# format string in the .bsp430_blog section of the application ELF
+# image in little-endian order, and the raw argument bytes.  The
+# section is not allocated so the linker places it at address zero,
+# but its recorded address is subtracted anyway.  The format string is parsed
+# here to determine the size of each argument.  Octets outside records
+# are copied to the output unchanged.
+#
+# Usage: python blog-decode.py app.elf [capture]
+#
+# With no capture file the stream is read from standard input, so the
+# script can be used as a filter on a serial port.
+
+import sys
+import re
+import struct
+import argparse
+
+SECTION_NAME = '.bsp430_blog'
+
+# Sizes of int, long, long long, and pointers by ELF e_machine
+EM_386 = 3
+EM_X86_64 = 62
+EM_MSP430 = 105
+TypeSizes = { EM_386: (4, 4, 8, 4),
+              EM_X86_64: (4, 8, 8, 8),
+              EM_MSP430: (2, 4, 8, 2) }
+
+format_re = re.compile('%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d+))?(?P<len>hh|h|ll|l|j|z|t)?(?P<conv>[%diouxXcsp])')
+
+class DecodeError (Exception):
+    pass
+
+def readSection (image, name):
+    """Return the contents of the named section of an ELF image along
+    with the image's e_machine value and the section address."""
+    if image[:4] != b'\x7fELF':
+        raise DecodeError('not an ELF image')
+    if 2 == bytearray(image[4:5])[0]:
+        (e_machine,) = struct.unpack_from('<H', image, 18)
+        (e_shoff,) = struct.unpack_from('<Q', image, 40)
+        (e_shentsize, e_shnum, e_shstrndx) = struct.unpack_from('<HHH', image, 58)
+        shdr_fmt = '<IIQQQQIIQQ'
+    else:
+        (e_machine,) = struct.unpack_from('<H', image, 18)
+        (e_shoff,) = struct.unpack_from('<I', image, 32)
+        (e_shentsize, e_shnum, e_shstrndx) = struct.unpack_from('<HHH', image, 46)
+        shdr_fmt = '<IIIIIIIIII'
+    shdrs = []
+    for i in range(e_shnum):
+        shdrs.append(struct.unpack_from(shdr_fmt, image, e_shoff + i * e_shentsize))
+    (_, _, _, _, str_offset, str_size, _, _, _, _) = shdrs[e_shstrndx]
+    strtab = image[str_offset:str_offset + str_size]
+    for (sh_name, _, _, sh_addr, sh_offset, sh_size, _, _, _, _) in shdrs:
+        if name == strtab[sh_name:strtab.index(b'\0', sh_name)].decode('latin-1'):
+            if 0x10000 < sh_size:
+                raise DecodeError('%s section exceeds 64 KiB' % (name,))
+            return (e_machine, image[sh_offset:sh_offset + sh_size], sh_addr)
+    raise DecodeError('image has no %s section' % (name,))
+
+class Decoder (object):
+    def __init__ (self, image, pointer_size=None):
+        (e_machine, self.__formats, self.__base) = readSection(image, SECTION_NAME)
+        sizes = TypeSizes.get(e_machine)
+        if sizes is None:
+            raise DecodeError('unsupported machine %d' % (e_machine,))
+        (self.__int, self.__long, self.__llong, self.__pointer) = sizes
+        if pointer_size is not None:
+            self.__pointer = pointer_size
+        self.__cache = {}
+
+    def __format (self, id):
+        id = (id - self.__base) & 0xFFFF
+        fmt = self.__cache.get(id)
+        if fmt is None:
+            if id >= len(self.__formats):
+                raise DecodeError('format id %u beyond section' % (id,))
+            end = self.__formats.index(b'\0', id)
+            fmt = self.__formats[id:end].decode('latin-1')
+            self.__cache[id] = fmt
+        return fmt
+
+    def __argSize (self, length, conv):
+        if 'p' == conv:
+            return self.__pointer
+        if 'll' == length:
+            return self.__llong
+        if length in ('l', 'j'):
+            return self.__long
+        if length in ('z', 't'):
+            return self.__pointer
+        return self.__int
+
+    def decodeRecord (self, data, pos):
+        """Decode the record following the marker at data[pos-1].
+        Return the text and the position following the record, or None
+        if the record is incomplete."""
+        if pos + 2 > len(data):
+            return None
+        (id,) = struct.unpack_from('<H', data, pos)
+        pos += 2
+        fmt = self.__format(id)
+        text = []
+        last = 0
+        for m in format_re.finditer(fmt):
+            text.append(fmt[last:m.start()])
+            last = m.end()
+            conv = m.group('conv')
+            if '%' == conv:
+                text.append('%')
+                continue
+            spec = '%' + m.group('flags')
+            for (field, prefix) in (('width', ''), ('prec', '.')):
+                value = m.group(field)
+                if '*' == value:
+                    if pos + self.__int > len(data):
+                        return None
+                    value = str(self.__readInt(data, pos, self.__int, True))
+                    pos += self.__int
+                if value is not None:
+                    spec += prefix + value
+            if 's' == conv:
+                if b'\0' not in data[pos:]:
+                    return None
+                end = data.index(b'\0', pos)
+                text.append((spec + 's') % (data[pos:end].decode('latin-1'),))
+                pos = end + 1
+                continue
+            size = self.__argSize(m.group('len'), conv)
+            if pos + size > len(data):
+                return None
+            value = self.__readInt(data, pos, size, conv in 'di')
+            pos += size
+            if 'c' == conv:
+                text.append((spec + 'c') % (chr(value & 0xFF),))
+            elif 'p' == conv:
+                text.append((spec + '#x') % (value,))
+            elif conv in 'iu':
+                text.append((spec + 'd') % (value,))
+            else:
+                text.append((spec + conv) % (value,))
+        text.append(fmt[last:])
+        return (''.join(text), pos)
+
+    def __readInt (self, data, pos, size, signed):
+        value = 0
+        for i in range(size - 1, -1, -1):
+            value = (value << 8) | bytearray(data[pos + i:pos + i + 1])[0]
+        if signed and (value & (1 << (8 * size - 1))):
+            value -= (1 << (8 * size))
+        return value
+
+    def decode (self, data, out):
+        """Decode a captured stream, writing text to out.  Return the
+        unconsumed tail of data, which holds an incomplete record."""
+        pos = 0
+        while pos < len(data):
+            mpos = data.find(b'\0', pos)
+            if 0 > mpos:
+                out.write(data[pos:].decode('latin-1'))
+                return b''
+            out.write(data[pos:mpos].decode('latin-1'))
+            rv = self.decodeRecord(data, mpos + 1)
+            if rv is None:
+                return data[mpos:]
+            (text, pos) = rv
+            out.write(text)
+        return b''
+
+parser = argparse.ArgumentParser(description='Decode BSP430 binary console log records')
+parser.add_argument('image', help='ELF image of the application that produced the log')
+parser.add_argument('capture', nargs='?', help='captured console output (default standard input)')
+parser.add_argument('--pointer-size', type=int,
+                    help='size of a data pointer in octets (4 for the MSP430X large memory model)')
+args = parser.parse_args()
+
+decoder = Decoder(open(args.image, 'rb').read(), args.pointer_size)
+# Read standard input an octet at a time so text appears as it arrives
+if args.capture is None:
+    instream = getattr(sys.stdin, 'buffer', sys.stdin)
+    block_size = 1
+else:
+    instream = open(args.capture, 'rb')
+    block_size = 4096
+pending = b''
+while True:
+    block = instream.read(block_size)
+    if not block:
+        break
+    pending = decoder.decode(pending + block, sys.stdout)
+    sys.stdout.flush()
@@ -0,0 +1,142 @@
+# Generate BSP430 CLI command tables from a description of the command
+# tree.
+#
+# Each non-blank line of the description defines one command.  The
+# first field is the command key; it is followed by optional
+# attributes of the form name=value:
+#
+#   help=TEXT      sBSP430cliCommand::help (quote text containing spaces)
+#   handler=EXPR   sBSP430cliCommand::handler
+#   simple=EXPR    iBSP430cliHandlerSimple with EXPR as param.simple_handler
+#   ptr=EXPR       sBSP430cliCommand::param.ptr
+#   helper=EXPR    sBSP430cliCommand::completion_helper
+#   rpc=EXPR       sBSP430cliCommand::rpc_handler
+#
+# Commands indented beneath a command are its sub-commands.  Text
+# following an unquoted # is a comment.  For example:
+#
+#   set help="[var] [value]"
+#     all   simple=cmd_set_all help="[ival] [uival]"
+#     ival  handler=iBSP430cliHandlerStoreI ptr=&ival rpc=iBSP430cliRPCHandlerAccessI
+#   uptime  simple=cmd_uptime help="# Show system uptime"
+#
+# The output is C source to be included in the application after the
+# declarations of the handlers and variables it references.  The
+# siblings at each level are emitted as an array sorted by key, with
+# sBSP430cliCommand::table_len set so iBSP430cliMatchCommand() can use
+# a binary search.  The top level array is named by --name (default
+# "commands") and is used wherever a command set is required.  The
+# application must define configBSP430_CLI_COMMAND_TABLE.  The index
+# of a command within its array is its position in the RPC command
+# path (see xBSP430cliRPCExecute()).
+#
+# Usage: python cli-gentable.py [--name NAME] description [output]
+
+import sys
+import re
+import shlex
+import argparse
+
+class DescriptionError (Exception):
+    pass
+
+class Command (object):
+    Attributes = ( 'help', 'handler', 'simple', 'ptr', 'helper', 'rpc' )
+
+    def __init__ (self, key, attrs, lineno):
+        self.key = key
+        self.attrs = attrs
+        self.lineno = lineno
+        self.children = []
+        self.table_name = None
+
+def parseDescription (infile):
+    root = Command(None, {}, 0)
+    # Stack of (indent, command) for the commands that may still
+    # receive children.
+    stack = [ (-1, root) ]
+    for (lineno, line) in enumerate(infile, 1):
+        fields = shlex.split(line, comments=True)
+        if not fields:
+            continue
+        indent = len(line) - len(line.lstrip())
+        attrs = {}
+        for field in fields[1:]:
+            (name, sep, value) = field.partition('=')
+            if (not sep) or (name not in Command.Attributes):
+                raise DescriptionError('%d: invalid attribute "%s"' % (lineno, field))
+            if name in attrs:
+                raise DescriptionError('%d: duplicate attribute "%s"' % (lineno, name))
+            attrs[name] = value
+        if ('simple' in attrs) and (('handler' in attrs) or ('ptr' in attrs)):
+            raise DescriptionError('%d: simple excludes handler and ptr' % (lineno,))
+        while stack[-1][0] >= indent:
+            stack.pop()
+        cmd = Command(fields[0], attrs, lineno)
+        stack[-1][1].children.append(cmd)
+        stack.append((indent, cmd))
+    return root
+
+def cString (text):
+    return '"%s"' % (text.replace('\\', '\\\\').replace('"', '\\"'),)
+
+def emitTable (out, siblings, name):
+    siblings.sort(key=lambda _c: _c.key)
+    if 255 < len(siblings):
+        raise DescriptionError('%s: too many commands at one level' % (name,))
+    for (prev, cmd) in zip(siblings, siblings[1:]):
+        if cmd.key.startswith(prev.key):
+            raise DescriptionError('%d: key "%s" has prefix "%s"' % (cmd.lineno, cmd.key, prev.key))
+    for cmd in siblings:
+        if cmd.children:
+            cmd.table_name = '%s_%s' % (name, re.sub(r'\W', '_', cmd.key))
+            emitTable(out, cmd.children, cmd.table_name)
+    out.write('static const sBSP430cliCommand %s[] = {\n' % (name,))
+    for (i, cmd) in enumerate(siblings):
+        fields = [ '.key = %s' % (cString(cmd.key),) ]
+        if 'help' in cmd.attrs:
+            fields.append('.help = %s' % (cString(cmd.attrs['help']),))
+        if cmd.table_name is not None:
+            fields.append('.child = %s' % (cmd.table_name,))
+        if i + 1 < len(siblings):
+            fields.append('.next = %s + %d' % (name, i + 1))
+        if 'simple' in cmd.attrs:
+            fields.append('.handler = iBSP430cliHandlerSimple')
+            fields.append('.param.simple_handler = %s' % (cmd.attrs['simple'],))
+        else:
+            if 'handler' in cmd.attrs:
+                fields.append('.handler = %s' % (cmd.attrs['handler'],))
+            if 'ptr' in cmd.attrs:
+                fields.append('.param.ptr = %s' % (cmd.attrs['ptr'],))
+        fields.append('.table_len = %d' % (len(siblings) - i,))
+        out.write('  { %s,\n' % (',\n    '.join(fields),))
+        if 'helper' in cmd.attrs:
+            out.write('#if (configBSP430_CLI_COMMAND_COMPLETION_HELPER - 0)\n')
+            out.write('    .completion_helper = %s,\n' % (cmd.attrs['helper'],))
+            out.write('#endif /* configBSP430_CLI_COMMAND_COMPLETION_HELPER */\n')
+        if 'rpc' in cmd.attrs:
+            out.write('#if (configBSP430_CLI_RPC - 0)\n')
+            out.write('    .rpc_handler = %s,\n' % (cmd.attrs['rpc'],))
+            out.write('#endif /* configBSP430_CLI_RPC */\n')
+        out.write('  },\n')
+    out.write('};\n\n')
+
+parser = argparse.ArgumentParser(description='Generate BSP430 CLI command tables')
+parser.add_argument('description', help='command tree description')
+parser.add_argument('output', nargs='?', help='generated C source (default standard output)')
+parser.add_argument('--name', default='commands',
+                    help='identifier of the top level command table')
+args = parser.parse_args()
+
+root = parseDescription(open(args.description))
+if not root.children:
+    raise DescriptionError('%s: no commands' % (args.description,))
+if args.output is None:
+    out = sys.stdout
+else:
+    out = open(args.output, 'w')
+out.write('/* Generated by maintainer/cli-gentable.py from %s; do not edit. */\n\n' % (args.description,))
+out.write('#if ! (configBSP430_CLI_COMMAND_TABLE - 0)\n')
+out.write('#error configBSP430_CLI_COMMAND_TABLE is required\n')
+out.write('#endif /* configBSP430_CLI_COMMAND_TABLE */\n\n')
+emitTable(out, root.children, args.name)
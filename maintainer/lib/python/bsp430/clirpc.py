@@ -0,0 +1,117 @@
+# Host-side client for the BSP430 CLI binary RPC mode
+# (configBSP430_CLI_RPC).
+#
+# A request identifies a command by the sequence of its positions
+# among its siblings at each level of the command tree, and carries
+# packed little-endian arguments.  The reply holds a status and packed
+# results.  Both are framed as:
+#
+#   SOF (0x01), length, body[length], CRC-16/CCITT (little-endian)
+#
+# where the CRC covers the length and the body.  For example, with a
+# pyserial port connected to an application using a command table
+# generated from:
+#
+#   set
+#     ival  handler=iBSP430cliHandlerStoreI ptr=&ival rpc=iBSP430cliRPCHandlerAccessI
+#
+#   client = bsp430.clirpc.Client(serial.Serial('/dev/ttyACM0', 115200, timeout=1))
+#   client.access((0, 0), 42)         # set ival 42
+#   value = client.access((0, 0))     # read ival
+
+import struct
+
+SOF = 0x01
+
+# eBSP430cliErrorType
+ErrorNames = { 1: 'Config',
+               2: 'Missing',
+               3: 'Unrecognized',
+               4: 'MultiMatch',
+               5: 'Invalid' }
+
+class RPCError (Exception):
+    """Raised when a reply is missing or malformed, or reports an
+    error.  status is the negative status from the reply, or None if no
+    valid reply was received."""
+    def __init__ (self, message, status=None):
+        super(RPCError, self).__init__(message)
+        self.status = status
+
+def crc16 (data, crc=0xFFFF):
+    """Return the CRC-16/CCITT of data, as uiBSP430cliRPCCRC()."""
+    for b in bytearray(data):
+        crc ^= b << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+def frame (body):
+    """Wrap a request or reply body in a frame."""
+    body = bytearray(body)
+    if 255 < len(body):
+        raise ValueError('frame body too long')
+    data = bytearray([len(body)]) + body
+    return bytes(bytearray([SOF]) + data + bytearray(struct.pack('<H', crc16(data))))
+
+def encodeRequest (path, args=b''):
+    """Return the frame invoking the command at path with the packed
+    arguments args."""
+    path = bytearray(path)
+    if not path:
+        raise ValueError('empty command path')
+    return frame(bytearray([len(path)]) + path + bytearray(args))
+
+class Client (object):
+    """Invoke commands over a stream.  port must provide read(n),
+    returning fewer than n octets on timeout, and write(data), as does
+    serial.Serial."""
+
+    def __init__ (self, port):
+        self.__port = port
+
+    def __read (self, n):
+        data = self.__port.read(n)
+        if len(data) < n:
+            raise RPCError('timeout waiting for reply')
+        return bytearray(data)
+
+    def readReply (self):
+        """Return the body of the next reply frame.  Octets preceding
+        the frame, such as console output, are discarded."""
+        while SOF != self.__read(1)[0]:
+            pass
+        hdr = self.__read(1)
+        body = self.__read(hdr[0])
+        (crc,) = struct.unpack('<H', bytes(self.__read(2)))
+        if crc != crc16(hdr + body):
+            raise RPCError('reply CRC mismatch')
+        if not body:
+            raise RPCError('empty reply')
+        return body
+
+    def call (self, path, args=b''):
+        """Invoke the command at path with packed arguments, returning
+        the packed results."""
+        self.__port.write(encodeRequest(path, args))
+        body = self.readReply()
+        if body[0]:
+            status = body[0] - 256
+            raise RPCError('command %s failed: %s' % (tuple(path), ErrorNames.get(-status, status)), status)
+        return bytes(body[1:])
+
+    def access (self, path, value=None, size=2, signed=False):
+        """Read, or write then read, a variable exposed through
+        iBSP430cliRPCHandlerAccessI() or iBSP430cliRPCHandlerAccessL().
+        size is sizeof(int) or sizeof(long) on the target."""
+        fmt = '<' + { 2: 'h', 4: 'i', 8: 'q' }[size]
+        if not signed:
+            fmt = fmt.upper()
+        args = b''
+        if value is not None:
+            args = struct.pack(fmt, value)
+        (rv,) = struct.unpack(fmt, self.call(path, args))
+        return rv
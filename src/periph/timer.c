@@ -35,6 +35,13 @@
 #include <bsp430/periph/timer.h>
 #include <bsp430/clock.h>
 
+#if (configBSP430_TIMER_CAPTURE_DMA - 0)
+#include <bsp430/periph/dma.h>
+#if ! ((BSP430_MODULE_DMAX - 0) && (BSP430_CORE_FAMILY_IS_5XX - 0))
+#error configBSP430_TIMER_CAPTURE_DMA requires a 5xx-family DMA controller
+#endif /* validate DMA */
+#endif /* configBSP430_TIMER_CAPTURE_DMA */
+
 #if (BSP430_CORE_FAMILY_IS_5XX - 0)
 /* In 5xx Timer_A and Timer_B use the same layout with 0x0E denoting
  * overflow */
@@ -364,7 +371,7 @@ timerOverflowAdjusted_ni (hBSP430halTIMER timer,
    *
    * Note that TAIFG, TBIFG, and TDIFG all have value 0x0001 so it
    * doesn't matter which type of timer this is. */
-  if ((0 <= (int)ctr) && (timer->hpl->ctl & TAIFG)) {
+  if ((0 <= (int16_t)ctr) && (timer->hpl->ctl & TAIFG)) {
     ++overflow_count;
   }
   return overflow_count;
@@ -387,9 +394,39 @@ ulBSP430timerCounter_ni (hBSP430halTIMER timer,
   r = uiBSP430timerBestCounterRead_ni(timer->hpl, timer->hal_state.flags);
   overflow_count = timerOverflowAdjusted_ni(timer, r);
   if (overflowp) {
-    *overflowp = overflow_count >> 16;
+    *overflowp = (uint16_t)(overflow_count >> 16);
   }
-  return (overflow_count << 16) + r;
+  return (uint32_t)((overflow_count << 16) + r);
+}
+
+unsigned long
+ulBSP430timerCounter (hBSP430halTIMER timer,
+                      unsigned int * overflowp)
+{
+  volatile unsigned long * const ocp = &timer->overflow_count;
+  unsigned long overflow_count;
+  unsigned int r;
+  unsigned int ifg;
+
+  /* Sample the overflow counter, the timer counter, and the pending
+   * overflow flag, and accept them only if the overflow counter did
+   * not change while doing so.  The overflow handler clears TAIFG and
+   * increments the counter without being interrupted, so an unchanged
+   * counter means the flag reflects an overflow that has not yet been
+   * counted.  A torn read of the multi-word counter cannot compare
+   * equal to the value that follows it. */
+  do {
+    overflow_count = *ocp;
+    r = uiBSP430timerBestCounterRead_ni(timer->hpl, timer->hal_state.flags);
+    ifg = timer->hpl->ctl & TAIFG;
+  } while (overflow_count != *ocp);
+  if (ifg && (0 <= (int16_t)r)) {
+    ++overflow_count;
+  }
+  if (overflowp) {
+    *overflowp = (uint16_t)(overflow_count >> 16);
+  }
+  return (uint32_t)((overflow_count << 16) + r);
 }
 
 unsigned long
@@ -397,7 +434,7 @@ ulBSP430timerCaptureCounter_ni (hBSP430halTIMER timer,
                                 unsigned int ccidx)
 {
   unsigned int lo = timer->hpl->ccr[ccidx];
-  return (timerOverflowAdjusted_ni(timer, lo) << 16) | lo;
+  return (uint32_t)((timerOverflowAdjusted_ni(timer, lo) << 16) | lo);
 }
 
 void
@@ -664,6 +701,167 @@ iBSP430timerAlarmCancel_ni (hBSP430timerAlarm alarm)
   return 1;
 }
 
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0)
+
+/* True if alarm a_ is due before alarm b_.  As with the sorted list
+ * this assumes all active alarms are due within half the counter
+ * range of each other. */
+#define MUX_HEAP_BEFORE_(a_, b_) (0 > (long)((a_)->setting_tck - (b_)->setting_tck))
+
+static BSP430_CORE_INLINE_FORCED
+void
+muxHeapPlace_ (hBSP430timerMuxSharedAlarm sap,
+               hBSP430timerMuxAlarm alarm,
+               unsigned int idx)
+{
+  sap->heap[idx] = alarm;
+  alarm->heap_idx = idx;
+}
+
+/* Move the alarm at idx toward the root until its parent is not due
+ * after it.  Returns the final position of the alarm. */
+static unsigned int
+muxHeapUp_ (hBSP430timerMuxSharedAlarm sap,
+            unsigned int idx)
+{
+  hBSP430timerMuxAlarm alarm = sap->heap[idx];
+
+  while (0 < idx) {
+    unsigned int pidx = (idx - 1) >> 1;
+    hBSP430timerMuxAlarm parent = sap->heap[pidx];
+
+    if (! MUX_HEAP_BEFORE_(alarm, parent)) {
+      break;
+    }
+    muxHeapPlace_(sap, parent, idx);
+    idx = pidx;
+  }
+  muxHeapPlace_(sap, alarm, idx);
+  return idx;
+}
+
+/* Move the alarm at idx away from the root until no child is due
+ * before it. */
+static void
+muxHeapDown_ (hBSP430timerMuxSharedAlarm sap,
+              unsigned int idx)
+{
+  hBSP430timerMuxAlarm alarm = sap->heap[idx];
+  unsigned int len = sap->heap_len;
+
+  while (1) {
+    unsigned int cidx = 2 * idx + 1;
+    hBSP430timerMuxAlarm child;
+
+    if (cidx >= len) {
+      break;
+    }
+    child = sap->heap[cidx];
+    if (((cidx + 1) < len) && MUX_HEAP_BEFORE_(sap->heap[cidx + 1], child)) {
+      child = sap->heap[++cidx];
+    }
+    if (! MUX_HEAP_BEFORE_(child, alarm)) {
+      break;
+    }
+    muxHeapPlace_(sap, child, idx);
+    idx = cidx;
+  }
+  muxHeapPlace_(sap, alarm, idx);
+}
+
+/* Remove the alarm at idx, filling its place with the last alarm. */
+static void
+muxHeapRemove_ (hBSP430timerMuxSharedAlarm sap,
+                unsigned int idx)
+{
+  unsigned int len = --sap->heap_len;
+
+  if (idx < len) {
+    sap->heap[idx] = sap->heap[len];
+    if (idx == muxHeapUp_(sap, idx)) {
+      muxHeapDown_(sap, idx);
+    }
+  }
+  sap->alarms = (0 < len) ? sap->heap[0] : NULL;
+}
+
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
+
+#if (configBSP430_TIMER_MUXALARM_SLACK - 0)
+
+/* True if the time a_ precedes the time b_ */
+#define MUX_TCK_BEFORE_(a_, b_) (0 > (long)((a_) - (b_)))
+
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0)
+/* Return wake_tck reduced to the latest permissible notification
+ * time of any alarm in the heap.  No alarm in a subtree is due before
+ * its root, so a subtree whose root is not due before wake_tck cannot
+ * reduce it.  This runs in the alarm interrupt, so the subtrees that
+ * can are walked in preorder without recursion: descend to the left
+ * child, and on leaving a subtree climb past right children to the
+ * next right sibling. */
+static unsigned long
+muxHeapWake_ (hBSP430timerMuxSharedAlarm sap,
+              unsigned long wake_tck)
+{
+  unsigned int len = sap->heap_len;
+  unsigned int idx = 0;
+
+  while (1) {
+    hBSP430timerMuxAlarm alarm = (idx < len) ? sap->heap[idx] : NULL;
+
+    if ((NULL != alarm) && MUX_TCK_BEFORE_(alarm->setting_tck, wake_tck)) {
+      unsigned long latest_tck = alarm->setting_tck + alarm->slack_tck;
+      if (MUX_TCK_BEFORE_(latest_tck, wake_tck)) {
+        wake_tck = latest_tck;
+      }
+      idx = 2 * idx + 1;
+      continue;
+    }
+    /* Right children have even indices */
+    while ((0 < idx) && (0 == (idx & 1))) {
+      idx = (idx - 1) >> 1;
+    }
+    if (0 == idx) {
+      break;
+    }
+    ++idx;
+  }
+  return wake_tck;
+}
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
+
+/* Return the time for the dedicated alarm: the earliest time by
+ * which some active alarm must be notified.  sap->alarms must not be
+ * null. */
+static unsigned long
+muxWake_ (hBSP430timerMuxSharedAlarm sap)
+{
+  hBSP430timerMuxAlarm alarm = sap->alarms;
+  unsigned long wake_tck = alarm->setting_tck + alarm->slack_tck;
+
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0)
+  wake_tck = muxHeapWake_(sap, wake_tck);
+#else /* configBSP430_TIMER_MUXALARM_HEAP */
+  /* The list is sorted by setting, so alarms after the first one not
+   * due before wake_tck cannot reduce it. */
+  alarm = alarm->next;
+  while ((NULL != alarm) && MUX_TCK_BEFORE_(alarm->setting_tck, wake_tck)) {
+    unsigned long latest_tck = alarm->setting_tck + alarm->slack_tck;
+    if (MUX_TCK_BEFORE_(latest_tck, wake_tck)) {
+      wake_tck = latest_tck;
+    }
+    alarm = alarm->next;
+  }
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
+  return wake_tck;
+}
+
+#define MUX_WAKE_(sap_) muxWake_(sap_)
+#else /* configBSP430_TIMER_MUXALARM_SLACK */
+#define MUX_WAKE_(sap_) ((sap_)->alarms->setting_tck)
+#endif /* configBSP430_TIMER_MUXALARM_SLACK */
+
 /* The capture/compare callback registered for enabled alarms.  It is
  * responsible for clearing the alarm and invoking the user-provided
  * callback. */
@@ -672,6 +870,32 @@ muxAlarm_cb_ni (hBSP430timerAlarm alarm)
 {
   hBSP430timerMuxSharedAlarm sap = (sBSP430timerMuxSharedAlarm *)(-offsetof(sBSP430timerMuxSharedAlarm, dedicated) + (char *)alarm);
   unsigned long now_tck = ulBSP430timerCounter_ni(sap->dedicated.timer, NULL);
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0)
+  hBSP430timerMuxAlarm fired = NULL;
+  hBSP430timerMuxAlarm * ap = &fired;
+  int rv = 0;
+
+  /* Collect the expired alarms in order of due time */
+  while (NULL != sap->alarms) {
+    hBSP430timerMuxAlarm due = sap->alarms;
+    if (0 < ((long)(due->setting_tck) - (long)now_tck)) {
+      break;
+    }
+    muxHeapRemove_(sap, 0);
+    *ap = due;
+    ap = &due->next;
+  }
+  *ap = NULL;
+  if (sap->alarms) {
+    (void)timerAlarmSet_ni(&sap->dedicated, MUX_WAKE_(sap), 1);
+  }
+  while (NULL != fired) {
+    hBSP430timerMuxAlarm notify = fired;
+    fired = notify->next;
+    notify->next = NULL;
+    rv |= notify->callback_ni(sap, notify);
+  }
+#else /* configBSP430_TIMER_MUXALARM_HEAP */
   hBSP430timerMuxAlarm fired = sap->alarms;
   hBSP430timerMuxAlarm * ap = &sap->alarms;
   int rv = 0;
@@ -684,7 +908,7 @@ muxAlarm_cb_ni (hBSP430timerAlarm alarm)
   }
   sap->alarms = *ap;
   if (sap->alarms) {
-    (void)timerAlarmSet_ni(&sap->dedicated, sap->alarms->setting_tck, 1);
+    (void)timerAlarmSet_ni(&sap->dedicated, MUX_WAKE_(sap), 1);
   }
   if (fired != sap->alarms) {
     *ap = NULL;
@@ -695,6 +919,7 @@ muxAlarm_cb_ni (hBSP430timerAlarm alarm)
       rv |= notify->callback_ni(sap, notify);
     }
   }
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
   return rv;
 }
 
@@ -749,6 +974,19 @@ iBSP430timerMuxAlarmAdd_ni (hBSP430timerMuxSharedAlarm shared,
 {
   int rc;
 
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0)
+  if (BSP430_TIMER_MUXALARM_HEAP_SIZE <= shared->heap_len) {
+    return -1;
+  }
+  rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
+  if (0 <= rc) {
+    alarm->next = NULL;
+    shared->heap[shared->heap_len] = alarm;
+    (void)muxHeapUp_(shared, shared->heap_len++);
+    shared->alarms = shared->heap[0];
+    rc = timerAlarmSet_ni(&shared->dedicated, MUX_WAKE_(shared), 1);
+  }
+#else /* configBSP430_TIMER_MUXALARM_HEAP */
   rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
   if (0 <= rc) {
     hBSP430timerMuxAlarm * np = &shared->alarms;
@@ -767,8 +1005,9 @@ iBSP430timerMuxAlarmAdd_ni (hBSP430timerMuxSharedAlarm shared,
     }
     alarm->next = *np;
     *np = alarm;
-    rc = timerAlarmSet_ni(&shared->dedicated, shared->alarms->setting_tck, 1);
+    rc = timerAlarmSet_ni(&shared->dedicated, MUX_WAKE_(shared), 1);
   }
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
   return rc;
 }
 
@@ -780,6 +1019,12 @@ iBSP430timerMuxAlarmRemove_ni (hBSP430timerMuxSharedAlarm shared,
 
   rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
   if (0 <= rc) {
+#if (configBSP430_TIMER_MUXALARM_HEAP - 0)
+    unsigned int idx = alarm->heap_idx;
+    if ((idx < shared->heap_len) && (alarm == shared->heap[idx])) {
+      muxHeapRemove_(shared, idx);
+    }
+#else /* configBSP430_TIMER_MUXALARM_HEAP */
     hBSP430timerMuxAlarm * np = &shared->alarms;
     while (NULL != *np) {
       if (alarm == *np) {
@@ -788,9 +1033,10 @@ iBSP430timerMuxAlarmRemove_ni (hBSP430timerMuxSharedAlarm shared,
       }
       np = &(*np)->next;
     }
+#endif /* configBSP430_TIMER_MUXALARM_HEAP */
     rc = 0;
     if (NULL != shared->alarms) {
-      rc = timerAlarmSet_ni(&shared->dedicated, shared->alarms->setting_tck, 1);
+      rc = timerAlarmSet_ni(&shared->dedicated, MUX_WAKE_(shared), 1);
     }
   }
   return rc;
@@ -940,6 +1186,338 @@ hBSP430timerPulseCaptureInitialize (hBSP430timerPulseCapture pulsecap,
   return pulsecap;
 }
 
+static int
+periodcap_isr (const struct sBSP430halISRIndexedChainNode * cb,
+               void * context,
+               int idx)
+{
+  hBSP430halTIMER timer = (hBSP430halTIMER)context;
+  hBSP430timerPeriodCapture periodcap = (hBSP430timerPeriodCapture)(-offsetof(sBSP430timerPeriodCapture, cb) + (unsigned char *)cb);
+  unsigned int flags = periodcap->flags_ni;
+  unsigned int ccr;
+  unsigned int cctl;
+  unsigned long cap_tt;
+  int rv = 0;
+
+  /* Record capture counter value then the state describing that
+   * value. */
+  ccr  = timer->hpl->ccr[idx];
+  cctl = timer->hpl->cctl[idx];
+  if (! (BSP430_TIMER_PERIODCAP_ACTIVE & flags)) {
+    return 0;
+  }
+
+  /* As with pulse capture, COV or CCIFG mean an edge was lost. */
+  if (cctl & (COV | CCIFG)) {
+    timer->hpl->cctl[idx] &= ~(COV | CCIFG);
+    flags |= BSP430_TIMER_PERIODCAP_OVERFLOW;
+  } else {
+    cap_tt = ccr;
+    if (timer->hpl->ctl & TAIE) {
+      cap_tt |= timerOverflowAdjusted_ni(timer, ccr) << 16;
+    }
+    if (BSP430_TIMER_PERIODCAP_SYNCED & flags) {
+      unsigned long period_tt = cap_tt - periodcap->last_tt_ni;
+
+      if (! (timer->hpl->ctl & TAIE)) {
+        period_tt = (uint16_t)period_tt;
+      }
+      periodcap->total_tt_ni += period_tt;
+      if ((0 == periodcap->intervals_ni) || (period_tt < periodcap->min_tt_ni)) {
+        periodcap->min_tt_ni = period_tt;
+      }
+      if (period_tt > periodcap->max_tt_ni) {
+        periodcap->max_tt_ni = period_tt;
+      }
+      if (++periodcap->intervals_ni >= periodcap->count) {
+        flags |= BSP430_TIMER_PERIODCAP_COMPLETE;
+      }
+    }
+    periodcap->last_tt_ni = cap_tt;
+    flags |= BSP430_TIMER_PERIODCAP_SYNCED;
+  }
+  if (flags & (BSP430_TIMER_PERIODCAP_COMPLETE | BSP430_TIMER_PERIODCAP_OVERFLOW)) {
+    /* The callback may start a new measurement, which re-sets
+     * ACTIVE. */
+    periodcap->flags_ni = flags & ~BSP430_TIMER_PERIODCAP_ACTIVE;
+    if (NULL != periodcap->callback_ni) {
+      periodcap->flags_ni |= BSP430_TIMER_PERIODCAP_CALLBACK_ACTIVE;
+      rv = periodcap->callback_ni(periodcap);
+      periodcap->flags_ni &= ~BSP430_TIMER_PERIODCAP_CALLBACK_ACTIVE;
+    }
+    if (! (BSP430_TIMER_PERIODCAP_ACTIVE & periodcap->flags_ni)) {
+      timer->hpl->cctl[idx] &= ~CCIE;
+    }
+  } else {
+    periodcap->flags_ni = flags;
+  }
+  return rv;
+}
+
+int
+iBSP430timerPeriodCaptureStart_ni (hBSP430timerPeriodCapture periodcap,
+                                   unsigned int count)
+{
+  unsigned int flags;
+
+  if ((NULL == periodcap)
+      || (NULL == periodcap->hal)
+      || (! (BSP430_TIMER_PERIODCAP_ENABLED & periodcap->flags_ni))
+      || (0 == count)) {
+    return -1;
+  }
+  flags = periodcap->flags_ni;
+  /* A restart from the callback of a successful measurement begins at
+   * the capture that completed it. */
+  if (! ((BSP430_TIMER_PERIODCAP_CALLBACK_ACTIVE & flags)
+         && (BSP430_TIMER_PERIODCAP_COMPLETE & flags)
+         && (! (BSP430_TIMER_PERIODCAP_OVERFLOW & flags)))) {
+    flags &= ~BSP430_TIMER_PERIODCAP_SYNCED;
+    periodcap->hal->hpl->cctl[periodcap->ccidx] &= ~(COV | CCIFG);
+  }
+  flags &= ~(BSP430_TIMER_PERIODCAP_COMPLETE | BSP430_TIMER_PERIODCAP_OVERFLOW);
+  periodcap->count = count;
+  periodcap->intervals_ni = 0;
+  periodcap->total_tt_ni = 0;
+  periodcap->min_tt_ni = 0;
+  periodcap->max_tt_ni = 0;
+  periodcap->flags_ni = flags | BSP430_TIMER_PERIODCAP_ACTIVE;
+  periodcap->hal->hpl->cctl[periodcap->ccidx] |= CCIE;
+  return 0;
+}
+
+int
+iBSP430timerPeriodCaptureStop_ni (hBSP430timerPeriodCapture periodcap)
+{
+  if ((NULL == periodcap)
+      || (NULL == periodcap->hal)
+      || (! (BSP430_TIMER_PERIODCAP_ENABLED & periodcap->flags_ni))) {
+    return -1;
+  }
+  periodcap->flags_ni &= ~BSP430_TIMER_PERIODCAP_ACTIVE;
+  periodcap->hal->hpl->cctl[periodcap->ccidx] &= ~CCIE;
+  return 0;
+}
+
+int
+iBSP430timerPeriodCaptureSetEnabled_ni (hBSP430timerPeriodCapture periodcap,
+                                        int enablep)
+{
+  if ((NULL == periodcap)
+      || (NULL == periodcap->hal)) {
+    return -1;
+  }
+  /* Spin for diagnostic, or return error to avoid corruption, if this
+   * is invoked from the callback. */
+  while (BSP430_TIMER_PERIODCAP_CALLBACK_ACTIVE & periodcap->flags_ni) {
+#if (BSP430_CORE_NDEBUG - 0)
+    return -1;
+#endif /* BSP430_CORE_NDEBUG */
+  }
+  if (enablep) {
+    if (! (periodcap->flags_ni & BSP430_TIMER_PERIODCAP_ENABLED)) {
+      BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode,
+                                      periodcap->hal->cc_cbchain_ni[periodcap->ccidx],
+                                      periodcap->cb,
+                                      next_ni);
+      periodcap->flags_ni |= BSP430_TIMER_PERIODCAP_ENABLED;
+    }
+  } else if (periodcap->flags_ni & BSP430_TIMER_PERIODCAP_ENABLED) {
+    (void)iBSP430timerPeriodCaptureStop_ni(periodcap);
+    periodcap->flags_ni &= ~BSP430_TIMER_PERIODCAP_ENABLED;
+    BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode,
+                                      periodcap->hal->cc_cbchain_ni[periodcap->ccidx],
+                                      periodcap->cb,
+                                      next_ni);
+  }
+  return 0;
+}
+
+hBSP430timerPeriodCapture
+hBSP430timerPeriodCaptureInitialize (hBSP430timerPeriodCapture periodcap,
+                                     tBSP430periphHandle periph,
+                                     int ccidx,
+                                     unsigned int capture_mode,
+                                     unsigned int ccis,
+                                     iBSP430timerPeriodCaptureCallback_ni callback)
+{
+  memset(periodcap, 0, sizeof(*periodcap));
+  periodcap->cb.callback_ni = periodcap_isr;
+  capture_mode &= CM0 | CM1;
+  periodcap->hal = hBSP430timerLookup(periph);
+  if ((NULL == periodcap->hal) || (0 == capture_mode)) {
+    periodcap->hal = NULL;
+    return NULL;
+  }
+  if (iBSP430timerSupportedCCs(periph) <= ccidx) {
+    periodcap->hal = NULL;
+    return NULL;
+  }
+  periodcap->ccidx = ccidx;
+  periodcap->callback_ni = callback;
+  periodcap->hal->hpl->cctl[ccidx] = capture_mode | (ccis & (CCIS0 | CCIS1)) | SCS | CAP;
+  return periodcap;
+}
+
+unsigned long
+ulBSP430timerExtendCaptures (unsigned long end_tt,
+                             const uint16_t * captures,
+                             unsigned long * tts,
+                             unsigned int count)
+{
+  unsigned long tt = end_tt;
+
+  if (0 < count) {
+    unsigned int i = count - 1;
+
+    tts[i] = tt;
+    while (0 < i--) {
+      tt -= (uint16_t)(captures[i + 1] - captures[i]);
+      tts[i] = tt;
+    }
+  }
+  return tt;
+}
+
+#if (configBSP430_TIMER_CAPTURE_DMA - 0)
+
+/* Each half of the buffer is one block of a repeated single transfer
+ * of words from the fixed capture register. */
+#define CAPDMA_DMACTL (DMADT_4 | DMASRCINCR_0 | DMADSTINCR_3)
+
+/* A half of the buffer is complete and the controller has reloaded
+ * the channel for the other half.  The destination register written
+ * now is used for the reload after that, so point it back at the
+ * half just completed.  The last capture happened within the
+ * interrupt latency, so its full counter value can be recovered from
+ * the current one. */
+static int
+capture_dma_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                    void * context,
+                    int idx)
+{
+  sBSP430timerCaptureDMA * cdp = (sBSP430timerCaptureDMA *)(-offsetof(sBSP430timerCaptureDMA, cb) + (unsigned char *)cb);
+  hBSP430halDMA dma = (hBSP430halDMA)context;
+  hBSP430halTIMER timer = cdp->timer;
+  unsigned int half = cdp->next_half;
+  uint16_t * hp = cdp->buffer + half * cdp->half_len;
+  unsigned long now_tt;
+  int rv;
+
+  (void)idx;
+  if (! (BSP430_TIMER_CAPDMA_ACTIVE & cdp->flags_ni)) {
+    return 0;
+  }
+  dma->hpl->ch[cdp->channel].da = (uintptr_t)hp;
+  now_tt = ulBSP430timerCounter_ni(timer, NULL);
+  cdp->end_tt_ni[half] = now_tt - (uint16_t)((unsigned int)now_tt - hp[cdp->half_len - 1]);
+  if ((dma->hpl->ch[cdp->channel].ctl & DMAIFG)
+      || (timer->hpl->cctl[cdp->ccidx] & COV)) {
+    timer->hpl->cctl[cdp->ccidx] &= ~COV;
+    cdp->flags_ni |= BSP430_TIMER_CAPDMA_OVERRUN;
+  }
+  cdp->next_half = !half;
+  ++cdp->blocks_ni;
+  rv = BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  if (NULL != cdp->callback_ni) {
+    rv = cdp->callback_ni(cdp, half);
+  }
+  return rv;
+}
+
+int
+iBSP430timerCaptureDMAConfigure_ni (sBSP430timerCaptureDMA * cdp,
+                                    tBSP430periphHandle periph,
+                                    int ccidx,
+                                    unsigned int capture_mode,
+                                    unsigned int ccis,
+                                    int channel,
+                                    int trigger,
+                                    uint16_t * buffer,
+                                    unsigned int len)
+{
+  volatile unsigned int * tselp;
+  unsigned int shift;
+
+  memset(cdp, 0, sizeof(*cdp));
+  capture_mode &= CM0 | CM1;
+  cdp->timer = hBSP430timerLookup(periph);
+  if ((NULL == cdp->timer)
+      || (0 == capture_mode)
+      || (iBSP430timerSupportedCCs(periph) <= ccidx)
+      || (0 > channel) || (BSP430_DMA_NUM_CHANNELS <= channel)
+      || (NULL == buffer) || (2 > len) || (len & 1)) {
+    cdp->timer = NULL;
+    return -1;
+  }
+  cdp->buffer = buffer;
+  cdp->half_len = len / 2;
+  cdp->ccidx = ccidx;
+  cdp->channel = channel;
+  cdp->cb.callback_ni = capture_dma_isr_ni;
+  cdp->timer->hpl->cctl[ccidx] = capture_mode | (ccis & (CCIS0 | CCIS1)) | SCS | CAP;
+
+  /* Each control word holds the trigger selections for two
+   * channels. */
+  BSP430_HPL_DMA->ch[channel].ctl = 0;
+  tselp = &BSP430_HPL_DMA->ctl0 + (channel / 2);
+  shift = 8 * (channel % 2);
+  *tselp = (*tselp & ~(0xFFU << shift)) | ((unsigned int)trigger << shift);
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[channel], cdp->cb, next_ni);
+  return 0;
+}
+
+int
+iBSP430timerCaptureDMAStart_ni (sBSP430timerCaptureDMA * cdp)
+{
+  volatile sBSP430hplDMAchannel * chp;
+
+  if ((NULL == cdp) || (NULL == cdp->timer)) {
+    return -1;
+  }
+  chp = BSP430_HPL_DMA->ch + cdp->channel;
+  chp->ctl = 0;
+  cdp->flags_ni = BSP430_TIMER_CAPDMA_ACTIVE;
+  cdp->blocks_ni = 0;
+  cdp->next_half = 0;
+  cdp->timer->hpl->cctl[cdp->ccidx] &= ~(COV | CCIFG);
+  chp->sa = (uintptr_t)(cdp->timer->hpl->ccr + cdp->ccidx);
+  chp->da = (uintptr_t)cdp->buffer;
+  chp->sz = cdp->half_len;
+  chp->ctl = CAPDMA_DMACTL | DMAIE | DMAEN;
+  /* Enabling the channel latched the first half; this is used when
+   * that block completes. */
+  chp->da = (uintptr_t)(cdp->buffer + cdp->half_len);
+  return 0;
+}
+
+int
+iBSP430timerCaptureDMAStop_ni (sBSP430timerCaptureDMA * cdp)
+{
+  volatile sBSP430hplDMAchannel * chp;
+
+  if ((NULL == cdp) || (NULL == cdp->timer)) {
+    return -1;
+  }
+  chp = BSP430_HPL_DMA->ch + cdp->channel;
+  chp->ctl &= ~(DMAEN | DMAIE | DMAIFG);
+  cdp->flags_ni &= ~BSP430_TIMER_CAPDMA_ACTIVE;
+  return cdp->half_len - chp->sz;
+}
+
+int
+iBSP430timerCaptureDMARelease_ni (sBSP430timerCaptureDMA * cdp)
+{
+  if ((NULL != cdp) && (NULL != cdp->timer)) {
+    (void)iBSP430timerCaptureDMAStop_ni(cdp);
+    BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[cdp->channel], cdp->cb, next_ni);
+    cdp->timer = NULL;
+  }
+  return 0;
+}
+
+#endif /* configBSP430_TIMER_CAPTURE_DMA */
+
 /* !BSP430! TYPE=A subst=TYPE instance=0,1,2,3 insert=hal_timer_isr_defn */
 /* BEGIN AUTOMATICALLY GENERATED CODE---DO NOT MODIFY [hal_timer_isr_defn] */
 #if (configBSP430_HAL_TA0_CC0_ISR - 0)
@@ -563,6 +563,85 @@ iBSP430usciI2CtxData_rh (hBSP430halSERIAL hal,
   return i;
 }
 
+static int
+usci_i2c_txrx_rh (hBSP430halSERIAL hal,
+                  const uint8_t * tx_data,
+                  size_t tx_len,
+                  uint8_t * rx_data,
+                  size_t rx_len)
+{
+  volatile struct sBSP430hplUSCI * hpl = SERIAL_HAL_HPL(hal);
+  struct sBSP430usciHPLAux * aux = SERIAL_HAL_HPLAUX(hal);
+  uint8_t * dp = rx_data;
+  const uint8_t * dpe = rx_data + rx_len;
+  int i = 0;
+
+  if (0 == rx_len) {
+    return iBSP430usciI2CtxData_rh(hal, tx_data, tx_len);
+  }
+  if (0 == tx_len) {
+    return iBSP430usciI2CrxData_rh(hal, rx_data, rx_len);
+  }
+
+  /* Check for errors while waiting for any in-progress activity to
+   * complete */
+  I2C_ERRCHECK_SPIN_WHILE_COND(hpl->stat & UCBUSY);
+
+  /* Issue a start for transmit and send the data. */
+  hpl->ctl1 |= UCTR | UCTXSTT;
+  while (i < tx_len) {
+    I2C_ERRCHECK_SPIN_WHILE_COND(! (aux->tx_bit & *aux->ifgp));
+    hpl->txbuf = tx_data[i++];
+    ++hal->num_tx;
+  }
+
+  /* Once the last octet has moved to the shift register, switch to
+   * receive and issue a repeated start.  The peripheral generates it
+   * after the octet has been acknowledged. */
+  I2C_ERRCHECK_SPIN_WHILE_COND(! (aux->tx_bit & *aux->ifgp));
+  hpl->ctl1 &= ~UCTR;
+  hpl->ctl1 |= UCTXSTT;
+  while (dp < dpe) {
+    if (dpe == (dp+1)) {
+      /* This will be last character: wait for the repeated start to
+       * complete then issue stop to be transmitted with next
+       * receive. */
+      if (hpl->ctl1 & UCTXSTT) {
+        I2C_ERRCHECK_SPIN_WHILE_COND(hpl->ctl1 & UCTXSTT);
+      }
+      hpl->ctl1 |= UCTXSTP;
+    }
+    I2C_ERRCHECK_SPIN_WHILE_COND(! (aux->rx_bit & *aux->ifgp));
+    *dp++ = hpl->rxbuf;
+    ++hal->num_rx;
+  }
+
+  /* Wait for STP transmission to complete */
+  I2C_ERRCHECK_SPIN_WHILE_COND(hpl->ctl1 & UCTXSTP);
+
+  return dp - rx_data;
+}
+
+/* On failure the bus is released and the error cleared, so that a
+ * later transaction can proceed. */
+int
+iBSP430usciI2CtxRxData_rh (hBSP430halSERIAL hal,
+                           const uint8_t * tx_data,
+                           size_t tx_len,
+                           uint8_t * rx_data,
+                           size_t rx_len)
+{
+  int rc = usci_i2c_txrx_rh(hal, tx_data, tx_len, rx_data, rx_len);
+
+  if (0 > rc) {
+    volatile struct sBSP430hplUSCI * hpl = SERIAL_HAL_HPL(hal);
+
+    hpl->ctl1 |= UCTXSTP;
+    hpl->stat &= ~(UCNACKIFG | UCALIFG);
+  }
+  return rc;
+}
+
 #if (BSP430_SERIAL - 0)
 static struct sBSP430serialDispatch dispatch_ = {
 #if (configBSP430_SERIAL_ENABLE_UART - 0)
@@ -581,6 +660,7 @@ static struct sBSP430serialDispatch dispatch_ = {
   .i2cSetAddresses_rh = iBSP430usciI2CsetAddresses_rh,
   .i2cRxData_rh = iBSP430usciI2CrxData_rh,
   .i2cTxData_rh = iBSP430usciI2CtxData_rh,
+  .i2cTxRxData_rh = iBSP430usciI2CtxRxData_rh,
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
   .setReset_rh = iBSP430usciSetReset_rh,
   .setHold_rh = iBSP430usciSetHold_rh,
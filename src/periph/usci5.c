@@ -532,6 +532,154 @@ iBSP430usci5I2CtxData_rh (hBSP430halSERIAL hal,
   return i;
 }
 
+static int
+usci5_i2c_txrx_rh (hBSP430halSERIAL hal,
+                   const uint8_t * tx_data,
+                   size_t tx_len,
+                   uint8_t * rx_data,
+                   size_t rx_len)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+  uint8_t * dp = rx_data;
+  const uint8_t * dpe = rx_data + rx_len;
+  int i = 0;
+
+  if (0 == rx_len) {
+    return iBSP430usci5I2CtxData_rh(hal, tx_data, tx_len);
+  }
+  if (0 == tx_len) {
+    return iBSP430usci5I2CrxData_rh(hal, rx_data, rx_len);
+  }
+
+  /* Check for errors while waiting for any in-progress activity to
+   * complete */
+  I2C_ERRCHECK_SPIN_WHILE_COND(hpl->stat & UCBUSY);
+
+  /* Issue a start for transmit and send the data. */
+  hpl->ctl1 |= UCTR | UCTXSTT;
+  while (i < tx_len) {
+    I2C_ERRCHECK_SPIN_WHILE_COND(! (hpl->ifg & UCTXIFG));
+    hpl->txbuf = tx_data[i];
+    ++i;
+  }
+
+  /* Once the last octet has moved to the shift register, switch to
+   * receive and issue a repeated start.  The peripheral generates it
+   * after the octet has been acknowledged. */
+  I2C_ERRCHECK_SPIN_WHILE_COND(! (hpl->ifg & UCTXIFG));
+  hpl->ctl1 &= ~UCTR;
+  hpl->ctl1 |= UCTXSTT;
+  while (dp < dpe) {
+    if (dpe == (dp+1)) {
+      /* This will be last character: wait for the repeated start to
+       * complete then issue stop to be transmitted with next
+       * receive. */
+      if (hpl->ctl1 & UCTXSTT) {
+        I2C_ERRCHECK_SPIN_WHILE_COND(hpl->ctl1 & UCTXSTT);
+      }
+      hpl->ctl1 |= UCTXSTP;
+    }
+    I2C_ERRCHECK_SPIN_WHILE_COND(! (hpl->ifg & UCRXIFG));
+    ++hal->num_rx;
+    *dp++ = hpl->rxbuf;
+  }
+
+  /* Wait for STP transmission to complete */
+  I2C_ERRCHECK_SPIN_WHILE_COND(hpl->ctl1 & UCTXSTP);
+
+  return dp - rx_data;
+}
+
+/* On failure the bus is released and the error cleared, so that a
+ * later transaction can proceed. */
+int
+iBSP430usci5I2CtxRxData_rh (hBSP430halSERIAL hal,
+                            const uint8_t * tx_data,
+                            size_t tx_len,
+                            uint8_t * rx_data,
+                            size_t rx_len)
+{
+  int rc = usci5_i2c_txrx_rh(hal, tx_data, tx_len, rx_data, rx_len);
+
+  if (0 > rc) {
+    volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+
+    hpl->ctl1 |= UCTXSTP;
+    hpl->ifg &= ~(UCNACKIFG | UCALIFG);
+  }
+  return rc;
+}
+
+#if (configBSP430_SERIAL_ENABLE_I2C - 0) && (configBSP430_SERIAL_I2C_ASYNC - 0)
+
+/* Interrupts used by the queued transaction engine */
+#define I2C_ENGINE_IE (UCNACKIE | UCALIE | UCTXIE | UCRXIE)
+
+/* Issue a START (or repeated START) for the read phase of the active
+ * transaction.  The peripheral does not signal acknowledgement of the
+ * address in receive mode, so a single-octet read has to wait for it
+ * before requesting the STOP. */
+static int
+usci5_i2c_start_rx_ni (volatile struct sBSP430hplUSCI5 * hpl,
+                       sBSP430i2cTransaction * tp)
+{
+  hpl->ctl1 &= ~UCTR;
+  hpl->ctl1 |= UCTXSTT;
+  if (1 == tp->rx_rem) {
+    I2C_ERRCHECK_SPIN_WHILE_COND(hpl->ctl1 & UCTXSTT);
+    hpl->ctl1 |= UCTXSTP;
+  }
+  return 0;
+}
+
+/* Wait for the STOP that ends the write phase before starting the
+ * read phase. */
+static int
+usci5_i2c_restart_rx_ni (volatile struct sBSP430hplUSCI5 * hpl,
+                         sBSP430i2cTransaction * tp)
+{
+  hpl->ctl1 |= UCTXSTP;
+  I2C_ERRCHECK_SPIN_WHILE_COND(hpl->ctl1 & UCTXSTP);
+  return usci5_i2c_start_rx_ni(hpl, tp);
+}
+
+static int
+usci5_i2c_start_ni (volatile struct sBSP430hplUSCI5 * hpl,
+                    sBSP430i2cTransaction * tp)
+{
+  /* Discard flags left by the previous transaction, and wait for
+   * any STOP it requested to complete */
+  hpl->ifg &= ~(UCNACKIFG | UCALIFG | UCTXIFG | UCRXIFG);
+  I2C_ERRCHECK_SPIN_WHILE_COND(hpl->ctl1 & UCTXSTP);
+  if (0 <= tp->address) {
+    hpl->i2csa = tp->address;
+  }
+  hpl->ie |= I2C_ENGINE_IE;
+  if (0 < tp->tx_rem) {
+    hpl->ctl1 |= UCTR | UCTXSTT;
+    return 0;
+  }
+  return usci5_i2c_start_rx_ni(hpl, tp);
+}
+
+static int
+iBSP430usci5I2Cstart_ni (hBSP430halSERIAL hal)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+  int rc;
+
+  if (! (hal->hal_state.cflags & BSP430_PERIPH_HAL_STATE_CFLAGS_ISR)) {
+    return -1;
+  }
+  rc = usci5_i2c_start_ni(hpl, hal->i2c_queue_ni);
+  if (0 > rc) {
+    hpl->ie &= ~I2C_ENGINE_IE;
+  }
+  return rc;
+}
+
+#endif /* configBSP430_SERIAL_I2C_ASYNC */
+
 /* Since the interrupt code is the same for all peripherals, on MCUs
  * with multiple USCI5 devices it is more space efficient to share it.
  * This does add an extra call/return for some minor cost in stack
@@ -555,6 +703,64 @@ iBSP430usci5I2CtxData_rh (hBSP430halSERIAL hal,
      || (configBSP430_HAL_USCI5_B2_ISR - 0)     \
      || (configBSP430_HAL_USCI5_B3_ISR - 0)     \
      )
+#if (configBSP430_SERIAL_ENABLE_I2C - 0) && (configBSP430_SERIAL_I2C_ASYNC - 0)
+/* Advance the active transaction in response to an I2C interrupt. */
+static int
+usci5_i2c_isr_ni (hBSP430halSERIAL hal,
+                  unsigned int iv)
+{
+  volatile struct sBSP430hplUSCI5 * hpl = SERIAL_HAL_HPL(hal);
+  sBSP430i2cTransaction * tp = hal->i2c_queue_ni;
+  int result = 0;
+  int rv = 0;
+
+  switch (iv) {
+    default:
+      break;
+    case USCI_I2C_UCALIFG:
+      result = -(BSP430_I2C_ERRFLAG_PROTOCOL | UCALIFG);
+      break;
+    case USCI_I2C_UCNACKIFG:
+      hpl->ctl1 |= UCTXSTP;
+      result = -(BSP430_I2C_ERRFLAG_PROTOCOL | UCNACKIFG);
+      break;
+    case USCI_I2C_UCTXIFG:
+      if (0 < tp->tx_rem) {
+        hpl->txbuf = *tp->txp++;
+        --tp->tx_rem;
+        ++hal->num_tx;
+      } else if (0 < tp->rx_rem) {
+        if (tp->flags & BSP430_I2C_TXN_FLAG_REPEATED_START) {
+          result = usci5_i2c_start_rx_ni(hpl, tp);
+        } else {
+          result = usci5_i2c_restart_rx_ni(hpl, tp);
+        }
+      } else {
+        hpl->ctl1 |= UCTXSTP;
+        result = tp->tx_len;
+      }
+      break;
+    case USCI_I2C_UCRXIFG:
+      *tp->rxp++ = hpl->rxbuf;
+      ++hal->num_rx;
+      if (0 == --tp->rx_rem) {
+        result = tp->tx_len + tp->rx_len;
+      } else if (1 == tp->rx_rem) {
+        hpl->ctl1 |= UCTXSTP;
+      }
+      break;
+  }
+  if (0 != result) {
+    rv = iBSP430i2cTransactionComplete_ni_(hal, result);
+    if (NULL == hal->i2c_queue_ni) {
+      hpl->ie &= ~I2C_ENGINE_IE;
+    }
+  }
+  return rv;
+}
+
+#endif /* configBSP430_SERIAL_I2C_ASYNC */
+
 static int
 #if (20120406 < __MSPGCC__) && (__MSP430X__ - 0)
 __attribute__ ( ( __c16__ ) )
@@ -562,10 +768,16 @@ __attribute__ ( ( __c16__ ) )
 /* __attribute__((__always_inline__)) */
 usci5_isr (hBSP430halSERIAL hal)
 {
+  unsigned int iv = SERIAL_HAL_HPL(hal)->iv;
   int did_tx;
   int rv = 0;
 
-  switch (SERIAL_HAL_HPL(hal)->iv) {
+#if (configBSP430_SERIAL_ENABLE_I2C - 0) && (configBSP430_SERIAL_I2C_ASYNC - 0)
+  if (hal->i2c_queue_ni && MODE_IS_I2C(hal)) {
+    return usci5_i2c_isr_ni(hal, iv);
+  }
+#endif /* configBSP430_SERIAL_I2C_ASYNC */
+  switch (iv) {
     default:
     case USCI_NONE:
       break;
@@ -620,6 +832,10 @@ static struct sBSP430serialDispatch dispatch_ = {
   .i2cSetAddresses_rh = iBSP430usci5I2CsetAddresses_rh,
   .i2cRxData_rh = iBSP430usci5I2CrxData_rh,
   .i2cTxData_rh = iBSP430usci5I2CtxData_rh,
+  .i2cTxRxData_rh = iBSP430usci5I2CtxRxData_rh,
+#if (configBSP430_SERIAL_I2C_ASYNC - 0)
+  .i2cStart_ni = iBSP430usci5I2Cstart_ni,
+#endif /* configBSP430_SERIAL_I2C_ASYNC */
 #endif /* configBSP430_SERIAL_ENABLE_I2C */
   .setReset_rh = iBSP430usci5SetReset_rh,
   .setHold_rh = iBSP430usci5SetHold_rh,
@@ -0,0 +1,187 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Platform implementation for native execution on the development host
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#include <bsp430/utility/led.h>
+#include <bsp430/periph/usci5.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/periph/port.h>
+#include <bsp430/platform/host/platform.h>
+
+#include <bsp430/platform/standard.inc>
+
+#if (BSP430_LED - 0)
+const sBSP430halLED xBSP430halLED_[] = {
+  { .outp = &P1OUT, .bit = BIT0 }, /* Red */
+  { .outp = &P4OUT, .bit = BIT7 }, /* Green */
+};
+const unsigned char nBSP430led = sizeof(xBSP430halLED_) / sizeof(*xBSP430halLED_);
+#endif /* BSP430_LED */
+
+int
+iBSP430platformConfigurePeripheralPins_ni (tBSP430periphHandle device,
+                                           int periph_config,
+                                           int enablep)
+{
+  unsigned char bits = 0;
+  uintptr_t pba = 0;
+  volatile sBSP430hplPORT_5XX_8 * hpl;
+
+  if (BSP430_PERIPH_LFXT1 == device) {
+    /* The simulated crystal needs no pins */
+    return 0;
+  }
+#if (configBSP430_HPL_USCI5_A0 - 0)
+  else if (BSP430_PERIPH_USCI5_A0 == device) {
+    bits = BIT3 | BIT4;
+    pba = BSP430_PERIPH_PORT3_BASEADDRESS_;
+  }
+#endif /* configBSP430_HPL_USCI5_A0 */
+#if (configBSP430_HPL_USCI5_A1 - 0)
+  else if (BSP430_PERIPH_USCI5_A1 == device) {
+    bits = BIT4 | BIT5;
+    if ((BSP430_PERIPHCFG_SERIAL_SPI3 == periph_config)
+        || (BSP430_PERIPHCFG_SERIAL_SPI4 == periph_config)) {
+      bits |= BIT0;
+      if (BSP430_PERIPHCFG_SERIAL_SPI4 == periph_config) {
+        bits |= BIT3;
+      }
+    }
+    pba = BSP430_PERIPH_PORT4_BASEADDRESS_;
+  }
+#endif /* configBSP430_HPL_USCI5_A1 */
+#if (configBSP430_HPL_USCI5_B0 - 0)
+  else if (BSP430_PERIPH_USCI5_B0 == device) {
+    bits = BIT0 | BIT1;
+    if ((BSP430_PERIPHCFG_SERIAL_SPI3 == periph_config)
+        || (BSP430_PERIPHCFG_SERIAL_SPI4 == periph_config)) {
+      bits |= BIT2;
+    }
+    pba = BSP430_PERIPH_PORT3_BASEADDRESS_;
+  }
+#endif /* configBSP430_HPL_USCI5_B0 */
+#if (configBSP430_HPL_USCI5_B1 - 0)
+  else if (BSP430_PERIPH_USCI5_B1 == device) {
+    bits = BIT1 | BIT2;
+    if ((BSP430_PERIPHCFG_SERIAL_SPI3 == periph_config)
+        || (BSP430_PERIPHCFG_SERIAL_SPI4 == periph_config)) {
+      bits |= BIT3;
+      if (BSP430_PERIPHCFG_SERIAL_SPI4 == periph_config) {
+        bits |= BIT0;
+      }
+    }
+    pba = BSP430_PERIPH_PORT4_BASEADDRESS_;
+  }
+#endif /* configBSP430_HPL_USCI5_B1 */
+  if (0 == pba) {
+    return -1;
+  }
+  hpl = (volatile sBSP430hplPORT_5XX_8 *)pba;
+  if (enablep) {
+    hpl->ren &= ~bits;
+    hpl->sel |= bits;
+  } else {
+    hpl->out &= ~bits;
+    hpl->dir |= bits;
+    hpl->sel &= ~bits;
+  }
+  return 0;
+}
+
+const char *
+xBSP430platformPeripheralHelp (tBSP430periphHandle device,
+                               int periph_config)
+{
+  if (BSP430_PERIPH_LFXT1 == device) {
+    return "simulated 32 KiHz crystal";
+  }
+#if (configBSP430_HPL_USCI5_A0 - 0)
+  if (BSP430_PERIPH_USCI5_A0 == device) {
+    return "MOSI/TXD=P3.3; MISO/RXD=P3.4";
+  }
+#endif /* configBSP430_HPL_USCI5_A0 */
+#if (configBSP430_HPL_USCI5_A1 - 0)
+  if (BSP430_PERIPH_USCI5_A1 == device) {
+    return "MOSI/TXD=P4.4 (stdout); MISO/RXD=P4.5; CLK=P4.0; STE=P4.3";
+  }
+#endif /* configBSP430_HPL_USCI5_A1 */
+#if (configBSP430_HPL_USCI5_B0 - 0)
+  if (BSP430_PERIPH_USCI5_B0 == device) {
+    return "MOSI/SDA=P3.0; MISO/SCL=P3.1; CLK=P3.2";
+  }
+#endif /* configBSP430_HPL_USCI5_B0 */
+#if (configBSP430_HPL_USCI5_B1 - 0)
+  if (BSP430_PERIPH_USCI5_B1 == device) {
+    return "MOSI/SDA=P4.1; MISO/SCL=P4.2; CLK=P4.3; STE=P4.0";
+  }
+#endif /* configBSP430_HPL_USCI5_B1 */
+  return NULL;
+}
+
+void
+vBSP430platformSpinForJumper_ni (void)
+{
+  /* P2.0 configured with pullup */
+  P2DIR &= ~BIT0;
+  P2REN |= BIT0;
+  P2OUT |= BIT0;
+
+  /* Flash LEDs alternately while waiting.  Nothing drives P2.0 low
+   * unless the application uses iBSP430hostSetPortInput(). */
+#if BSP430_LED
+  vBSP430ledInitialize_ni();
+#else /* BSP430_LED */
+  P1DIR |= BIT0;
+  P1SEL &= ~BIT0;
+  P4DIR |= BIT7;
+  P4SEL &= ~BIT7;
+#endif /* BSP430_LED */
+  P1OUT |= BIT0;
+  while (! (P2IN & BIT0)) {
+    BSP430_CORE_WATCHDOG_CLEAR();
+    BSP430_CORE_DELAY_CYCLES(BSP430_CLOCK_NOMINAL_MCLK_HZ / 10);
+    P1OUT ^= BIT0;
+    P4OUT ^= BIT7;
+  }
+
+  /* Restore P2.0 and LEDs */
+  P1OUT &= ~BIT0;
+  P4OUT &= ~BIT7;
+  P2DIR |= BIT0;
+  P2REN &= ~BIT0;
+}
@@ -0,0 +1,1957 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Peripheral simulator for the host platform
+ *
+ * See <bsp430/platform/host/sim.h> for the model.  The peripheral
+ * page is mapped twice: once at #__MSP430_HOST_PERIPH_BASE__ with no
+ * access, which is what the application sees, and once read/write for
+ * the simulator.  An application access faults; the fault handler
+ * brings the simulation up to date, opens the page, and single-steps
+ * the faulting instruction.  The resulting trap closes the page and
+ * applies side effects by comparing the page against its state
+ * before the access.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+/* Needed for memfd_create() and the register indexes of ucontext_t.
+ * Normally supplied by the platform Makefile.common. */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/periph/usci5.h>
+#include <bsp430/periph/port.h>
+#include <bsp430/periph/dma.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#if ! (defined(__x86_64__) && defined(__linux__))
+#error The host platform simulator requires x86_64 Linux
+#endif /* x86_64 Linux */
+
+/* MCLK cycles charged for each peripheral register access */
+#define ACCESS_CYCLES 3
+
+/* MCLK cycles charged for interrupt entry and return */
+#define INTERRUPT_CYCLES 6
+#define RETI_CYCLES 5
+
+/* Trap flag in RFLAGS */
+#define EFLAGS_TF 0x100
+
+/* Write bit of the page fault error code */
+#define PF_ERR_WRITE 0x2
+
+#define PERIPH_BASE __MSP430_HOST_PERIPH_BASE__
+#define PERIPH_SIZE __MSP430_HOST_PERIPH_SIZE__
+
+/* Offset within the peripheral page of an application address */
+#define OFS(a_) ((unsigned long)(a_) - PERIPH_BASE)
+
+/* The application-visible layout relies on the HPL structures having
+ * these offsets on the host. */
+_Static_assert(offsetof(sBSP430hplTIMER, r) == __MSP430_HOST_TIMER_R_OFS, "timer r");
+_Static_assert(offsetof(sBSP430hplTIMER, cctl[1]) == __MSP430_HOST_TIMER_CCTL_OFS(1), "timer cctl");
+_Static_assert(offsetof(sBSP430hplTIMER, ccr[2]) == __MSP430_HOST_TIMER_CCR_OFS(2), "timer ccr");
+_Static_assert(sizeof(sBSP430hplTIMER) <= __MSP430_HOST_TIMER_EX0_OFS, "timer ex0");
+_Static_assert(offsetof(sBSP430hplUSCI5, ifg) == 0x35, "usci5 ifg");
+_Static_assert(offsetof(sBSP430hplUSCI5, iv) == 0x38, "usci5 iv");
+_Static_assert(offsetof(sBSP430hplDMA, iv) == 0x1C, "dma iv");
+_Static_assert(offsetof(sBSP430hplDMA, ch[1]) == 0x48, "dma ch");
+_Static_assert(offsetof(sBSP430hplPORT_5XX_8, ifg) == 0x1C, "port ifg");
+
+/* Interrupt handlers are located through weak references, so an
+ * application that does not link a handler gets a null pointer. */
+#define WEAK_ISR(n_) extern void n_ (void) __attribute__((__weak__))
+WEAK_ISR(isr_cc0_TA0);
+WEAK_ISR(isr_TA0);
+WEAK_ISR(isr_cc0_TA1);
+WEAK_ISR(isr_TA1);
+WEAK_ISR(isr_cc0_TA2);
+WEAK_ISR(isr_TA2);
+WEAK_ISR(isr_cc0_TB0);
+WEAK_ISR(isr_TB0);
+WEAK_ISR(isr_USCI5_A0);
+WEAK_ISR(isr_USCI5_B0);
+WEAK_ISR(isr_USCI5_A1);
+WEAK_ISR(isr_USCI5_B1);
+WEAK_ISR(isr_PORT1);
+WEAK_ISR(isr_PORT2);
+WEAK_ISR(isr_DMA);
+
+/* DMA trigger numbers, from the DMAxTSEL values */
+#define TRIG_NONE -1
+#define TRIG_DMAREQ 0
+#define TRIG_TA0CCR0 1
+#define TRIG_TA0CCR2 2
+#define TRIG_TA1CCR0 3
+#define TRIG_TA1CCR2 4
+#define TRIG_TA2CCR0 5
+#define TRIG_TA2CCR2 6
+#define TRIG_TB0CCR0 7
+#define TRIG_TB0CCR2 8
+#define TRIG_UCA0RXIFG 16
+#define TRIG_UCA0TXIFG 17
+#define TRIG_UCB0RXIFG 18
+#define TRIG_UCB0TXIFG 19
+#define TRIG_UCA1RXIFG 20
+#define TRIG_UCA1TXIFG 21
+#define TRIG_UCB1RXIFG 22
+#define TRIG_UCB1TXIFG 23
+
+typedef struct sSimTimer {
+  unsigned long base;
+  int nccs;
+  unsigned int cc0_vector;
+  unsigned int vector;
+  void (* cc0_isr) (void);
+  void (* isr) (void);
+  int trig_ccr0;
+  int trig_ccr2;
+  /* Fraction of a timer tick, in units of 1/(MCLK * divider) */
+  unsigned long long acc;
+  /* Counting down in up/down mode */
+  int down;
+} sSimTimer;
+
+#define USCI_RXQ_SIZE 1024
+#define USCI_OUT_SIZE 256
+
+typedef struct sSimUSCI {
+  unsigned long base;
+  unsigned int vector;
+  void (* isr) (void);
+  int trig_rx;
+  int trig_tx;
+  /* A byte is in the shift register, completing at shift_done */
+  int shifting;
+  unsigned char shift;
+  unsigned long long shift_done;
+  /* A byte is waiting in TXBUF for the shift register */
+  int pending;
+  unsigned char pend;
+  /* Injected receive data, next byte delivered at rx_at */
+  unsigned char rxq[USCI_RXQ_SIZE];
+  unsigned int rxq_head;
+  unsigned int rxq_count;
+  unsigned long long rx_at;
+  /* Completion time of an I2C START or STOP */
+  unsigned long long i2c_at;
+  /* Address of the simulated I2C slave, if i2c_slave_valid */
+  int i2c_slave_valid;
+  unsigned int i2c_slave;
+  /* The slave is sending data to the master */
+  int i2c_rx;
+  /* UART output not yet written to stdout */
+  char out[USCI_OUT_SIZE];
+  unsigned int nout;
+  /* Where UART output is collected instead, if not null */
+  unsigned char * cap;
+  size_t cap_size;
+  size_t cap_len;
+} sSimUSCI;
+
+typedef struct sSimPort {
+  unsigned long base;
+  /* Address of PxIV, zero for ports without interrupts */
+  unsigned long iv;
+  unsigned int vector;
+  void (* isr) (void);
+  /* Level driven on the pins from outside */
+  unsigned char ext;
+  /* Level most recently presented in PxIN */
+  unsigned char level;
+} sSimPort;
+
+/* Working copies of the channel addresses and count; the registers
+ * retain the initial values for repeated transfers. */
+typedef struct sSimDMAChannel {
+  unsigned long sa;
+  unsigned long da;
+  unsigned int sz;
+  unsigned int sz0;
+} sSimDMAChannel;
+
+static sSimTimer timers_[] = {
+  { .base = __MSP430_BASEADDRESS_T0A5__, .nccs = 5,
+    .cc0_vector = TIMER0_A0_VECTOR, .vector = TIMER0_A1_VECTOR,
+    .cc0_isr = isr_cc0_TA0, .isr = isr_TA0,
+    .trig_ccr0 = TRIG_TA0CCR0, .trig_ccr2 = TRIG_TA0CCR2 },
+  { .base = __MSP430_BASEADDRESS_T1A3__, .nccs = 3,
+    .cc0_vector = TIMER1_A0_VECTOR, .vector = TIMER1_A1_VECTOR,
+    .cc0_isr = isr_cc0_TA1, .isr = isr_TA1,
+    .trig_ccr0 = TRIG_TA1CCR0, .trig_ccr2 = TRIG_TA1CCR2 },
+  { .base = __MSP430_BASEADDRESS_T2A3__, .nccs = 3,
+    .cc0_vector = TIMER2_A0_VECTOR, .vector = TIMER2_A1_VECTOR,
+    .cc0_isr = isr_cc0_TA2, .isr = isr_TA2,
+    .trig_ccr0 = TRIG_TA2CCR0, .trig_ccr2 = TRIG_TA2CCR2 },
+  { .base = __MSP430_BASEADDRESS_T0B7__, .nccs = 7,
+    .cc0_vector = TIMER0_B0_VECTOR, .vector = TIMER0_B1_VECTOR,
+    .cc0_isr = isr_cc0_TB0, .isr = isr_TB0,
+    .trig_ccr0 = TRIG_TB0CCR0, .trig_ccr2 = TRIG_TB0CCR2 },
+};
+#define NUM_TIMERS (sizeof(timers_) / sizeof(*timers_))
+
+static sSimUSCI uscis_[] = {
+  { .base = __MSP430_BASEADDRESS_USCI_A0__, .vector = USCI_A0_VECTOR, .isr = isr_USCI5_A0,
+    .trig_rx = TRIG_UCA0RXIFG, .trig_tx = TRIG_UCA0TXIFG },
+  { .base = __MSP430_BASEADDRESS_USCI_B0__, .vector = USCI_B0_VECTOR, .isr = isr_USCI5_B0,
+    .trig_rx = TRIG_UCB0RXIFG, .trig_tx = TRIG_UCB0TXIFG },
+  { .base = __MSP430_BASEADDRESS_USCI_A1__, .vector = USCI_A1_VECTOR, .isr = isr_USCI5_A1,
+    .trig_rx = TRIG_UCA1RXIFG, .trig_tx = TRIG_UCA1TXIFG },
+  { .base = __MSP430_BASEADDRESS_USCI_B1__, .vector = USCI_B1_VECTOR, .isr = isr_USCI5_B1,
+    .trig_rx = TRIG_UCB1RXIFG, .trig_tx = TRIG_UCB1TXIFG },
+};
+#define NUM_USCIS (sizeof(uscis_) / sizeof(*uscis_))
+
+static sSimPort ports_[] = {
+  { .base = BSP430_PERIPH_PORT1_BASEADDRESS_, .iv = __MSP430_BASEADDRESS_PORTA_R__ + 0x0E,
+    .vector = PORT1_VECTOR, .isr = isr_PORT1 },
+  { .base = BSP430_PERIPH_PORT2_BASEADDRESS_, .iv = __MSP430_BASEADDRESS_PORTA_R__ + 0x1E,
+    .vector = PORT2_VECTOR, .isr = isr_PORT2 },
+  { .base = BSP430_PERIPH_PORT3_BASEADDRESS_ },
+  { .base = BSP430_PERIPH_PORT4_BASEADDRESS_ },
+  { .base = BSP430_PERIPH_PORT5_BASEADDRESS_ },
+  { .base = BSP430_PERIPH_PORT6_BASEADDRESS_ },
+  { .base = BSP430_PERIPH_PORT7_BASEADDRESS_ },
+  { .base = BSP430_PERIPH_PORT8_BASEADDRESS_ },
+  { .base = __MSP430_BASEADDRESS_PORTJ_R__ },
+};
+#define NUM_PORTS (sizeof(ports_) / sizeof(*ports_))
+
+static sSimDMAChannel dma_[BSP430_DMA_NUM_CHANNELS];
+
+/* Simulator view of the peripheral page */
+static unsigned char * sim_;
+
+/* Page contents before the access being single-stepped */
+static unsigned char shadow_[PERIPH_SIZE];
+
+/* Page offset and direction of the access being single-stepped */
+static unsigned long access_ofs_;
+static int access_write_;
+/* Offset of the previous read, or -1 if the previous access was a write */
+static long poll_ofs_ = -1;
+/* Value returned by the previous read, and the number of consecutive
+ * reads that found it unchanged */
+static unsigned char poll_val_;
+static unsigned int poll_repeat_;
+
+/* Virtual MCLK cycle counter */
+static unsigned long long now_;
+
+/* Simulated status register, and the values saved on interrupt
+ * entry */
+static unsigned int sr_;
+static unsigned int saved_sr_[16];
+static unsigned int nsaved_sr_;
+
+/* DMA channels with an outstanding trigger, and a guard against
+ * re-entering the DMA engine from a transfer's side effects */
+static unsigned int dma_pending_;
+static int dma_active_;
+
+/* Clock configuration */
+static unsigned long mclk_hz_ = BSP430_CLOCK_PUC_MCLK_HZ;
+static eBSP430clockSource smclk_src_ = eBSP430clockSRC_DCOCLKDIV;
+static unsigned int smclk_shift_;
+static eBSP430clockSource aclk_src_ = eBSP430clockSRC_XT1CLK;
+static unsigned int aclk_shift_;
+
+static void flush_output (void);
+
+static void __attribute__((__noreturn__))
+sim_fatal (const char * what)
+{
+  flush_output();
+  fflush(stdout);
+  fprintf(stderr, "host: %s at cycle %llu\n", what, now_);
+  abort();
+}
+
+#define SIM_HPL(type_, base_) ((volatile type_ *)(sim_ + OFS(base_)))
+#define SIM_REG16(addr_) (*(volatile uint16_t *)(sim_ + OFS(addr_)))
+
+static unsigned long
+source_hz (eBSP430clockSource src)
+{
+  switch (src) {
+    case eBSP430clockSRC_VLOCLK:
+      return BSP430_CLOCK_NOMINAL_VLOCLK_HZ;
+    case eBSP430clockSRC_XT1CLK:
+    case eBSP430clockSRC_REFOCLK:
+    case eBSP430clockSRC_XT1CLK_OR_VLOCLK:
+    case eBSP430clockSRC_XT1CLK_OR_REFOCLK:
+    case eBSP430clockSRC_XT1CLK_FALLBACK:
+      return BSP430_CLOCK_NOMINAL_XT1CLK_HZ;
+    case eBSP430clockSRC_DCOCLK:
+      return 2 * mclk_hz_;
+    case eBSP430clockSRC_DCOCLKDIV:
+    case eBSP430clockSRC_SMCLK_PU_DEFAULT:
+      return mclk_hz_;
+    default:
+      break;
+  }
+  return 0;
+}
+
+static unsigned long
+aclk_hz (void)
+{
+  return source_hz(aclk_src_) >> aclk_shift_;
+}
+
+static unsigned long
+smclk_hz (void)
+{
+  return source_hz(smclk_src_) >> smclk_shift_;
+}
+
+/* ---------------------------------------------------------------- */
+/* DMA */
+
+/* Returns the number of channels that responded to the trigger */
+static int
+dma_trigger (int trig)
+{
+  volatile sBSP430hplDMA * hpl;
+  int ch;
+  int rv = 0;
+
+  if (TRIG_NONE == trig) {
+    return rv;
+  }
+  hpl = SIM_HPL(sBSP430hplDMA, BSP430_PERIPH_DMA_BASEADDRESS_);
+  for (ch = 0; ch < BSP430_DMA_NUM_CHANNELS; ++ch) {
+    unsigned int tsel;
+    if (! (hpl->ch[ch].ctl & DMAEN)) {
+      continue;
+    }
+    /* Each trigger select register holds the selection for an even
+     * channel in its low byte and the following odd channel in its
+     * high byte. */
+    switch (ch / 2) {
+      case 0:
+        tsel = hpl->ctl0;
+        break;
+      case 1:
+        tsel = hpl->ctl1;
+        break;
+      case 2:
+        tsel = hpl->ctl2;
+        break;
+      default:
+        tsel = hpl->ctl3;
+        break;
+    }
+    if (ch & 1) {
+      tsel >>= 8;
+    }
+    if ((tsel & 0x1F) == (unsigned int)trig) {
+      dma_pending_ |= 1U << ch;
+      ++rv;
+    }
+  }
+  return rv;
+}
+
+static void apply_write (unsigned long ofs, int is_write);
+static void read_hook (unsigned long ofs);
+
+static unsigned int
+dma_load (unsigned long addr,
+          int bytep)
+{
+  unsigned int v;
+
+  if ((PERIPH_BASE <= addr) && (addr < PERIPH_BASE + PERIPH_SIZE)) {
+    read_hook(OFS(addr));
+    addr = (unsigned long)sim_ + OFS(addr);
+  }
+  if (bytep) {
+    v = *(volatile uint8_t *)addr;
+  } else {
+    v = *(volatile uint16_t *)addr;
+  }
+  return v;
+}
+
+static void
+dma_store (unsigned long addr,
+           unsigned int v,
+           int bytep)
+{
+  int periph = (PERIPH_BASE <= addr) && (addr < PERIPH_BASE + PERIPH_SIZE);
+  unsigned long ofs = OFS(addr);
+
+  if (periph) {
+    memcpy(shadow_, sim_, sizeof(shadow_));
+    addr = (unsigned long)sim_ + ofs;
+  }
+  if (bytep) {
+    *(volatile uint8_t *)addr = v;
+  } else {
+    *(volatile uint16_t *)addr = v;
+  }
+  if (periph) {
+    apply_write(ofs, 1);
+  }
+}
+
+static unsigned long
+dma_step (unsigned long addr,
+          unsigned int incr,
+          int bytep)
+{
+  unsigned int size = bytep ? 1 : 2;
+  if (3 == incr) {
+    return addr + size;
+  }
+  if (2 == incr) {
+    return addr - size;
+  }
+  return addr;
+}
+
+static void
+dma_transfer (int ch)
+{
+  volatile sBSP430hplDMA * hpl = SIM_HPL(sBSP430hplDMA, BSP430_PERIPH_DMA_BASEADDRESS_);
+  volatile sBSP430hplDMAchannel * chp = hpl->ch + ch;
+  sSimDMAChannel * sp = dma_ + ch;
+  unsigned int ctl = chp->ctl;
+  unsigned int dt = (ctl / DMADT_1) & 7;
+  int srcbyte = !!(ctl & DMASRCBYTE);
+  int dstbyte = !!(ctl & DMADSTBYTE);
+  /* Block and burst-block modes move the whole block per trigger */
+  unsigned int units = (dt & 3) ? sp->sz : 1;
+
+  while (units-- && sp->sz) {
+    unsigned int v = dma_load(sp->sa, srcbyte);
+    if (dstbyte) {
+      v &= 0xFF;
+    }
+    dma_store(sp->da, v, dstbyte);
+    sp->sa = dma_step(sp->sa, (ctl / DMASRCINCR_1) & 3, srcbyte);
+    sp->da = dma_step(sp->da, (ctl / DMADSTINCR_1) & 3, dstbyte);
+    chp->sz = --sp->sz;
+  }
+  if (0 == sp->sz) {
+    chp->ctl |= DMAIFG;
+    if (dt & 4) {
+      sp->sa = chp->sa;
+      sp->da = chp->da;
+      sp->sz = chp->sz = sp->sz0;
+    } else {
+      chp->ctl &= ~DMAEN;
+    }
+  }
+}
+
+static void
+dma_service (void)
+{
+  if (dma_active_) {
+    return;
+  }
+  dma_active_ = 1;
+  while (dma_pending_) {
+    int ch;
+    for (ch = 0; ch < BSP430_DMA_NUM_CHANNELS; ++ch) {
+      if (dma_pending_ & (1U << ch)) {
+        dma_pending_ &= ~(1U << ch);
+        dma_transfer(ch);
+      }
+    }
+  }
+  dma_active_ = 0;
+}
+
+/* ---------------------------------------------------------------- */
+/* Timers */
+
+static unsigned long
+timer_src_hz (volatile sBSP430hplTIMER * hpl)
+{
+  switch (hpl->ctl & TASSEL_3) {
+    case TASSEL_1:
+      return aclk_hz();
+    case TASSEL_2:
+      return smclk_hz();
+    default:
+      break;
+  }
+  return 0;
+}
+
+static unsigned long long
+timer_denominator (const sSimTimer * tp,
+                   volatile sBSP430hplTIMER * hpl)
+{
+  unsigned int ex0 = SIM_REG16(tp->base + __MSP430_HOST_TIMER_EX0_OFS);
+  unsigned int div = (1U << ((hpl->ctl & ID_3) / ID_1)) * (1 + (ex0 & 7));
+  return (unsigned long long)mclk_hz_ * div;
+}
+
+static unsigned long
+phase_distance (unsigned long p,
+                unsigned long q,
+                unsigned long period)
+{
+  unsigned long d = (q + period - p) % period;
+  return d ? d : period;
+}
+
+/* Number of ticks until the counter lands on a value at which a flag
+ * is set, or zero if the timer is not counting. */
+static unsigned long
+timer_ticks_to_event (const sSimTimer * tp,
+                      volatile sBSP430hplTIMER * hpl)
+{
+  unsigned int mc = hpl->ctl & MC_3;
+  unsigned int r = hpl->r & 0xFFFF;
+  unsigned int ccr0 = hpl->ccr[0] & 0xFFFF;
+  unsigned long best;
+  int n;
+
+  if ((MC_0 == mc) || ((MC_2 != mc) && (0 == ccr0))) {
+    return 0;
+  }
+  if ((MC_2 == mc) || ((MC_1 == mc) && (r > ccr0))) {
+    /* Continuous, or up mode above CCR0 which runs to rollover */
+    best = 0x10000 - r;
+    for (n = 0; n < tp->nccs; ++n) {
+      unsigned int v = hpl->ccr[n] & 0xFFFF;
+      if (! (hpl->cctl[n] & CAP)) {
+        unsigned long d = (MC_2 == mc) ? phase_distance(r, v, 0x10000) : (0x10000 - r + v);
+        if ((MC_2 == mc) || (v <= ccr0)) {
+          if (d < best) {
+            best = d;
+          }
+        }
+      }
+    }
+    return best;
+  }
+  if (MC_1 == mc) {
+    unsigned long period = ccr0 + 1UL;
+    best = phase_distance(r, 0, period);
+    for (n = 0; n < tp->nccs; ++n) {
+      unsigned int v = hpl->ccr[n] & 0xFFFF;
+      if ((! (hpl->cctl[n] & CAP)) && (v <= ccr0)) {
+        unsigned long d = phase_distance(r, v, period);
+        if (d < best) {
+          best = d;
+        }
+      }
+    }
+    return best;
+  }
+  /* Up/down */
+  {
+    unsigned long period = 2UL * ccr0;
+    unsigned long p;
+    if (r > ccr0) {
+      r = ccr0;
+    }
+    p = tp->down ? (period - r) % period : r;
+    best = phase_distance(p, 0, period);
+    for (n = 0; n < tp->nccs; ++n) {
+      unsigned int v = hpl->ccr[n] & 0xFFFF;
+      if ((! (hpl->cctl[n] & CAP)) && (v <= ccr0)) {
+        unsigned long d = phase_distance(p, v, period);
+        if (d < best) {
+          best = d;
+        }
+        d = phase_distance(p, (period - v) % period, period);
+        if (d < best) {
+          best = d;
+        }
+      }
+    }
+    return best;
+  }
+}
+
+/* Move the counter forward by ticks, which must not pass an event */
+static void
+timer_move (sSimTimer * tp,
+            volatile sBSP430hplTIMER * hpl,
+            unsigned long ticks)
+{
+  unsigned int mc = hpl->ctl & MC_3;
+  unsigned int r = hpl->r & 0xFFFF;
+  unsigned int ccr0 = hpl->ccr[0] & 0xFFFF;
+
+  if (MC_2 == mc) {
+    r = (r + ticks) & 0xFFFF;
+  } else if (MC_1 == mc) {
+    if (r > ccr0) {
+      if (ticks < (0x10000 - r)) {
+        r += ticks;
+      } else {
+        r = (ticks - (0x10000 - r)) % (ccr0 + 1UL);
+      }
+    } else {
+      r = (r + ticks) % (ccr0 + 1UL);
+    }
+  } else {
+    unsigned long period = 2UL * ccr0;
+    unsigned long p;
+    if (r > ccr0) {
+      r = ccr0;
+    }
+    p = tp->down ? (period - r) % period : r;
+    p = (p + ticks) % period;
+    tp->down = (p >= ccr0);
+    r = tp->down ? period - p : p;
+  }
+  hpl->r = r;
+}
+
+/* CCIFG on CCR0 or CCR2 triggers DMA unless its interrupt is
+ * enabled, and is cleared when a channel responds. */
+static void
+timer_dma_trigger (sSimTimer * tp,
+                   volatile sBSP430hplTIMER * hpl,
+                   int n)
+{
+  int trig = TRIG_NONE;
+
+  if (0 == n) {
+    trig = tp->trig_ccr0;
+  } else if (2 == n) {
+    trig = tp->trig_ccr2;
+  }
+  if ((! (hpl->cctl[n] & CCIE)) && (0 < dma_trigger(trig))) {
+    hpl->cctl[n] &= ~CCIFG;
+  }
+}
+
+/* Set the flags for the event at the current counter value */
+static void
+timer_event (sSimTimer * tp,
+             volatile sBSP430hplTIMER * hpl)
+{
+  unsigned int r = hpl->r & 0xFFFF;
+  int n;
+
+  if (0 == r) {
+    hpl->ctl |= TAIFG;
+  }
+  for (n = 0; n < tp->nccs; ++n) {
+    if ((! (hpl->cctl[n] & CAP)) && (r == (hpl->ccr[n] & 0xFFFF))) {
+      hpl->cctl[n] |= CCIFG;
+      timer_dma_trigger(tp, hpl, n);
+    }
+  }
+}
+
+static void
+timer_advance (sSimTimer * tp,
+               unsigned long long cycles)
+{
+  volatile sBSP430hplTIMER * hpl = SIM_HPL(sBSP430hplTIMER, tp->base);
+  unsigned long src_hz = timer_src_hz(hpl);
+  unsigned long long den;
+  unsigned long long ticks;
+
+  if ((0 == src_hz) || (MC_0 == (hpl->ctl & MC_3))) {
+    return;
+  }
+  den = timer_denominator(tp, hpl);
+  tp->acc += cycles * src_hz;
+  ticks = tp->acc / den;
+  tp->acc %= den;
+  while (0 < ticks) {
+    unsigned long d = timer_ticks_to_event(tp, hpl);
+    unsigned long step;
+    if (0 == d) {
+      break;
+    }
+    step = (ticks < d) ? ticks : d;
+    timer_move(tp, hpl, step);
+    if (step == d) {
+      timer_event(tp, hpl);
+    }
+    ticks -= step;
+  }
+}
+
+/* MCLK cycles until the timer next sets a flag, or zero if never */
+static unsigned long long
+timer_cycles_to_event (sSimTimer * tp)
+{
+  volatile sBSP430hplTIMER * hpl = SIM_HPL(sBSP430hplTIMER, tp->base);
+  unsigned long src_hz = timer_src_hz(hpl);
+  unsigned long long den;
+  unsigned long long need;
+  unsigned long d;
+
+  if (0 == src_hz) {
+    return 0;
+  }
+  d = timer_ticks_to_event(tp, hpl);
+  if (0 == d) {
+    return 0;
+  }
+  den = timer_denominator(tp, hpl);
+  need = d * den;
+  need = (need > tp->acc) ? need - tp->acc : 1;
+  return (need + src_hz - 1) / src_hz;
+}
+
+static unsigned int
+timer_iv_read (sSimTimer * tp)
+{
+  volatile sBSP430hplTIMER * hpl = SIM_HPL(sBSP430hplTIMER, tp->base);
+  int n;
+
+  for (n = 1; n < tp->nccs; ++n) {
+    if ((hpl->cctl[n] & (CCIE | CCIFG)) == (CCIE | CCIFG)) {
+      hpl->cctl[n] &= ~CCIFG;
+      return 2 * n;
+    }
+  }
+  if ((hpl->ctl & (TAIE | TAIFG)) == (TAIE | TAIFG)) {
+    hpl->ctl &= ~TAIFG;
+    return 0x0E;
+  }
+  return 0;
+}
+
+static void
+timer_write (sSimTimer * tp)
+{
+  volatile sBSP430hplTIMER * hpl = SIM_HPL(sBSP430hplTIMER, tp->base);
+  const sBSP430hplTIMER * old = (const sBSP430hplTIMER *)(shadow_ + OFS(tp->base));
+  int n;
+
+  if (hpl->ctl & TACLR) {
+    hpl->ctl &= ~TACLR;
+    hpl->r = 0;
+    tp->acc = 0;
+    tp->down = 0;
+  }
+  for (n = 0; n < tp->nccs; ++n) {
+    unsigned int cctl = hpl->cctl[n];
+    unsigned int ccis = cctl & CCIS_3;
+    unsigned int oldccis = old->cctl[n] & CCIS_3;
+
+    /* Software capture: toggling the input between GND and VCC */
+    if ((cctl & CAP) && (ccis != oldccis)
+        && (CCIS_2 <= ccis) && (CCIS_2 <= oldccis)) {
+      int rising = (CCIS_3 == ccis);
+      int captured = (rising && (cctl & CM_1)) || ((! rising) && (cctl & CM_2));
+      if (captured) {
+        if (cctl & CCIFG) {
+          cctl |= COV;
+        }
+        hpl->ccr[n] = hpl->r;
+        cctl |= CCIFG;
+      }
+      cctl = rising ? (cctl | CCI) : (cctl & ~CCI);
+      hpl->cctl[n] = cctl;
+      if (captured) {
+        timer_dma_trigger(tp, hpl, n);
+      }
+    }
+  }
+}
+
+/* ---------------------------------------------------------------- */
+/* USCI */
+
+static int
+usci_in_reset (volatile sBSP430hplUSCI5 * hpl)
+{
+  return hpl->ctl1 & UCSWRST;
+}
+
+static int
+usci_is_uart (volatile sBSP430hplUSCI5 * hpl)
+{
+  return ! (hpl->ctl0 & UCSYNC);
+}
+
+static int
+usci_is_i2c (volatile sBSP430hplUSCI5 * hpl)
+{
+  return (hpl->ctl0 & (UCSYNC | UCMODE_3)) == (UCSYNC | UCMODE_3);
+}
+
+/* MCLK cycles to transfer one character */
+static unsigned long long
+usci_char_cycles (volatile sBSP430hplUSCI5 * hpl)
+{
+  unsigned long src_hz = (UCSSEL_1 == (hpl->ctl1 & UCSSEL_3)) || (0 == (hpl->ctl1 & UCSSEL_3)) ? aclk_hz() : smclk_hz();
+  unsigned long long brw = hpl->brw & 0xFFFF;
+  unsigned long long eighths;
+
+  if (0 == brw) {
+    brw = 1;
+  }
+  if (usci_is_uart(hpl)) {
+    unsigned int mctl = hpl->mctl;
+    if (mctl & UCOS16) {
+      eighths = 8 * (16 * brw + ((mctl / UCBRF_1) & 0x0F));
+    } else {
+      eighths = 8 * brw + ((mctl / UCBRS_1) & 0x07);
+    }
+    /* Start, eight data, stop */
+    eighths *= 10;
+  } else if (usci_is_i2c(hpl)) {
+    eighths = 8 * 9 * brw;
+  } else {
+    eighths = 8 * 8 * brw;
+  }
+  if (0 == src_hz) {
+    return 1;
+  }
+  return (eighths * mclk_hz_ + 8ULL * src_hz - 1) / (8ULL * src_hz);
+}
+
+static void
+usci_flush (sSimUSCI * up)
+{
+  unsigned int off = 0;
+  while (off < up->nout) {
+    ssize_t rc = write(STDOUT_FILENO, up->out + off, up->nout - off);
+    if (0 >= rc) {
+      break;
+    }
+    off += rc;
+  }
+  up->nout = 0;
+}
+
+static void
+usci_raise (sSimUSCI * up,
+            volatile sBSP430hplUSCI5 * hpl,
+            unsigned char flag)
+{
+  if (! (hpl->ifg & flag)) {
+    hpl->ifg |= flag;
+    if (UCTXIFG == flag) {
+      dma_trigger(up->trig_tx);
+    } else if (UCRXIFG == flag) {
+      dma_trigger(up->trig_rx);
+    }
+  }
+}
+
+static void
+usci_receive (sSimUSCI * up,
+              volatile sBSP430hplUSCI5 * hpl,
+              unsigned char c)
+{
+  if (hpl->ifg & UCRXIFG) {
+    hpl->stat |= UCOE;
+  }
+  hpl->rxbuf = c;
+  usci_raise(up, hpl, UCRXIFG);
+}
+
+static int
+usci_rx_pop (sSimUSCI * up)
+{
+  int c;
+  if (0 == up->rxq_count) {
+    return -1;
+  }
+  c = up->rxq[up->rxq_head];
+  up->rxq_head = (up->rxq_head + 1) % USCI_RXQ_SIZE;
+  --up->rxq_count;
+  return c;
+}
+
+static void
+usci_start_shift (sSimUSCI * up,
+                  volatile sBSP430hplUSCI5 * hpl,
+                  unsigned char c,
+                  unsigned long long start)
+{
+  up->shifting = 1;
+  up->shift = c;
+  up->shift_done = start + usci_char_cycles(hpl);
+  hpl->stat |= UCBUSY;
+  usci_raise(up, hpl, UCTXIFG);
+}
+
+/* Clock in one octet from the simulated I2C slave */
+static void
+usci_i2c_start_rx (sSimUSCI * up,
+                   volatile sBSP430hplUSCI5 * hpl,
+                   unsigned long long start)
+{
+  up->shifting = 1;
+  up->shift_done = start + usci_char_cycles(hpl);
+  hpl->stat |= UCBUSY;
+}
+
+/* Finish a STOP: the bus is released */
+static void
+usci_i2c_stop (sSimUSCI * up,
+               volatile sBSP430hplUSCI5 * hpl)
+{
+  hpl->ctl1 &= ~UCTXSTP;
+  hpl->stat &= ~UCBBUSY;
+  up->i2c_rx = 0;
+}
+
+/* Store the octet just transmitted in the capture buffer, if one is
+ * set.  Returns nonzero if the octet was captured. */
+static int
+usci_capture (sSimUSCI * up)
+{
+  if (NULL == up->cap) {
+    return 0;
+  }
+  if (up->cap_len < up->cap_size) {
+    up->cap[up->cap_len] = up->shift;
+  }
+  ++up->cap_len;
+  return 1;
+}
+
+static void
+usci_update (sSimUSCI * up)
+{
+  volatile sBSP430hplUSCI5 * hpl = SIM_HPL(sBSP430hplUSCI5, up->base);
+
+  if (usci_in_reset(hpl)) {
+    return;
+  }
+  while (up->shifting && (up->shift_done <= now_)) {
+    unsigned long long done = up->shift_done;
+    if (usci_is_uart(hpl)) {
+      if (! usci_capture(up)) {
+        up->out[up->nout++] = up->shift;
+        if (('\n' == up->shift) || (USCI_OUT_SIZE == up->nout)) {
+          usci_flush(up);
+        }
+      }
+    } else if (! usci_is_i2c(hpl)) {
+      int c = usci_rx_pop(up);
+      usci_receive(up, hpl, (0 > c) ? 0xFF : c);
+    } else if (up->i2c_rx) {
+      int c = usci_rx_pop(up);
+      usci_receive(up, hpl, (0 > c) ? 0xFF : c);
+    } else {
+      /* An octet written to the I2C slave */
+      (void)usci_capture(up);
+    }
+    up->shifting = 0;
+    hpl->stat &= ~UCBUSY;
+    if (up->i2c_rx) {
+      /* A requested STOP follows the octet; otherwise the slave sends
+       * another once the master has taken this one. */
+      if (hpl->ctl1 & UCTXSTP) {
+        usci_i2c_stop(up, hpl);
+      } else if (! (hpl->ifg & UCRXIFG)) {
+        usci_i2c_start_rx(up, hpl, done);
+      }
+      continue;
+    }
+    if (up->pending) {
+      up->pending = 0;
+      usci_start_shift(up, hpl, up->pend, done);
+    }
+  }
+  if (usci_is_uart(hpl)) {
+    while (up->rxq_count && (up->rx_at <= now_)) {
+      usci_receive(up, hpl, usci_rx_pop(up));
+      up->rx_at += usci_char_cycles(hpl);
+    }
+  }
+  if (up->i2c_at && (up->i2c_at <= now_)) {
+    up->i2c_at = 0;
+    if (hpl->ctl1 & UCTXSTT) {
+      hpl->ctl1 &= ~UCTXSTT;
+      if (up->i2c_slave_valid && (up->i2c_slave == (hpl->i2csa & 0x3FF))) {
+        /* The slave acknowledges; in receive mode it starts sending */
+        if (! (hpl->ctl1 & UCTR)) {
+          up->i2c_rx = 1;
+          usci_i2c_start_rx(up, hpl, now_);
+        } else if (up->pending && (! up->shifting)) {
+          up->pending = 0;
+          usci_start_shift(up, hpl, up->pend, now_);
+        }
+      } else {
+        /* Nothing on the bus acknowledges its address */
+        up->pending = 0;
+        usci_raise(up, hpl, UCNACKIFG);
+      }
+    }
+    if ((hpl->ctl1 & UCTXSTP) && (! up->i2c_rx)) {
+      usci_i2c_stop(up, hpl);
+    }
+  }
+}
+
+static unsigned long long
+usci_next_event (sSimUSCI * up)
+{
+  volatile sBSP430hplUSCI5 * hpl = SIM_HPL(sBSP430hplUSCI5, up->base);
+  unsigned long long rv = 0;
+
+  if (usci_in_reset(hpl)) {
+    return 0;
+  }
+  if (up->shifting) {
+    rv = up->shift_done;
+  }
+  if (usci_is_uart(hpl) && up->rxq_count && ((0 == rv) || (up->rx_at < rv))) {
+    rv = up->rx_at;
+  }
+  if (up->i2c_at && ((0 == rv) || (up->i2c_at < rv))) {
+    rv = up->i2c_at;
+  }
+  return rv;
+}
+
+static int
+usci_flag_register (unsigned long ofs)
+{
+  unsigned int i;
+
+  for (i = 0; i < NUM_USCIS; ++i) {
+    unsigned long base = OFS(uscis_[i].base);
+    if ((base + offsetof(sBSP430hplUSCI5, ifg) == ofs)
+        || (base + offsetof(sBSP430hplUSCI5, stat) == ofs)
+        || (base + offsetof(sBSP430hplUSCI5, ctl1) == ofs)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static unsigned int
+usci_iv_read (sSimUSCI * up)
+{
+  volatile sBSP430hplUSCI5 * hpl = SIM_HPL(sBSP430hplUSCI5, up->base);
+  unsigned char active = hpl->ie & hpl->ifg;
+
+  if (usci_is_i2c(hpl)) {
+    static const unsigned char order[] = { UCALIFG, UCNACKIFG, UCSTTIFG, UCSTPIFG, UCRXIFG, UCTXIFG };
+    unsigned int i;
+    for (i = 0; i < sizeof(order); ++i) {
+      if (active & order[i]) {
+        hpl->ifg &= ~order[i];
+        return 2 * (i + 1);
+      }
+    }
+    return USCI_NONE;
+  }
+  if (active & UCRXIFG) {
+    hpl->ifg &= ~UCRXIFG;
+    return USCI_UCRXIFG;
+  }
+  if (active & UCTXIFG) {
+    hpl->ifg &= ~UCTXIFG;
+    return USCI_UCTXIFG;
+  }
+  return USCI_NONE;
+}
+
+static void
+usci_reset (sSimUSCI * up,
+            volatile sBSP430hplUSCI5 * hpl)
+{
+  hpl->ie = 0;
+  hpl->ifg = UCTXIFG;
+  hpl->stat &= UCLISTEN;
+  up->shifting = 0;
+  up->pending = 0;
+  up->i2c_at = 0;
+  up->i2c_rx = 0;
+}
+
+static void
+usci_write (sSimUSCI * up)
+{
+  volatile sBSP430hplUSCI5 * hpl = SIM_HPL(sBSP430hplUSCI5, up->base);
+  const sBSP430hplUSCI5 * old = (const sBSP430hplUSCI5 *)(shadow_ + OFS(up->base));
+  unsigned char set;
+
+  if (usci_in_reset(hpl)) {
+    if (! (old->ctl1 & UCSWRST)) {
+      usci_reset(up, hpl);
+    }
+    return;
+  }
+  if (usci_is_i2c(hpl)) {
+    /* A START or STOP requested while an octet is being transmitted
+     * (e.g. a repeated START) follows that octet */
+    unsigned long long at = (up->shifting && (! up->i2c_rx)) ? up->shift_done : now_;
+
+    set = hpl->ctl1 & ~old->ctl1;
+    if (set & UCTXSTT) {
+      hpl->stat |= UCBBUSY;
+      up->i2c_rx = 0;
+      up->i2c_at = at + usci_char_cycles(hpl);
+      if (hpl->ctl1 & UCTR) {
+        usci_raise(up, hpl, UCTXIFG);
+      }
+    }
+    if ((set & UCTXSTP) && (! up->i2c_rx)) {
+      up->i2c_at = at + usci_char_cycles(hpl);
+    }
+  }
+  /* A flag set by software triggers DMA as a hardware one would */
+  set = hpl->ifg & ~old->ifg;
+  if (set & UCTXIFG) {
+    dma_trigger(up->trig_tx);
+  }
+  if (set & UCRXIFG) {
+    dma_trigger(up->trig_rx);
+  }
+}
+
+static void
+usci_txbuf_write (sSimUSCI * up)
+{
+  volatile sBSP430hplUSCI5 * hpl = SIM_HPL(sBSP430hplUSCI5, up->base);
+
+  if (usci_in_reset(hpl)) {
+    return;
+  }
+  hpl->ifg &= ~UCTXIFG;
+  /* An I2C octet is held until the address has been acknowledged */
+  if (up->shifting || (usci_is_i2c(hpl) && (hpl->ctl1 & UCTXSTT))) {
+    up->pending = 1;
+    up->pend = hpl->txbuf;
+  } else {
+    usci_start_shift(up, hpl, hpl->txbuf, now_);
+  }
+}
+
+/* ---------------------------------------------------------------- */
+/* Digital I/O */
+
+static void
+ports_update (void)
+{
+  unsigned int i;
+
+  for (i = 0; i < NUM_PORTS; ++i) {
+    sSimPort * pp = ports_ + i;
+    volatile sBSP430hplPORT_5XX_8 * hpl = SIM_HPL(sBSP430hplPORT_5XX_8, pp->base);
+    unsigned char dir = hpl->dir;
+    unsigned char level = (dir & hpl->out) | (~dir & hpl->ren & hpl->out) | (~dir & ~hpl->ren & pp->ext);
+    unsigned char changed = level ^ pp->level;
+
+    if (pp->iv && changed) {
+      unsigned char rising = changed & level;
+      unsigned char falling = changed & ~level;
+      hpl->ifg |= (rising & ~hpl->ies) | (falling & hpl->ies);
+    }
+    pp->level = level;
+    hpl->in = level;
+  }
+}
+
+static unsigned int
+port_iv_read (sSimPort * pp)
+{
+  volatile sBSP430hplPORT_5XX_8 * hpl = SIM_HPL(sBSP430hplPORT_5XX_8, pp->base);
+  unsigned char active = hpl->ifg & hpl->ie;
+  unsigned int bit;
+
+  for (bit = 0; bit < 8; ++bit) {
+    if (active & (1U << bit)) {
+      hpl->ifg &= ~(1U << bit);
+      return 2 * (bit + 1);
+    }
+  }
+  return 0;
+}
+
+/* ---------------------------------------------------------------- */
+/* Access hooks */
+
+static int
+iv_at (unsigned long ofs,
+       unsigned long iv_addr)
+{
+  return (ofs == OFS(iv_addr)) || (ofs == 1 + OFS(iv_addr));
+}
+
+static void
+store_iv (unsigned long iv_addr,
+          unsigned int value)
+{
+  SIM_REG16(iv_addr) = value;
+}
+
+/* Prepare for a read at ofs: vector registers and receive buffers
+ * have read side effects. */
+static void
+read_hook (unsigned long ofs)
+{
+  unsigned int i;
+
+  for (i = 0; i < NUM_TIMERS; ++i) {
+    unsigned long iv = timers_[i].base + __MSP430_HOST_TIMER_IV_OFS;
+    if (iv_at(ofs, iv)) {
+      store_iv(iv, timer_iv_read(timers_ + i));
+      return;
+    }
+  }
+  for (i = 0; i < NUM_USCIS; ++i) {
+    sSimUSCI * up = uscis_ + i;
+    volatile sBSP430hplUSCI5 * hpl = SIM_HPL(sBSP430hplUSCI5, up->base);
+    unsigned long base = OFS(up->base);
+    if (ofs == base + offsetof(sBSP430hplUSCI5, iv)) {
+      hpl->iv = usci_iv_read(up);
+      return;
+    }
+    if (ofs == base + offsetof(sBSP430hplUSCI5, rxbuf)) {
+      hpl->ifg &= ~UCRXIFG;
+      hpl->stat &= ~(UCOE | UCFE | UCPE | UCBRK | UCRXERR);
+      /* The I2C slave was waiting for the master to take the octet */
+      if (up->i2c_rx && (! up->shifting)) {
+        usci_i2c_start_rx(up, hpl, now_);
+      }
+      return;
+    }
+  }
+  for (i = 0; i < NUM_PORTS; ++i) {
+    if (ports_[i].iv && iv_at(ofs, ports_[i].iv)) {
+      store_iv(ports_[i].iv, port_iv_read(ports_ + i));
+      return;
+    }
+  }
+  if (iv_at(ofs, BSP430_PERIPH_DMA_BASEADDRESS_ + offsetof(sBSP430hplDMA, iv))) {
+    volatile sBSP430hplDMA * hpl = SIM_HPL(sBSP430hplDMA, BSP430_PERIPH_DMA_BASEADDRESS_);
+    int ch;
+    hpl->iv = 0;
+    for (ch = 0; ch < BSP430_DMA_NUM_CHANNELS; ++ch) {
+      if ((hpl->ch[ch].ctl & (DMAIE | DMAIFG)) == (DMAIE | DMAIFG)) {
+        hpl->ch[ch].ctl &= ~DMAIFG;
+        hpl->iv = 2 * (ch + 1);
+        break;
+      }
+    }
+  }
+}
+
+static void
+dma_write (void)
+{
+  volatile sBSP430hplDMA * hpl = SIM_HPL(sBSP430hplDMA, BSP430_PERIPH_DMA_BASEADDRESS_);
+  const sBSP430hplDMA * old = (const sBSP430hplDMA *)(shadow_ + OFS(BSP430_PERIPH_DMA_BASEADDRESS_));
+  int ch;
+
+  for (ch = 0; ch < BSP430_DMA_NUM_CHANNELS; ++ch) {
+    volatile sBSP430hplDMAchannel * chp = hpl->ch + ch;
+    if ((chp->ctl & DMAEN) && ! (old->ch[ch].ctl & DMAEN)) {
+      dma_[ch].sa = chp->sa;
+      dma_[ch].da = chp->da;
+      dma_[ch].sz = dma_[ch].sz0 = chp->sz;
+    }
+    if (chp->ctl & DMAREQ) {
+      chp->ctl &= ~DMAREQ;
+      if (chp->ctl & DMAEN) {
+        dma_pending_ |= 1U << ch;
+      }
+    }
+  }
+}
+
+/* Apply the side effects of an access at ofs, given the page
+ * contents before the access in shadow_. */
+static void
+apply_write (unsigned long ofs,
+             int is_write)
+{
+  unsigned int i;
+
+  for (i = 0; i < NUM_TIMERS; ++i) {
+    timer_write(timers_ + i);
+  }
+  for (i = 0; i < NUM_USCIS; ++i) {
+    sSimUSCI * up = uscis_ + i;
+    usci_write(up);
+    if (is_write && (ofs == OFS(up->base) + offsetof(sBSP430hplUSCI5, txbuf))) {
+      usci_txbuf_write(up);
+    }
+  }
+  ports_update();
+  dma_write();
+}
+
+/* ---------------------------------------------------------------- */
+/* Time */
+
+static unsigned long long
+next_event (void)
+{
+  unsigned long long rv = 0;
+  unsigned int i;
+
+  for (i = 0; i < NUM_TIMERS; ++i) {
+    unsigned long long c = timer_cycles_to_event(timers_ + i);
+    if (c && ((0 == rv) || (now_ + c < rv))) {
+      rv = now_ + c;
+    }
+  }
+  for (i = 0; i < NUM_USCIS; ++i) {
+    unsigned long long t = usci_next_event(uscis_ + i);
+    if (t && ((0 == rv) || (t < rv))) {
+      rv = t;
+    }
+  }
+  return rv;
+}
+
+static void
+advance (unsigned long long cycles)
+{
+  unsigned long long end = now_ + cycles;
+
+  while (now_ < end) {
+    unsigned long long t = next_event();
+    unsigned int i;
+
+    if ((0 == t) || (t > end)) {
+      t = end;
+    }
+    for (i = 0; i < NUM_TIMERS; ++i) {
+      timer_advance(timers_ + i, t - now_);
+    }
+    now_ = t;
+    for (i = 0; i < NUM_USCIS; ++i) {
+      usci_update(uscis_ + i);
+    }
+    dma_service();
+  }
+}
+
+/* ---------------------------------------------------------------- */
+/* Interrupts */
+
+typedef struct sSimSource {
+  unsigned int vector;
+  void (* isr) (void);
+  /* Flag cleared by hardware when the vector is taken */
+  volatile unsigned int * autoclear;
+} sSimSource;
+
+static int
+highest_pending (sSimSource * sp)
+{
+  unsigned int i;
+  int found = 0;
+
+  memset(sp, 0, sizeof(*sp));
+#define CONSIDER(vector_, isr_, autoclear_) do {        \
+    if ((! found) || ((vector_) > sp->vector)) {        \
+      found = 1;                                        \
+      sp->vector = (vector_);                           \
+      sp->isr = (isr_);                                 \
+      sp->autoclear = (autoclear_);                     \
+    }                                                   \
+  } while (0)
+
+  for (i = 0; i < NUM_TIMERS; ++i) {
+    sSimTimer * tp = timers_ + i;
+    volatile sBSP430hplTIMER * hpl = SIM_HPL(sBSP430hplTIMER, tp->base);
+    int n;
+    if ((hpl->cctl[0] & (CCIE | CCIFG)) == (CCIE | CCIFG)) {
+      CONSIDER(tp->cc0_vector, tp->cc0_isr, hpl->cctl);
+    }
+    if ((hpl->ctl & (TAIE | TAIFG)) == (TAIE | TAIFG)) {
+      CONSIDER(tp->vector, tp->isr, NULL);
+    }
+    for (n = 1; n < tp->nccs; ++n) {
+      if ((hpl->cctl[n] & (CCIE | CCIFG)) == (CCIE | CCIFG)) {
+        CONSIDER(tp->vector, tp->isr, NULL);
+      }
+    }
+  }
+  for (i = 0; i < NUM_USCIS; ++i) {
+    sSimUSCI * up = uscis_ + i;
+    volatile sBSP430hplUSCI5 * hpl = SIM_HPL(sBSP430hplUSCI5, up->base);
+    if (hpl->ie & hpl->ifg) {
+      CONSIDER(up->vector, up->isr, NULL);
+    }
+  }
+  for (i = 0; i < NUM_PORTS; ++i) {
+    sSimPort * pp = ports_ + i;
+    volatile sBSP430hplPORT_5XX_8 * hpl = SIM_HPL(sBSP430hplPORT_5XX_8, pp->base);
+    if (pp->iv && (hpl->ie & hpl->ifg)) {
+      CONSIDER(pp->vector, pp->isr, NULL);
+    }
+  }
+  {
+    volatile sBSP430hplDMA * hpl = SIM_HPL(sBSP430hplDMA, BSP430_PERIPH_DMA_BASEADDRESS_);
+    int ch;
+    for (ch = 0; ch < BSP430_DMA_NUM_CHANNELS; ++ch) {
+      if ((hpl->ch[ch].ctl & (DMAIE | DMAIFG)) == (DMAIE | DMAIFG)) {
+        CONSIDER(DMA_VECTOR, isr_DMA, NULL);
+      }
+    }
+  }
+#undef CONSIDER
+  return found;
+}
+
+/* Invoke handlers for pending interrupts while interrupts are
+ * enabled */
+static void
+dispatch (void)
+{
+  sSimSource src;
+
+  while ((sr_ & GIE) && highest_pending(&src)) {
+    char msg[64];
+    if (NULL == src.isr) {
+      snprintf(msg, sizeof(msg), "unhandled interrupt vector %u", src.vector);
+      sim_fatal(msg);
+    }
+    if (sizeof(saved_sr_) / sizeof(*saved_sr_) <= nsaved_sr_) {
+      sim_fatal("interrupt nesting too deep");
+    }
+    if (src.autoclear) {
+      *src.autoclear &= ~CCIFG;
+    }
+    advance(INTERRUPT_CYCLES);
+    saved_sr_[nsaved_sr_++] = sr_;
+    sr_ &= SCG0;
+    src.isr();
+    sr_ = saved_sr_[--nsaved_sr_];
+    advance(RETI_CYCLES);
+  }
+}
+
+/* Could anything that can happen without the CPU raise an enabled
+ * interrupt? */
+static int
+wakeup_possible (void)
+{
+  unsigned int i;
+
+  for (i = 0; i < NUM_TIMERS; ++i) {
+    sSimTimer * tp = timers_ + i;
+    volatile sBSP430hplTIMER * hpl = SIM_HPL(sBSP430hplTIMER, tp->base);
+    int n;
+    if (0 == timer_cycles_to_event(tp)) {
+      continue;
+    }
+    if (hpl->ctl & TAIE) {
+      return 1;
+    }
+    for (n = 0; n < tp->nccs; ++n) {
+      if (hpl->cctl[n] & CCIE) {
+        return 1;
+      }
+    }
+  }
+  for (i = 0; i < NUM_USCIS; ++i) {
+    sSimUSCI * up = uscis_ + i;
+    volatile sBSP430hplUSCI5 * hpl = SIM_HPL(sBSP430hplUSCI5, up->base);
+    if (hpl->ie && usci_next_event(up)) {
+      return 1;
+    }
+  }
+  {
+    volatile sBSP430hplDMA * hpl = SIM_HPL(sBSP430hplDMA, BSP430_PERIPH_DMA_BASEADDRESS_);
+    int ch;
+    for (ch = 0; ch < BSP430_DMA_NUM_CHANNELS; ++ch) {
+      if ((hpl->ch[ch].ctl & (DMAIE | DMAEN)) == (DMAIE | DMAEN)) {
+        return 0 != next_event();
+      }
+    }
+  }
+  return 0;
+}
+
+/* Sleep until an interrupt handler clears CPUOFF */
+static void
+low_power_mode (void)
+{
+  dispatch();
+  while (sr_ & CPUOFF) {
+    unsigned long long t;
+    if (! (sr_ & GIE)) {
+      sim_fatal("low power mode entered with interrupts disabled");
+    }
+    if (! wakeup_possible()) {
+      sim_fatal("low power mode entered with no wakeup source");
+    }
+    t = next_event();
+    advance(t - now_);
+    dispatch();
+  }
+}
+
+/* ---------------------------------------------------------------- */
+/* Fault handling */
+
+static void
+segv_handler (int sig,
+              siginfo_t * si,
+              void * vctx)
+{
+  ucontext_t * uc = (ucontext_t *)vctx;
+  unsigned long addr = (unsigned long)si->si_addr;
+
+  (void)sig;
+  if ((addr < PERIPH_BASE) || (PERIPH_BASE + PERIPH_SIZE <= addr)) {
+    /* A genuine fault: let it happen again without us */
+    signal(SIGSEGV, SIG_DFL);
+    return;
+  }
+  access_ofs_ = addr - PERIPH_BASE;
+  access_write_ = !!(uc->uc_mcontext.gregs[REG_ERR] & PF_ERR_WRITE);
+  if (access_write_) {
+    poll_ofs_ = -1;
+    advance(ACCESS_CYCLES);
+  } else {
+    unsigned long long cycles = ACCESS_CYCLES;
+    /* A loop spinning on a USCI flag cannot observe anything until
+     * the next event, so jump there rather than trapping every
+     * ACCESS_CYCLES of a UART character time.  A single repeat is
+     * not taken as polling: it may be the read-modify-write that
+     * responds to a change, such as setting UCTXSTP as soon as
+     * UCTXSTT clears. */
+    if ((access_ofs_ == poll_ofs_) && (sim_[access_ofs_] == poll_val_)) {
+      ++poll_repeat_;
+    } else {
+      poll_repeat_ = 0;
+    }
+    if ((1 < poll_repeat_) && usci_flag_register(access_ofs_)) {
+      unsigned long long t = next_event();
+      if (t > now_ + cycles) {
+        cycles = t - now_;
+      }
+    }
+    poll_ofs_ = access_ofs_;
+    advance(cycles);
+  }
+  if (! access_write_) {
+    read_hook(access_ofs_);
+    poll_val_ = sim_[access_ofs_];
+  }
+  memcpy(shadow_, sim_, sizeof(shadow_));
+  mprotect((void *)PERIPH_BASE, PERIPH_SIZE, PROT_READ | PROT_WRITE);
+  uc->uc_mcontext.gregs[REG_EFL] |= EFLAGS_TF;
+}
+
+static void
+trap_handler (int sig,
+              siginfo_t * si,
+              void * vctx)
+{
+  ucontext_t * uc = (ucontext_t *)vctx;
+
+  (void)sig;
+  (void)si;
+  if (! (uc->uc_mcontext.gregs[REG_EFL] & EFLAGS_TF)) {
+    signal(SIGTRAP, SIG_DFL);
+    raise(SIGTRAP);
+    return;
+  }
+  uc->uc_mcontext.gregs[REG_EFL] &= ~EFLAGS_TF;
+  mprotect((void *)PERIPH_BASE, PERIPH_SIZE, PROT_NONE);
+  apply_write(access_ofs_, access_write_);
+  dma_service();
+  /* An interrupt enabled or raised by the access is taken before the
+   * next instruction. */
+  dispatch();
+}
+
+static void
+flush_output (void)
+{
+  unsigned int i;
+  for (i = 0; i < NUM_USCIS; ++i) {
+    usci_flush(uscis_ + i);
+  }
+}
+
+static void __attribute__((__constructor__))
+sim_initialize (void)
+{
+  struct sigaction sa;
+  unsigned int i;
+  int fd;
+  void * app;
+
+  fd = memfd_create("bsp430-periph", 0);
+  if ((0 > fd) || (0 != ftruncate(fd, PERIPH_SIZE))) {
+    perror("host: peripheral page");
+    exit(EXIT_FAILURE);
+  }
+  app = mmap((void *)PERIPH_BASE, PERIPH_SIZE, PROT_NONE, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+  sim_ = mmap(NULL, PERIPH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (((void *)PERIPH_BASE != app) || (MAP_FAILED == sim_)) {
+    perror("host: peripheral map");
+    exit(EXIT_FAILURE);
+  }
+  close(fd);
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+  sa.sa_sigaction = segv_handler;
+  sigaction(SIGSEGV, &sa, NULL);
+  sa.sa_sigaction = trap_handler;
+  sigaction(SIGTRAP, &sa, NULL);
+
+  /* Power-up register values */
+  for (i = 0; i < NUM_USCIS; ++i) {
+    volatile sBSP430hplUSCI5 * hpl = SIM_HPL(sBSP430hplUSCI5, uscis_[i].base);
+    hpl->ctl1 = UCSWRST;
+    usci_reset(uscis_ + i, hpl);
+  }
+  atexit(flush_output);
+}
+
+/* ---------------------------------------------------------------- */
+/* Intrinsics */
+
+unsigned int
+__get_interrupt_state (void)
+{
+  return sr_;
+}
+
+void
+__set_interrupt_state (unsigned int istate)
+{
+  sr_ = (sr_ & ~GIE) | (istate & GIE);
+  dispatch();
+}
+
+void
+__enable_interrupt (void)
+{
+  sr_ |= GIE;
+  dispatch();
+}
+
+void
+__disable_interrupt (void)
+{
+  sr_ &= ~GIE;
+}
+
+void
+__nop (void)
+{
+  advance(1);
+  dispatch();
+}
+
+void
+__delay_cycles (unsigned long cycles)
+{
+  unsigned long long end = now_ + cycles;
+
+  dispatch();
+  while (now_ < end) {
+    unsigned long long t = next_event();
+    if ((0 == t) || (t > end)) {
+      t = end;
+    }
+    advance(t - now_);
+    dispatch();
+  }
+}
+
+unsigned int
+__read_status_register (void)
+{
+  return sr_;
+}
+
+void
+__bis_status_register (unsigned int bits)
+{
+  sr_ |= bits;
+  if (sr_ & CPUOFF) {
+    low_power_mode();
+  } else {
+    dispatch();
+  }
+}
+
+void
+__bic_status_register (unsigned int bits)
+{
+  sr_ &= ~bits;
+}
+
+void
+__bis_status_register_on_exit (unsigned int bits)
+{
+  if (nsaved_sr_) {
+    saved_sr_[nsaved_sr_ - 1] |= bits;
+  }
+}
+
+void
+__bic_status_register_on_exit (unsigned int bits)
+{
+  if (nsaved_sr_) {
+    saved_sr_[nsaved_sr_ - 1] &= ~bits;
+  }
+}
+
+/* ---------------------------------------------------------------- */
+/* Host interface */
+
+unsigned long long
+ullBSP430hostCycles (void)
+{
+  return now_;
+}
+
+int
+iBSP430hostInjectRx (tBSP430periphHandle periph,
+                     const void * data,
+                     size_t len)
+{
+  const unsigned char * dp = (const unsigned char *)data;
+  unsigned int i;
+
+  for (i = 0; i < NUM_USCIS; ++i) {
+    sSimUSCI * up = uscis_ + i;
+    if ((unsigned long)periph == up->base) {
+      size_t n;
+      if ((USCI_RXQ_SIZE - up->rxq_count) < len) {
+        return -1;
+      }
+      if (0 == up->rxq_count) {
+        up->rx_at = now_ + usci_char_cycles(SIM_HPL(sBSP430hplUSCI5, up->base));
+      }
+      for (n = 0; n < len; ++n) {
+        up->rxq[(up->rxq_head + up->rxq_count++) % USCI_RXQ_SIZE] = dp[n];
+      }
+      return len;
+    }
+  }
+  return -1;
+}
+
+long
+lBSP430hostCaptureTx (tBSP430periphHandle periph,
+                      void * buf,
+                      size_t size)
+{
+  unsigned int i;
+
+  for (i = 0; i < NUM_USCIS; ++i) {
+    sSimUSCI * up = uscis_ + i;
+    if ((unsigned long)periph == up->base) {
+      long rv = up->cap_len;
+      usci_flush(up);
+      up->cap = (unsigned char *)buf;
+      up->cap_size = buf ? size : 0;
+      up->cap_len = 0;
+      return rv;
+    }
+  }
+  return -1;
+}
+
+int
+iBSP430hostSetI2CSlave (tBSP430periphHandle periph,
+                        int address)
+{
+  unsigned int i;
+
+  for (i = 0; i < NUM_USCIS; ++i) {
+    sSimUSCI * up = uscis_ + i;
+    if ((unsigned long)periph == up->base) {
+      up->i2c_slave_valid = (0 <= address);
+      up->i2c_slave = address;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+int
+iBSP430hostSetPortInput (tBSP430periphHandle periph,
+                         unsigned char mask,
+                         unsigned char value)
+{
+  unsigned int i;
+
+  for (i = 0; i < NUM_PORTS; ++i) {
+    sSimPort * pp = ports_ + i;
+    if ((unsigned long)periph == pp->base) {
+      pp->ext = (pp->ext & ~mask) | (value & mask);
+      ports_update();
+      dispatch();
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/* ---------------------------------------------------------------- */
+/* Clock interface */
+
+static eBSP430clockSource
+normalize_source (eBSP430clockSource sel)
+{
+  switch (sel) {
+    case eBSP430clockSRC_XT1CLK_OR_VLOCLK:
+    case eBSP430clockSRC_XT1CLK_OR_REFOCLK:
+    case eBSP430clockSRC_XT1CLK_FALLBACK:
+      /* The simulated crystal never faults */
+      return eBSP430clockSRC_XT1CLK;
+    case eBSP430clockSRC_SMCLK_PU_DEFAULT:
+      return eBSP430clockSRC_DCOCLKDIV;
+    default:
+      break;
+  }
+  return sel;
+}
+
+eBSP430clockSource
+xBSP430clockACLKSource ()
+{
+  return aclk_src_;
+}
+
+eBSP430clockSource
+xBSP430clockSMCLKSource ()
+{
+  return smclk_src_;
+}
+
+eBSP430clockSource
+xBSP430clockMCLKSource ()
+{
+  return eBSP430clockSRC_DCOCLKDIV;
+}
+
+unsigned long
+ulBSP430clockConfigureMCLK_ni (unsigned long mclk_Hz)
+{
+  if (0 == mclk_Hz) {
+    mclk_Hz = BSP430_CLOCK_PUC_MCLK_HZ;
+  }
+  mclk_hz_ = mclk_Hz;
+  return ulBSP430clockMCLK_Hz_ni();
+}
+
+unsigned long
+ulBSP430clockMCLK_Hz_ni (void)
+{
+  return mclk_hz_;
+}
+
+int
+iBSP430clockConfigureSMCLK_ni (eBSP430clockSource sel,
+                               unsigned int dividing_shift)
+{
+  sel = normalize_source(sel);
+  if (0 == source_hz(sel)) {
+    return -1;
+  }
+  if (5 < dividing_shift) {
+    dividing_shift = 5;
+  }
+  smclk_src_ = sel;
+  smclk_shift_ = dividing_shift;
+  return 0;
+}
+
+unsigned long
+ulBSP430clockSMCLK_Hz_ni (void)
+{
+  return smclk_hz();
+}
+
+int
+iBSP430clockConfigureLFXT1_ni (int enablep,
+                               int loop_limit)
+{
+  int rc = 0;
+
+  BSP430_CLOCK_CLEAR_FAULTS_NI();
+  if (enablep && (0 != loop_limit)) {
+    rc = (0 == iBSP430platformConfigurePeripheralPins_ni(BSP430_PERIPH_LFXT1, 0, 1));
+  }
+  if (! rc) {
+    (void)iBSP430platformConfigurePeripheralPins_ni(BSP430_PERIPH_LFXT1, 0, 0);
+  }
+  return rc;
+}
+
+int
+iBSP430clockConfigureXT2_ni (int enablep,
+                             int loop_limit)
+{
+  /* No XT2 on the simulated board */
+  return 0;
+}
+
+int
+iBSP430clockConfigureACLK_ni (eBSP430clockSource sel,
+                              unsigned int dividing_shift)
+{
+  sel = normalize_source(sel);
+  if (0 == source_hz(sel)) {
+    return -1;
+  }
+  if (5 < dividing_shift) {
+    dividing_shift = 5;
+  }
+  aclk_src_ = sel;
+  aclk_shift_ = dividing_shift;
+  return 0;
+}
+
+unsigned long
+ulBSP430clockACLK_Hz_ni (void)
+{
+  return aclk_hz();
+}
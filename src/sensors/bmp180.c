@@ -41,7 +41,6 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <string.h>
 #include <bsp430/platform.h>
 #include <bsp430/serial.h>
 #include <bsp430/utility/uptime.h>
@@ -88,12 +87,7 @@ iBSP430sensorsBMP180getCalibration (hBSP430halSERIAL i2c,
     uint16_t * wp;
 
     data[0] = BMP180_REG_CALIBRATION;
-    rc = iBSP430i2cTxData_rh(i2c, data, 1);
-    if (0 > rc) {
-      break;
-    }
-    memset(data, 0, sizeof(data));
-    rc = iBSP430i2cRxData_rh(i2c, data, sizeof(data));
+    rc = iBSP430i2cTxRxData_rh(i2c, data, 1, data, sizeof(data));
     if (0 > rc) {
       break;
     }
@@ -148,11 +142,7 @@ iBSP430sensorsBMP180getSample (hBSP430halSERIAL i2c,
     BSP430_UPTIME_DELAY_MS(5, LPM0_bits, 0);
 
     data[0] = BMP180_REG_DATA;
-    rc = iBSP430i2cTxData_rh(i2c, data, 1);
-    if (0 > rc) {
-      break;
-    }
-    rc = iBSP430i2cRxData_rh(i2c, data, 2);
+    rc = iBSP430i2cTxRxData_rh(i2c, data, 1, data, 2);
     if (0 > rc) {
       break;
     }
@@ -173,11 +163,7 @@ iBSP430sensorsBMP180getSample (hBSP430halSERIAL i2c,
     /* 1.5 ms plus 3 ms for each sample. */
     BSP430_UPTIME_DELAY_MS(2 + (3 << sample->oversampling), LPM0_bits, 0);
     data[0] = BMP180_REG_DATA;
-    rc = iBSP430i2cTxData_rh(i2c, data, 1);
-    if (0 > rc) {
-      break;
-    }
-    rc = iBSP430i2cRxData_rh(i2c, data, 3);
+    rc = iBSP430i2cTxRxData_rh(i2c, data, 1, data, 3);
     if (0 > rc) {
       break;
     }
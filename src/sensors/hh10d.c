@@ -88,11 +88,7 @@ iBSP430sensorsHH10DgetCalibration (hBSP430halSERIAL i2c,
     if (0 > rc) {
       break;
     }
-    rc = iBSP430i2cTxData_rh(i2c, &addr, sizeof(addr));
-    if (sizeof(addr) != rc) {
-      break;
-    }
-    rc = iBSP430i2cRxData_rh(i2c, data, sizeof(data));
+    rc = iBSP430i2cTxRxData_rh(i2c, &addr, sizeof(addr), data, sizeof(data));
     if (sizeof(data) != rc) {
       break;
     }
@@ -114,12 +114,8 @@ iBSP430sensorsSHT21eic (hBSP430halSERIAL i2c,
     dp = data;
     *dp++ = 0xFA;
     *dp++ = 0x0F;
-    rc = iBSP430i2cTxData_rh(i2c, data, dp-data);
-    if ((dp-data) != rc) {
-      break;
-    }
     dpe = data + 8;
-    rc = iBSP430i2cRxData_rh(i2c, data, dpe-data);
+    rc = iBSP430i2cTxRxData_rh(i2c, data, dp-data, data, dpe-data);
     if ((dpe-data) != rc) {
       break;
     }
@@ -142,12 +138,8 @@ iBSP430sensorsSHT21eic (hBSP430halSERIAL i2c,
     dp = data;
     *dp++ = 0xFC;
     *dp++ = 0xC9;
-    rc = iBSP430i2cTxData_rh(i2c, data, dp-data);
-    if ((dp-data) != rc) {
-      break;
-    }
     dpe = data + 6;
-    rc = iBSP430i2cRxData_rh(i2c, data, dpe-data);
+    rc = iBSP430i2cTxRxData_rh(i2c, data, dp-data, data, dpe-data);
     if ((dpe-data) != rc) {
       break;
     }
@@ -199,11 +191,7 @@ iBSP430sensorsSHT21configuration (hBSP430halSERIAL i2c,
     int rc;
     uint8_t cmd = SHT21_USERREG_R;
 
-    rc = iBSP430i2cTxData_rh(i2c, &cmd, sizeof(cmd));
-    if (sizeof(cmd) != rc) {
-      break;
-    }
-    rc = iBSP430i2cRxData_rh(i2c, &ur_orig, sizeof(ur_orig));
+    rc = iBSP430i2cTxRxData_rh(i2c, &cmd, sizeof(cmd), &ur_orig, sizeof(ur_orig));
     if (sizeof(ur_orig) != rc) {
       break;
     }
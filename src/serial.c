@@ -77,3 +77,428 @@ uiBSP430serialSMCLKPrescaler (unsigned long freq_Hz)
   }
   return (unsigned int)prescaler;
 }
+
+#if (configBSP430_SERIAL_ENABLE_SPI - 0) && (configBSP430_SERIAL_SPI_ASYNC - 0)
+
+#include <bsp430/periph/dma.h>
+#include <bsp430/periph/usci5.h>
+#include <bsp430/periph/eusci.h>
+#include <stddef.h>
+
+#if ! ((BSP430_MODULE_DMAX - 0) && (BSP430_CORE_FAMILY_IS_5XX - 0))
+#error configBSP430_SERIAL_SPI_ASYNC requires a 5xx-family DMA controller
+#endif /* validate DMA */
+
+#define SPI_ASYNC_DMACTL (DMADT_0 | DMASRCBYTE | DMADSTBYTE)
+
+/* Select the trigger for a DMA channel.  Each control word holds the
+ * trigger selections for two channels. */
+static void
+spi_async_set_trigger_ni (int channel,
+                          int trigger)
+{
+  volatile unsigned int * tselp = &BSP430_HPL_DMA->ctl0 + (channel / 2);
+  unsigned int shift = 8 * (channel % 2);
+
+  *tselp = (*tselp & ~(0xFFU << shift)) | ((unsigned int)trigger << shift);
+}
+
+/* Arm the transmit channel to send len octets from src, advancing
+ * through the source only if incr.  The channel is triggered by the
+ * rising edge of UCTXIFG; if the flag is already set (and the channel
+ * has not yet fired) an edge is produced by clearing and re-setting
+ * it. */
+static void
+spi_async_start_tx_ni (sBSP430spiAsync * ap,
+                       const uint8_t * src,
+                       size_t len,
+                       int incr,
+                       unsigned int ie)
+{
+  volatile sBSP430hplDMAchannel * chp = BSP430_HPL_DMA->ch + ap->tx_channel;
+
+  chp->ctl = 0;
+  chp->sa = (uintptr_t)src;
+  chp->da = (uintptr_t)ap->txbuf;
+  chp->sz = len;
+  chp->ctl = SPI_ASYNC_DMACTL | (incr ? DMASRCINCR_3 : DMASRCINCR_0) | DMADSTINCR_0 | ie | DMAEN;
+  if ((*ap->ifg & UCTXIFG) && (len == chp->sz)) {
+    *ap->ifg &= ~UCTXIFG;
+    *ap->ifg |= UCTXIFG;
+  }
+}
+
+/* Transmit channel completion.  This is enabled only when the
+ * command octets are followed by dummy octets, which require the
+ * channel to be reprogrammed with a fixed source. */
+static int
+spi_async_tx_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                     void * context,
+                     int idx)
+{
+  sBSP430spiAsync * ap = (sBSP430spiAsync *)((char *)cb - offsetof(sBSP430spiAsync, tx_cb));
+  size_t rx_len = ap->pending_rx_len;
+
+  (void)context;
+  (void)idx;
+  if (0 == rx_len) {
+    return 0;
+  }
+  ap->pending_rx_len = 0;
+  spi_async_start_tx_ni(ap, &ap->tx_dummy, rx_len, 0, 0);
+  return 0;
+}
+
+/* Receive channel completion: the last response has been stored, so
+ * the transaction is complete. */
+static int
+spi_async_rx_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                     void * context,
+                     int idx)
+{
+  sBSP430spiAsync * ap = (sBSP430spiAsync *)((char *)cb - offsetof(sBSP430spiAsync, rx_cb));
+  int rv;
+
+  (void)context;
+  (void)idx;
+  if (0 != ap->result) {
+    return 0;
+  }
+  ap->hal->num_rx += ap->length;
+  ap->hal->num_tx += ap->length;
+  ap->result = ap->length;
+  rv = BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  if (ap->callback_ni) {
+    rv = ap->callback_ni(ap);
+  }
+  return rv;
+}
+
+int
+iBSP430spiAsyncConfigure_ni (sBSP430spiAsync * ap,
+                             hBSP430halSERIAL hal,
+                             int rx_channel,
+                             int rx_trigger,
+                             int tx_channel,
+                             int tx_trigger)
+{
+  if ((0 > rx_channel) || (BSP430_DMA_NUM_CHANNELS <= rx_channel)
+      || (0 > tx_channel) || (BSP430_DMA_NUM_CHANNELS <= tx_channel)
+      || (rx_channel == tx_channel)) {
+    return -1;
+  }
+  ap->txbuf = NULL;
+#if (configBSP430_SERIAL_USE_USCI5 - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_USCI5(hal)) {
+    ap->rxbuf = &hal->hpl.usci5->rxbuf;
+    ap->txbuf = &hal->hpl.usci5->txbuf;
+    ap->ifg = &hal->hpl.usci5->ifg;
+  }
+#endif /* configBSP430_SERIAL_USE_USCI5 */
+#if (configBSP430_SERIAL_USE_EUSCI - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_EUSCIA(hal)) {
+    ap->rxbuf = (volatile uint8_t *)&hal->hpl.euscia->rxbuf;
+    ap->txbuf = (volatile uint8_t *)&hal->hpl.euscia->txbuf;
+    ap->ifg = (volatile uint8_t *)&hal->hpl.euscia->ifg;
+  } else if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_EUSCIB(hal)) {
+    ap->rxbuf = (volatile uint8_t *)&hal->hpl.euscib->rxbuf;
+    ap->txbuf = (volatile uint8_t *)&hal->hpl.euscib->txbuf;
+    ap->ifg = (volatile uint8_t *)&hal->hpl.euscib->ifg;
+  }
+#endif /* configBSP430_SERIAL_USE_EUSCI */
+  if (NULL == ap->txbuf) {
+    return -1;
+  }
+  ap->hal = hal;
+  ap->rx_channel = rx_channel;
+  ap->tx_channel = tx_channel;
+  ap->pending_rx_len = 0;
+  ap->result = -1;
+  ap->tx_dummy = BSP430_SERIAL_SPI_READ_TX_BYTE(0);
+  ap->rx_cb.callback_ni = spi_async_rx_isr_ni;
+  ap->tx_cb.callback_ni = spi_async_tx_isr_ni;
+  spi_async_set_trigger_ni(rx_channel, rx_trigger);
+  spi_async_set_trigger_ni(tx_channel, tx_trigger);
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[rx_channel], ap->rx_cb, next_ni);
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[tx_channel], ap->tx_cb, next_ni);
+  return 0;
+}
+
+int
+iBSP430spiAsyncRelease_ni (sBSP430spiAsync * ap)
+{
+  BSP430_HPL_DMA->ch[ap->rx_channel].ctl = 0;
+  BSP430_HPL_DMA->ch[ap->tx_channel].ctl = 0;
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[ap->rx_channel], ap->rx_cb, next_ni);
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[ap->tx_channel], ap->tx_cb, next_ni);
+  ap->hal = NULL;
+  return 0;
+}
+
+int
+iBSP430spiTxRxAsync_ni (sBSP430spiAsync * ap,
+                        const uint8_t * tx_data,
+                        size_t tx_len,
+                        size_t rx_len,
+                        uint8_t * rx_data)
+{
+  volatile sBSP430hplDMAchannel * rxp;
+  hBSP430halSERIAL hal = ap->hal;
+  size_t length = tx_len + rx_len;
+  uint8_t rx_discard;
+
+  if ((NULL == hal) || (0 == ap->result)
+      || hal->tx_cbchain_ni || hal->rx_cbchain_ni
+      || (0 == length)) {
+    return -1;
+  }
+  ap->length = length;
+  ap->result = 0;
+
+  /* Discard any stale received octet so the first response produces
+   * a fresh edge on UCRXIFG. */
+  rx_discard = *ap->rxbuf;
+  (void)rx_discard;
+
+  rxp = BSP430_HPL_DMA->ch + ap->rx_channel;
+  rxp->ctl = 0;
+  rxp->sa = (uintptr_t)ap->rxbuf;
+  rxp->da = (uintptr_t)(rx_data ? rx_data : &ap->rx_dummy);
+  rxp->sz = length;
+  rxp->ctl = SPI_ASYNC_DMACTL | DMASRCINCR_0 | (rx_data ? DMADSTINCR_3 : DMADSTINCR_0) | DMAIE | DMAEN;
+
+  if (0 < tx_len) {
+    ap->pending_rx_len = rx_len;
+    spi_async_start_tx_ni(ap, tx_data, tx_len, 1, (0 < rx_len) ? DMAIE : 0);
+  } else {
+    ap->pending_rx_len = 0;
+    spi_async_start_tx_ni(ap, &ap->tx_dummy, rx_len, 0, 0);
+  }
+  return 0;
+}
+
+#if (configBSP430_SERIAL_SPI_BUS - 0)
+
+/* Assert the chip select of the transaction at the head of the queue,
+ * reconfigure the device if necessary, and start the transfer. */
+static int
+spi_bus_start_ni (sBSP430spiBus * bp)
+{
+  sBSP430spiTransaction * tp = bp->queue_ni;
+  hBSP430halSERIAL hal = bp->async.hal;
+  int rc;
+
+  if ((! bp->configured)
+      || (tp->ctl0_byte != bp->ctl0_byte)
+      || (tp->ctl1_byte != bp->ctl1_byte)
+      || (tp->prescaler != bp->prescaler)) {
+    /* Reopening the device clears its statistics, which cover all
+     * devices on the bus. */
+    unsigned long num_rx = hal->num_rx;
+    unsigned long num_tx = hal->num_tx;
+
+    bp->configured = 0;
+    if (NULL == hBSP430serialOpenSPI(hal, tp->ctl0_byte, tp->ctl1_byte, tp->prescaler)) {
+      return -1;
+    }
+    hal->num_rx = num_rx;
+    hal->num_tx = num_tx;
+    bp->ctl0_byte = tp->ctl0_byte;
+    bp->ctl1_byte = tp->ctl1_byte;
+    bp->prescaler = tp->prescaler;
+    bp->configured = 1;
+  }
+  if (tp->csn_port) {
+    tp->csn_port->out &= ~tp->csn_bit;
+  }
+  rc = iBSP430spiTxRxAsync_ni(&bp->async, tp->tx_data, tp->tx_len, tp->rx_len, tp->rx_data);
+  if ((0 > rc) && tp->csn_port) {
+    tp->csn_port->out |= tp->csn_bit;
+  }
+  return rc;
+}
+
+/* Retire the transaction at the head of the queue with the given
+ * result, and start its successors until one starts successfully.  A
+ * successful transaction that holds the chip select leaves the
+ * successors waiting for the device's next transaction. */
+static int
+spi_bus_complete_ni (sBSP430spiBus * bp,
+                     int result)
+{
+  int rv = 0;
+
+  do {
+    sBSP430spiTransaction * tp = bp->queue_ni;
+
+    bp->held = (0 < result) && (tp->flags & BSP430_SPI_TXN_FLAG_HOLD_CS);
+    if (bp->held) {
+      bp->hold_port = tp->csn_port;
+      bp->hold_bit = tp->csn_bit;
+    } else if (tp->csn_port) {
+      tp->csn_port->out |= tp->csn_bit;
+    }
+    bp->queue_ni = tp->next_ni;
+    tp->next_ni = NULL;
+    tp->result = result;
+    /* Start the successor before notifying, so a callback that
+     * submits a new transaction only appends it to the queue. */
+    result = 0;
+    if (bp->queue_ni && (! bp->held)) {
+      result = spi_bus_start_ni(bp);
+    }
+    if (tp->callback_ni) {
+      rv |= tp->callback_ni(tp);
+    } else {
+      rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+    }
+  } while (0 > result);
+  return rv;
+}
+
+static int
+spi_bus_async_callback_ni (sBSP430spiAsync * ap)
+{
+  sBSP430spiBus * bp = (sBSP430spiBus *)((char *)ap - offsetof(sBSP430spiBus, async));
+
+  return spi_bus_complete_ni(bp, ap->result);
+}
+
+int
+iBSP430spiBusConfigure_ni (sBSP430spiBus * bp,
+                           hBSP430halSERIAL hal,
+                           int rx_channel,
+                           int rx_trigger,
+                           int tx_channel,
+                           int tx_trigger)
+{
+  int rc;
+
+  rc = iBSP430spiAsyncConfigure_ni(&bp->async, hal, rx_channel, rx_trigger, tx_channel, tx_trigger);
+  if (0 != rc) {
+    return rc;
+  }
+  bp->async.callback_ni = spi_bus_async_callback_ni;
+  bp->queue_ni = NULL;
+  bp->configured = 0;
+  bp->held = 0;
+  return 0;
+}
+
+int
+iBSP430spiBusRelease_ni (sBSP430spiBus * bp)
+{
+  while (bp->queue_ni) {
+    sBSP430spiTransaction * tp = bp->queue_ni;
+
+    if (tp->csn_port) {
+      tp->csn_port->out |= tp->csn_bit;
+    }
+    bp->queue_ni = tp->next_ni;
+    tp->next_ni = NULL;
+    tp->result = -1;
+  }
+  if (bp->held && bp->hold_port) {
+    bp->hold_port->out |= bp->hold_bit;
+  }
+  bp->held = 0;
+  return iBSP430spiAsyncRelease_ni(&bp->async);
+}
+
+int
+iBSP430spiBusSubmit_ni (sBSP430spiBus * bp,
+                        sBSP430spiTransaction * tp)
+{
+  sBSP430spiTransaction * volatile * tpp;
+
+  if (0 == (tp->tx_len + tp->rx_len)) {
+    return -1;
+  }
+  tp->result = 0;
+  tpp = &bp->queue_ni;
+  if (bp->held && (tp->csn_port == bp->hold_port) && (tp->csn_bit == bp->hold_bit)) {
+    /* The device holding the bus continues ahead of the transactions
+     * waiting for it. */
+    bp->held = 0;
+  } else {
+    while (*tpp) {
+      tpp = &(*tpp)->next_ni;
+    }
+  }
+  tp->next_ni = *tpp;
+  *tpp = tp;
+  if ((tpp == &bp->queue_ni) && (! bp->held) && (0 > spi_bus_start_ni(bp))) {
+    (void)spi_bus_complete_ni(bp, -1);
+  }
+  return 0;
+}
+
+#endif /* configBSP430_SERIAL_SPI_BUS */
+
+#endif /* configBSP430_SERIAL_SPI_ASYNC */
+
+#if (configBSP430_SERIAL_SPI_BUS - 0) && ! (configBSP430_SERIAL_SPI_ASYNC - 0)
+#error configBSP430_SERIAL_SPI_BUS requires configBSP430_SERIAL_SPI_ASYNC
+#endif /* validate SPI bus */
+
+#if (configBSP430_SERIAL_ENABLE_I2C - 0) && (configBSP430_SERIAL_I2C_ASYNC - 0)
+
+int
+iBSP430i2cSubmit_ni (hBSP430halSERIAL hal,
+                     sBSP430i2cTransaction * tp)
+{
+  sBSP430i2cTransaction * volatile * tpp;
+  int rc;
+
+  if ((NULL == hal->dispatch->i2cStart_ni)
+      || (0 == (tp->tx_len + tp->rx_len))) {
+    return -1;
+  }
+  tp->result = 0;
+  tp->next_ni = NULL;
+  tp->txp = tp->tx_data;
+  tp->tx_rem = tp->tx_len;
+  tp->rxp = tp->rx_data;
+  tp->rx_rem = tp->rx_len;
+  tpp = &hal->i2c_queue_ni;
+  while (*tpp) {
+    tpp = &(*tpp)->next_ni;
+  }
+  *tpp = tp;
+  if (tpp == &hal->i2c_queue_ni) {
+    rc = hal->dispatch->i2cStart_ni(hal);
+    if (0 > rc) {
+      (void)iBSP430i2cTransactionComplete_ni_(hal, rc);
+    }
+  }
+  return 0;
+}
+
+int
+iBSP430i2cTransactionComplete_ni_ (hBSP430halSERIAL hal,
+                                   int result)
+{
+  int rv = 0;
+
+  do {
+    sBSP430i2cTransaction * tp = hal->i2c_queue_ni;
+
+    hal->i2c_queue_ni = tp->next_ni;
+    tp->next_ni = NULL;
+    tp->result = result;
+    /* Start the successor before notifying, so a callback that
+     * submits a new transaction only appends it to the queue. */
+    result = 0;
+    if (hal->i2c_queue_ni) {
+      result = hal->dispatch->i2cStart_ni(hal);
+    }
+    if (tp->callback_ni) {
+      rv |= tp->callback_ni(tp);
+    } else {
+      rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+    }
+  } while (0 > result);
+  return rv;
+}
+
+#endif /* configBSP430_SERIAL_I2C_ASYNC */
@@ -57,6 +57,14 @@ void vBSP430cliSetDiagnosticFunction (iBSP430cliDiagnosticFunction diagnostic_fu
 #if 0 < BSP430_CLI_CONSOLE_BUFFER_SIZE
 static char consoleBuffer_[BSP430_CLI_CONSOLE_BUFFER_SIZE];
 static char * cbEnd_;
+#if (configBSP430_CLI_RPC - 0)
+/* Octets remaining in the RPC frame being received into
+ * consoleBuffer_, or zero when receiving a command line. */
+static unsigned int rpcNeed_;
+#if 255 < BSP430_CLI_RPC_REPLY_SIZE
+#error BSP430_CLI_RPC_REPLY_SIZE exceeds maximum frame body length
+#endif /* BSP430_CLI_RPC_REPLY_SIZE */
+#endif /* configBSP430_CLI_RPC */
 #endif /* BSP430_CLI_CONSOLE_BUFFER_SIZE */
 
 const char *
@@ -163,6 +171,34 @@ iBSP430cliMatchCommand (const sBSP430cliCommand * cmds,
     *argstr_lenp = command_len;
   }
   nmatches = 0;
+#if (configBSP430_CLI_COMMAND_TABLE - 0)
+  if ((0 < len) && (NULL != cmds) && (1 < cmds->table_len)) {
+    /* Commands with keys that begin with the token are adjacent in the
+     * sorted table.  Find the first key that does not sort before the
+     * token, then collect matches until one fails. */
+    unsigned char lo = 0;
+    unsigned char hi = cmds->table_len;
+
+    while (lo < hi) {
+      unsigned char mid = (lo + hi) >> 1;
+      if (0 > strncmp(cmds[mid].key, key, len)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    while ((lo < cmds->table_len) && (0 == strncmp(key, cmds[lo].key, len))) {
+      ++nmatches;
+      if (0 != match_callback) {
+        match_callback->callback(match_callback, cmds + lo);
+      }
+      match = cmds + lo;
+      ++lo;
+    }
+    /* Any commands chained after the table are checked linearly */
+    cmds = cmds[cmds->table_len - 1].next;
+  }
+#endif /* configBSP430_CLI_COMMAND_TABLE */
   while (cmds) {
     if (0 == strncmp(key, cmds->key, len)) {
       ++nmatches;
@@ -259,6 +295,259 @@ iBSP430cliParseCommand (const sBSP430cliCommand * cmds,
   return processSubcommand_(NULL, cmds, param, command, strlen(command), chain_handler, handler);
 }
 
+int
+iBSP430cliScriptReadMemory (const sBSP430cliScriptSource * self,
+                            unsigned long offset,
+                            char * dst,
+                            size_t len)
+{
+  const sBSP430cliScriptMemory * smp = (const sBSP430cliScriptMemory *)self;
+
+  if (offset >= smp->script_len) {
+    return 0;
+  }
+  if (len > (smp->script_len - offset)) {
+    len = smp->script_len - offset;
+  }
+  memcpy(dst, smp->script + offset, len);
+  return len;
+}
+
+int
+iBSP430cliExecuteScript (const sBSP430cliCommand * cmds,
+                         void * param,
+                         const sBSP430cliScriptSource * src,
+                         char * line,
+                         size_t line_size)
+{
+  sBSP430cliCommandLink script_link;
+  unsigned long offset = 0;
+  size_t have = 0;
+  int at_end = 0;
+  int rv = 0;
+
+  script_link.link = NULL;
+  script_link.command_set = cmds;
+  script_link.cmd = NULL;
+  if (2 > line_size) {
+    return diagnosticFunction(&script_link, eBSP430_CLI_ERR_Config, "", 0);
+  }
+  while (1) {
+    char * ep;
+    char * lep;
+    const char * cp;
+    const char * tp;
+    size_t remaining;
+    size_t tlen;
+    int rc;
+
+    /* Text following the last complete line is kept at the start of
+     * the buffer; read enough to fill the rest of it.  The line's
+     * terminator is replaced by the NUL, so a line of line_size-1
+     * characters fits. */
+    while ((! at_end) && (have < line_size)) {
+      rc = src->read(src, offset, line + have, line_size - have);
+      if (0 > rc) {
+        return rc;
+      }
+      if (0 == rc) {
+        at_end = 1;
+      }
+      offset += rc;
+      have += rc;
+    }
+    lep = line + have;
+    ep = line;
+    while ((ep < lep) && ('\n' != *ep) && (0 != *ep) && (0xFF != (unsigned char)*ep)) {
+      ++ep;
+    }
+    if ((ep == lep) && ((! at_end) || (line_size == have))) {
+      /* No room for the NUL: the line is too long */
+      line[line_size - 1] = 0;
+      return diagnosticFunction(&script_link, eBSP430_CLI_ERR_Invalid, line, line_size - 1);
+    }
+    if ((ep < lep) && ('\n' != *ep)) {
+      /* NUL or erased memory marks the end of the script */
+      at_end = 1;
+      lep = ep;
+    }
+    *ep = 0;
+    cp = line;
+    remaining = ep - line;
+    tp = xBSP430cliNextToken(&cp, &remaining, &tlen);
+    if ((0 < tlen) && ('#' != *tp)) {
+      rc = processSubcommand_(NULL, cmds, param, line, ep - line, NULL, NULL);
+      if (0 > rc) {
+        return rc;
+      }
+      ++rv;
+    }
+    if (ep == lep) {
+      return rv;
+    }
+    ++ep;
+    have = lep - ep;
+    memmove(line, ep, have);
+  }
+}
+
+#if (configBSP430_CLI_RPC - 0)
+
+uint16_t
+uiBSP430cliRPCCRC (uint16_t crc,
+                   const uint8_t * data,
+                   size_t len)
+{
+  while (0 < len--) {
+    crc = (crc >> 8) | (crc << 8);
+    crc ^= *data++;
+    crc ^= (crc & 0xFF) >> 4;
+    crc ^= crc << 12;
+    crc ^= (crc & 0xFF) << 5;
+  }
+  return crc;
+}
+
+static int
+rpcSubcommand_ (sBSP430cliCommandLink * chain,
+                const sBSP430cliCommand * command_set,
+                void * param,
+                const uint8_t * path,
+                size_t depth,
+                const uint8_t * args,
+                size_t args_len,
+                uint8_t * result,
+                size_t result_size)
+{
+  sBSP430cliCommandLink parent_link;
+  const sBSP430cliCommand * cmd = command_set;
+  unsigned int position = *path;
+
+#if (configBSP430_CLI_COMMAND_TABLE - 0)
+  if ((NULL != cmd) && (position < cmd->table_len)) {
+    cmd += position;
+    position = 0;
+  }
+#endif /* configBSP430_CLI_COMMAND_TABLE */
+  while ((NULL != cmd) && (0 < position--)) {
+    cmd = cmd->next;
+  }
+  if (NULL == cmd) {
+    return -eBSP430_CLI_ERR_Unrecognized;
+  }
+  parent_link.link = chain;
+  parent_link.command_set = command_set;
+  parent_link.cmd = cmd;
+  if (1 < depth) {
+    if (NULL == cmd->child) {
+      return -eBSP430_CLI_ERR_Unrecognized;
+    }
+    return rpcSubcommand_(&parent_link, cmd->child, param, path + 1, depth - 1, args, args_len, result, result_size);
+  }
+  if (NULL == cmd->rpc_handler) {
+    return -eBSP430_CLI_ERR_Config;
+  }
+  return cmd->rpc_handler(&parent_link, param, args, args_len, result, result_size);
+}
+
+size_t
+xBSP430cliRPCExecute (const sBSP430cliCommand * cmds,
+                      void * param,
+                      const uint8_t * body,
+                      size_t body_len,
+                      uint8_t * reply,
+                      size_t reply_size)
+{
+  size_t depth = 0;
+  int rv;
+
+  if (0 < body_len) {
+    depth = body[0];
+  }
+  if (0 == depth) {
+    rv = -eBSP430_CLI_ERR_Missing;
+  } else if (body_len <= depth) {
+    rv = -eBSP430_CLI_ERR_Invalid;
+  } else {
+    rv = rpcSubcommand_(NULL, cmds, param, body + 1, depth,
+                        body + 1 + depth, body_len - 1 - depth,
+                        reply + 1, reply_size - 1);
+  }
+  if (0 > rv) {
+    reply[0] = (uint8_t)rv;
+    return 1;
+  }
+  reply[0] = 0;
+  return 1 + rv;
+}
+
+/* Read and optionally write a variable of the given size, with the
+ * value transferred little-endian. */
+static int
+rpcAccess_ (sBSP430cliCommandLink * chain,
+            const uint8_t * args,
+            size_t args_len,
+            uint8_t * result,
+            size_t result_size,
+            size_t size)
+{
+  void * vp = chain->cmd->param.ptr;
+  unsigned long v;
+  size_t i;
+
+  if ((NULL == vp) || (result_size < size)) {
+    return -eBSP430_CLI_ERR_Config;
+  }
+  if (0 != args_len) {
+    if (size != args_len) {
+      return -eBSP430_CLI_ERR_Invalid;
+    }
+    v = 0;
+    for (i = size; 0 < i--; ) {
+      v = (v << 8) | args[i];
+    }
+    if (sizeof(unsigned int) == size) {
+      *(unsigned int *)vp = v;
+    } else {
+      *(unsigned long *)vp = v;
+    }
+  }
+  if (sizeof(unsigned int) == size) {
+    v = *(const unsigned int *)vp;
+  } else {
+    v = *(const unsigned long *)vp;
+  }
+  for (i = 0; i < size; ++i) {
+    result[i] = v;
+    v >>= 8;
+  }
+  return size;
+}
+
+int
+iBSP430cliRPCHandlerAccessI (sBSP430cliCommandLink * chain,
+                             void * param,
+                             const uint8_t * args,
+                             size_t args_len,
+                             uint8_t * result,
+                             size_t result_size)
+{
+  return rpcAccess_(chain, args, args_len, result, result_size, sizeof(unsigned int));
+}
+
+int
+iBSP430cliRPCHandlerAccessL (sBSP430cliCommandLink * chain,
+                             void * param,
+                             const uint8_t * args,
+                             size_t args_len,
+                             uint8_t * result,
+                             size_t result_size)
+{
+  return rpcAccess_(chain, args, args_len, result, result_size, sizeof(unsigned long));
+}
+
+#endif /* configBSP430_CLI_RPC */
+
 int
 iBSP430cliHandlerSimple (sBSP430cliCommandLink * chain,
                          void * param,
@@ -511,6 +800,9 @@ void
 vBSP430cliConsoleBufferClear (void)
 {
   cbEnd_ = NULL;
+#if (configBSP430_CLI_RPC - 0)
+  rpcNeed_ = 0;
+#endif /* configBSP430_CLI_RPC */
 }
 
 int
@@ -538,6 +830,30 @@ iBSP430cliConsoleBufferProcessInput ()
     cbEnd_ = consoleBuffer_;
   }
   while (0 <= ((c = cgetchar()))) {
+#if (configBSP430_CLI_RPC - 0)
+    if (0 < rpcNeed_) {
+      /* The first octet is the body length; the body is followed by
+       * a two-octet CRC.  Octets that do not fit are counted but
+       * discarded, and the frame rejected when processed. */
+      if (cbEnd_ == consoleBuffer_) {
+        rpcNeed_ = 2 + c;
+      } else {
+        --rpcNeed_;
+      }
+      if (cbEnd_ < (consoleBuffer_ + sizeof(consoleBuffer_))) {
+        *cbEnd_++ = c;
+      }
+      if (0 == rpcNeed_) {
+        rv |= eBSP430cliConsole_RPC_READY;
+        break;
+      }
+      continue;
+    }
+    if ((BSP430_CLI_RPC_SOF == c) && (cbEnd_ == consoleBuffer_)) {
+      rpcNeed_ = 1;
+      continue;
+    }
+#endif /* configBSP430_CLI_RPC */
     if (KEY_BS == c) {
       if (cbEnd_ == consoleBuffer_) {
         cputchar(KEY_BEL);
@@ -587,6 +903,40 @@ iBSP430cliConsoleBufferProcessInput ()
   return rv;
 }
 
+#if (configBSP430_CLI_RPC - 0)
+int
+iBSP430cliConsoleBufferProcessRPC (const sBSP430cliCommand * cmds,
+                                   void * param)
+{
+  const uint8_t * fp = (const uint8_t *)consoleBuffer_;
+  uint8_t reply[4 + BSP430_CLI_RPC_REPLY_SIZE];
+  size_t stored = 0;
+  size_t len;
+  uint16_t crc;
+  int rv = -eBSP430_CLI_ERR_Invalid;
+
+  if (NULL != cbEnd_) {
+    stored = cbEnd_ - consoleBuffer_;
+  }
+  if ((3 <= stored) && (stored == (3 + fp[0]))) {
+    len = fp[0];
+    crc = uiBSP430cliRPCCRC(0xFFFF, fp, 1 + len);
+    if (crc == (fp[1 + len] | (fp[2 + len] << 8))) {
+      len = xBSP430cliRPCExecute(cmds, param, fp + 1, len, reply + 2, BSP430_CLI_RPC_REPLY_SIZE);
+      reply[0] = BSP430_CLI_RPC_SOF;
+      reply[1] = len;
+      crc = uiBSP430cliRPCCRC(0xFFFF, reply + 1, 1 + len);
+      reply[2 + len] = crc & 0xFF;
+      reply[3 + len] = crc >> 8;
+      (void)cputraw(reply, 4 + len);
+      rv = reply[2] ? ((int)reply[2] - 256) : 0;
+    }
+  }
+  vBSP430cliConsoleBufferClear();
+  return rv;
+}
+#endif /* configBSP430_CLI_RPC */
+
 int
 iBSP430cliConsoleBufferConsumeEscape (int flags)
 {
@@ -39,23 +39,28 @@
 
 #include <bsp430/platform.h>
 #include <bsp430/utility/console.h>
+#include <bsp430/periph/dma.h>
+#include <bsp430/periph/usci5.h>
+#include <bsp430/periph/eusci.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <string.h>
+#include <limits.h>
 
 #if (BSP430_CONSOLE - 0)
+
+/* The console formats its own output on the target; the binary log
+ * macro applies only to application call sites. */
+#undef cprintf
+
 /* Inhibit definition if required components were not provided. */
 
 #if (BSP430_CONSOLE_USE_EMBTEXTF - 0)
 #define HAVE_EMBTEXTF 1
 #include <embtextf/uprintf.h>
-#include <embtextf/xtoa.h>
 
-#define itoa embtextf_itoa
-#define utoa embtextf_utoa
-#define ltoa embtextf_ltoa
-#define ultoa embtextf_ultoa
 #define vuprintf embtextf_vuprintf
 #elif (BSP430_CORE_TOOLCHAIN_LIBC_MSP430_LIBC - 0)
 /* msp430-libc natively incorporates the same interfaces provided by embtextf. */
@@ -64,16 +69,32 @@
 
 static hBSP430halSERIAL console_hal_;
 
+/* Reduce a buffer index in the range [0, 2*size_) to [0, size_).  The
+ * size is a compile-time constant, so this becomes a mask when it is
+ * a power of two and a conditional subtraction otherwise; neither
+ * requires a division. */
+#define CONSOLE_BUFFER_WRAP_(size_, i_) ((0 == ((size_) & ((size_) - 1))) \
+                                         ? ((i_) & ((size_) - 1))        \
+                                         : (((size_) <= (i_)) ? ((i_) - (size_)) : (i_)))
+
 #if (BSP430_CONSOLE_RX_BUFFER_SIZE - 0)
-#if 254 < (BSP430_CONSOLE_RX_BUFFER_SIZE)
+#if 32768 < (BSP430_CONSOLE_RX_BUFFER_SIZE)
 #error BSP430_CONSOLE_RX_BUFFER_SIZE is too large
 #endif /* validate BSP430_CONSOLE_RX_BUFFER_SIZE */
 
+#if 255 >= (BSP430_CONSOLE_RX_BUFFER_SIZE)
+typedef unsigned char tConsoleRxIndex;
+#else /* BSP430_CONSOLE_RX_BUFFER_SIZE */
+typedef unsigned int tConsoleRxIndex;
+#endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
+
+#define RX_BUFFER_WRAP_(i_) CONSOLE_BUFFER_WRAP_(BSP430_CONSOLE_RX_BUFFER_SIZE, i_)
+
 typedef struct sConsoleRxBuffer {
   sBSP430halISRVoidChainNode cb_node;
   char buffer[BSP430_CONSOLE_RX_BUFFER_SIZE];
-  volatile unsigned char head;
-  volatile unsigned char tail;
+  volatile tConsoleRxIndex head;
+  volatile tConsoleRxIndex tail;
   iBSP430consoleRxCallback_ni callback_ni;
 } sConsoleRxBuffer;
 
@@ -83,13 +104,13 @@ console_rx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
 {
   sConsoleRxBuffer * bufp = (sConsoleRxBuffer *)cb;
   sBSP430halSERIAL * hal = (sBSP430halSERIAL *) context;
-  unsigned char head = bufp->head;
+  tConsoleRxIndex head = bufp->head;
   int rv;
 
   bufp->buffer[head] = hal->rx_byte;
-  head = (head + 1) % (sizeof(bufp->buffer) / sizeof(*bufp->buffer));
+  head = RX_BUFFER_WRAP_(head + 1);
   if (head == bufp->tail) {
-    bufp->tail = (bufp->tail + 1) % (sizeof(bufp->buffer) / sizeof(*bufp->buffer));
+    bufp->tail = RX_BUFFER_WRAP_(bufp->tail + 1);
   }
   bufp->head = head;
   if (NULL != bufp->callback_ni) {
@@ -114,16 +135,38 @@ vBSP430consoleSetRxCallback_ni (iBSP430consoleRxCallback_ni cb)
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 
 #if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
-#if 254 < (BSP430_CONSOLE_TX_BUFFER_SIZE)
+#if 32768 < (BSP430_CONSOLE_TX_BUFFER_SIZE)
 #error BSP430_CONSOLE_TX_BUFFER_SIZE is too large
 #endif /* validate BSP430_CONSOLE_TX_BUFFER_SIZE */
 
+#if 255 >= (BSP430_CONSOLE_TX_BUFFER_SIZE)
+typedef unsigned char tConsoleTxIndex;
+#else /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+typedef unsigned int tConsoleTxIndex;
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+
+#define TX_BUFFER_WRAP_(i_) CONSOLE_BUFFER_WRAP_(BSP430_CONSOLE_TX_BUFFER_SIZE, i_)
+
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+#if ! ((BSP430_MODULE_DMAX - 0) && (BSP430_CORE_FAMILY_IS_5XX - 0))
+#error configBSP430_CONSOLE_TX_DMA requires a 5xx-family DMA controller
+#endif /* validate DMA */
+#ifndef BSP430_CONSOLE_TX_DMA_TRIGGER
+#error configBSP430_CONSOLE_TX_DMA requires BSP430_CONSOLE_TX_DMA_TRIGGER
+#endif /* BSP430_CONSOLE_TX_DMA_TRIGGER */
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
 typedef struct sConsoleTxBuffer {
   sBSP430halISRVoidChainNode cb_node;
   char buffer[BSP430_CONSOLE_TX_BUFFER_SIZE];
-  volatile unsigned char head;
-  volatile unsigned char tail;
+  volatile tConsoleTxIndex head;
+  volatile tConsoleTxIndex tail;
   volatile int wake_available;
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  /* Number of bytes starting at tail that belong to the active DMA
+   * transfer; zero when the channel is idle. */
+  volatile tConsoleTxIndex dma_len;
+#endif /* configBSP430_CONSOLE_TX_DMA */
 } sConsoleTxBuffer;
 
 /* Calculate the number of bytes available in the buffer given the
@@ -138,8 +181,8 @@ console_tx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
 {
   sConsoleTxBuffer * bufp = (sConsoleTxBuffer *)cb;
   sBSP430halSERIAL * hal = (sBSP430halSERIAL *) context;
-  unsigned char tail = bufp->tail;
-  unsigned char head = bufp->head;
+  tConsoleTxIndex tail = bufp->tail;
+  tConsoleTxIndex head = bufp->head;
   int wake_available;
   int rv = 0;
 
@@ -148,7 +191,7 @@ console_tx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
   if (head != tail) {
     hal->tx_byte = bufp->buffer[tail];
     rv |= BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN;
-    bufp->tail = tail = (tail + 1) % (sizeof(bufp->buffer) / sizeof(*bufp->buffer));
+    bufp->tail = tail = TX_BUFFER_WRAP_(tail + 1);
   }
   wake_available = bufp->wake_available;
   if (head == tail) {
@@ -176,6 +219,130 @@ static sConsoleTxBuffer tx_buffer_ = {
   .cb_node = { .callback_ni = console_tx_isr_ni },
 };
 
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+
+/* The UART transmit buffer and interrupt flag register, low bytes
+ * only, as seen by the DMA channel. */
+static volatile unsigned char * dma_txbuf_;
+static volatile unsigned char * dma_ifg_;
+
+/* Hand the longest contiguous run of queued data to the DMA channel.
+ * The channel must be idle.  Transfers are triggered by the rising
+ * edge of UCTXIFG; if the flag is already set no edge will occur, so
+ * one is produced by clearing and re-setting it. */
+static void
+console_tx_dma_start_ni (sConsoleTxBuffer * bufp)
+{
+  volatile sBSP430hplDMAchannel * chp = BSP430_HPL_DMA->ch + BSP430_CONSOLE_TX_DMA_CHANNEL;
+  tConsoleTxIndex head = bufp->head;
+  tConsoleTxIndex tail = bufp->tail;
+  tConsoleTxIndex len;
+
+  if (head == tail) {
+    return;
+  }
+  len = ((head > tail) ? head : sizeof(bufp->buffer)) - tail;
+  bufp->dma_len = len;
+  chp->ctl = 0;
+  chp->sa = (uintptr_t)(bufp->buffer + tail);
+  chp->da = (uintptr_t)dma_txbuf_;
+  chp->sz = len;
+  chp->ctl = DMADT_0 | DMADSTINCR_0 | DMASRCINCR_3 | DMADSTBYTE | DMASRCBYTE | DMAIE | DMAEN;
+  if ((*dma_ifg_ & UCTXIFG) && (len == chp->sz)) {
+    *dma_ifg_ &= ~UCTXIFG;
+    *dma_ifg_ |= UCTXIFG;
+  }
+}
+
+/* DMA completion: release the transferred segment, start the next
+ * one, and wake anybody waiting for space, as console_tx_isr_ni()
+ * does for the interrupt-driven path. */
+static int
+console_tx_dma_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                       void * context,
+                       int idx)
+{
+  sConsoleTxBuffer * bufp = &tx_buffer_;
+  tConsoleTxIndex head = bufp->head;
+  tConsoleTxIndex tail = TX_BUFFER_WRAP_(bufp->tail + bufp->dma_len);
+  int wake_available = bufp->wake_available;
+  int rv = 0;
+
+  (void)cb;
+  (void)context;
+  (void)idx;
+  bufp->tail = tail;
+  bufp->dma_len = 0;
+  if (head == tail) {
+    if (0 != wake_available) {
+      bufp->wake_available = 0;
+      rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+    }
+  } else {
+    if ((0 < wake_available)
+        && (TX_BUFFER_AVAILABLE_(bufp, head, tail) >= wake_available)) {
+      bufp->wake_available = 0;
+      rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+    }
+    console_tx_dma_start_ni(bufp);
+  }
+  return rv;
+}
+
+static sBSP430halISRIndexedChainNode tx_dma_cb_node_ = {
+  .callback_ni = console_tx_dma_isr_ni,
+};
+
+/* Stop the DMA channel, releasing whatever it already transferred.
+ * Anything left in the buffer is subsequently sent through the
+ * interrupt-driven or polled path. */
+static void
+console_tx_dma_stop_ni (sConsoleTxBuffer * bufp)
+{
+  volatile sBSP430hplDMAchannel * chp = BSP430_HPL_DMA->ch + BSP430_CONSOLE_TX_DMA_CHANNEL;
+
+  chp->ctl &= ~(DMAEN | DMAIE | DMAIFG);
+  if (0 != bufp->dma_len) {
+    bufp->tail = TX_BUFFER_WRAP_(bufp->tail + bufp->dma_len - chp->sz);
+    bufp->dma_len = 0;
+  }
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[BSP430_CONSOLE_TX_DMA_CHANNEL], tx_dma_cb_node_, next_ni);
+}
+
+/* Route the console transmit buffer through the DMA channel. */
+static void
+console_tx_dma_configure_ni (hBSP430halSERIAL hal)
+{
+  volatile unsigned int * tselp = &BSP430_HPL_DMA->ctl0 + (BSP430_CONSOLE_TX_DMA_CHANNEL / 2);
+  unsigned int shift = 8 * (BSP430_CONSOLE_TX_DMA_CHANNEL % 2);
+
+#if (BSP430_MODULE_EUSCI - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_EUSCIA(hal)) {
+    dma_txbuf_ = (volatile unsigned char *)&hal->hpl.euscia->txbuf;
+    dma_ifg_ = (volatile unsigned char *)&hal->hpl.euscia->ifg;
+  }
+#endif /* BSP430_MODULE_EUSCI */
+#if (BSP430_MODULE_USCI5 - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_USCI5(hal)) {
+    dma_txbuf_ = &hal->hpl.usci5->txbuf;
+    dma_ifg_ = &hal->hpl.usci5->ifg;
+  }
+#endif /* BSP430_MODULE_USCI5 */
+  *tselp = (*tselp & ~(0xFFU << shift)) | ((unsigned int)(BSP430_CONSOLE_TX_DMA_TRIGGER) << shift);
+  tx_buffer_.dma_len = 0;
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[BSP430_CONSOLE_TX_DMA_CHANNEL], tx_dma_cb_node_, next_ni);
+}
+
+/* Begin transmission of newly queued data when nothing is in
+ * flight. */
+#define CONSOLE_TX_KICK_NI(uart_, bufp_) console_tx_dma_start_ni(bufp_)
+
+#else /* configBSP430_CONSOLE_TX_DMA */
+
+#define CONSOLE_TX_KICK_NI(uart_, bufp_) vBSP430serialWakeupTransmit_rh(uart_)
+
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
 static int
 console_tx_queue (hBSP430halSERIAL uart, uint8_t c)
 {
@@ -184,8 +351,8 @@ console_tx_queue (hBSP430halSERIAL uart, uint8_t c)
 
   BSP430_CORE_DISABLE_INTERRUPT();
   while (1) {
-    unsigned char head = bufp->head;
-    unsigned char next_head = (head + 1) % (sizeof(bufp->buffer)/sizeof(*bufp->buffer));
+    tConsoleTxIndex head = bufp->head;
+    tConsoleTxIndex next_head = TX_BUFFER_WRAP_(head + 1);
     if (next_head == bufp->tail) {
       if (0 == bufp->wake_available) {
         bufp->wake_available = 1;
@@ -200,7 +367,7 @@ console_tx_queue (hBSP430halSERIAL uart, uint8_t c)
     bufp->buffer[head] = c;
     bufp->head = next_head;
     if (head == bufp->tail) {
-      vBSP430serialWakeupTransmit_rh(uart);
+      CONSOLE_TX_KICK_NI(uart, bufp);
     }
     break;
   }
@@ -208,6 +375,63 @@ console_tx_queue (hBSP430halSERIAL uart, uint8_t c)
   return c;
 }
 
+/* Queue a block of bytes for transmission.  Each pass through the
+ * loop copies as much of the remaining data as fits into the buffer
+ * in one critical section, in at most two segments when the data
+ * wraps.  The caller sleeps only when the buffer is full, and asks to
+ * be woken when there is space for the rest of the data (or as much
+ * of it as the buffer can hold). */
+static void
+console_tx_queue_chars (hBSP430halSERIAL uart,
+                        const char * cp,
+                        size_t len)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  sConsoleTxBuffer * bufp = &tx_buffer_;
+  const size_t size = sizeof(bufp->buffer)/sizeof(*bufp->buffer);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  while (0 < len) {
+    tConsoleTxIndex head = bufp->head;
+    tConsoleTxIndex tail = bufp->tail;
+    size_t n = TX_BUFFER_AVAILABLE_(bufp, head, tail);
+    size_t seg;
+
+    if (0 == n) {
+      int want = (len < (size - 1)) ? len : (size - 1);
+      int wake_available = bufp->wake_available;
+
+      /* Merge with any pending request rather than replacing it, so a
+       * waiter that needs less space (or is waiting for the buffer to
+       * drain) is still woken. */
+      if ((0 >= wake_available) || (want < wake_available)) {
+        bufp->wake_available = want;
+      }
+      BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
+      BSP430_CORE_DISABLE_INTERRUPT();
+      continue;
+    }
+    if (n > len) {
+      n = len;
+    }
+    seg = size - head;
+    if (seg > n) {
+      seg = n;
+    }
+    memcpy(bufp->buffer + head, cp, seg);
+    if (seg < n) {
+      memcpy(bufp->buffer, cp + seg, n - seg);
+    }
+    bufp->head = TX_BUFFER_WRAP_(head + n);
+    if (head == tail) {
+      CONSOLE_TX_KICK_NI(uart, bufp);
+    }
+    cp += n;
+    len -= n;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
 static int (* uartTransmit) (hBSP430halSERIAL uart, uint8_t c);
 
 #define UART_TRANSMIT(uart_, c_) uartTransmit(uart_, c_)
@@ -251,16 +475,59 @@ cputchar (int c)
   return emit_char(c);
 }
 
-/* Emit a NUL-terminated string of text, returning the number of
- * characters emitted. */
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+/* Emit a block of characters through the transmit buffer.  Runs of
+ * characters are queued in bulk; with ONLCR each newline is replaced
+ * by a CR/LF pair. */
+static void
+emit_chars_queued (const char * cp,
+                   size_t len,
+                   hBSP430halSERIAL uart)
+{
+  const char * const cpe = cp + len;
+
+  while (cp < cpe) {
+    const char * sp = cp;
+#if (configBSP430_CONSOLE_USE_ONLCR - 0)
+    while ((sp < cpe) && ('\n' != *sp)) {
+      ++sp;
+    }
+#else /* configBSP430_CONSOLE_USE_ONLCR */
+    sp = cpe;
+#endif /* configBSP430_CONSOLE_USE_ONLCR */
+    if (sp > cp) {
+      console_tx_queue_chars(uart, cp, sp - cp);
+    }
+#if (configBSP430_CONSOLE_USE_ONLCR - 0)
+    if (sp < cpe) {
+      console_tx_queue_chars(uart, "\r\n", 2);
+      ++sp;
+    }
+#endif /* configBSP430_CONSOLE_USE_ONLCR */
+    BSP430_CORE_WATCHDOG_CLEAR();
+    cp = sp;
+  }
+}
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+
+/* Emit a sequence of characters, returning the number of characters
+ * emitted. */
 static int
-emit_text (const char * s,
-           hBSP430halSERIAL uart)
+emit_chars (const char * cp,
+            size_t len,
+            hBSP430halSERIAL uart)
 {
   int rv = 0;
+
   if (uart) {
-    while (s[rv]) {
-      emit_char2(s[rv++], uart);
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+    if (console_tx_queue == uartTransmit) {
+      emit_chars_queued(cp, len, uart);
+      return len;
+    }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+    while (rv < len) {
+      emit_char2(cp[rv++], uart);
       BSP430_CORE_WATCHDOG_CLEAR();
     }
   }
@@ -270,15 +537,18 @@ emit_text (const char * s,
 /* Emit a NUL-terminated string of text, returning the number of
  * characters emitted. */
 static int
-emit_chars (const char * cp,
-            size_t len,
-            hBSP430halSERIAL uart)
+emit_text (const char * s,
+           hBSP430halSERIAL uart)
 {
   int rv = 0;
-
   if (uart) {
-    while (rv < len) {
-      emit_char2(cp[rv++], uart);
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+    if (console_tx_queue == uartTransmit) {
+      return emit_chars(s, strlen(s), uart);
+    }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+    while (s[rv]) {
+      emit_char2(s[rv++], uart);
       BSP430_CORE_WATCHDOG_CLEAR();
     }
   }
@@ -322,139 +592,655 @@ cputchars (const char * cp,
   return emit_chars(cp, len, uart);
 }
 
-#if HAVE_EMBTEXTF
-int
-cputi (int n, int radix)
+/* Emit octets without newline translation. */
+static void
+emit_raw (const void * data,
+          size_t len,
+          hBSP430halSERIAL uart)
 {
-  char buffer[sizeof("-32767")];
-  return emit_text(itoa(n, buffer, radix), console_hal_);
+  const char * cp = (const char *)data;
+
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+  if (console_tx_queue == uartTransmit) {
+    console_tx_queue_chars(uart, cp, len);
+    return;
+  }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  while (0 < len--) {
+    UART_TRANSMIT(uart, *cp++);
+  }
 }
 
 int
-cputu (unsigned int n, int radix)
+cputraw (const void * data,
+         size_t len)
 {
-  char buffer[sizeof("65535")];
-  return emit_text(utoa(n, buffer, radix), console_hal_);
+  hBSP430halSERIAL uart = console_hal_;
+
+  if (! uart) {
+    return 0;
+  }
+  emit_raw(data, len, uart);
+  return len;
 }
 
+#if (configBSP430_CONSOLE_BINARY_LOG - 0)
+#if ! (__GNUC__ - 0)
+#error configBSP430_CONSOLE_BINARY_LOG requires GCC extensions
+#endif /* __GNUC__ */
+
 int
-cputl (long n, int radix)
+iBSP430consoleBinaryLog (const char * format,
+                         const unsigned char * codes,
+                         ...)
 {
-  char buffer[sizeof("-2147483647")];
-  return emit_text(ltoa(n, buffer, radix), console_hal_);
+  hBSP430halSERIAL uart = console_hal_;
+  va_list ap;
+  uint16_t id;
+  unsigned char hdr[3];
+  int rv;
+
+  if (! uart) {
+    return 0;
+  }
+  /* The format is in a section that is not allocated and so is
+   * linked at address zero: its address is its offset in the
+   * section. */
+  id = (uint16_t)(uintptr_t)format;
+  hdr[0] = BSP430_CONSOLE_BINARY_LOG_MARKER;
+  hdr[1] = id & 0xFF;
+  hdr[2] = id >> 8;
+  emit_raw(hdr, sizeof(hdr), uart);
+  rv = sizeof(hdr);
+  va_start(ap, codes);
+  while (*codes) {
+    union {
+      int i;
+      long l;
+      long long ll;
+    } v;
+    const void * dp = &v;
+    size_t len = *codes++;
+
+    if (1 == len) {
+      dp = va_arg(ap, const char *);
+      len = 1 + strlen((const char *)dp);
+    } else if (sizeof(v.i) == len) {
+      v.i = va_arg(ap, int);
+    } else if (sizeof(v.l) == len) {
+      v.l = va_arg(ap, long);
+    } else {
+      v.ll = va_arg(ap, long long);
+    }
+    emit_raw(dp, len, uart);
+    rv += len;
+  }
+  va_end(ap);
+  return rv;
 }
+#endif /* configBSP430_CONSOLE_BINARY_LOG */
+
+/* Space for the representation of an unsigned long in radix 8 or
+ * larger, with a sign and a terminating NUL. */
+#define XTOA_BUFFER_SIZE (sizeof("-") + 3 * sizeof(unsigned long))
+
+#if (BSP430_CONSOLE_XTOA_RECIPROCAL - 0)
+#if (0xFFFFFFFFUL < ULONG_MAX) && ! defined(__SIZEOF_INT128__)
+#error BSP430_CONSOLE_XTOA_RECIPROCAL requires a 128-bit type when long has 64 bits
+#endif /* validate BSP430_CONSOLE_XTOA_RECIPROCAL */
+#else /* BSP430_CONSOLE_XTOA_RECIPROCAL */
+/* Powers of ten used to generate decimal digits by subtraction */
+static const unsigned long pow10_[] = {
+#if 0xFFFFFFFFUL < ULONG_MAX
+  10000000000000000000UL, 1000000000000000000UL, 100000000000000000UL,
+  10000000000000000UL, 1000000000000000UL, 100000000000000UL,
+  10000000000000UL, 1000000000000UL, 100000000000UL, 10000000000UL,
+#endif /* ULONG_MAX */
+  1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+  10000UL, 1000UL, 100UL, 10UL
+};
+#endif /* BSP430_CONSOLE_XTOA_RECIPROCAL */
 
-int
-cputul (unsigned long n, int radix)
+/* Convert an unsigned value to text in a buffer of XTOA_BUFFER_SIZE
+ * octets, returning a pointer to the first digit.  The first octet of
+ * the buffer is never used, so the caller may store a sign before the
+ * returned pointer.
+ *
+ * No division is used for radix 10 or a power of two.  Decimal digits
+ * are produced by multiplying by a reciprocal of ten when
+ * #BSP430_CONSOLE_XTOA_RECIPROCAL is true, and otherwise by
+ * subtracting powers of ten, which costs at most nine subtractions per
+ * digit. */
+static char *
+console_ultoa (unsigned long uval,
+               char * buf,
+               unsigned int radix)
 {
-  char buffer[sizeof("4294967295")];
-  return emit_text(ultoa(n, buffer, radix), console_hal_);
+  char * ep = buf + XTOA_BUFFER_SIZE;
+
+  *--ep = 0;
+  if (0 == (radix & (radix - 1))) {
+    unsigned int mask = radix - 1;
+    unsigned int shift = 0;
+
+    while (mask >> shift) {
+      ++shift;
+    }
+    do {
+      unsigned int digit = uval & mask;
+      *--ep = (10 > digit) ? ('0' + digit) : ('A' + digit - 10);
+      uval >>= shift;
+    } while (0 < uval);
+    return ep;
+  }
+  if (10 == radix) {
+#if (BSP430_CONSOLE_XTOA_RECIPROCAL - 0)
+    unsigned int v;
+
+    /* floor(x / 10) == (x * ceil(2^35 / 10)) >> 35 for all 32-bit x,
+     * and likewise with 2^19 for all 16-bit x and 2^67 for all 64-bit
+     * x. */
+#if 0xFFFFFFFFUL < ULONG_MAX
+    while (0xFFFFFFFFUL < uval) {
+      unsigned long q = (unsigned long)((uval * (unsigned __int128)0xCCCCCCCCCCCCCCCDULL) >> 67);
+      *--ep = '0' + (char)(uval - 10 * q);
+      uval = q;
+    }
+#endif /* ULONG_MAX */
+    while (0xFFFF < uval) {
+      unsigned long q = (unsigned long)((uval * 0xCCCCCCCDULL) >> 35);
+      *--ep = '0' + (char)(uval - 10 * q);
+      uval = q;
+    }
+    v = uval;
+    do {
+      unsigned int q = (unsigned int)((v * 0xCCCDUL) >> 19);
+      *--ep = '0' + (char)(v - 10 * q);
+      v = q;
+    } while (0 < v);
+    return ep;
+#else /* BSP430_CONSOLE_XTOA_RECIPROCAL */
+    const unsigned long * pp = pow10_;
+    const unsigned long * const ppe = pow10_ + sizeof(pow10_) / sizeof(*pow10_);
+    char * sp = buf + 1;
+
+    while ((pp < ppe) && (uval < *pp)) {
+      ++pp;
+    }
+    while (pp < ppe) {
+      char digit = '0';
+      while (uval >= *pp) {
+        uval -= *pp;
+        ++digit;
+      }
+      *sp++ = digit;
+      ++pp;
+    }
+    *sp++ = '0' + (char)uval;
+    *sp = 0;
+    return buf + 1;
+#endif /* BSP430_CONSOLE_XTOA_RECIPROCAL */
+  }
+  do {
+    unsigned int digit = uval % radix;
+    uval /= radix;
+    *--ep = (10 > digit) ? ('0' + digit) : ('A' + digit - 10);
+  } while (0 < uval);
+  return ep;
 }
 
-int
-vcprintf (const char * fmt, va_list ap)
+/* As console_ultoa(), with a leading minus sign for negative values
+ * in radix 10.  In other radixes a negative value is shown as its
+ * two's complement in the width of its own type, which the caller
+ * supplies as uval. */
+static char *
+console_ltoa (long sval,
+              unsigned long uval,
+              char * buf,
+              unsigned int radix)
 {
-  /* Fail fast if printing is disabled */
-  if (! console_hal_) {
-    return 0;
+  char * sp;
+
+  if ((10 == radix) && (0 > sval)) {
+    sp = console_ultoa(- (unsigned long)sval, buf, radix);
+    *--sp = '-';
+    return sp;
   }
-  return vuprintf(emit_char, fmt, ap);
+  return console_ultoa(uval, buf, radix);
 }
 
-#elif (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0)
-
-#define XTOA_T(INT_T)                                                   \
-static char *                                                           \
-xtoa_##INT_T (INT_T sval,                                               \
-              char * str,                                               \
-              int radix,                                                \
-              int signedp)                                              \
-{                                                                       \
-  unsigned INT_T uval;                                                  \
-  unsigned int uradix = radix;                                          \
-  char *sp = str;                                                       \
-  char *sp2;                                                            \
-                                                                        \
-  /* If signed, store sign at start of buffer for negative base-10 values */ \
-  if (signedp && (10 == uradix) && (0 > sval)) {                        \
-    *sp++ = '-';                                                        \
-    uval = -sval;                                                       \
-  } else {                                                              \
-    uval = sval;                                                        \
-  }                                                                     \
-  sp2 = sp;                                                             \
-                                                                        \
-  do {                                                                  \
-    unsigned int rem = uval % uradix;                                   \
-    uval /= uradix;                                                     \
-    if (10 > rem) {                                                     \
-      *sp++ = '0' + rem;                                                \
-    } else {                                                            \
-      *sp++ = 'A' + rem - 10;                                           \
-    }                                                                   \
-  } while (0 < uval);                                                   \
-                                                                        \
-  /* Mark end of string */                                              \
-  *sp-- = 0;                                                            \
-                                                                        \
-  /* Reverse string contents (excluding sign) in place */               \
-  while (sp2 < sp) {                                                    \
-    char tmp = *sp2;                                                    \
-    *sp2++ = *sp;                                                       \
-    *sp-- = tmp;                                                        \
-  }                                                                     \
-                                                                        \
-  return str;                                                           \
-}
-
-XTOA_T(int)
-
 int
 cputi (int n, int radix)
 {
-  char buffer[sizeof("-32767")];
-  return emit_text(xtoa_int(n, buffer, radix, 1), console_hal_);
+  char buffer[XTOA_BUFFER_SIZE];
+  return emit_text(console_ltoa(n, (unsigned int)n, buffer, radix), console_hal_);
 }
 
 int
 cputu (unsigned int n, int radix)
 {
-  char buffer[sizeof("65535")];
-  return emit_text(xtoa_int((int)n, buffer, radix, 0), console_hal_);
+  char buffer[XTOA_BUFFER_SIZE];
+  return emit_text(console_ultoa(n, buffer, radix), console_hal_);
 }
 
-XTOA_T(long)
-
 int
 cputl (long n, int radix)
 {
-  char buffer[sizeof("-2147483647")];
-  return emit_text(xtoa_long(n, buffer, radix, 1), console_hal_);
+  char buffer[XTOA_BUFFER_SIZE];
+  return emit_text(console_ltoa(n, n, buffer, radix), console_hal_);
 }
 
 int
 cputul (unsigned long n, int radix)
 {
-  char buffer[sizeof("4294967295")];
-  return emit_text(xtoa_long((long)n, buffer, radix, 0), console_hal_);
+  char buffer[XTOA_BUFFER_SIZE];
+  return emit_text(console_ultoa(n, buffer, radix), console_hal_);
 }
 
-int
-vcprintf (const char * fmt, va_list ap)
+#if HAVE_EMBTEXTF
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+/* Characters produced by vuprintf() are collected here and queued in
+ * blocks rather than one at a time.  A vcprintf() invoked from an
+ * interrupt while the stage is in use bypasses it. */
+static char stage_[16];
+static unsigned char stage_len_;
+static volatile unsigned char stage_busy_;
+
+static int
+emit_char_staged (int c)
 {
-  /* Fail fast if printing is disabled */
-  if (! console_hal_) {
-    return 0;
+  if (sizeof(stage_) == stage_len_) {
+    emit_chars_queued(stage_, stage_len_, console_hal_);
+    stage_len_ = 0;
   }
+  stage_[stage_len_++] = c;
+  return c;
+}
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+
+/* Format through the library, which divides once per digit when
+ * converting long values. */
+static int
+console_vformat_ (const char * fmt, va_list ap)
+{
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+  if ((console_tx_queue == uartTransmit) && (! stage_busy_)) {
+    int rv;
+
+    stage_busy_ = 1;
+    stage_len_ = 0;
+    rv = vuprintf(emit_char_staged, fmt, ap);
+    if (0 < stage_len_) {
+      emit_chars_queued(stage_, stage_len_, console_hal_);
+    }
+    stage_busy_ = 0;
+    return rv;
+  }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  return vuprintf(emit_char, fmt, ap);
+}
+
+#elif ((BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0)  \
+       || (BSP430_CORE_TOOLCHAIN_HOST - 0))
+
+#if (BSP430_CORE_TOOLCHAIN_HOST - 0)
+/* The host C library formats into a stream that writes to the
+ * console UART rather than to the process standard output. */
+static ssize_t
+console_stream_write (void * cookie,
+                      const char * buf,
+                      size_t size)
+{
+  return emit_chars(buf, size, console_hal_);
+}
+
+static FILE *
+console_stream (void)
+{
+  static FILE * stream;
+  if (NULL == stream) {
+    static const cookie_io_functions_t funcs = { .write = console_stream_write };
+    stream = fopencookie(NULL, "w", funcs);
+    setvbuf(stream, NULL, _IONBF, 0);
+  }
+  return stream;
+}
+#endif /* BSP430_CORE_TOOLCHAIN_HOST */
+
+static int
+console_vformat_ (const char * fmt, va_list ap)
+{
+#if (BSP430_CORE_TOOLCHAIN_HOST - 0)
+  return vfprintf(console_stream(), fmt, ap);
+#else /* BSP430_CORE_TOOLCHAIN_HOST */
   /* Delegate to newlib standard output */
   return vprintf(fmt, ap);
+#endif /* BSP430_CORE_TOOLCHAIN_HOST */
 }
 
 #endif /* HAVE_EMBTEXTF */
 
 #if ((BSP430_CONSOLE_USE_EMBTEXTF - 0)                  \
      || (BSP430_CORE_TOOLCHAIN_LIBC_MSP430_LIBC - 0)    \
-     || (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0))
+     || (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0)         \
+     || (BSP430_CORE_TOOLCHAIN_HOST - 0))
+
+/* Classes of argument consumed by a conversion specification */
+#define SPEC_ARG_NONE 0
+#define SPEC_ARG_INT 1
+#define SPEC_ARG_LONG 2
+#define SPEC_ARG_LLONG 3
+#define SPEC_ARG_PTR 4
+#define SPEC_ARG_DOUBLE 5
+#define SPEC_ARG_LDOUBLE 6
+#define SPEC_ARG_INVALID 7
+
+/* The integer class of an argument of the given type, which for the
+ * z, j, and t modifiers depends on the target. */
+#define SPEC_ARG_FOR_(type_) ((sizeof(type_) <= sizeof(int)) ? SPEC_ARG_INT      \
+                              : ((sizeof(type_) <= sizeof(long)) ? SPEC_ARG_LONG \
+                                 : SPEC_ARG_LLONG))
+
+/* Parse the conversion specification that follows a '%'.  Returns the
+ * class of the converted argument, stores the number of '*' fields
+ * (each of which consumes an int) in *starsp, and stores the location
+ * following the specification in *endp.  A conversion that is not
+ * recognized returns SPEC_ARG_INVALID; its argument cannot be located,
+ * and neither can any that follow it. */
+static unsigned char
+spec_parse (const char * fp,
+            const char ** endp,
+            unsigned char * starsp)
+{
+  unsigned char stars = 0;
+  unsigned char rv = SPEC_ARG_INT;
+  char mod = 0;
+
+  while (*fp && (NULL != strchr("-+ #0", *fp))) {
+    ++fp;
+  }
+  do {
+    if ('*' == *fp) {
+      ++stars;
+      ++fp;
+    }
+    while (isdigit((unsigned char)*fp)) {
+      ++fp;
+    }
+  } while (('.' == *fp) && ++fp);
+  if (*fp && (NULL != strchr("hlzjtL", *fp))) {
+    mod = *fp++;
+    if ((('h' == mod) || ('l' == mod)) && (mod == *fp)) {
+      mod = ('l' == mod) ? 'q' : 'h';
+      ++fp;
+    }
+  }
+  switch (mod) {
+    case 'l':
+      rv = SPEC_ARG_LONG;
+      break;
+    case 'q':
+    case 'L':
+      rv = SPEC_ARG_LLONG;
+      break;
+    case 'z':
+      rv = SPEC_ARG_FOR_(size_t);
+      break;
+    case 'j':
+      rv = SPEC_ARG_FOR_(intmax_t);
+      break;
+    case 't':
+      rv = SPEC_ARG_FOR_(ptrdiff_t);
+      break;
+  }
+  switch (*fp) {
+    case 0:
+      *endp = fp;
+      *starsp = 0;
+      return SPEC_ARG_NONE;
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+      break;
+    case 'c':
+      rv = SPEC_ARG_INT;
+      break;
+    case 's':
+    case 'p':
+      rv = SPEC_ARG_PTR;
+      break;
+    case 'a':
+    case 'A':
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+      rv = ('L' == mod) ? SPEC_ARG_LDOUBLE : SPEC_ARG_DOUBLE;
+      break;
+    case '%':
+      rv = SPEC_ARG_NONE;
+      break;
+    default:
+      rv = SPEC_ARG_INVALID;
+      break;
+  }
+  *endp = fp + 1;
+  *starsp = stars;
+  return rv;
+}
+
+/* Emit n copies of c */
+static void
+emit_pad (char c,
+          int n,
+          hBSP430halSERIAL uart)
+{
+  while (0 < n--) {
+    emit_chars(&c, 1, uart);
+  }
+}
+
+/* Convert a long integer argument with console_ultoa().  fp addresses
+ * the text following the '%' of a specification with an l modifier
+ * that spec_parse() classified as SPEC_ARG_LONG.  The flags and field
+ * width are supported.  Returns -1 without consuming an argument if
+ * the specification has a precision or the # flag; those are left to
+ * the library. */
+static int
+console_format_long (const char * fp,
+                     va_list * app,
+                     hBSP430halSERIAL uart)
+{
+  char buffer[XTOA_BUFFER_SIZE];
+  char * sp;
+  char conv;
+  char sign = 0;
+  char pad = ' ';
+  unsigned char left = 0;
+  unsigned char star = 0;
+  int width = 0;
+  int len;
+
+  while (*fp && (NULL != strchr("-+ #0", *fp))) {
+    switch (*fp++) {
+      case '-':
+        left = 1;
+        break;
+      case '0':
+        pad = '0';
+        break;
+      case '+':
+        sign = '+';
+        break;
+      case ' ':
+        if (! sign) {
+          sign = ' ';
+        }
+        break;
+      default:
+        return -1;
+    }
+  }
+  if ('*' == *fp) {
+    star = 1;
+    ++fp;
+  }
+  while (isdigit((unsigned char)*fp)) {
+    width = 10 * width + (*fp++ - '0');
+  }
+  if ('.' == *fp) {
+    return -1;
+  }
+  conv = fp[1];
+  if (star) {
+    width = va_arg(*app, int);
+    if (0 > width) {
+      left = 1;
+      width = -width;
+    }
+  }
+  if (('d' == conv) || ('i' == conv)) {
+    long sval = va_arg(*app, long);
+
+    sp = console_ltoa(sval, sval, buffer, 10);
+    if (sign && (0 <= sval)) {
+      *--sp = sign;
+    }
+  } else {
+    unsigned long uval = va_arg(*app, unsigned long);
+
+    sp = console_ultoa(uval, buffer, ('o' == conv) ? 8 : (('u' == conv) ? 10 : 16));
+    if ('x' == conv) {
+      char * dp;
+      for (dp = sp; *dp; ++dp) {
+        if ('A' <= *dp) {
+          *dp += 'a' - 'A';
+        }
+      }
+    }
+  }
+  len = strlen(sp);
+  if (width <= len) {
+    return emit_chars(sp, len, uart);
+  }
+  if (left) {
+    emit_chars(sp, len, uart);
+    emit_pad(' ', width - len, uart);
+  } else if ('0' == pad) {
+    if (! isxdigit((unsigned char)*sp)) {
+      emit_chars(sp++, 1, uart);
+      --len;
+      emit_pad('0', width - len - 1, uart);
+    } else {
+      emit_pad('0', width - len, uart);
+    }
+    emit_chars(sp, len, uart);
+  } else {
+    emit_pad(' ', width - len, uart);
+    emit_chars(sp, len, uart);
+  }
+  return width;
+}
+
+/* Conversions of long integers are done here without division.
+ * Formats that have none are passed to the library whole; otherwise
+ * each of the remaining conversions is passed to the library
+ * separately, and the arguments it consumes are skipped. */
+int
+vcprintf (const char * fmt, va_list ap)
+{
+  hBSP430halSERIAL uart = console_hal_;
+  const char * fp;
+  va_list args;
+  int rv = 0;
+
+  /* Fail fast if printing is disabled */
+  if (! uart) {
+    return 0;
+  }
+  fp = fmt;
+  while (NULL != (fp = strchr(fp, '%'))) {
+    unsigned char stars;
+    if ((SPEC_ARG_LONG == spec_parse(fp + 1, &fp, &stars)) && ('l' == fp[-2])) {
+      break;
+    }
+  }
+  if (NULL == fp) {
+    return console_vformat_(fmt, ap);
+  }
+  /* A parameter of array type va_list cannot be passed by address */
+  va_copy(args, ap);
+  fp = fmt;
+  while (*fp) {
+    const char * sp = fp;
+    const char * ep;
+    unsigned char stars;
+    unsigned char kind;
+    int n = -1;
+
+    while (*sp && ('%' != *sp)) {
+      ++sp;
+    }
+    if (sp > fp) {
+      rv += emit_chars(fp, sp - fp, uart);
+    }
+    if (! *sp) {
+      break;
+    }
+    kind = spec_parse(sp + 1, &ep, &stars);
+    if ((SPEC_ARG_LONG == kind) && ('l' == ep[-2])) {
+      n = console_format_long(sp + 1, &args, uart);
+    }
+    if (0 > n) {
+      char spec[16];
+      va_list aq;
+
+      if ((SPEC_ARG_LDOUBLE < kind) || (sizeof(spec) <= (size_t)(ep - sp))) {
+        /* The argument cannot be skipped; let the library have the
+         * rest */
+        rv += console_vformat_(sp, args);
+        break;
+      }
+      memcpy(spec, sp, ep - sp);
+      spec[ep - sp] = 0;
+      va_copy(aq, args);
+      n = console_vformat_(spec, aq);
+      va_end(aq);
+      while (0 < stars--) {
+        (void)va_arg(args, int);
+      }
+      switch (kind) {
+        case SPEC_ARG_INT:
+          (void)va_arg(args, int);
+          break;
+        case SPEC_ARG_LONG:
+          (void)va_arg(args, long);
+          break;
+        case SPEC_ARG_LLONG:
+          (void)va_arg(args, long long);
+          break;
+        case SPEC_ARG_PTR:
+          (void)va_arg(args, void *);
+          break;
+        case SPEC_ARG_DOUBLE:
+          (void)va_arg(args, double);
+          break;
+        case SPEC_ARG_LDOUBLE:
+          (void)va_arg(args, long double);
+          break;
+      }
+    }
+    rv += n;
+    fp = ep;
+  }
+  va_end(args);
+  return rv;
+}
 
 int
 #if (__GNUC__ - 0)
@@ -470,6 +1256,218 @@ cprintf (const char *fmt, ...)
   return rv;
 }
 
+#if (0 < BSP430_CONSOLE_LOG_DEFERRED_RECORDS)
+#if 255 < (BSP430_CONSOLE_LOG_DEFERRED_RECORDS)
+#error BSP430_CONSOLE_LOG_DEFERRED_RECORDS exceeds 255
+#endif /* validate BSP430_CONSOLE_LOG_DEFERRED_RECORDS */
+
+/* Number of record words occupied by a value of the given type */
+#define LOG_WORDS_(type_) ((sizeof(type_) + sizeof(unsigned int) - 1) / sizeof(unsigned int))
+
+typedef struct sConsoleLogRecord {
+  const char * format;
+  unsigned char nwords;
+  unsigned int words[BSP430_CONSOLE_LOG_DEFERRED_WORDS];
+} sConsoleLogRecord;
+
+static struct {
+  sConsoleLogRecord records[BSP430_CONSOLE_LOG_DEFERRED_RECORDS];
+  volatile unsigned char head;
+  volatile unsigned char tail;
+  volatile unsigned int dropped;
+} log_;
+
+#define LOG_WRAP_(i_) CONSOLE_BUFFER_WRAP_(BSP430_CONSOLE_LOG_DEFERRED_RECORDS, i_)
+
+void
+vBSP430consoleLogDeferred_ni (const char * fmt, ...)
+{
+  sConsoleLogRecord * rp;
+  unsigned int * wp;
+  unsigned int * wpe;
+  unsigned char head = log_.head;
+  unsigned char next = LOG_WRAP_(head + 1);
+  va_list argp;
+
+  if (next == log_.tail) {
+    ++log_.dropped;
+    return;
+  }
+  rp = log_.records + head;
+  rp->format = fmt;
+  wp = rp->words;
+  wpe = wp + sizeof(rp->words) / sizeof(*rp->words);
+  va_start(argp, fmt);
+  while (*fmt) {
+    unsigned char stars;
+    unsigned char kind;
+
+    if ('%' != *fmt++) {
+      continue;
+    }
+    kind = spec_parse(fmt, &fmt, &stars);
+    if (SPEC_ARG_PTR < kind) {
+      /* Floating point and unrecognized conversions are not
+       * supported, and nothing after them can be captured. */
+      wp = wpe;
+      break;
+    }
+    while (stars--) {
+      int v = va_arg(argp, int);
+      if (wp + LOG_WORDS_(v) <= wpe) {
+        memcpy(wp, &v, sizeof(v));
+        wp += LOG_WORDS_(v);
+      } else {
+        wp = wpe;
+      }
+    }
+#define LOG_CAPTURE_(type_) do {                        \
+      type_ v = va_arg(argp, type_);                    \
+      if (wp + LOG_WORDS_(v) <= wpe) {                  \
+        memcpy(wp, &v, sizeof(v));                      \
+        wp += LOG_WORDS_(v);                            \
+      } else {                                          \
+        wp = wpe;                                       \
+      }                                                 \
+    } while (0)
+    switch (kind) {
+      case SPEC_ARG_INT:
+        LOG_CAPTURE_(int);
+        break;
+      case SPEC_ARG_LONG:
+        LOG_CAPTURE_(long);
+        break;
+      case SPEC_ARG_LLONG:
+        LOG_CAPTURE_(long long);
+        break;
+      case SPEC_ARG_PTR:
+        LOG_CAPTURE_(const void *);
+        break;
+    }
+#undef LOG_CAPTURE_
+  }
+  va_end(argp);
+  rp->nwords = wp - rp->words;
+  log_.head = next;
+}
+
+/* Emit one deferred record, formatting each conversion separately
+ * from the argument words captured for it. */
+static void
+log_emit (const sConsoleLogRecord * rp)
+{
+  const char * fp = rp->format;
+  const unsigned int * wp = rp->words;
+  const unsigned int * const wpe = wp + rp->nwords;
+  char spec[16];
+
+  while (*fp) {
+    const char * sp = fp;
+    unsigned char stars;
+    unsigned char kind;
+    int st[2];
+    size_t len;
+    unsigned char i;
+
+    while (*sp && ('%' != *sp)) {
+      ++sp;
+    }
+    if (sp > fp) {
+      cputchars(fp, sp - fp);
+    }
+    if (! *sp) {
+      break;
+    }
+    kind = spec_parse(sp + 1, &fp, &stars);
+    len = fp - sp;
+    if (SPEC_ARG_NONE == kind) {
+      cputchars(fp - 1, 1);
+      continue;
+    }
+    if ((SPEC_ARG_PTR < kind) || (2 < stars) || (sizeof(spec) <= len)) {
+      /* Too complex to replay; the arguments that follow cannot be
+       * located either. */
+      cputchars("?", 1);
+      wp = wpe;
+      continue;
+    }
+    memcpy(spec, sp, len);
+    spec[len] = 0;
+    for (i = 0; i < stars; ++i) {
+      if (wp + LOG_WORDS_(int) > wpe) {
+        break;
+      }
+      memcpy(st + i, wp, sizeof(*st));
+      wp += LOG_WORDS_(int);
+    }
+#define LOG_EMIT_(type_) do {                                   \
+      type_ v;                                                  \
+      if ((i < stars) || (wp + LOG_WORDS_(v) > wpe)) {          \
+        cputchars("?", 1);                                      \
+        wp = wpe;                                               \
+        break;                                                  \
+      }                                                         \
+      memcpy(&v, wp, sizeof(v));                                \
+      wp += LOG_WORDS_(v);                                      \
+      if (0 == stars) {                                         \
+        cprintf(spec, v);                                       \
+      } else if (1 == stars) {                                  \
+        cprintf(spec, st[0], v);                                \
+      } else {                                                  \
+        cprintf(spec, st[0], st[1], v);                         \
+      }                                                         \
+    } while (0)
+    switch (kind) {
+      case SPEC_ARG_INT:
+        LOG_EMIT_(int);
+        break;
+      case SPEC_ARG_LONG:
+        LOG_EMIT_(long);
+        break;
+      case SPEC_ARG_LLONG:
+        LOG_EMIT_(long long);
+        break;
+      case SPEC_ARG_PTR:
+        LOG_EMIT_(const void *);
+        break;
+    }
+#undef LOG_EMIT_
+  }
+}
+
+int
+iBSP430consoleLogDrain (void)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  sConsoleLogRecord record;
+  unsigned int dropped;
+  int rv = 0;
+
+  while (1) {
+    unsigned char tail;
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    tail = log_.tail;
+    if (tail == log_.head) {
+      dropped = log_.dropped;
+      log_.dropped = 0;
+      BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+      break;
+    }
+    record = log_.records[tail];
+    log_.tail = LOG_WRAP_(tail + 1);
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    log_emit(&record);
+    ++rv;
+  }
+  if (0 < dropped) {
+    cprintf("[%u deferred log records dropped]\n", dropped);
+  }
+  return rv;
+}
+
+#endif /* BSP430_CONSOLE_LOG_DEFERRED_RECORDS */
+
 #endif /* cprintf */
 
 hBSP430halSERIAL
@@ -489,9 +1487,9 @@ console_getchar_ (int do_pop)
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
     if (rx_buffer_.head != rx_buffer_.tail) {
-      rv = rx_buffer_.buffer[rx_buffer_.tail];
+      rv = (unsigned char)rx_buffer_.buffer[rx_buffer_.tail];
       if (do_pop) {
-        rx_buffer_.tail = (rx_buffer_.tail + 1) & ((sizeof(rx_buffer_.buffer) / sizeof(*rx_buffer_.buffer)) - 1);
+        rx_buffer_.tail = RX_BUFFER_WRAP_(rx_buffer_.tail + 1);
       }
     }
   } while (0);
@@ -533,11 +1531,15 @@ iBSP430consoleTransmitUseInterrupts_ni (int enablep)
     if (uartTransmit != console_tx_queue) {
       uartTransmit = console_tx_queue;
       vBSP430serialFlush_ni(console_hal_);
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+      console_tx_dma_configure_ni(console_hal_);
+#else /* configBSP430_CONSOLE_TX_DMA */
       iBSP430serialSetHold_rh(console_hal_, 1);
       BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, console_hal_->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
       iBSP430serialSetHold_rh(console_hal_, 0);
+#endif /* configBSP430_CONSOLE_TX_DMA */
       if (tx_buffer_.head != tx_buffer_.tail) {
-        vBSP430serialWakeupTransmit_rh(console_hal_);
+        CONSOLE_TX_KICK_NI(console_hal_, &tx_buffer_);
       }
     }
   } else {
@@ -545,10 +1547,15 @@ iBSP430consoleTransmitUseInterrupts_ni (int enablep)
       uartTransmit = iBSP430uartTxByte_rh;
       /* This flushes any character currently in the UART; it does not
        * flush anything left in the transmission buffer. */
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+      console_tx_dma_stop_ni(&tx_buffer_);
+      vBSP430serialFlush_ni(console_hal_);
+#else /* configBSP430_CONSOLE_TX_DMA */
       vBSP430serialFlush_ni(console_hal_);
       iBSP430serialSetHold_rh(console_hal_, 1);
       BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, console_hal_->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
       iBSP430serialSetHold_rh(console_hal_, 0);
+#endif /* configBSP430_CONSOLE_TX_DMA */
     }
   }
   return 0;
@@ -587,7 +1594,11 @@ iBSP430consoleInitialize (void)
     uartTransmit = console_tx_queue;
     tx_buffer_.wake_available = 0;
     tx_buffer_.head = tx_buffer_.tail = 0;
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+    console_tx_dma_configure_ni(hal);
+#else /* configBSP430_CONSOLE_TX_DMA */
     BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, hal->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
+#endif /* configBSP430_CONSOLE_TX_DMA */
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 
     /* Attempt to configure and install the console */
@@ -634,7 +1645,11 @@ iBSP430consoleDeconfigure (void)
     BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, console_hal_->rx_cbchain_ni, rx_buffer_.cb_node, next_ni);
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 #if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+    console_tx_dma_stop_ni(&tx_buffer_);
+#else /* configBSP430_CONSOLE_TX_DMA */
     BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, console_hal_->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
+#endif /* configBSP430_CONSOLE_TX_DMA */
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 #if (BSP430_SERIAL_ENABLE_RESOURCE - 0)
     (void)iBSP430resourceRelease_ni(&console_hal_->resource, &console_hal_);
@@ -655,8 +1670,8 @@ iBSP430consoleWaitForTxSpace_ni (int want_available)
   }
   while (1) {
     int available;
-    unsigned char head = tx_buffer_.head;
-    unsigned char tail = tx_buffer_.tail;
+    tConsoleTxIndex head = tx_buffer_.head;
+    tConsoleTxIndex tail = tx_buffer_.tail;
 
     if (0 > want_available) {
       if (head == tail) {
@@ -700,17 +1715,32 @@ iBSP430consoleFlush (void)
   return rv;
 }
 
+static const char hex_digits_[] = "0123456789abcdef";
+
 void
 vBSP430consoleDisplayOctets (const uint8_t * dp,
                              size_t len)
 {
+  hBSP430halSERIAL uart = console_hal_;
   const uint8_t * const edp = dp + len;
+  char buffer[3 * 16];
+  char * bp = buffer;
+
+  if (! uart) {
+    return;
+  }
   while (dp < edp) {
-    cprintf("%02x", *dp++);
-    if (dp < edp) {
-      cputchar(' ');
+    *bp++ = hex_digits_[*dp >> 4];
+    *bp++ = hex_digits_[*dp & 0x0F];
+    if (++dp < edp) {
+      *bp++ = ' ';
+    }
+    if ((buffer + sizeof(buffer)) < (bp + 3)) {
+      emit_chars(buffer, bp - buffer, uart);
+      bp = buffer;
     }
   }
+  emit_chars(buffer, bp - buffer, uart);
 }
 
 void
@@ -718,41 +1748,77 @@ vBSP430consoleDisplayMemory (const uint8_t * dp,
                              size_t len,
                              unsigned long base)
 {
+  hBSP430halSERIAL uart = console_hal_;
   const uint8_t * const edp = dp + len;
   const uint8_t * adp = dp;
+  /* One display line: newline, address, 16 octets with a separator
+   * after the eighth, the printable characters, and a final
+   * newline. */
+  char line[sizeof("\n ") + 2 * sizeof(unsigned long) + 16 * 3 + 1 + sizeof("  ") + 16 + 1];
+  char * lp = line;
 
+  if (! uart) {
+    return;
+  }
   while (dp < edp) {
     if (0 == (base & 0x0F)) {
       if (adp < dp) {
-        cputtext("  ");
+        *lp++ = ' ';
+        *lp++ = ' ';
         while (adp < dp) {
-          cputchar(isprint(*adp) ? *adp : '.');
+          *lp++ = isprint(*adp) ? *adp : '.';
           ++adp;
         }
       }
       adp = dp;
-      cprintf("\n%08lx ", base);
+      emit_chars(line, lp - line, uart);
+      lp = line;
+      *lp++ = '\n';
+      {
+        /* At least eight digits, more if the address needs them */
+        unsigned long addr = base;
+        unsigned int nd = 8;
+        char * ap;
+
+        while ((nd < (2 * sizeof(addr))) && (addr >> (4 * nd))) {
+          ++nd;
+        }
+        lp += nd;
+        ap = lp;
+        do {
+          *--ap = hex_digits_[addr & 0x0F];
+          addr >>= 4;
+        } while (ap > line + 1);
+      }
+      *lp++ = ' ';
     } else if (0 == (base & 0x07)) {
-      cputchar(' ');
+      *lp++ = ' ';
     }
-    cprintf(" %02x", *dp++);
+    *lp++ = ' ';
+    *lp++ = hex_digits_[*dp >> 4];
+    *lp++ = hex_digits_[*dp & 0x0F];
+    ++dp;
     ++base;
   }
   if (adp < dp) {
     while (base & 0x0F) {
       if (0 == (base & 0x07)) {
-        cputchar(' ');
+        *lp++ = ' ';
       }
-      cprintf("   ");
+      *lp++ = ' ';
+      *lp++ = ' ';
+      *lp++ = ' ';
       ++base;
     }
-    cputtext("  ");
+    *lp++ = ' ';
+    *lp++ = ' ';
     while (adp < dp) {
-      cputchar(isprint(*adp) ? *adp : '.');
+      *lp++ = isprint(*adp) ? *adp : '.';
       ++adp;
     }
   }
-  cputchar('\n');
+  *lp++ = '\n';
+  emit_chars(line, lp - line, uart);
 }
 
 #if (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0)
@@ -817,6 +1883,9 @@ write (int fd,
 #endif
 }
 #endif /* configBSP430_CONSOLE_PROVIDES_STDIO */
+#elif (BSP430_CORE_TOOLCHAIN_HOST - 0)
+/* The host C library's putchar() is left alone: it writes to standard
+ * output, where console output also appears. */
 #else /* BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB */
 #if (configBSP430_CONSOLE_PROVIDES_PUTCHAR - 0)
 int putchar (c)
@@ -0,0 +1,168 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/idle.h>
+#include <bsp430/utility/event.h>
+
+/* Number of active constraints for each mode shallower than LPM4 */
+static unsigned int constraints_ni[eBSP430idleMode_LPM4];
+static hBSP430timerMuxSharedAlarm mux_shared_ni;
+
+unsigned int
+uiBSP430idleModeLPMBits (eBSP430idleMode mode)
+{
+  switch (mode) {
+    case eBSP430idleMode_LPM0:
+      return LPM0_bits;
+    case eBSP430idleMode_LPM1:
+      return LPM1_bits;
+    case eBSP430idleMode_LPM2:
+      return LPM2_bits;
+    case eBSP430idleMode_LPM3:
+      return LPM3_bits;
+    case eBSP430idleMode_LPM4:
+      return LPM4_bits;
+    default:
+    case eBSP430idleMode_ACTIVE:
+      break;
+  }
+  return 0;
+}
+
+void
+vBSP430idleConstraintAdd_ni (eBSP430idleMode mode)
+{
+  if (mode < eBSP430idleMode_LPM4) {
+    ++constraints_ni[mode];
+  }
+}
+
+void
+vBSP430idleConstraintRemove_ni (eBSP430idleMode mode)
+{
+  if ((mode < eBSP430idleMode_LPM4) && (0 < constraints_ni[mode])) {
+    --constraints_ni[mode];
+  }
+}
+
+void
+vBSP430idleSetMuxAlarm_ni (hBSP430timerMuxSharedAlarm shared)
+{
+  mux_shared_ni = shared;
+}
+
+/* The deepest mode in which a timer continues to count.  An external
+ * TACLK runs regardless of the MCU clocks.  INCLK is treated as ACLK
+ * since on many MCUs that is what it is. */
+static eBSP430idleMode
+timerMode_ (hBSP430halTIMER timer)
+{
+  switch (timer->hpl->ctl & TASSEL_3) {
+    case TASSEL_0:
+      return eBSP430idleMode_LPM4;
+    case TASSEL_2:
+      return eBSP430idleMode_LPM0;
+    default:
+    case TASSEL_1:
+    case TASSEL_3:
+      break;
+  }
+  return eBSP430idleMode_LPM3;
+}
+
+eBSP430idleMode
+xBSP430idleDeepestMode_ni (hBSP430halTIMER timer)
+{
+  eBSP430idleMode mode = eBSP430idleMode_LPM4;
+  eBSP430idleMode limit;
+  int i;
+
+  if (! iBSP430eventFlagsEmpty_ni()) {
+    return eBSP430idleMode_ACTIVE;
+  }
+  for (i = eBSP430idleMode_ACTIVE; i < mode; ++i) {
+    if (constraints_ni[i]) {
+      mode = (eBSP430idleMode)i;
+      break;
+    }
+  }
+  if (timer) {
+    limit = timerMode_(timer);
+    if (limit < mode) {
+      mode = limit;
+    }
+  }
+  if (mux_shared_ni && mux_shared_ni->alarms) {
+    limit = timerMode_(mux_shared_ni->dedicated.timer);
+    if (limit < mode) {
+      mode = limit;
+    }
+  }
+  return mode;
+}
+
+unsigned int
+uiBSP430idleSleep_ni (void)
+{
+  unsigned int lpm_bits = uiBSP430idleModeLPMBits(xBSP430idleDeepestMode_ni(NULL));
+
+  if (lpm_bits) {
+    BSP430_CORE_LPM_ENTER_NI(lpm_bits);
+    BSP430_CORE_DISABLE_INTERRUPT();
+  }
+  return lpm_bits;
+}
+
+#if (configBSP430_UPTIME_DELAY - 0)
+
+unsigned int
+uiBSP430idleSleepUntil_ni (unsigned long wake_utt)
+{
+  unsigned int lpm_bits = uiBSP430idleModeLPMBits(xBSP430idleDeepestMode_ni(hBSP430uptimeTimer()));
+
+  if (lpm_bits) {
+    /* An alarm this close cannot be set */
+    if ((long)BSP430_TIMER_ALARM_FUTURE_LIMIT > (long)(wake_utt - ulBSP430uptime_ni())) {
+      return 0;
+    }
+    /* lBSP430uptimeSleepUntil() returns zero without sleeping when
+     * the alarm cannot be set.  After a sleep a zero result means the
+     * wakeup time was reached, which is otherwise still ahead. */
+    if ((0 == lBSP430uptimeSleepUntil(wake_utt, lpm_bits))
+        && (0 < (long)(wake_utt - ulBSP430uptime_ni()))) {
+      return 0;
+    }
+  }
+  return lpm_bits;
+}
+
+#endif /* configBSP430_UPTIME_DELAY */
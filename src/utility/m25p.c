@@ -36,6 +36,91 @@
 
 #include <bsp430/utility/console.h>
 
+/* Exchange data with the device.  Unless hold is set the exchange
+ * is a complete command, framed by asserting and de-asserting CS#;
+ * otherwise CS# is left asserted if the exchange succeeds, so the
+ * command can be completed by a subsequent call. */
+static int
+m25p_txrx_rh (hBSP430m25p dev,
+              const uint8_t * tx_data,
+              size_t tx_len,
+              size_t rx_len,
+              uint8_t * rx_data,
+              int hold)
+{
+  int rc;
+
+#if (configBSP430_SERIAL_SPI_BUS - 0)
+  if (NULL != dev->bus) {
+    BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+    sBSP430spiTransaction txn;
+
+    memset(&txn, 0, sizeof(txn));
+    txn.csn_port = dev->csn_port;
+    txn.csn_bit = dev->csn_bit;
+    txn.ctl0_byte = dev->ctl0_byte;
+    txn.ctl1_byte = dev->ctl1_byte;
+    txn.prescaler = dev->prescaler;
+    txn.tx_data = tx_data;
+    txn.tx_len = tx_len;
+    txn.rx_len = rx_len;
+    txn.rx_data = rx_data;
+    txn.flags = hold ? BSP430_SPI_TXN_FLAG_HOLD_CS : 0;
+    /* Interrupts stay disabled from the submission to the test of the
+     * result, so the completion cannot slip in ahead of the sleep. */
+    BSP430_CORE_DISABLE_INTERRUPT();
+    rc = iBSP430spiBusSubmit_ni(dev->bus, &txn);
+    if (0 == rc) {
+      while (0 == txn.result) {
+        BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
+        BSP430_CORE_DISABLE_INTERRUPT();
+      }
+      rc = txn.result;
+    } else {
+      rc = -1;
+    }
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    return rc;
+  }
+#endif /* configBSP430_SERIAL_SPI_BUS */
+  BSP430_M25P_CS_ASSERT(dev);
+  rc = iBSP430spiTxRx_rh(dev->spi, tx_data, tx_len, rx_len, rx_data);
+  if ((! hold) || (0 > rc)) {
+    BSP430_M25P_CS_DEASSERT(dev);
+  }
+  return rc;
+}
+
+/* Transmit a command and its address, leaving CS# asserted if hold */
+static int
+m25p_address_command_rh (hBSP430m25p dev,
+                         uint8_t cmd,
+                         unsigned long addr,
+                         int hold)
+{
+  uint8_t cmdb[5];              /* 1 cmd, 3 addr, optional 1 dummy */
+  uint8_t * cbp;
+  size_t len;
+
+  cbp = cmdb;
+  *cbp++ = cmd;
+  *cbp++ = 0xFF & (addr >> 16);
+  *cbp++ = 0xFF & (addr >> 8);
+  *cbp++ = 0xFF & addr;
+  if (BSP430_M25P_CMD_FAST_READ == cmd) {
+    /* This command requires a dummy byte */
+    *cbp++ = 0;
+  }
+  len = cbp - cmdb;
+  if (len == m25p_txrx_rh(dev, cmdb, len, 0, NULL, hold)) {
+    return 0;
+  }
+  if (hold) {
+    BSP430_M25P_CS_DEASSERT(dev);
+  }
+  return -1;
+}
+
 hBSP430m25p
 hBSP430m25pInitialize (hBSP430m25p dev,
                        unsigned char ctl0_byte,
@@ -44,11 +129,24 @@ hBSP430m25pInitialize (hBSP430m25p dev,
 {
   BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
 
-  if ((NULL == dev) || (NULL == dev->spi) || (NULL == dev->csn_port)) {
+  if ((NULL == dev) || (NULL == dev->csn_port)) {
     return NULL;
   }
-  if (NULL == hBSP430serialOpenSPI(dev->spi, ctl0_byte, ctl1_byte, prescaler)) {
-    return NULL;
+#if (configBSP430_SERIAL_SPI_BUS - 0)
+  if (NULL != dev->bus) {
+    /* The bus opens the peripheral for each transaction */
+    dev->ctl0_byte = ctl0_byte;
+    dev->ctl1_byte = ctl1_byte;
+    dev->prescaler = prescaler;
+  } else
+#endif /* configBSP430_SERIAL_SPI_BUS */
+  {
+    if (NULL == dev->spi) {
+      return NULL;
+    }
+    if (NULL == hBSP430serialOpenSPI(dev->spi, ctl0_byte, ctl1_byte, prescaler)) {
+      return NULL;
+    }
   }
   /* Set the signal before making the port an output */
   BSP430_CORE_DISABLE_INTERRUPT();
@@ -71,9 +169,7 @@ iBSP430m25pStatus_rh (hBSP430m25p dev)
   uint8_t res[2];
   int rc;
 
-  BSP430_M25P_CS_ASSERT(dev);
-  rc = iBSP430spiTxRx_rh(dev->spi, &cmd, sizeof(cmd), sizeof(res[1]), res);
-  BSP430_M25P_CS_DEASSERT(dev);
+  rc = m25p_txrx_rh(dev, &cmd, sizeof(cmd), sizeof(res[1]), res, 0);
   if (sizeof(cmd) + sizeof(res[1]) == rc) {
     return res[1];
   }
@@ -84,15 +180,13 @@ int
 iBSP430m25pStrobeCommand_rh (hBSP430m25p dev,
                              uint8_t cmd)
 {
-  int rc = -1;
+  int rc;
 
-  BSP430_M25P_CS_ASSERT(dev);
-  rc = iBSP430spiTxRx_rh(dev->spi, &cmd, sizeof(cmd), 0, NULL);
+  rc = m25p_txrx_rh(dev, &cmd, sizeof(cmd), 0, NULL, 0);
   if (sizeof(cmd) == rc) {
-    rc = 0;
+    return 0;
   }
-  BSP430_M25P_CS_DEASSERT(dev);
-  return rc;
+  return -1;
 }
 
 int
@@ -100,21 +194,14 @@ iBSP430m25pStrobeAddressCommand_rh (hBSP430m25p dev,
                                     uint8_t cmd,
                                     unsigned long addr)
 {
-  int rv = iBSP430m25pInitiateAddressCommand_rh(dev, cmd, addr);
-  /* Safe enough to deassert regardless of success/failure */
-  BSP430_M25P_CS_DEASSERT(dev);
-  return rv;
+  return m25p_address_command_rh(dev, cmd, addr, 0);
 }
 
 int
 iBSP430m25pInitiateCommand_rh (hBSP430m25p dev,
                                uint8_t cmd)
 {
-  int rc;
-
-  BSP430_M25P_CS_ASSERT(dev);
-  rc = iBSP430spiTxRx_rh(dev->spi, &cmd, sizeof(cmd), 0, NULL);
-  if (sizeof(cmd) == rc) {
+  if (sizeof(cmd) == m25p_txrx_rh(dev, &cmd, sizeof(cmd), 0, NULL, 1)) {
     return 0;
   }
   BSP430_M25P_CS_DEASSERT(dev);
@@ -126,28 +213,7 @@ iBSP430m25pInitiateAddressCommand_rh (hBSP430m25p dev,
                                       uint8_t cmd,
                                       unsigned long addr)
 {
-  uint8_t cmdb[5];              /* 1 cmd, 3 addr, optional 1 dummy */
-  uint8_t * cbp;
-  size_t len;
-  int rc;
-
-  cbp = cmdb;
-  *cbp++ = cmd;
-  *cbp++ = 0xFF & (addr >> 16);
-  *cbp++ = 0xFF & (addr >> 8);
-  *cbp++ = 0xFF & addr;
-  if (BSP430_M25P_CMD_FAST_READ == cmd) {
-    /* This command requires a dummy byte */
-    *cbp++ = 0;
-  }
-  len = cbp - cmdb;
-  BSP430_M25P_CS_ASSERT(dev);
-  rc = iBSP430spiTxRx_rh(dev->spi, cmdb, len, 0, NULL);
-  if (len == rc) {
-    return 0;
-  }
-  BSP430_M25P_CS_DEASSERT(dev);
-  return -1;
+  return m25p_address_command_rh(dev, cmd, addr, 1);
 }
 
 int
@@ -157,9 +223,22 @@ iBSP430m25pCompleteTxRx_rh (hBSP430m25p dev,
                             size_t rx_len,
                             uint8_t * rx_data)
 {
-  int rv;
-  rv = iBSP430spiTxRx_rh(dev->spi, tx_data, tx_len, rx_len, rx_data);
-  BSP430_M25P_CS_DEASSERT(dev);
-  return rv;
+#if (configBSP430_SERIAL_SPI_BUS - 0)
+  if (NULL != dev->bus) {
+    if (0 == (tx_len + rx_len)) {
+      /* The bus releases the chip select only by completing a
+       * transaction.  A dummy octet is harmless after any command:
+       * reads ignore it and programming 0xFF leaves flash
+       * unchanged. */
+      return (1 == m25p_txrx_rh(dev, NULL, 0, 1, NULL, 0)) ? 0 : -1;
+    }
+    return m25p_txrx_rh(dev, tx_data, tx_len, rx_len, rx_data, 0);
+  }
+#endif /* configBSP430_SERIAL_SPI_BUS */
+  {
+    int rv;
+    rv = iBSP430spiTxRx_rh(dev->spi, tx_data, tx_len, rx_len, rx_data);
+    BSP430_M25P_CS_DEASSERT(dev);
+    return rv;
+  }
 }
-
@@ -0,0 +1,186 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/pps.h>
+#include <limits.h>
+
+#if ! (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+#error utility/pps requires configBSP430_UPTIME_EPOCH_DISCIPLINE
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
+
+/* Most recent capture, if captured_ni is set */
+static unsigned long capture_utt_ni;
+static char captured_ni;
+/* Most recent association */
+static sBSP430ppsState state_ni;
+/* When an offset was last passed to the epoch discipline, if fed is
+ * set.  Used only by iBSP430ppsAssociateTime(). */
+static unsigned long fed_utt;
+static char fed;
+
+/* Convert an offset to microseconds without overflowing an
+ * intermediate product, saturating at the range of long. */
+static long
+offset_as_us (int64_t offset_ntp)
+{
+  int64_t us = (offset_ntp >> 32) * 1000000L;
+
+  us += (int64_t)((1000000ULL * (uint32_t)offset_ntp) >> 32);
+  if (LONG_MAX < us) {
+    return LONG_MAX;
+  }
+  if (LONG_MIN > us) {
+    return LONG_MIN;
+  }
+  return us;
+}
+
+int
+iBSP430ppsCapture_ni (unsigned long pps_utt)
+{
+  capture_utt_ni = pps_utt;
+  captured_ni = 1;
+  return 0;
+}
+
+int
+iBSP430ppsAssociateTime (time_t utc,
+                         unsigned int msec,
+                         unsigned long rx_utt)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  unsigned long utt_per_s = ulBSP430uptimeConversionFrequency_Hz();
+  unsigned long pps_utt;
+  int have_capture;
+  int is_repeat;
+  uint64_t pulse_ntp;
+  uint64_t local_ntp;
+  int64_t offset_ntp;
+  int rv;
+
+  if ((1000 - BSP430_PPS_ALIGN_MS) < msec) {
+    utc += 1;
+  } else if (BSP430_PPS_ALIGN_MS < msec) {
+    return -1;
+  }
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    pps_utt = capture_utt_ni;
+    have_capture = captured_ni;
+    /* Several messages may describe the same pulse */
+    is_repeat = (0 != state_ni.pulses) && (pps_utt == state_ni.pps_utt);
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  if ((! have_capture) || (utt_per_s <= (uint32_t)(rx_utt - pps_utt))) {
+    return -1;
+  }
+  if (is_repeat) {
+    return 0;
+  }
+
+  if (0 != iBSP430uptimeCheckEpochValidity()) {
+    struct timeval tv;
+
+    tv.tv_sec = utc;
+    tv.tv_usec = 0;
+    rv = iBSP430uptimeSetEpochFromTimeval(&tv, pps_utt);
+    if (0 != rv) {
+      return rv;
+    }
+    offset_ntp = 0;
+    fed = 1;
+    fed_utt = pps_utt;
+    rv = 1;
+  } else {
+    rv = iBSP430uptimeAsNTP(pps_utt, &local_ntp, 0);
+    if (0 != rv) {
+      return rv;
+    }
+    pulse_ntp = (uint64_t)(BSP430_UPTIME_POSIX_EPOCH_NTPIS + (uint32_t)utc) << 32;
+    offset_ntp = pulse_ntp - local_ntp;
+    /* Pulses are associated every second but fed to the discipline
+     * only as often as it can use them. */
+    if ((! fed)
+        || ((BSP430_PPS_UPDATE_INTERVAL_S * utt_per_s) <= (uint32_t)(pps_utt - fed_utt))) {
+      rv = iBSP430uptimeDisciplineEpochFromNTP(offset_ntp);
+      if (0 > rv) {
+        return rv;
+      }
+      if ((1 == rv)
+          && (0 == iBSP430uptimeAsNTP(pps_utt, &local_ntp, 0))) {
+        /* Record what remains after the epoch was stepped */
+        offset_ntp = pulse_ntp - local_ntp;
+      }
+      fed = 1;
+      fed_utt = pps_utt;
+    }
+  }
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    state_ni.pps_utt = pps_utt;
+    state_ni.pps_utc = utc;
+    state_ni.offset_us = offset_as_us(offset_ntp);
+    ++state_ni.pulses;
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+void
+vBSP430ppsReset (void)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    captured_ni = 0;
+    fed = 0;
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
+int
+iBSP430ppsGetState (sBSP430ppsState * sp)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  int rv = -1;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    if (sp && (0 != state_ni.pulses)) {
+      *sp = state_ni;
+      rv = 0;
+    }
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
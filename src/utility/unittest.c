@@ -104,6 +104,11 @@ vBSP430unittestFinalize (void)
   while (0 <= --ctr) {
     cputs("# ...done");
   }
+#if (BSP430_PLATFORM_HOST - 0)
+  /* A native executable reports the result through its exit status */
+  (void)iBSP430consoleFlush();
+  exit((0 < num_failed) ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif /* BSP430_PLATFORM_HOST */
   if (0 < num_failed) {
     BSP430_CORE_DISABLE_INTERRUPT();
     vBSP430ledSet(BSP430_UNITTEST_LED_PASSED, 0);
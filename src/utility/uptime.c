@@ -41,6 +41,80 @@
 hBSP430halTIMER xBSP430uptimeTIMER_;
 unsigned long ulBSP430uptimeConversionFrequency_Hz_ni_;
 
+/* Parameters to compute floor(a * num / den) by multiplication, where
+ * mult is floor(2^32 * num / den) and den is less than 2^31.  See
+ * convert_(). */
+typedef struct sConversion {
+  uint32_t num;
+  uint32_t den;
+  uint64_t mult;
+} sConversion;
+
+/* Conversions to and from uptime ticks.  These are recomputed by
+ * conversionsUpdate_ni_() whenever the conversion frequency
+ * changes. */
+static sConversion utt_to_s_ni;
+static sConversion utt_to_ms_ni;
+static sConversion utt_to_us_ni;
+static sConversion ms_to_utt_ni;
+static sConversion us_to_utt_ni;
+
+/* Conversions for breaking seconds into minutes and hours */
+static const sConversion div60 = { 1, 60, 0x100000000ULL / 60 };
+static const sConversion div3600 = { 1, 3600, 0x100000000ULL / 3600 };
+
+static void
+conversionInitialize_ (sConversion * cp,
+                       uint32_t num,
+                       uint32_t den)
+{
+  cp->num = num;
+  cp->den = den;
+  cp->mult = ((uint64_t)num << 32) / den;
+}
+
+/* Return floor(a * cp->num / cp->den).  The product of a with the
+ * 64-bit multiplier is formed from two 32x32 multiplications, keeping
+ * the upper 64 bits of the 96-bit result.  Because the multiplier is
+ * rounded down by less than one unit in 2^32 the estimate is at most
+ * one too small.  The remainder a * num - q * den is then less than
+ * 2 * den, which fits in 32 bits, so it can be formed from the low
+ * words of the products alone; the estimate is low exactly when the
+ * remainder is at least den. */
+static uint64_t
+convert_ (const sConversion * cp,
+          uint32_t a)
+{
+  uint64_t q;
+
+  q = (uint64_t)a * (uint32_t)(cp->mult >> 32);
+  q += ((uint64_t)a * (uint32_t)cp->mult) >> 32;
+  if ((uint32_t)(a * cp->num - (uint32_t)q * cp->den) >= cp->den) {
+    ++q;
+  }
+  return q;
+}
+
+#if (configBSP430_UPTIME_EPOCH - 0) && (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+/* Recompute the discipline frequency correction, which depends on the
+ * conversion frequency */
+static void discipline_drift_update_ni (void);
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
+
+static void
+conversionsUpdate_ni_ (unsigned long frequency_Hz)
+{
+  ulBSP430uptimeConversionFrequency_Hz_ni_ = frequency_Hz;
+  conversionInitialize_(&utt_to_s_ni, 1, frequency_Hz);
+  conversionInitialize_(&utt_to_ms_ni, 1000UL, frequency_Hz);
+  conversionInitialize_(&utt_to_us_ni, 1000000UL, frequency_Hz);
+  conversionInitialize_(&ms_to_utt_ni, frequency_Hz, 1000UL);
+  conversionInitialize_(&us_to_utt_ni, frequency_Hz, 1000000UL);
+#if (configBSP430_UPTIME_EPOCH - 0) && (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+  discipline_drift_update_ni();
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
+}
+
 #if (configBSP430_UPTIME_EPOCH - 0)
 /* Flag indicating epoch is valid.  Invalidated by resuming the timer,
  * so needs to be visible to those routines. */
@@ -163,7 +237,7 @@ vBSP430uptimeSuspend_ni (void)
 void
 vBSP430uptimeResume_ni (void)
 {
-  ulBSP430uptimeConversionFrequency_Hz_ni_ = ulBSP430timerFrequency_Hz_ni(BSP430_UPTIME_TIMER_PERIPH_HANDLE);
+  conversionsUpdate_ni_(ulBSP430timerFrequency_Hz_ni(BSP430_UPTIME_TIMER_PERIPH_HANDLE));
 #if (configBSP430_UPTIME_DELAY - 0)
   delayAlarm_.flags |= DELAY_ALARM_TIMER_ACTIVE;
   (void)delayAlarmSetRegistered_ni_(1);
@@ -198,15 +272,61 @@ unsigned long
 ulBSP430uptimeSetConversionFrequency_ni (unsigned long frequency_Hz)
 {
   unsigned long rv = ulBSP430uptimeConversionFrequency_Hz_ni_;
-  ulBSP430uptimeConversionFrequency_Hz_ni_ = frequency_Hz;
+  if (0 == frequency_Hz) {
+    frequency_Hz = ulBSP430timerFrequency_Hz_ni(BSP430_UPTIME_TIMER_PERIPH_HANDLE);
+  }
+  conversionsUpdate_ni_(frequency_Hz);
   return rv;
 }
 
+/* Interrupt-safe conversion.  The parameters are multi-word and may
+ * be replaced by an interrupt handler, so they are copied with
+ * interrupts disabled; the conversion itself runs with interrupts in
+ * their original state. */
+static unsigned long
+convertSafe_ (const sConversion * cp,
+              unsigned long a)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  sConversion conv;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  conv = *cp;
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return convert_(&conv, a);
+}
+
+unsigned long
+ulBSP430uptimeUTTToMS (unsigned long duration_utt)
+{
+  return convertSafe_(&utt_to_ms_ni, duration_utt);
+}
+
+unsigned long
+ulBSP430uptimeUTTToUS (unsigned long duration_utt)
+{
+  return convertSafe_(&utt_to_us_ni, duration_utt);
+}
+
+unsigned long
+ulBSP430uptimeMSToUTT (unsigned long duration_ms)
+{
+  return convertSafe_(&ms_to_utt_ni, duration_ms);
+}
+
+unsigned long
+ulBSP430uptimeUSToUTT (unsigned long duration_us)
+{
+  return convertSafe_(&us_to_utt_ni, duration_us);
+}
+
 const char *
 xBSP430uptimeAsText (unsigned long duration_utt,
                      char * buffer)
 {
-  unsigned long conversionFrequency_Hz;
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  sConversion to_s;
+  sConversion to_ms;
   unsigned int msec;
   unsigned int sec;
   unsigned int min;
@@ -215,13 +335,18 @@ xBSP430uptimeAsText (unsigned long duration_utt,
   unsigned long q_min;
   unsigned long q_hr;
 
-  conversionFrequency_Hz = ulBSP430uptimeConversionFrequency_Hz_ni_;
-  q_sec = duration_utt / conversionFrequency_Hz;
-  r_utt = duration_utt - (q_sec * conversionFrequency_Hz);
-  msec = (1000L * r_utt) / conversionFrequency_Hz;
-  q_min = q_sec / 60;
+  /* As with convertSafe_(), but both from the same frequency */
+  BSP430_CORE_DISABLE_INTERRUPT();
+  to_s = utt_to_s_ni;
+  to_ms = utt_to_ms_ni;
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+
+  q_sec = convert_(&to_s, duration_utt);
+  r_utt = duration_utt - (q_sec * to_s.den);
+  msec = convert_(&to_ms, r_utt);
+  q_min = convert_(&div60, q_sec);
   sec = q_sec - (q_min * 60);
-  q_hr = q_min / 60;
+  q_hr = convert_(&div60, q_min);
   min = (q_min - (q_hr * 60));
   if (0 < q_hr) {
     snprintf(buffer, BSP430_UPTIME_AS_TEXT_LENGTH, "%u:%02u:%02u.%03u", (unsigned int)q_hr, min, sec, msec);
@@ -242,32 +367,47 @@ unsigned int
 uiBSP430uptimeScaleForDisplay (unsigned long long duration_utt,
                                const char ** unitp)
 {
-  const unsigned long long s_utt = ulBSP430uptimeConversionFrequency_Hz_ni_;
-  const unsigned long long min_utt = 60U * s_utt;
-  const unsigned long long h_utt = 60U * min_utt;
-  const unsigned long long us_cutoff_utt = (10 * s_utt) / 1000U;
-  const unsigned long long ms_cutoff_utt = 10 * s_utt;
-  const unsigned long long s_cutoff_utt = 3U * min_utt;
-  const unsigned long long min_cutoff_utt = 3U * h_utt;
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  sConversion to_s;
+  sConversion to_ms;
+  sConversion to_us;
+  unsigned long long s_utt;
+  unsigned long q_s;
 
-  if (duration_utt < us_cutoff_utt) {
+  /* As with convertSafe_(), but all from the same frequency */
+  BSP430_CORE_DISABLE_INTERRUPT();
+  to_s = utt_to_s_ni;
+  to_ms = utt_to_ms_ni;
+  to_us = utt_to_us_ni;
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  s_utt = to_s.den;
+
+  /* Durations shown in us or ms are less than ten seconds, so fit in
+   * 32 bits.  Only durations beyond 2^32 ticks need 64-bit
+   * division. */
+  if ((100U * (duration_utt + 1)) <= s_utt) {
     *unitp = "us";
-    return (1000000U * duration_utt) / s_utt;
+    return convert_(&to_us, duration_utt);
   }
-  if (duration_utt < ms_cutoff_utt) {
+  if (duration_utt < (10U * s_utt)) {
     *unitp = "ms";
-    return (1000U * duration_utt) / s_utt;
+    return convert_(&to_ms, duration_utt);
   }
-  if (duration_utt < s_cutoff_utt) {
+  if (duration_utt >> 32) {
+    q_s = duration_utt / s_utt;
+  } else {
+    q_s = convert_(&to_s, duration_utt);
+  }
+  if (q_s < (3U * 60U)) {
     *unitp = "s";
-    return duration_utt / s_utt;
+    return q_s;
   }
-  if (duration_utt < min_cutoff_utt) {
+  if (q_s < (3U * 3600U)) {
     *unitp = "min";
-    return duration_utt / min_utt;
+    return convert_(&div60, q_s);
   }
   *unitp = "h";
-  return duration_utt / h_utt;
+  return convert_(&div3600, q_s);
 }
 
 void
@@ -353,13 +493,124 @@ lBSP430uptimeSleepUntil (unsigned long setting_utt,
 #define US_PER_S 1000000UL
 
 /** The duration of an era in uptime ticks. */
-#define ERA_UTT (1 + (uint64_t)~(unsigned long)0)
+#define ERA_UTT (1 + (uint64_t)UINT32_MAX)
 
 /* NTP epoch. */
 static uint64_t epoch_ntp_ni;
 static unsigned long epoch_updated_utt_ni;
 static struct timeval epoch_tv_ni;
 
+#if (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+/* Discipline state.  Corrections are relative to
+ * epoch_updated_utt_ni, and are folded into epoch_ntp_ni whenever
+ * that is moved. */
+static struct {
+  /* Fractional frequency error of the uptime clock, scaled by 2^32 */
+  int32_t freq_s32;
+  /* The correction for freq_s32 in NTP ticks per uptime tick, scaled
+   * by 2^32 */
+  int64_t drift_s32;
+  /* Offset being slewed in, and the duration over which that is done */
+  int32_t slew_ntp;
+  uint32_t slew_utt;
+  /* The rate at which slew_ntp is applied in NTP ticks per uptime
+   * tick, scaled by 2^32 */
+  int64_t slew_rate_s32;
+  /* Average magnitude of unexplained offsets */
+  uint32_t jitter_ntp;
+  /* Time at which the offset was last known */
+  unsigned long baseline_utt;
+  unsigned int samples;
+} discipline_ni;
+
+/* Return d * rate_s32 / 2^32 rounded toward zero.  As in convert_()
+ * the magnitude is formed from two 32x32 multiplications, so
+ * conversions within a critical section need no division. */
+static int64_t
+discipline_scale_ (int32_t d,
+                   int64_t rate_s32)
+{
+  uint32_t ud = (0 > d) ? -(uint32_t)d : (uint32_t)d;
+  uint64_t ur = (0 > rate_s32) ? -(uint64_t)rate_s32 : (uint64_t)rate_s32;
+  uint64_t q;
+
+  q = (uint64_t)ud * (uint32_t)(ur >> 32);
+  q += ((uint64_t)ud * (uint32_t)ur) >> 32;
+  return ((0 > d) != (0 > rate_s32)) ? -(int64_t)q : (int64_t)q;
+}
+
+/* Return num / den as a rate scaled by 2^32, or zero if den is
+ * zero. */
+static int64_t
+discipline_rate_ (int32_t num,
+                  uint32_t den)
+{
+  if (0 == den) {
+    return 0;
+  }
+  return ((int64_t)num * ((int64_t)1 << 32)) / (int64_t)den;
+}
+
+static void
+discipline_drift_update_ni (void)
+{
+  discipline_ni.drift_s32 = discipline_rate_(discipline_ni.freq_s32, ulBSP430uptimeConversionFrequency_Hz_ni_);
+}
+
+/* The part of the slew applied at d_utt ticks past the epoch update */
+static int32_t
+discipline_slewed_ni (int32_t d_utt)
+{
+  if (0 >= d_utt) {
+    return 0;
+  }
+  if ((uint32_t)d_utt >= discipline_ni.slew_utt) {
+    return discipline_ni.slew_ntp;
+  }
+  return discipline_scale_(d_utt, discipline_ni.slew_rate_s32);
+}
+
+/* The correction, in NTP ticks, to be added to the undisciplined
+ * conversion of utt. */
+static int64_t
+discipline_ntp_ni (unsigned long utt)
+{
+  int32_t d_utt = (int32_t)(utt - epoch_updated_utt_ni);
+
+  return discipline_scale_(d_utt, discipline_ni.drift_s32)
+         + discipline_slewed_ni(d_utt);
+}
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
+
+static void
+epoch_store_ni (uint64_t epoch_ntp)
+{
+  epoch_ntp_ni = epoch_ntp;
+  epoch_tv_ni.tv_sec = ((uint32_t)(epoch_ntp >> 32) - BSP430_UPTIME_POSIX_EPOCH_NTPIS);
+  epoch_tv_ni.tv_usec = (US_PER_S * (epoch_ntp & ~(uint32_t)0)) >> 32;
+}
+
+#if (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+/* Move the epoch update time to now_utt, preserving the converted
+ * value of all times. */
+static void
+discipline_reanchor_ni (unsigned long now_utt)
+{
+  int32_t d_utt = (int32_t)(now_utt - epoch_updated_utt_ni);
+
+  epoch_store_ni(epoch_ntp_ni + discipline_ntp_ni(now_utt));
+  discipline_ni.slew_ntp -= discipline_slewed_ni(d_utt);
+  if (0 < d_utt) {
+    if ((uint32_t)d_utt >= discipline_ni.slew_utt) {
+      discipline_ni.slew_utt = 0;
+    } else {
+      discipline_ni.slew_utt -= d_utt;
+    }
+  }
+  epoch_updated_utt_ni = now_utt;
+}
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
+
 int
 iBSP430uptimeCheckEpochValidity ()
 {
@@ -396,7 +647,7 @@ lBSP430uptimeEpochAge ()
     if (! epoch_is_valid_ni) {
       rv = -1L;
     } else {
-      rv = ulBSP430uptime_ni() - epoch_updated_utt_ni;
+      rv = (int32_t)(ulBSP430uptime_ni() - epoch_updated_utt_ni);
     }
   } while (0);
   BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
@@ -404,10 +655,10 @@ lBSP430uptimeEpochAge ()
 }
 
 static int
-epoch_era_ni (unsigned long utt)
+epoch_era_ni (uint32_t utt)
 {
-  const unsigned long HALF_ERA = 0x80000000L;
-  unsigned long delta_utt;
+  const uint32_t HALF_ERA = 0x80000000UL;
+  uint32_t delta_utt;
   int is_before;
 
   if (! epoch_is_valid_ni) {
@@ -526,11 +777,17 @@ iBSP430uptimeSetEpochFromNTP (uint64_t epoch_ntp)
   BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
-    epoch_ntp_ni = epoch_ntp;
-    epoch_tv_ni.tv_sec = ((uint32_t)(epoch_ntp >> 32) - BSP430_UPTIME_POSIX_EPOCH_NTPIS);
-    epoch_tv_ni.tv_usec = (US_PER_S * (epoch_ntp & ~(uint32_t)0)) >> 32;
+    epoch_store_ni(epoch_ntp);
     epoch_updated_utt_ni = ulBSP430uptime_ni();
     epoch_is_valid_ni = 1;
+#if (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+    /* The new epoch is exact as of now.  Any pending slew is
+     * superseded, but the frequency estimate remains valid. */
+    discipline_ni.slew_ntp = 0;
+    discipline_ni.slew_utt = 0;
+    discipline_ni.slew_rate_s32 = 0;
+    discipline_ni.baseline_utt = epoch_updated_utt_ni;
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
   } while (0);
   BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
   return 0;
@@ -544,6 +801,10 @@ iBSP430uptimeAdjustEpochFromNTP (int64_t adjustment_ntp)
 
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
+#if (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+    /* Adjust relative to the disciplined time */
+    discipline_reanchor_ni(ulBSP430uptime_ni());
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
     rv = iBSP430uptimeSetEpochFromNTP(epoch_ntp_ni + adjustment_ntp);
   } while (0);
   BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
@@ -574,7 +835,7 @@ iBSP430uptimeAsNTP (unsigned long utt,
   int rv = -1;
   uint64_t ntp;
 
-  ntp = get_relative_ntp(utt);
+  ntp = get_relative_ntp((uint32_t)utt);
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
     int era;
@@ -589,6 +850,9 @@ iBSP430uptimeAsNTP (unsigned long utt,
     } else {
       era -= 1;
       ntp += epoch_ntp_ni;
+#if (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+      ntp += discipline_ntp_ni(utt);
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
     }
     if (0 != era) {
       uint64_t era_ntp = get_relative_ntp(ERA_UTT);
@@ -617,7 +881,7 @@ iBSP430uptimeAsTimeval (unsigned long utt,
   struct timeval tv;
   int rv = -1;
 
-  get_relative_timeval(utt, &tv);
+  get_relative_timeval((uint32_t)utt, &tv);
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
     int era = epoch_era_ni(utt);
@@ -628,6 +892,13 @@ iBSP430uptimeAsTimeval (unsigned long utt,
     era -= 1;
     tv.tv_sec += epoch_tv_ni.tv_sec;
     tv.tv_usec += epoch_tv_ni.tv_usec;
+#if (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+    {
+      int64_t corr_ntp = discipline_ntp_ni(utt);
+      tv.tv_sec += (int32_t)(corr_ntp >> 32);
+      tv.tv_usec += ((uint64_t)US_PER_S * (uint32_t)corr_ntp) >> 32;
+    }
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
     if (0 != era) {
       struct timeval etv;
       get_relative_timeval(ERA_UTT, &etv);
@@ -707,7 +978,7 @@ iBSP430uptimeProcessNTPResponse (const sBSP430uptimeNTPPacketHeader * req,
     if ((int32_t)adjustment64_ms == adjustment64_ms) {
       *adjustment_ms = (1000 * theta) >> 32;
     } else {
-      *adjustment_ms = (0 > theta) ? LONG_MIN : LONG_MAX;
+      *adjustment_ms = (0 > theta) ? INT32_MIN : INT32_MAX;
     }
   }
   if (rtt_us) {
@@ -716,12 +987,171 @@ iBSP430uptimeProcessNTPResponse (const sBSP430uptimeNTPPacketHeader * req,
     if (rtt64_us == rtt32_us) {
       *rtt_us = rtt32_us;
     } else {
-      *rtt_us = ULONG_MAX;
+      *rtt_us = UINT32_MAX;
     }
   }
   return 0;
 }
 
+#if (configBSP430_UPTIME_EPOCH_DISCIPLINE - 0)
+
+/* Magnitude of x, scaled from NTP ticks to microseconds */
+static uint32_t
+ntp_as_us (int64_t x)
+{
+  if (0 > x) {
+    x = -x;
+  }
+  return (US_PER_S * (uint64_t)x) >> 32;
+}
+
+int
+iBSP430uptimeDisciplineEpochFromNTP (int64_t adjustment_ntp)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  const int64_t max_freq_s32 = ((int64_t)BSP430_UPTIME_DISCIPLINE_MAX_PPM << 32) / 1000000L;
+  unsigned long now_utt;
+  unsigned long anchor_utt;
+  unsigned long interval_utt;
+  unsigned long freq_hz;
+  int32_t residual_ntp;
+  int32_t freq_s32;
+  int64_t drift_s32;
+  int64_t slew_rate_s32;
+  uint64_t slew_utt;
+  unsigned int samples;
+  int update_freq;
+  int published;
+  int rv;
+
+  if ((BSP430_UPTIME_DISCIPLINE_STEP_NTP <= adjustment_ntp)
+      || (-BSP430_UPTIME_DISCIPLINE_STEP_NTP >= adjustment_ntp)) {
+    BSP430_CORE_DISABLE_INTERRUPT();
+    do {
+      rv = -1;
+      if (! epoch_is_valid_ni) {
+        break;
+      }
+      rv = iBSP430uptimeAdjustEpochFromNTP(adjustment_ntp);
+      if (0 == rv) {
+        rv = 1;
+      }
+    } while (0);
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    return rv;
+  }
+  do {
+    /* Snapshot the discipline state.  The 64-bit divisions below are
+     * done with interrupts enabled; the lock is retaken only to
+     * publish the results. */
+    BSP430_CORE_DISABLE_INTERRUPT();
+    do {
+      rv = epoch_is_valid_ni ? 0 : -1;
+      now_utt = ulBSP430uptime_ni();
+      anchor_utt = epoch_updated_utt_ni;
+      freq_hz = ulBSP430uptimeConversionFrequency_Hz_ni_;
+      /* Whatever was not still waiting to be slewed in accumulated
+       * since the baseline because of a frequency error. */
+      residual_ntp = (int32_t)adjustment_ntp
+                     - (discipline_ni.slew_ntp - discipline_slewed_ni((int32_t)(now_utt - anchor_utt)));
+      interval_utt = now_utt - discipline_ni.baseline_utt;
+      freq_s32 = discipline_ni.freq_s32;
+      samples = discipline_ni.samples;
+    } while (0);
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    if (0 != rv) {
+      break;
+    }
+
+    /* An interval that does not fit in 31 bits (about 18 h at 32 KiHz)
+     * may have wrapped, so it gives no frequency estimate. */
+    update_freq = (0 != freq_hz)
+                  && (interval_utt >= (BSP430_UPTIME_DISCIPLINE_MIN_INTERVAL_S * freq_hz))
+                  && (interval_utt <= INT32_MAX);
+    if (update_freq) {
+      int64_t est_s32 = (residual_ntp * (int64_t)freq_hz) / (int32_t)interval_utt;
+
+      /* Take the first estimate at face value, then filter */
+      if (0 != samples) {
+        est_s32 /= (1 << BSP430_UPTIME_DISCIPLINE_GAIN_SHIFT);
+      }
+      est_s32 += freq_s32;
+      if (max_freq_s32 < est_s32) {
+        est_s32 = max_freq_s32;
+      } else if (-max_freq_s32 > est_s32) {
+        est_s32 = -max_freq_s32;
+      }
+      freq_s32 = est_s32;
+      drift_s32 = discipline_rate_(freq_s32, freq_hz);
+    }
+
+    /* Slew the whole offset in at the maximum rate. */
+    slew_utt = ((uint64_t)(0 > adjustment_ntp ? -adjustment_ntp : adjustment_ntp)
+                * (1000000L / BSP430_UPTIME_DISCIPLINE_MAX_PPM)) >> 16;
+    slew_utt = (slew_utt * freq_hz) >> 16;
+    if (INT32_MAX < slew_utt) {
+      slew_utt = INT32_MAX;
+    }
+    /* The remaining slew keeps this rate when the epoch is reanchored,
+     * so it is computed only here. */
+    slew_rate_s32 = discipline_rate_(adjustment_ntp, slew_utt);
+
+    /* Publish unless the epoch or conversion frequency changed while
+     * the estimate was computed, in which case start over. */
+    BSP430_CORE_DISABLE_INTERRUPT();
+    published = epoch_is_valid_ni
+                && (anchor_utt == epoch_updated_utt_ni)
+                && (freq_hz == ulBSP430uptimeConversionFrequency_Hz_ni_);
+    if (published) {
+      uint32_t mag_ntp = (0 > residual_ntp) ? -residual_ntp : residual_ntp;
+
+      /* Reanchor at the current time so no converted value already
+       * reported changes.  What the old slew applied since now_utt is
+       * a few ticks at most and is not deducted. */
+      discipline_reanchor_ni(ulBSP430uptime_ni());
+      discipline_ni.jitter_ntp += (mag_ntp >> BSP430_UPTIME_DISCIPLINE_GAIN_SHIFT)
+                                  - (discipline_ni.jitter_ntp >> BSP430_UPTIME_DISCIPLINE_GAIN_SHIFT);
+      if (update_freq) {
+        discipline_ni.freq_s32 = freq_s32;
+        discipline_ni.drift_s32 = drift_s32;
+        ++discipline_ni.samples;
+      }
+      discipline_ni.baseline_utt = now_utt;
+      discipline_ni.slew_ntp = adjustment_ntp;
+      discipline_ni.slew_utt = slew_utt;
+      discipline_ni.slew_rate_s32 = slew_rate_s32;
+    }
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  } while (! published);
+  return rv;
+}
+
+int
+iBSP430uptimeGetDiscipline (sBSP430uptimeDiscipline * dp)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  int32_t slew_ntp;
+
+  if (! dp) {
+    return -1;
+  }
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    slew_ntp = discipline_ni.slew_ntp - discipline_slewed_ni((int32_t)(ulBSP430uptime_ni() - epoch_updated_utt_ni));
+    dp->freq_ppb = ((int64_t)discipline_ni.freq_s32 * 1000000000L) >> 32;
+    dp->jitter_us = ntp_as_us(discipline_ni.jitter_ntp);
+    dp->samples = discipline_ni.samples;
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  dp->slew_us = ntp_as_us(slew_ntp);
+  if (0 > slew_ntp) {
+    dp->slew_us = -dp->slew_us;
+  }
+  return 0;
+}
+
+#endif /* configBSP430_UPTIME_EPOCH_DISCIPLINE */
+
 #endif /* configBSP430_UPTIME_DELAY */
 
 #endif /* BSP430_UPTIME */